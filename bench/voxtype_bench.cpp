@@ -0,0 +1,879 @@
+// voxtype_bench: speed and accuracy of the whole pipeline over a fixed corpus,
+// measured in one run so the two can't drift apart.
+//
+// Every clip in bench/corpus/manifest.tsv is benchmarked clean and with
+// seeded white noise at each requested SNR:
+//   audio  capture-thread stage (high-pass + gate) and AGC/normalization
+//   vad    streaming VAD feed and segment extraction
+//   text   TextProcessor on the reference transcript with fillers added
+//   decode Transcriber real-time factor and WER per model x profile x threads
+//
+// Results go to stdout as tables, and optionally to a JSON file (--json) and
+// a Markdown summary (--markdown), which replaces the marked block of an
+// existing document such as ACCURACY_RESULTS.md.
+
+#include "audio_processor.hpp"
+#include "config.hpp"
+#include "cpu_topology.hpp"
+#include "model_manager.hpp"
+#include "streaming_vad.hpp"
+#include "text_processor.hpp"
+#include "thread_tuner.hpp"
+#include "transcriber.hpp"
+#include "wav_reader.hpp"
+#include "whisper.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace whispr;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int SAMPLE_RATE = 16000;
+constexpr int CLEAN = 1000;         // SNR value standing for "no noise added"
+constexpr size_t CAPTURE_BLOCK = 512;  // Config::frames_per_buffer
+constexpr int STAGE_RUNS = 20;      // Cheap stages: median of this many runs
+constexpr int TEXT_ITERATIONS = 2000;
+
+const char* MARK_BEGIN = "<!-- voxtype_bench:begin -->";
+const char* MARK_END = "<!-- voxtype_bench:end -->";
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+std::string snr_label(int snr) {
+    return snr == CLEAN ? "clean" : std::to_string(snr) + "dB";
+}
+
+std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> parts;
+    std::stringstream stream(s);
+    std::string part;
+    while (std::getline(stream, part, sep)) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+// SHA-256 (FIPS 180-4) of a file's bytes as lowercase hex, empty if unreadable
+std::string sha256_file(const std::string& path) {
+    static const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+    auto compress = [&](const unsigned char* block) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = static_cast<uint32_t>(block[4 * i]) << 24 | static_cast<uint32_t>(block[4 * i + 1]) << 16 |
+                   static_cast<uint32_t>(block[4 * i + 2]) << 8 | static_cast<uint32_t>(block[4 * i + 3]);
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = k + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            k = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+    };
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return "";
+    unsigned char block[64];
+    uint64_t bytes = 0;
+    size_t n;
+    while ((n = static_cast<size_t>(file.read(reinterpret_cast<char*>(block), 64).gcount())) == 64) {
+        compress(block);
+        bytes += 64;
+    }
+    bytes += n;
+
+    // Padding: 0x80, zeros, then the length in bits (big-endian)
+    block[n++] = 0x80;
+    if (n > 56) {
+        std::memset(block + n, 0, 64 - n);
+        compress(block);
+        n = 0;
+    }
+    std::memset(block + n, 0, 56 - n);
+    for (int i = 0; i < 8; ++i) block[56 + i] = static_cast<unsigned char>((bytes * 8) >> (56 - 8 * i));
+    compress(block);
+
+    char hex[65];
+    for (int i = 0; i < 8; ++i) std::snprintf(hex + 8 * i, 9, "%08x", h[i]);
+    return std::string(hex, 64);
+}
+
+struct Clip {
+    std::string name;
+    std::string sha256;
+    std::string reference;
+    std::vector<float> audio;  // 16 kHz mono
+    double audio_ms() const { return audio.size() * 1000.0 / SAMPLE_RATE; }
+};
+
+// manifest.tsv lines: <file name><TAB><sha256><TAB><reference transcript>;
+// # starts a comment. Every clip must match its hash: numbers measured on
+// other audio (a different TTS voice, a re-encoded file) aren't comparable,
+// so nothing is reported unless the whole corpus verifies. With
+// `allow_unverified`, clips that don't match are used anyway and `verified`
+// is cleared so the results can say so; missing clips always fail.
+bool load_corpus(const std::string& dir, bool allow_unverified, std::vector<Clip>& clips, bool& verified) {
+    verified = true;
+    std::ifstream manifest(dir + "/manifest.tsv");
+    if (!manifest) {
+        std::cerr << "No corpus manifest at " << dir << "/manifest.tsv" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    size_t missing = 0;
+    size_t mismatched = 0;
+    while (std::getline(manifest, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t tab = line.find('\t');
+        size_t second = tab == std::string::npos ? tab : line.find('\t', tab + 1);
+        if (second == std::string::npos) continue;
+
+        Clip clip;
+        clip.name = line.substr(0, tab);
+        clip.sha256 = line.substr(tab + 1, second - tab - 1);
+        clip.reference = line.substr(second + 1);
+        const std::string path = dir + "/" + clip.name;
+        const std::string actual = sha256_file(path);
+        if (actual.empty()) {
+            std::cerr << clip.name << ": cannot open " << path << std::endl;
+            ++missing;
+            continue;
+        }
+        if (actual != clip.sha256) {
+            std::cerr << clip.name << ": sha256 " << actual << " does not match the manifest ("
+                      << clip.sha256 << ")" << std::endl;
+            if (!allow_unverified) {
+                ++mismatched;
+                continue;
+            }
+            // Recorded as measured, so unverified result files can still be compared with each other
+            clip.sha256 = actual;
+            verified = false;
+        }
+        std::string error;
+        if (!WavReader::read_all(path, clip.audio, SAMPLE_RATE, &error)) {
+            std::cerr << clip.name << ": " << error << std::endl;
+            ++mismatched;
+            continue;
+        }
+        clips.push_back(std::move(clip));
+    }
+
+    if (missing > 0) {
+        std::cerr << missing << " corpus clip(s) missing; fetch them with scripts/make_bench_corpus.sh" << std::endl;
+    }
+    if (mismatched > 0) {
+        std::cerr << mismatched << " corpus clip(s) differ from the pinned corpus; refusing to report"
+                  << " (--unverified runs on them anyway)" << std::endl;
+    }
+    return missing == 0 && mismatched == 0 && !clips.empty();
+}
+
+// Deterministic noise at `snr` dB below the clip's overall RMS, seeded by the
+// clip name so every run and every machine mixes the same signal
+std::vector<float> with_noise(const Clip& clip, int snr) {
+    std::vector<float> audio = clip.audio;
+    if (snr == CLEAN || audio.empty()) return audio;
+
+    double sum_sq = 0.0;
+    for (float s : audio) sum_sq += static_cast<double>(s) * s;
+    const float rms = static_cast<float>(std::sqrt(sum_sq / audio.size()));
+    const float noise_rms = rms / std::pow(10.0f, snr / 20.0f);
+
+    uint32_t state = 2166136261u;  // FNV-1a of the name and SNR
+    for (char c : clip.name + "/" + std::to_string(snr)) {
+        state = (state ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    auto uniform = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / 16777216.0f - 0.5f;
+    };
+
+    // Sum of four uniforms: close enough to Gaussian, variance 4/12
+    const float scale = noise_rms / std::sqrt(4.0f / 12.0f);
+    for (float& s : audio) {
+        s += scale * (uniform() + uniform() + uniform() + uniform());
+    }
+    return audio;
+}
+
+// The recording path of App: process_block and VAD feed per capture block,
+// then AGC/normalization and speech compaction on release
+struct PipelineTiming {
+    double capture_ms = 0.0;   // process_block over every block
+    double vad_feed_ms = 0.0;
+    double finish_ms = 0.0;
+    double segments_ms = 0.0;
+    size_t segments = 0;
+    size_t speech_samples = 0;
+};
+
+std::vector<float> preprocess(std::vector<float> audio, bool enabled, PipelineTiming* timing = nullptr) {
+    if (!enabled) return audio;
+
+    Config config;
+    AudioProcessor processor(static_cast<float>(SAMPLE_RATE));
+    VadConfig vad_config;
+    vad_config.threshold = config.silence_threshold * 1.5f;
+    vad_config.min_speech_ms = config.min_silence_ms;
+    vad_config.padding_ms = config.vad_padding_ms;
+    StreamingVad vad(vad_config, audio.size());
+
+    PipelineTiming t;
+    for (size_t i = 0; i < audio.size(); i += CAPTURE_BLOCK) {
+        Span<float> block(audio.data() + i, std::min(CAPTURE_BLOCK, audio.size() - i));
+        auto start = Clock::now();
+        processor.process_block(block);
+        t.capture_ms += ms_since(start);
+        start = Clock::now();
+        vad.feed(Span<const float>(block.data(), block.size()));
+        t.vad_feed_ms += ms_since(start);
+    }
+
+    auto start = Clock::now();
+    const float gain = processor.finish(audio);
+    t.finish_ms = ms_since(start);
+
+    start = Clock::now();
+    std::vector<SampleRange> ranges = vad.segments(gain);
+    if (!ranges.empty()) {
+        audio.resize(AudioProcessor::compact(audio, ranges));
+    }
+    t.segments_ms = ms_since(start);
+    t.segments = ranges.size();
+    t.speech_samples = audio.size();
+
+    if (audio.size() < static_cast<size_t>(SAMPLE_RATE / 10)) {
+        audio.resize(SAMPLE_RATE / 10, 0.0f);  // Whisper's 100ms minimum, as in App
+    }
+    if (timing) *timing = t;
+    return audio;
+}
+
+// Lowercased words with punctuation dropped (apostrophes kept), so WER counts
+// recognition errors and not formatting
+std::vector<std::string> normalize_words(const std::string& text) {
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : text) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u) || c == '\'') {
+            word += static_cast<char>(std::tolower(u));
+        } else if (c == '-' || std::isspace(u)) {
+            if (!word.empty()) words.push_back(std::move(word));
+            word.clear();
+        }
+    }
+    if (!word.empty()) words.push_back(std::move(word));
+    return words;
+}
+
+// Word-level Levenshtein distance: substitutions + deletions + insertions
+size_t word_edits(const std::vector<std::string>& ref, const std::vector<std::string>& hyp) {
+    std::vector<size_t> prev(hyp.size() + 1), cur(hyp.size() + 1);
+    for (size_t j = 0; j <= hyp.size(); ++j) prev[j] = j;
+    for (size_t i = 1; i <= ref.size(); ++i) {
+        cur[0] = i;
+        for (size_t j = 1; j <= hyp.size(); ++j) {
+            size_t substitute = prev[j - 1] + (ref[i - 1] == hyp[j - 1] ? 0 : 1);
+            cur[j] = std::min({substitute, prev[j] + 1, cur[j - 1] + 1});
+        }
+        std::swap(prev, cur);
+    }
+    return prev[hyp.size()];
+}
+
+// Reference with a filler every few words, so the filler stage has work to do
+std::string with_fillers(const std::string& reference) {
+    static const char* FILLERS[] = {"um", "uh", "you know", "like"};
+    std::string out;
+    size_t n = 0;
+    for (const std::string& word : split(reference, ' ')) {
+        if (n % 5 == 2) {
+            out += FILLERS[(n / 5) % 4];
+            out += ' ';
+        }
+        out += word;
+        out += ' ';
+        ++n;
+    }
+    return out;
+}
+
+struct Options {
+    std::string corpus_dir = "bench/corpus";
+    std::string model_dir = "models";
+    std::vector<ModelQuality> qualities = {ModelQuality::Fast, ModelQuality::Balanced,
+                                           ModelQuality::Accurate, ModelQuality::Best};
+    std::vector<ModelPrecision> precisions = {ModelPrecision::F16, ModelPrecision::Q8, ModelPrecision::Q5};
+    std::vector<std::string> profiles;  // Empty: each model's own profile
+    std::vector<int> threads;           // Empty: ThreadTuner candidates
+    std::vector<int> snrs = {CLEAN, 20, 10, 5};
+    int repeat = 3;
+    bool use_gpu = true;
+    bool preprocess = true;
+    bool decode = true;
+    bool unverified = false;  // Run on clips that don't match their pinned hashes
+    std::string json_path;
+    std::string markdown_path;
+};
+
+const TranscriptionProfile* find_profile(const std::string& name) {
+    for (const TranscriptionProfile* p : {&PROFILE_FAST, &PROFILE_BALANCED, &PROFILE_ACCURATE,
+                                          &PROFILE_BEST, &PROFILE_OPTIMIZED}) {
+        std::string lower = p->name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        if (name == lower) return p;
+    }
+    return nullptr;
+}
+
+bool parse_quality(const std::string& name, ModelQuality& quality) {
+    if (name == "fast") quality = ModelQuality::Fast;
+    else if (name == "balanced") quality = ModelQuality::Balanced;
+    else if (name == "accurate") quality = ModelQuality::Accurate;
+    else if (name == "best") quality = ModelQuality::Best;
+    else return false;
+    return true;
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "\nOptions:\n"
+              << "  --corpus DIR        Corpus with manifest.tsv (default: bench/corpus)\n"
+              << "  -m, --model-dir DIR Directory containing models (default: models)\n"
+              << "  -q, --quality LIST  Models by quality: fast,balanced,accurate,best (default: all found)\n"
+              << "  --precision LIST    Model weights: f16,q8,q5 (default: all found)\n"
+              << "  --profiles LIST     Profiles: fast,balanced,accurate,best,optimized (default: the model's own)\n"
+              << "  -t, --threads LIST  Decode thread counts (default: the thread tuner's candidates)\n"
+              << "  --snr LIST          Noise conditions: clean and SNRs in dB (default: clean,20,10,5)\n"
+              << "  --repeat N          Decodes per clip; the median is reported (default: 3)\n"
+              << "  --no-gpu            Decode on the CPU\n"
+              << "  --no-preprocess     Skip AGC and VAD before decoding\n"
+              << "  --stages-only       Benchmark preprocessing and text only, no models\n"
+              << "  --unverified        Run on clips that don't match their pinned hashes; results are marked unverified\n"
+              << "  --json FILE         Write every measurement as JSON\n"
+              << "  --markdown FILE     Write the summary table (replaces the marked block if FILE has one)\n"
+              << "  -h, --help          Show this help message\n"
+              << std::endl;
+}
+
+bool parse_args(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            std::exit(0);
+        }
+        else if (strcmp(argv[i], "--corpus") == 0 && has_value) {
+            options.corpus_dir = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--model-dir") == 0) && has_value) {
+            options.model_dir = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quality") == 0) && has_value) {
+            options.qualities.clear();
+            for (const std::string& name : split(argv[++i], ',')) {
+                ModelQuality quality;
+                if (!parse_quality(name, quality)) {
+                    std::cerr << "Unknown quality mode: " << name << std::endl;
+                    return false;
+                }
+                options.qualities.push_back(quality);
+            }
+        }
+        else if (strcmp(argv[i], "--precision") == 0 && has_value) {
+            options.precisions.clear();
+            for (const std::string& name : split(argv[++i], ',')) {
+                ModelPrecision precision;
+                if (!parse_model_precision(name, precision) || precision == ModelPrecision::Auto) {
+                    std::cerr << "Unknown model precision: " << name << std::endl;
+                    return false;
+                }
+                options.precisions.push_back(precision);
+            }
+        }
+        else if (strcmp(argv[i], "--profiles") == 0 && has_value) {
+            options.profiles = split(argv[++i], ',');
+            for (const std::string& name : options.profiles) {
+                if (!find_profile(name)) {
+                    std::cerr << "Unknown profile: " << name << std::endl;
+                    return false;
+                }
+            }
+        }
+        else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) && has_value) {
+            options.threads.clear();
+            for (const std::string& n : split(argv[++i], ',')) {
+                options.threads.push_back(std::max(1, std::atoi(n.c_str())));
+            }
+        }
+        else if (strcmp(argv[i], "--snr") == 0 && has_value) {
+            options.snrs.clear();
+            for (const std::string& s : split(argv[++i], ',')) {
+                options.snrs.push_back(s == "clean" ? CLEAN : std::atoi(s.c_str()));
+            }
+        }
+        else if (strcmp(argv[i], "--repeat") == 0 && has_value) {
+            options.repeat = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--no-gpu") == 0) {
+            options.use_gpu = false;
+        }
+        else if (strcmp(argv[i], "--no-preprocess") == 0) {
+            options.preprocess = false;
+        }
+        else if (strcmp(argv[i], "--stages-only") == 0) {
+            options.decode = false;
+        }
+        else if (strcmp(argv[i], "--unverified") == 0) {
+            options.unverified = true;
+        }
+        else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            options.json_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--markdown") == 0 && has_value) {
+            options.markdown_path = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// One model x profile x thread count over the whole corpus
+struct DecodeSummary {
+    std::string model;
+    std::string profile;
+    int threads = 0;
+    bool on_gpu = false;
+    int64_t load_ms = 0;
+    uint64_t file_mb = 0;
+    uint64_t memory_mb = 0;           // Resident memory the load added
+    std::map<int, size_t> edits;      // By SNR
+    std::map<int, size_t> ref_words;  // By SNR
+    std::vector<double> rtf;
+
+    double wer(int snr) const {
+        auto words = ref_words.find(snr);
+        if (words == ref_words.end() || words->second == 0) return 0.0;
+        return static_cast<double>(edits.at(snr)) / words->second;
+    }
+};
+
+struct Results {
+    std::vector<std::string> audio;      // JSON objects
+    std::vector<std::string> text;
+    std::vector<std::string> decode;
+    std::vector<DecodeSummary> summaries;
+};
+
+void bench_stages(const std::vector<Clip>& clips, const Options& options, Results& results) {
+    std::cout << "\n=== Preprocessing (median of " << STAGE_RUNS << " runs, ms) ===" << std::endl;
+    std::cout << std::left << std::setw(24) << "clip" << std::setw(7) << "noise" << std::right
+              << std::setw(9) << "audio" << std::setw(9) << "capture" << std::setw(9) << "vad"
+              << std::setw(9) << "finish" << std::setw(9) << "segment" << std::setw(10) << "x real"
+              << std::setw(6) << "segs" << std::setw(9) << "speech" << std::endl;
+
+    for (const Clip& clip : clips) {
+        for (int snr : options.snrs) {
+            const std::vector<float> noisy = with_noise(clip, snr);
+            std::vector<double> capture, feed, finish, segments;
+            PipelineTiming t;
+            for (int run = 0; run < STAGE_RUNS; ++run) {
+                preprocess(noisy, true, &t);
+                capture.push_back(t.capture_ms);
+                feed.push_back(t.vad_feed_ms);
+                finish.push_back(t.finish_ms);
+                segments.push_back(t.segments_ms);
+            }
+            const double total = median(capture) + median(feed) + median(finish) + median(segments);
+            const double realtime = total > 0.0 ? clip.audio_ms() / total : 0.0;
+            const double speech_ms = t.speech_samples * 1000.0 / SAMPLE_RATE;
+
+            std::cout << std::left << std::setw(24) << clip.name << std::setw(7) << snr_label(snr)
+                      << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(9) << std::setprecision(0) << clip.audio_ms() << std::setprecision(3)
+                      << std::setw(9) << median(capture) << std::setw(9) << median(feed)
+                      << std::setw(9) << median(finish) << std::setw(9) << median(segments)
+                      << std::setw(10) << std::setprecision(0) << realtime
+                      << std::setw(6) << t.segments << std::setw(9) << speech_ms << std::endl;
+
+            std::ostringstream json;
+            json << std::fixed << std::setprecision(4)
+                 << "{\"clip\":" << json_string(clip.name) << ",\"snr\":" << json_string(snr_label(snr))
+                 << ",\"audio_ms\":" << clip.audio_ms() << ",\"capture_ms\":" << median(capture)
+                 << ",\"vad_feed_ms\":" << median(feed) << ",\"finish_ms\":" << median(finish)
+                 << ",\"segments_ms\":" << median(segments) << ",\"x_realtime\":" << realtime
+                 << ",\"segments\":" << t.segments << ",\"speech_ms\":" << speech_ms << "}";
+            results.audio.push_back(json.str());
+        }
+    }
+
+    std::cout << "\n=== Text processing (" << TEXT_ITERATIONS << " iterations) ===" << std::endl;
+    std::cout << std::left << std::setw(24) << "clip" << std::right << std::setw(8) << "chars"
+              << std::setw(12) << "ns/char" << std::setw(10) << "MB/s" << std::endl;
+
+    TextProcessor processor;
+    std::string out;
+    for (const Clip& clip : clips) {
+        const std::string input = with_fillers(clip.reference);
+        processor.process(input, out);  // Warm the per-thread buffers
+
+        auto start = Clock::now();
+        for (int i = 0; i < TEXT_ITERATIONS; ++i) {
+            processor.process(input, out);
+        }
+        const double ms = ms_since(start);
+        const double bytes = static_cast<double>(input.size()) * TEXT_ITERATIONS;
+        const double ns_per_char = ms * 1e6 / bytes;
+        const double mb_per_s = bytes / (ms * 1e3);
+
+        std::cout << std::left << std::setw(24) << clip.name << std::right << std::setw(8) << input.size()
+                  << std::fixed << std::setprecision(2) << std::setw(12) << ns_per_char
+                  << std::setw(10) << std::setprecision(1) << mb_per_s << std::endl;
+
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(4)
+             << "{\"clip\":" << json_string(clip.name) << ",\"chars\":" << input.size()
+             << ",\"ns_per_char\":" << ns_per_char << ",\"mb_per_s\":" << mb_per_s << "}";
+        results.text.push_back(json.str());
+    }
+}
+
+void bench_decode(const std::vector<Clip>& clips, const Options& options, Results& results) {
+    std::vector<int> thread_counts = options.threads;
+    if (thread_counts.empty()) {
+        thread_counts = ThreadTuner::candidates(performance_core_count(), available_cpu_count());
+    }
+
+    // Preprocessing is deterministic, so do it once per clip and condition
+    std::vector<std::vector<std::vector<float>>> inputs(clips.size());
+    for (size_t c = 0; c < clips.size(); ++c) {
+        for (int snr : options.snrs) {
+            inputs[c].push_back(preprocess(with_noise(clips[c], snr), options.preprocess));
+        }
+    }
+
+    std::vector<std::vector<std::string>> references;
+    for (const Clip& clip : clips) references.push_back(normalize_words(clip.reference));
+
+    for (ModelQuality quality : options.qualities) {
+        for (ModelPrecision precision : options.precisions) {
+            const std::string filename = get_model_filename(quality, precision);
+            const std::string path = options.model_dir + "/" + filename;
+            std::ifstream exists(path);
+            if (!exists) {
+                std::cout << "\nSkipping " << filename << " (not found in " << options.model_dir << ")" << std::endl;
+                continue;
+            }
+
+            auto model = WhisperModel::load(path, 1, options.use_gpu);
+            if (!model) {
+                std::cerr << "Failed to load " << path << std::endl;
+                continue;
+            }
+            Transcriber transcriber;
+            transcriber.initialize(model);
+
+            std::vector<const TranscriptionProfile*> profiles;
+            for (const std::string& name : options.profiles) profiles.push_back(find_profile(name));
+            if (profiles.empty()) profiles.push_back(&get_profile(quality));
+
+            for (const TranscriptionProfile* profile : profiles) {
+                for (int threads : thread_counts) {
+                    DecodeSummary summary;
+                    summary.model = filename;
+                    summary.profile = profile->name;
+                    summary.threads = threads;
+                    summary.on_gpu = model->on_gpu();
+                    summary.load_ms = model->load_ms();
+                    summary.file_mb = model->file_bytes() / (1024 * 1024);
+                    summary.memory_mb = model->memory_bytes() / (1024 * 1024);
+
+                    std::cout << "\n=== " << summary.model << " / " << summary.profile << " / "
+                              << threads << " threads" << (summary.on_gpu ? " (GPU)" : "") << " ===" << std::endl;
+
+                    DecodeOptions decode;
+                    decode.n_threads = threads;
+                    decode.log_result = false;
+                    transcriber.warm_up(*profile);
+
+                    for (size_t c = 0; c < clips.size(); ++c) {
+                        for (size_t s = 0; s < options.snrs.size(); ++s) {
+                            const int snr = options.snrs[s];
+                            std::vector<double> times;
+                            TranscriptionResult result;
+                            for (int run = 0; run < options.repeat; ++run) {
+                                auto start = Clock::now();
+                                result = transcriber.transcribe_with_profile(inputs[c][s], *profile, decode);
+                                times.push_back(ms_since(start));
+                            }
+                            const double decode_ms = median(times);
+                            const double rtf = decode_ms / clips[c].audio_ms();
+                            const size_t edits = word_edits(references[c], normalize_words(result.text));
+                            const size_t words = references[c].size();
+                            const double wer = words ? static_cast<double>(edits) / words : 0.0;
+
+                            summary.edits[snr] += edits;
+                            summary.ref_words[snr] += words;
+                            summary.rtf.push_back(rtf);
+
+                            std::cout << std::left << std::setw(24) << clips[c].name << std::setw(7) << snr_label(snr)
+                                      << std::right << std::fixed << std::setprecision(0) << std::setw(8) << decode_ms
+                                      << "ms  RTF " << std::setprecision(3) << rtf
+                                      << "  WER " << std::setprecision(1) << std::setw(5) << wer * 100.0 << "%"
+                                      << (result.success ? "" : "  (failed: " + result.error + ")") << std::endl;
+
+                            std::ostringstream json;
+                            json << std::fixed << std::setprecision(4)
+                                 << "{\"model\":" << json_string(summary.model) << ",\"profile\":" << json_string(summary.profile)
+                                 << ",\"threads\":" << threads << ",\"clip\":" << json_string(clips[c].name)
+                                 << ",\"snr\":" << json_string(snr_label(snr)) << ",\"audio_ms\":" << clips[c].audio_ms()
+                                 << ",\"decode_ms\":" << decode_ms << ",\"rtf\":" << rtf << ",\"wer\":" << wer
+                                 << ",\"edits\":" << edits << ",\"ref_words\":" << words
+                                 << ",\"confidence\":" << result.confidence << ",\"success\":" << (result.success ? "true" : "false")
+                                 << ",\"text\":" << json_string(result.text) << "}";
+                            results.decode.push_back(json.str());
+                        }
+                    }
+                    results.summaries.push_back(std::move(summary));
+                }
+            }
+        }
+    }
+}
+
+double mean(const std::vector<double>& values) {
+    if (values.empty()) return 0.0;
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    return sum / values.size();
+}
+
+std::string timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buf;
+}
+
+std::string markdown_table(const Results& results, const Options& options, size_t clip_count, bool verified) {
+    std::ostringstream md;
+    md << "Measured by `voxtype_bench` on " << timestamp() << ": " << clip_count << " clips, "
+       << available_cpu_count() << " CPUs (" << performance_core_count() << " performance), "
+       << (options.preprocess ? "with" : "without") << " preprocessing, median of "
+       << options.repeat << " decodes.\n\n";
+    if (!verified) {
+        md << "**Unverified corpus:** the clips don't match the pinned hashes in `bench/corpus/manifest.tsv`, "
+           << "so these numbers are not comparable with other machines or runs.\n\n";
+    }
+    if (results.summaries.empty()) {
+        md << "(No models were benchmarked.)\n";
+        return md.str();
+    }
+
+    md << "| Model | Profile | Threads | Load (ms) | Memory (MB) |";
+    for (int snr : options.snrs) md << " WER " << snr_label(snr) << " |";
+    md << " RTF mean | RTF max |\n";
+    md << "|-------|---------|---------|-----------|-------------|";
+    for (size_t i = 0; i < options.snrs.size(); ++i) md << "------|";
+    md << "----------|---------|\n";
+
+    md << std::fixed;
+    for (const DecodeSummary& s : results.summaries) {
+        md << "| " << s.model << " | " << s.profile << " | " << s.threads << (s.on_gpu ? " + GPU" : "")
+           << " | " << s.load_ms << " | " << s.memory_mb << " |";
+        for (int snr : options.snrs) md << " " << std::setprecision(1) << s.wer(snr) * 100.0 << "% |";
+        md << " " << std::setprecision(3) << mean(s.rtf) << " | "
+           << *std::max_element(s.rtf.begin(), s.rtf.end()) << " |\n";
+    }
+    return md.str();
+}
+
+bool write_markdown(const std::string& path, const std::string& table) {
+    std::string document;
+    {
+        std::ifstream in(path);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        document = buffer.str();
+    }
+
+    size_t begin = document.find(MARK_BEGIN);
+    size_t end = document.find(MARK_END);
+    if (begin != std::string::npos && end != std::string::npos && end > begin) {
+        begin += std::strlen(MARK_BEGIN);
+        document.replace(begin, end - begin, "\n" + table);
+    } else {
+        document = std::string(MARK_BEGIN) + "\n" + table + MARK_END + "\n";
+    }
+
+    std::ofstream out(path);
+    out << document;
+    return static_cast<bool>(out);
+}
+
+bool write_json(const std::string& path, const Results& results, const Options& options,
+                const std::vector<Clip>& clips, bool verified) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    auto list = [&out](const char* name, const std::vector<std::string>& items) {
+        out << ",\n\"" << name << "\":[";
+        for (size_t i = 0; i < items.size(); ++i) {
+            out << (i ? ",\n " : "\n ") << items[i];
+        }
+        out << "\n]";
+    };
+
+    out << "{\"meta\":{\"time\":" << json_string(timestamp())
+        << ",\"clips\":" << clips.size()
+        << ",\"verified\":" << (verified ? "true" : "false")
+        << ",\"cpus\":" << available_cpu_count()
+        << ",\"performance_cores\":" << performance_core_count()
+        << ",\"preprocess\":" << (options.preprocess ? "true" : "false")
+        << ",\"repeat\":" << options.repeat
+        << ",\"system\":" << json_string(whisper_print_system_info())
+        << ",\"corpus\":{";
+    // The clip hashes, so two result files can be checked for the same audio
+    for (size_t i = 0; i < clips.size(); ++i) {
+        out << (i ? "," : "") << json_string(clips[i].name) << ":" << json_string(clips[i].sha256);
+    }
+    out << "}}";
+    list("audio", results.audio);
+    list("text", results.text);
+    list("decode", results.decode);
+
+    std::vector<std::string> summaries;
+    for (const DecodeSummary& s : results.summaries) {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(4)
+             << "{\"model\":" << json_string(s.model) << ",\"profile\":" << json_string(s.profile)
+             << ",\"threads\":" << s.threads << ",\"gpu\":" << (s.on_gpu ? "true" : "false")
+             << ",\"load_ms\":" << s.load_ms << ",\"file_mb\":" << s.file_mb
+             << ",\"memory_mb\":" << s.memory_mb << ",\"wer\":{";
+        for (size_t i = 0; i < options.snrs.size(); ++i) {
+            json << (i ? "," : "") << json_string(snr_label(options.snrs[i])) << ":" << s.wer(options.snrs[i]);
+        }
+        json << "},\"rtf_mean\":" << mean(s.rtf)
+             << ",\"rtf_max\":" << *std::max_element(s.rtf.begin(), s.rtf.end()) << "}";
+        summaries.push_back(json.str());
+    }
+    list("summary", summaries);
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_args(argc, argv, options)) return 1;
+
+    std::vector<Clip> clips;
+    bool verified = false;
+    if (!load_corpus(options.corpus_dir, options.unverified, clips, verified)) return 1;
+
+    double corpus_ms = 0.0;
+    for (const Clip& clip : clips) corpus_ms += clip.audio_ms();
+    std::cout << "Corpus: " << clips.size() << " clips, " << std::fixed << std::setprecision(1)
+              << corpus_ms / 1000.0 << "s of audio" << (verified ? "" : " (unverified)") << std::endl;
+    std::cout << "CPUs: " << available_cpu_count() << " (" << performance_core_count() << " performance)" << std::endl;
+
+    Results results;
+    bench_stages(clips, options, results);
+    if (options.decode) {
+        bench_decode(clips, options, results);
+    }
+
+    const std::string table = markdown_table(results, options, clips.size(), verified);
+    if (!results.summaries.empty()) {
+        std::cout << "\n=== Summary ===\n" << table;
+    }
+
+    if (!options.json_path.empty()) {
+        if (!write_json(options.json_path, results, options, clips, verified)) {
+            std::cerr << "Failed to write " << options.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << options.json_path << std::endl;
+    }
+    if (!options.markdown_path.empty()) {
+        if (!write_markdown(options.markdown_path, table)) {
+            std::cerr << "Failed to write " << options.markdown_path << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << options.markdown_path << std::endl;
+    }
+    return 0;
+}
@@ -3,14 +3,29 @@
 #include "config.hpp"
 #include "audio_capture.hpp"
 #include "transcriber.hpp"
+#include "transcription_worker.hpp"
 #include "hotkey_manager.hpp"
 #include "clipboard.hpp"
+#include "keyboard_output.hpp"
+#include "text_typer.hpp"
 #include "audio_processor.hpp"
+#include "streaming_transcriber.hpp"
+#include "long_form_transcriber.hpp"
+#include "continuous_dictation.hpp"
+#include "streaming_vad.hpp"
+#include "model_manager.hpp"
+#include "file_watcher.hpp"
+#include "vocabulary.hpp"
+#include "ipc_server.hpp"
+#include "history_store.hpp"
 
 #include <memory>
 #include <atomic>
 #include <string>
 #include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 namespace whispr {
 
@@ -45,30 +60,169 @@ public:
 
     // Manual control (for menu bar actions)
     void start_recording();
-    void stop_recording();
+    // `released` is when the hotkey went up; key-to-text latency is measured from it
+    void stop_recording(std::chrono::steady_clock::time_point released = std::chrono::steady_clock::now());
+
+    // Switch model quality at runtime. Returns immediately; the model loads in
+    // the background if it isn't cached, and recordings keep using the current
+    // one until it is ready.
+    void set_quality(ModelQuality quality);
+    ModelQuality quality() const { return quality_.load(); }
+
+    // Hands-free dictation: listen without the hotkey and transcribe each
+    // utterance as soon as the speaker pauses, while the next one is captured.
+    // Refused while a push-to-talk recording is in progress.
+    void set_continuous(bool continuous);
+    bool is_continuous() const { return continuous_.load(); }
+
+    // Saved dictations (null with history off or if the log couldn't be opened)
+    const HistoryStore* history() const { return history_.get(); }
 
 private:
-    void on_hotkey(bool pressed);
-    void on_transcription_complete(const std::string& text);
+    void on_hotkey(bool pressed, std::chrono::steady_clock::time_point when);
+    // `typer` holds what streaming already typed for this recording, if anything
+    void on_transcription_complete(const std::string& text, TextTyper* typer);
+
+    // Type newly committed streaming text while the hotkey is still held
+    void type_partial(TextTyper& typer, const std::string& committed_text);
+
+    // Runs on the worker thread: preprocessing, VAD and inference for one recording
+    TranscriptionResult transcribe_recording(Transcriber& transcriber, std::vector<float>& audio_data,
+                                             const AudioStats& stats, StreamingVad* vad);
+    // Runs on the worker thread after each job, in submission order.
+    // `separate` puts a space before the text (hands-free utterances after the first).
+    void finish_transcription(const TranscriptionResult& result, TextTyper* typer,
+                              std::chrono::steady_clock::time_point released, int64_t audio_ms,
+                              bool separate = false);
+
+    // Hands-free session (under continuous_mutex_)
+    void start_continuous();
+    void stop_continuous();
+    // Runs on the dictation thread as each utterance ends: queue it for transcription
+    void submit_utterance(AudioChunk&& utterance);
+
+    // Append an output dictation to the history log and refresh the tray
+    void record_history(const TranscriptionResult& result, int64_t audio_ms, int64_t key_to_text_ms);
+
+    // Leave Recording/Transcribing once no work remains
+    void update_idle_state();
+
+    // (Re)load the vocabulary file and give the transcriber a prompt built
+    // with the model's tokenizer; runs at startup and whenever the file changes
+    void reload_vocabulary();
+
+    // Measure thread counts for the current model's profiles in the background
+    // (auto threads only); started at launch and after each model switch
+    void start_thread_tuning();
+    void run_thread_tuning();
+    // Tuning trials would compete with dictation for the cores: stopped when
+    // a recording starts, picked up again once everything is idle
+    void pause_thread_tuning();
+    void resume_thread_tuning();
+
+    // Queue warm-up decodes ahead of any recording; thread tuning follows them
+    void queue_warm_up();
+
+    // Daemon mode: decode a client's audio on the shared worker, replying
+    // with partial text per chunk if asked and then the result
+    void transcribe_for_client(std::shared_ptr<SharedAudio> audio, bool partials, IpcServer::Reply reply);
+    std::string ipc_status() const;
+
+    // Idle footprint: after idle_compact_minutes free the decode states and
+    // capture buffers, after idle_unload_minutes unload the model as well
+    void idle_loop();
+    void compact_idle();
+    void unload_idle();
+    // Something happened: restart the idle clock. `recording_stopped` also
+    // marks when the user stopped talking, to see how much of a wake showed.
+    void note_activity(bool recording_stopped = false);
+    // Bring the model back after idling, in the background: called as a
+    // recording starts, so the reload overlaps with the user talking
+    void wake_model();
+    void finish_wake(std::shared_ptr<WhisperModel> model, bool reloaded);
 
     Config config_;
     std::unique_ptr<AudioCapture> audio_;
-    std::unique_ptr<Transcriber> transcriber_;
+    std::unique_ptr<ModelManager> models_;
+    std::unique_ptr<TranscriptionWorker> worker_;
     std::unique_ptr<HotkeyManager> hotkey_;
-    std::unique_ptr<AudioProcessor> audio_processor_;
+    std::unique_ptr<AudioProcessor> audio_processor_;  // Filters on the audio thread, finish() on the worker
+    std::unique_ptr<IpcServer> ipc_;                   // Daemon mode only
+    std::unique_ptr<HistoryStore> history_;
+    std::chrono::steady_clock::time_point started_;
+
+    // Speech detector fed during capture (owned by its job once submitted)
+    std::shared_ptr<StreamingVad> vad_;
+
+    // Streaming session for the current recording (owned by its job once submitted)
+    std::shared_ptr<StreamingTranscriber> stream_session_;
+    std::atomic<StreamingTranscriber*> active_stream_{nullptr};  // Read by the audio callback
+
+    // Long-form session for the current recording (owned by its job once submitted)
+    std::shared_ptr<LongFormTranscriber> long_session_;
+    std::atomic<LongFormTranscriber*> active_long_{nullptr};  // Read by the audio callback
+
+    // Hands-free session while listening (owned by its jobs too, which recycle its buffers)
+    std::mutex continuous_mutex_;
+    std::shared_ptr<ContinuousDictation> continuous_session_;  // Set before begin(), reset after end()
+    std::atomic<ContinuousDictation*> active_continuous_{nullptr};  // Read by the audio callback
+    std::shared_ptr<bool> continuous_output_started_;  // Per session; read and set by completions only
+    std::atomic<bool> continuous_{false};
+
+    // Keystroke output (config_.type_output and a working backend)
+    bool typing_ = false;
+    std::shared_ptr<TextTyper> typer_;        // Current streaming/long-form recording (owned by its job once submitted)
+    std::atomic<int> outputs_in_flight_{0};   // Submitted recordings whose text isn't out yet
+
+    // User vocabulary and how often its terms were dictated (guarded by vocab_mutex_)
+    std::mutex vocab_mutex_;
+    VocabularyConfig vocab_;
+    TermUsage vocab_usage_;
+    FileWatcher vocab_watcher_;
+
+    // Thread auto-tuning (null with a fixed thread count or parallel jobs)
+    std::shared_ptr<ThreadTuner> thread_tuner_;
+    std::thread tune_thread_;
+    std::mutex tune_mutex_;
+    bool tune_running_ = false;   // Guarded by tune_mutex_
+    bool tune_again_ = false;     // Model switched while tuning; guarded by tune_mutex_
+    std::atomic<bool> tune_cancel_{false};
+    std::atomic<bool> tune_paused_{false};   // Aborts the trial in progress too
+
+    // Idle policy state (guarded by idle_mutex_)
+    enum class Residency { Loaded, Compact, Unloaded };
+    std::thread idle_thread_;
+    mutable std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    Residency residency_ = Residency::Loaded;
+    bool waking_ = false;
+    std::chrono::steady_clock::time_point last_activity_;
+    std::chrono::steady_clock::time_point last_stop_;     // Latest recording end
+    std::chrono::steady_clock::time_point wake_started_;
+    int64_t last_wake_ms_ = -1;
+
+    std::atomic<ModelQuality> quality_{ModelQuality::Balanced};            // Model in use
+    std::atomic<ModelQuality> requested_quality_{ModelQuality::Balanced};  // Latest switch request
 
     std::atomic<AppState> state_{AppState::Idle};
     std::atomic<bool> should_quit_{false};
     std::atomic<bool> enabled_{true};
 
-    // Timestamp of last recording end (for cooldown)
+    // Tags each recording's (or hands-free utterance's) trace events
+    std::atomic<uint64_t> trace_job_{0};
+
+    // Timestamp of last recording end (for cooldown, hotkey thread only)
     std::chrono::steady_clock::time_point last_recording_end_;
+    std::chrono::steady_clock::time_point recording_started_;  // Hotkey thread only
 };
 
 // Platform-specific tray icon
 bool create_tray_icon(App* app);
 void destroy_tray_icon();
 void update_tray_state(AppState state);
-void add_to_history(const std::string& text);
+// The history changed: the tray takes a fresh snapshot of what it lists
+void update_tray_history();
+// Hands-free dictation was switched on or off
+void update_tray_continuous(bool continuous);
 
 } // namespace whispr
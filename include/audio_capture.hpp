@@ -1,18 +1,28 @@
 #pragma once
 
+#include "span.hpp"
+#include "ring_buffer.hpp"
+#include "audio_processor.hpp"
+#include "streaming_vad.hpp"
+
 #include <vector>
 #include <atomic>
 #include <functional>
-#include <mutex>
+#include <cstdint>
 #include <portaudio.h>
 
 namespace whispr {
 
 class AudioCapture {
 public:
-    using AudioCallback = std::function<void(const std::vector<float>&)>;
+    // Called on the real-time audio thread with a view of the captured buffer.
+    // Must not block or allocate; the view is only valid during the call.
+    using AudioCallback = std::function<void(Span<const float>)>;
 
-    AudioCapture(int sample_rate = 16000, int channels = 1, int frames_per_buffer = 512);
+    // preroll_ms > 0 keeps the input stream running while idle and starts each
+    // recording with that much audio from before start_recording()
+    AudioCapture(int sample_rate = 16000, int channels = 1, int frames_per_buffer = 512,
+                 int max_recording_seconds = 30, int preroll_ms = 0);
     ~AudioCapture();
 
     bool initialize();
@@ -22,15 +32,45 @@ public:
     bool stop_recording();
     bool is_recording() const { return recording_.load(); }
 
-    // Get all recorded audio since start_recording()
+    // Stream stays open between recordings (pre-roll enabled)
+    bool is_warm() const { return preroll_samples_ > 0; }
+    // Upper bound on samples one recording can contain (pre-roll included)
+    size_t max_samples() const { return max_samples_ + preroll_samples_; }
+
+    // Hand out all audio recorded since start_recording() (moved out, the
+    // buffer is replaced on the next clear). Call after stop_recording().
     std::vector<float> get_recorded_audio();
 
     // Clear the audio buffer
     void clear_buffer();
 
-    // Set callback for real-time audio data
+    // Free the recording buffers while idle; the next start_recording()
+    // allocates them again. Call only while not recording.
+    void release_buffers();
+
+    // Set callback for real-time audio data (set before recording starts)
     void set_callback(AudioCallback callback) { callback_ = callback; }
 
+    // Run the processor's streaming stage (high-pass + noise gate) on the audio
+    // thread, so recorded audio and callback data are already filtered. The
+    // processor is not owned; reset it and set it only while not recording.
+    void set_processor(AudioProcessor* processor) { processor_ = processor; }
+
+    // Feed every recorded sample to a voice activity detector as it arrives.
+    // Not owned; set only while not recording.
+    void set_vad(StreamingVad* vad) { vad_ = vad; }
+
+    // With keep_audio off, samples only go to the callback and the VAD:
+    // nothing is kept for get_recorded_audio(), so a recording can run past
+    // max_recording_seconds (long-form sessions buffer the audio themselves).
+    // Set only while not recording.
+    void set_keep_audio(bool keep) { keep_audio_ = keep; }
+
+    // Samples lost because the recording exceeded max_recording_seconds
+    uint64_t dropped_samples() const { return dropped_samples_.load(); }
+    // Number of callbacks PortAudio flagged with paInputOverflow
+    uint64_t overflow_count() const { return overflow_count_.load(); }
+
 private:
     static int pa_callback(const void* input, void* output,
                           unsigned long frame_count,
@@ -38,16 +78,48 @@ private:
                           PaStreamCallbackFlags status_flags,
                           void* user_data);
 
+    // Audio thread: filter (if a processor is set) and deliver
+    void capture(const float* samples, size_t count);
+
+    // Audio thread: push samples into the ring and the callback
+    void deliver(const float* samples, size_t count);
+
+    // Audio thread, idle: keep the most recent preroll_samples_ samples
+    void remember(const float* samples, size_t count);
+    // Audio thread, first callback of a recording: capture the pre-roll, oldest first
+    void flush_preroll();
+
     int sample_rate_;
     int channels_;
     int frames_per_buffer_;
+    size_t max_samples_;
 
     PaStream* stream_ = nullptr;
     std::atomic<bool> recording_{false};
     std::atomic<bool> initialized_{false};
+    // Set while the audio thread may touch recording state; with a warm stream
+    // stop_recording() waits on it instead of on Pa_StopStream
+    std::atomic<bool> in_callback_{false};
+
+    // Pre-roll (audio thread only once the stream runs)
+    size_t preroll_samples_;
+    std::vector<float> preroll_;
+    size_t preroll_pos_ = 0;    // Next write position
+    size_t preroll_fill_ = 0;   // Valid samples
+    bool was_recording_ = false;
+
+    // Audio thread writes, the consumer drains after recording stops
+    SpscRingBuffer<float> ring_;
+    std::vector<float> recorded_;  // Preallocated destination for get_recorded_audio()
+    std::vector<float> scratch_;   // Audio thread only: processed copy of the input
+
+    AudioProcessor* processor_ = nullptr;
+    StreamingVad* vad_ = nullptr;
+    bool keep_audio_ = true;
+    bool buffers_released_ = false;
 
-    std::vector<float> audio_buffer_;
-    std::mutex buffer_mutex_;
+    std::atomic<uint64_t> dropped_samples_{0};
+    std::atomic<uint64_t> overflow_count_{0};
 
     AudioCallback callback_;
 };
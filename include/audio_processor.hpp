@@ -1,7 +1,10 @@
 #pragma once
 
+#include "span.hpp"
+
 #include <vector>
 #include <cmath>
+#include <cstddef>
 
 namespace whispr {
 
@@ -28,6 +31,21 @@ struct AudioProcessorConfig {
     float agc_min_gain = 0.1f;      // Min gain (-20dB, to prevent clipping loud speech)
 };
 
+// Running reductions over first-stage (high-pass + gate) output, used by the
+// gain stages. Accumulated block by block so they can be gathered during capture.
+struct AudioStats {
+    float sum_sq = 0.0f;  // Sum of squared samples (accumulated in sample order)
+    size_t count = 0;     // Number of samples accumulated
+};
+
+// Half-open range of sample indices [start, end)
+struct SampleRange {
+    size_t start;
+    size_t end;
+
+    size_t size() const { return end - start; }
+};
+
 // Audio preprocessing for improved transcription accuracy
 class AudioProcessor {
 public:
@@ -36,14 +54,50 @@ public:
     explicit AudioProcessor(float sample_rate = 16000.0f);
     AudioProcessor(float sample_rate, const Config& config);
 
-    // Process audio buffer in-place
-    void process(std::vector<float>& audio);
+    // Process audio buffer in-place (process_block + finish over the whole buffer)
+    void process(Span<float> audio);
+
+    // First stage: high-pass and noise gate in one fused pass, continuing filter
+    // state from the previous block and accumulating stats(). No allocation, so
+    // this can run on the capture thread as audio arrives.
+    void process_block(Span<float> audio);
+
+    // Second stage: AGC and normalization over the complete recording, using
+    // stats gathered by process_block(). Const, so it is safe to run on another
+    // thread while process_block() handles the next recording. Returns the
+    // combined linear gain applied (soft clipping aside).
+    float finish(Span<float> audio, const AudioStats& stats) const;
+    float finish(Span<float> audio) const { return finish(audio, stats_); }
+
+    const AudioStats& stats() const { return stats_; }
+
+    // Stats for audio that has already been through process_block()
+    static AudioStats measure(Span<const float> audio);
 
     // Individual processing stages (for testing)
-    void apply_highpass(std::vector<float>& audio);
-    void apply_noise_gate(std::vector<float>& audio);
-    void apply_normalization(std::vector<float>& audio);
-    void apply_agc(std::vector<float>& audio);
+    void apply_highpass(Span<float> audio);
+    void apply_noise_gate(Span<float> audio);
+    void apply_normalization(Span<float> audio);
+    void apply_agc(Span<float> audio);
+
+    // VAD: Find the speech region between leading and trailing silence.
+    // Returns the whole buffer if no significant silence is found.
+    static SampleRange find_speech_bounds(Span<const float> audio,
+                                          float threshold = 0.01f,
+                                          int min_silence_samples = 1600,
+                                          int sample_rate = 16000);
+
+    // Enhanced VAD: Padded, merged, non-overlapping speech segments in order.
+    // Returns an empty list if no speech segment was found.
+    static std::vector<SampleRange> detect_speech(Span<const float> audio,
+                                                  float threshold = 0.015f,
+                                                  int min_speech_ms = 100,
+                                                  int padding_ms = 50,
+                                                  int sample_rate = 16000);
+
+    // Move the given ranges to the front of the buffer, in order, without
+    // allocating. Ranges must be sorted and non-overlapping. Returns the new length.
+    static size_t compact(Span<float> audio, const std::vector<SampleRange>& ranges);
 
     // VAD: Trim silence from start and end of audio
     // Returns trimmed audio (or original if no significant silence found)
@@ -60,12 +114,7 @@ public:
                                              int padding_ms = 50,
                                              int sample_rate = 16000);
 
-    // Calculate short-term energy with smoothing
-    static std::vector<float> calculate_energy(const std::vector<float>& audio,
-                                               int window_size = 160,  // 10ms at 16kHz
-                                               int hop_size = 80);     // 5ms hop
-
-    // Reset filter state (call between recordings)
+    // Reset filter state and stats (call between recordings)
     void reset();
 
     void set_config(const Config& config) { config_ = config; reset(); }
@@ -84,8 +133,17 @@ private:
 
     // Noise gate state
     float gate_env_ = 0.0f;
+    float attack_coef_ = 0.0f;
+    float release_coef_ = 0.0f;
+
+    AudioStats stats_;
 
     void design_highpass_filter();
+    void design_noise_gate();
+
+    // Gain stages shared by finish() and the individual apply_* functions
+    float agc_gain(float rms) const;
+    float normalize(Span<float> audio, float peak) const;
 };
 
 } // namespace whispr
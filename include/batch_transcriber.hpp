@@ -0,0 +1,75 @@
+#pragma once
+
+#include "config.hpp"
+#include "transcriber.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace whispr {
+
+enum class OutputFormat {
+    Text,  // Plain transcript
+    Json,  // Transcript plus timestamped segments
+    Srt    // Subtitles
+};
+
+bool parse_output_format(const std::string& name, OutputFormat& format);
+const char* output_extension(OutputFormat format);
+
+// Headless transcription of recorded files through the same preprocessing,
+// decoding and text processing as dictation. Files are decoded as a stream
+// and cut into chunks at pauses; chunks decode in parallel on one shared model
+// while the next ones are read, and at most a few are in memory at once.
+// WAV is read directly, anything else through ffmpeg.
+class BatchTranscriber {
+public:
+    explicit BatchTranscriber(const Config& config);
+
+    // Audio files in a directory, sorted by name
+    static std::vector<std::string> find_inputs(const std::string& dir);
+
+    // Transcribe every input, writing <name>.<ext> next to it or into
+    // Config::output_dir. Returns the number of files that failed.
+    int run(const std::vector<std::string>& inputs, OutputFormat format);
+
+    // Stop after the chunks already decoding (e.g. from a signal handler)
+    void cancel() { cancelled_.store(true); }
+
+private:
+    struct Segment {
+        int64_t t0_ms;
+        int64_t t1_ms;
+        std::string text;
+    };
+
+    struct FileResult {
+        std::string path;
+        std::string output_path;
+        std::vector<Segment> segments;
+        int64_t duration_ms = 0;
+        bool failed = false;
+        std::string error;
+    };
+
+    // Wait for a decode slot; released when a chunk's result is delivered
+    void acquire_slot();
+    void release_slot();
+
+    bool write_output(const FileResult& file, OutputFormat format, const Transcriber& transcriber) const;
+    std::string output_path_for(const std::string& input, OutputFormat format) const;
+
+    Config config_;
+    std::atomic<bool> cancelled_{false};
+
+    size_t max_in_flight_ = 1;
+    size_t in_flight_ = 0;
+    std::mutex slots_mutex_;
+    std::condition_variable slots_cv_;
+};
+
+} // namespace whispr
@@ -6,7 +6,14 @@ namespace whispr {
 
 class Clipboard {
 public:
-    // Set text to clipboard
+    // Open persistent platform connections (display connection, virtual
+    // keyboard) so copy and paste don't pay setup per use. Optional: without
+    // it the calls fall back to one-off connections and external tools.
+    static bool initialize();
+    static void shutdown();
+
+    // Set text to clipboard. Returns once the new contents are being served,
+    // so paste() can follow immediately.
     static bool set_text(const std::string& text);
 
     // Get text from clipboard
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstdint>
+#include <algorithm>
 
 namespace whispr {
 
@@ -13,6 +14,16 @@ enum class ModelQuality {
     Best        // medium.en - highest accuracy, ~95% accuracy
 };
 
+// Weight precision of the model files. Quantized weights are smaller and,
+// on CPUs with integer SIMD, faster to decode since decoding is mostly
+// memory bound; accuracy drops a little at q5.
+enum class ModelPrecision {
+    Auto,  // Chosen per machine by select_model_precision()
+    F16,   // ggml-<model>.bin
+    Q8,    // ggml-<model>-q8_0.bin, about half the size of f16
+    Q5     // ggml-<model>-q5_1.bin (q5_0 for medium), about a third
+};
+
 // Transcription parameter profiles
 struct TranscriptionProfile {
     int best_of;
@@ -21,20 +32,49 @@ struct TranscriptionProfile {
     float no_speech_thold;
     float temperature;
     const char* name;
+
+    // Short-clip encoder context. Clips up to short_max_ms are encoded with an
+    // audio_ctx covering only the clip plus margin (never below min_audio_ctx)
+    // instead of the full 30s window. short_max_ms = 0 always uses the full window.
+    int short_max_ms;
+    int short_margin_ms;
+    int min_audio_ctx;
+
+    // Per-token timestamps (extra work in every decode; segment times don't
+    // need them). Off in every built-in profile.
+    bool token_timestamps = false;
 };
 
 // Predefined profiles
 // best_of: number of candidates, beam_size: beam search width
 // entropy_thold: skip if entropy > threshold, no_speech_thold: skip if no_speech prob > threshold
-inline const TranscriptionProfile PROFILE_FAST = {1, 1, 2.4f, 0.6f, 0.0f, "Fast"};
-inline const TranscriptionProfile PROFILE_BALANCED = {5, 5, 2.8f, 0.5f, 0.0f, "Balanced"};  // More accurate than before
-inline const TranscriptionProfile PROFILE_ACCURATE = {5, 8, 3.0f, 0.4f, 0.0f, "Accurate"};
-inline const TranscriptionProfile PROFILE_BEST = {5, 10, 3.0f, 0.35f, 0.0f, "Best"};
+// short_*: clip length limit / margin (ms) and encoder frame floor for the short-clip path
+inline const TranscriptionProfile PROFILE_FAST = {1, 1, 2.4f, 0.6f, 0.0f, "Fast", 10000, 1000, 256};
+inline const TranscriptionProfile PROFILE_BALANCED = {5, 5, 2.8f, 0.5f, 0.0f, "Balanced", 10000, 1000, 384};  // More accurate than before
+inline const TranscriptionProfile PROFILE_ACCURATE = {5, 8, 3.0f, 0.4f, 0.0f, "Accurate", 10000, 2000, 512};
+inline const TranscriptionProfile PROFILE_BEST = {5, 10, 3.0f, 0.35f, 0.0f, "Best", 0, 0, 0};
 
 // Optimized profile based on OpenAI recommendations for maximum accuracy
 // Lower no_speech_thold (0.3) = more sensitive to speech
 // Higher beam_size (8) = better search but slower
-inline const TranscriptionProfile PROFILE_OPTIMIZED = {5, 8, 2.4f, 0.3f, 0.0f, "Optimized"};
+// Full encoder window: this is the adaptive retry, so it must not share the fast path's shortcuts
+inline const TranscriptionProfile PROFILE_OPTIMIZED = {5, 8, 2.4f, 0.3f, 0.0f, "Optimized", 0, 0, 0};
+
+// Whisper's encoder produces 1500 frames for 30s of audio (20ms per frame)
+constexpr int WHISPER_FULL_AUDIO_CTX = 1500;
+constexpr int WHISPER_MS_PER_AUDIO_FRAME = 20;
+
+// Encoder context for a clip of duration_ms under profile, or 0 for the full window
+inline int select_audio_ctx(const TranscriptionProfile& profile, int64_t duration_ms) {
+    if (profile.short_max_ms <= 0 || duration_ms > profile.short_max_ms) return 0;
+
+    int64_t frames = (duration_ms + profile.short_margin_ms + WHISPER_MS_PER_AUDIO_FRAME - 1) / WHISPER_MS_PER_AUDIO_FRAME;
+    frames = std::max<int64_t>(frames, profile.min_audio_ctx);
+    frames = (frames + 63) / 64 * 64;  // Round up to a multiple of 64 for friendlier kernel shapes
+    if (frames >= WHISPER_FULL_AUDIO_CTX) return 0;
+
+    return static_cast<int>(frames);
+}
 
 // Get profile for quality level
 inline const TranscriptionProfile& get_profile(ModelQuality quality) {
@@ -58,6 +98,69 @@ inline std::string get_model_filename(ModelQuality quality) {
     }
 }
 
+inline const char* precision_name(ModelPrecision precision) {
+    switch (precision) {
+        case ModelPrecision::Auto: return "auto";
+        case ModelPrecision::F16: return "f16";
+        case ModelPrecision::Q8: return "q8_0";
+        case ModelPrecision::Q5: return "q5";
+        default: return "f16";
+    }
+}
+
+inline bool parse_model_precision(const std::string& name, ModelPrecision& precision) {
+    if (name == "auto") precision = ModelPrecision::Auto;
+    else if (name == "f16") precision = ModelPrecision::F16;
+    else if (name == "q8" || name == "q8_0") precision = ModelPrecision::Q8;
+    else if (name == "q5" || name == "q5_0" || name == "q5_1") precision = ModelPrecision::Q5;
+    else return false;
+    return true;
+}
+
+// Model filename for a quality at a given precision (Auto is treated as f16).
+// These are the names published alongside the f16 models and written by
+// whisper.cpp's quantize tool in scripts/download_models.sh.
+inline std::string get_model_filename(ModelQuality quality, ModelPrecision precision) {
+    std::string name = get_model_filename(quality);
+    const char* suffix = nullptr;
+    switch (precision) {
+        case ModelPrecision::Q8: suffix = "-q8_0"; break;
+        case ModelPrecision::Q5: suffix = quality == ModelQuality::Best ? "-q5_0" : "-q5_1"; break;
+        default: return name;
+    }
+    return name.insert(name.size() - 4, suffix);  // Before ".bin"
+}
+
+// Approximate size of a model file in MB
+inline int model_size_mb(ModelQuality quality, ModelPrecision precision) {
+    static const int F16_MB[] = {75, 142, 466, 1500};
+    static const int Q8_MB[] = {42, 78, 252, 785};
+    static const int Q5_MB[] = {31, 57, 181, 514};
+    const int i = static_cast<int>(quality);
+    switch (precision) {
+        case ModelPrecision::Q8: return Q8_MB[i];
+        case ModelPrecision::Q5: return Q5_MB[i];
+        default: return F16_MB[i];
+    }
+}
+
+// Precision to prefer when the user asked for Auto:
+// - GPU: f16, the precision the GPU kernels are tuned for, with memory to spare.
+// - Less free RAM than twice the f16 file (weights plus decode states and
+//   room for everything else): q5, whatever the CPU.
+// - CPU with SIMD integer dot products (AVX2, AVX-512, NEON): q8 for the
+//   small models where it is as accurate as f16, q5 for medium where it
+//   saves a gigabyte.
+// - Otherwise f16: without SIMD, dequantizing costs more than it saves.
+// available_mb = 0 means unknown.
+inline ModelPrecision select_model_precision(ModelQuality quality, bool gpu, bool simd_int8, uint64_t available_mb) {
+    if (gpu) return ModelPrecision::F16;
+    const uint64_t f16_mb = static_cast<uint64_t>(model_size_mb(quality, ModelPrecision::F16));
+    if (available_mb > 0 && available_mb < 2 * f16_mb) return ModelPrecision::Q5;
+    if (!simd_int8) return ModelPrecision::F16;
+    return quality == ModelQuality::Best ? ModelPrecision::Q5 : ModelPrecision::Q8;
+}
+
 struct Config {
     // Audio settings
     int sample_rate = 16000;        // Whisper expects 16kHz
@@ -67,11 +170,20 @@ struct Config {
     // Whisper model
     std::string model_dir = "models";
     ModelQuality model_quality = ModelQuality::Balanced;  // base.en model
-    int n_threads = 4;              // CPU threads for inference
+    ModelPrecision model_precision = ModelPrecision::Auto;  // Falls back to whichever precision is on disk
+    int n_threads = 0;              // CPU threads for inference (0 = auto: measured per model and profile, on performance cores)
+    int model_cache_size = 2;       // Models kept loaded for instant quality switches
+    bool preload_models = true;     // Load the next likely quality in the background
+    bool warm_up = true;            // Decode silence at startup so the first dictation isn't the slow one
+
+    // Latency instrumentation (stage timings are only collected when one is set)
+    bool latency_report = false;    // Print p50/p95/p99 per pipeline stage on exit
+    std::string trace_path;         // Write a Chrome trace (chrome://tracing, Perfetto) here on exit
 
-    // Get full model path based on quality
+    // Get full model path based on quality (f16 for Auto precision; ModelManager
+    // resolves the file actually loaded)
     std::string get_model_path() const {
-        return model_dir + "/" + get_model_filename(model_quality);
+        return model_dir + "/" + get_model_filename(model_quality, model_precision);
     }
 
     // Hotkey (default: Right Option/Alt key)
@@ -80,12 +192,18 @@ struct Config {
 
     // Behavior
     bool auto_paste = true;
+    bool type_output = false;       // Type into the focused window (clipboard untouched); overrides auto_paste
     bool play_sound = false;
     int max_recording_seconds = 30;
+    int preroll_ms = 0;             // Audio kept from before the key press; > 0 keeps the microphone open while idle
+    int max_queued_jobs = 4;        // Recordings waiting for (or in) transcription before new ones are dropped
+    int parallel_jobs = 1;          // Recordings decoded concurrently (one whisper_state each, shared weights)
 
     // Performance & Accuracy
-    bool use_gpu = true;            // Metal/CUDA acceleration
+    bool use_gpu = true;            // Metal/CUDA/Vulkan acceleration (falls back to CPU)
+    int gpu_device = -1;            // GPU index; -1 = the one with the most free memory
     bool adaptive_quality = true;   // Auto-retry with higher quality if low confidence
+    bool speculative_adaptive = true;  // Run the fast and accurate passes at once, cancel accurate if fast is confident
     bool translate = false;         // Just transcribe, don't translate
     std::string language = "en";    // English
 
@@ -97,6 +215,35 @@ struct Config {
     int min_silence_ms = 100;         // Minimum silence duration to trim
     int vad_padding_ms = 50;          // Padding around speech segments
 
+    // Streaming transcription (decode while the hotkey is still held)
+    bool streaming = false;           // Commit segments during recording, decode only the tail on release
+    int streaming_step_ms = 1000;     // Re-decode interval while recording
+    int streaming_holdback_ms = 1500; // Audio near the live edge that stays uncommitted
+
+    // Long-form dictation (no max_recording_seconds limit; takes precedence over streaming)
+    bool long_form = false;           // Cut recordings at pauses into ~25s chunks decoded while recording
+    int long_form_overlap_ms = 1000;  // Audio from the previous chunk decoded again for context
+
+    // Hands-free dictation (toggled from the tray; push-to-talk otherwise)
+    bool continuous = false;           // Start listening hands-free (--continuous)
+    int continuous_end_silence_ms = 700;  // Pause that ends an utterance and sends it for transcription
+
+    // Dictation history (~/.whispr/history.log; --history, --search)
+    bool history = true;               // Keep every dictation, searchable from the tray and CLI
+    std::string history_path;          // HistoryStore::default_path() when empty
+
+    // Idle footprint (0 disables a stage)
+    int idle_compact_minutes = 5;      // Free decode states and capture buffers; the weights stay loaded
+    int idle_unload_minutes = 30;      // Unload the model too; pressing the hotkey reloads it while you talk
+
+    // Daemon mode (--daemon): serve transcriptions to other tools over a Unix socket
+    bool daemon = false;               // Hotkey and microphone become optional
+    std::string socket_path;           // IpcServer::default_socket_path() when empty
+
+    // Batch mode (--input / --batch): transcribe files instead of listening for the hotkey
+    std::string output_dir;            // Transcripts go next to each input when empty
+    std::string output_format = "txt"; // txt, json or srt
+
     // Initial prompt for context (helps accuracy and vocabulary recognition)
     // Add proper nouns and technical terms you commonly use
     std::string initial_prompt = "The following is a clear transcription of speech. "
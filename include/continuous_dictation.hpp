@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ring_buffer.hpp"
+#include "speech_chunker.hpp"
+#include "span.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace whispr {
+
+struct ContinuousConfig {
+    int sample_rate = 16000;
+    int end_silence_ms = 700;         // Pause that ends an utterance
+    int max_utterance_ms = 28000;     // Cut at the quietest moment by here (whisper decodes 30s windows)
+    int min_speech_ms = 250;          // Less speech than this (a cough, a click) is not an utterance
+    float silence_threshold = 0.01f;  // Frame RMS below this is silence
+    int intake_seconds = 10;          // Capture intake capacity: audio arriving while an utterance is cut
+};
+
+// Hands-free dictation: capture never stops, and an utterance ends when the
+// speaker pauses for end_silence_ms. Each utterance is handed on as soon as its
+// end is found, so it can be transcribed while the next one is still being
+// spoken. Cutting uses the same pause detection as long-form chunks; the half
+// of the pause before the cut ends the utterance, the rest leads the next one.
+class ContinuousDictation {
+public:
+    // Called on the dictation thread (or in end()) with each utterance, in
+    // order. Hand the buffer back with recycle() once done with it.
+    using UtteranceCallback = std::function<void(AudioChunk&& utterance)>;
+
+    ContinuousDictation(const ContinuousConfig& config, UtteranceCallback on_utterance);
+    ~ContinuousDictation();
+
+    ContinuousDictation(const ContinuousDictation&) = delete;
+    ContinuousDictation& operator=(const ContinuousDictation&) = delete;
+
+    // Start listening; sample offsets count from here
+    void begin();
+
+    // Append captured samples. Lock-free and allocation-free: safe to call
+    // from the real-time audio callback.
+    void feed(Span<const float> samples);
+
+    // Stop listening. Speech still in progress is handed on as a last
+    // utterance before this returns. Stop feeding first.
+    void end();
+
+    bool is_active() const { return active_.load(); }
+
+    // Return an utterance's buffer for reuse. Thread-safe.
+    void recycle(std::vector<float>&& buffer) { chunker_.recycle(std::move(buffer)); }
+
+    uint64_t utterances() const { return utterances_.load(); }
+    uint64_t dropped_samples() const { return dropped_samples_.load(); }
+
+private:
+    void listen_loop();
+    // Move everything the audio callback produced into the chunker (dictation thread)
+    void drain_intake();
+    void on_chunk(AudioChunk&& chunk);
+
+    ContinuousConfig config_;
+    UtteranceCallback on_utterance_;
+
+    // Written by the audio callback, drained by the dictation thread
+    SpscRingBuffer<float> intake_;
+    std::vector<float> drain_scratch_;
+    std::atomic<uint64_t> dropped_samples_{0};
+
+    // Owned by the dictation thread while active, by end() afterwards
+    SpeechChunker chunker_;
+
+    // Used only to wake the dictation thread for end() (never from the audio callback)
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    std::thread listen_thread_;
+    std::atomic<bool> active_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> utterances_{0};
+};
+
+} // namespace whispr
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace whispr {
+
+// SIMD extensions ggml's quantized kernels use
+struct CpuFeatures {
+    bool avx2 = false;
+    bool avx512 = false;
+    bool neon = false;
+
+    // Fast integer dot products, where quantized weights beat f16
+    bool fast_int8() const { return avx2 || avx512 || neon; }
+};
+
+CpuFeatures cpu_features();
+
+// Memory that can be allocated without swapping, in MB (0 if unknown)
+uint64_t available_memory_mb();
+
+// Resident set size of this process in bytes (0 if unknown)
+uint64_t resident_memory_bytes();
+
+// Give memory the allocator keeps cached after frees back to the system
+void release_free_memory();
+
+// Logical CPUs of the fastest class available to this process: the P-cores of
+// a hybrid CPU, or every CPU where all are alike
+int performance_core_count();
+
+// Every logical CPU available to this process
+int available_cpu_count();
+
+// Run the calling thread, and threads it creates afterwards, on performance
+// cores (affinity on Linux, QoS class on macOS). Returns false if the
+// platform refused.
+bool pin_to_performance_cores();
+
+} // namespace whispr
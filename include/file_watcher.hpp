@@ -0,0 +1,28 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace whispr {
+
+// Watches one file for edits. The parent directory is watched, so the file may
+// not exist yet and editors that save by writing a new file and renaming it over
+// the old one are seen too. Bursts of changes are coalesced into one callback,
+// which runs on the watcher's own thread.
+class FileWatcher {
+public:
+    using Callback = std::function<void()>;
+
+    FileWatcher();
+    ~FileWatcher();
+
+    bool start(const std::string& path, Callback callback);
+    void stop();
+    bool is_running() const { return platform_handle_ != nullptr; }
+
+private:
+    // Platform-specific state
+    void* platform_handle_ = nullptr;
+};
+
+} // namespace whispr
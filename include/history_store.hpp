@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace whispr {
+
+// How long the stages of one dictation took
+struct HistoryTimings {
+    uint32_t audio_ms = 0;        // Recording length
+    uint32_t decode_ms = 0;       // Transcription, preprocessing to text
+    uint32_t key_to_text_ms = 0;  // Hotkey release -> text out
+};
+
+struct HistoryEntry {
+    uint64_t id = 0;              // 1 for the oldest entry; assigned by append()
+    int64_t time_ms = 0;          // Unix time; append() fills in now when 0
+    std::string text;             // As output
+    std::string raw_text;         // As whisper produced it
+    float confidence = 0.0f;
+    HistoryTimings timings;
+};
+
+// A few entries for a menu: previews only, so its size doesn't depend on
+// how long anyone dictated. Full text comes from HistoryStore::get().
+struct HistorySnapshot {
+    struct Item {
+        uint64_t id;
+        int64_t time_ms;
+        float confidence;
+        std::string preview;
+    };
+
+    std::vector<Item> items;   // Newest first
+    size_t matches = 0;        // Entries that qualified, listed or not
+    std::string query;         // Empty for the most recent entries
+};
+
+// Every dictation, kept on disk in an append-only log that is memory-mapped,
+// so an append is a copy into the mapping and nothing is rewritten. Records
+// carry a checksum; a torn record at the end (crash mid-append) is dropped on
+// open. Search goes through an inverted index of the words in each entry,
+// built when the log is opened and extended by every append. Only record
+// offsets and the index are held in memory; texts are read from the mapping.
+// Thread-safe.
+class HistoryStore {
+public:
+    HistoryStore() = default;
+    ~HistoryStore();
+
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    // Open (creating it unless read_only) and index the log. One writer at a
+    // time: a second one fails while the first has it open.
+    bool open(const std::string& path, bool read_only = false);
+    void close();
+    bool is_open() const;
+    const std::string& error() const { return error_; }
+
+    // Assigns entry.id (and time_ms when 0)
+    bool append(HistoryEntry& entry);
+
+    bool get(uint64_t id, HistoryEntry& entry) const;
+    size_t size() const;
+
+    // Ids of entries containing every word of the query, newest first. The
+    // last word also matches as a prefix (unless the query ends in a space),
+    // so results follow along while a query is typed. Case-insensitive, and
+    // punctuation is ignored.
+    std::vector<uint64_t> search(const std::string& query, size_t limit) const;
+
+    // The newest `count` entries, or the newest matching `query`
+    HistorySnapshot snapshot(size_t count, size_t preview_chars, const std::string& query = "") const;
+
+    // ~/.whispr/history.log
+    static std::string default_path();
+
+    // First `max_chars` characters (UTF-8) of text on one line, "..." if cut
+    static std::string preview(const std::string& text, size_t max_chars);
+
+    // Lowercase words of text as indexed: ASCII letters and digits plus any
+    // non-ASCII bytes, apostrophes dropped ("Don't" -> "dont")
+    static std::vector<std::string> words(const std::string& text);
+
+private:
+    bool map_file(size_t bytes);
+    bool read_locked(size_t index, HistoryEntry& entry) const;
+    void index_locked(uint32_t index, const std::string& text, const std::string& raw_text);
+    std::vector<uint64_t> search_locked(const std::string& query, size_t limit, size_t* matches) const;
+
+    int fd_ = -1;
+    bool read_only_ = false;
+    uint8_t* data_ = nullptr;       // Mapping of the whole file
+    size_t mapped_ = 0;
+    size_t used_ = 0;               // Header and valid records
+    std::string error_;
+
+    std::vector<uint64_t> offsets_;                      // Record offset per entry, oldest first
+    std::map<std::string, std::vector<uint32_t>> index_; // Word -> entries containing it, ascending
+
+    mutable std::mutex mutex_;
+};
+
+} // namespace whispr
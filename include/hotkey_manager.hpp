@@ -3,13 +3,17 @@
 #include <functional>
 #include <atomic>
 #include <thread>
+#include <chrono>
 #include <cstdint>
 
 namespace whispr {
 
 class HotkeyManager {
 public:
-    using HotkeyCallback = std::function<void(bool pressed)>;
+    using Clock = std::chrono::steady_clock;
+    // `when` is the time the key actually went down/up (from the OS event where
+    // available), so latency can be measured from the keystroke itself
+    using HotkeyCallback = std::function<void(bool pressed, Clock::time_point when)>;
 
     HotkeyManager();
     ~HotkeyManager();
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "span.hpp"
+#include "transcriber.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace whispr {
+
+// Local API of a running voxtype (--daemon), so editor plugins and scripts
+// share its loaded, warmed-up model instead of starting their own.
+//
+// Unix-domain stream socket, one request line at a time per connection:
+//   STATUS
+//   TRANSCRIBE <samples> [partial]
+//       16 kHz mono float32 samples in a memfd passed with the request as
+//       SCM_RIGHTS and sealed with at least F_SEAL_SHRINK; nothing is copied
+//       through the socket and the daemon maps the client's pages directly
+//       (Linux only: elsewhere shared memory can't be sealed, use inline)
+//   TRANSCRIBE <samples> inline [partial]
+//       the same, with samples * 4 bytes following the line (for clients
+//       that can't pass file descriptors)
+// Replies are one JSON object per line:
+//   {"type":"status", ...}
+//   {"type":"partial","text":"..."}   with `partial`, after each pause-cut chunk (20-30s)
+//   {"type":"result","text":"...","raw_text":"...","confidence":0.9,"duration_ms":120,"segments":[...]}
+//   {"type":"error","error":"..."}
+// A TRANSCRIBE always ends with exactly one result or error line.
+
+// Audio handed over by a client, mapped copy-on-write from its sealed memfd
+// (so preprocessing in place never touches the client's pages) or owned
+class SharedAudio {
+public:
+    static std::shared_ptr<SharedAudio> map(int fd, size_t samples, std::string& error);
+    static std::shared_ptr<SharedAudio> own(std::vector<float>&& samples);
+    ~SharedAudio();
+
+    SharedAudio(const SharedAudio&) = delete;
+    SharedAudio& operator=(const SharedAudio&) = delete;
+
+    Span<float> samples() { return Span<float>(data_, size_); }
+
+private:
+    SharedAudio() = default;
+
+    float* data_ = nullptr;
+    size_t size_ = 0;
+    void* mapping_ = nullptr;
+    size_t mapping_bytes_ = 0;
+    std::vector<float> owned_;
+};
+
+class IpcServer {
+public:
+    // Send one reply line; `final` marks the last line of a request. Safe to
+    // call from any thread. Returns false once the client has gone away.
+    using Reply = std::function<bool(const std::string& json, bool final)>;
+
+    struct Handlers {
+        // Queue a transcription and reply (possibly later, from another thread)
+        // with partial lines if asked for, then one final result or error
+        std::function<void(std::shared_ptr<SharedAudio> audio, bool partials, Reply reply)> transcribe;
+        // Fields of the status reply, as the inside of a JSON object
+        std::function<std::string()> status;
+    };
+
+    explicit IpcServer(Handlers handlers);
+    ~IpcServer();
+
+    IpcServer(const IpcServer&) = delete;
+    IpcServer& operator=(const IpcServer&) = delete;
+
+    // Listen on `path` (owner-only permissions). A stale socket left by a
+    // crashed daemon is replaced; a live one is an error.
+    bool start(const std::string& path);
+    // Stop accepting, disconnect clients and join their threads
+    void stop();
+
+    const std::string& path() const { return path_; }
+    uint64_t requests() const { return requests_.load(); }
+
+    // $XDG_RUNTIME_DIR/voxtype.sock, or ~/.whispr/voxtype.sock
+    static std::string default_socket_path();
+
+    // Reply lines
+    static std::string quote(const std::string& text);
+    static std::string partial_json(const std::string& text);
+    static std::string result_json(const TranscriptionResult& result);
+    static std::string error_json(const std::string& error);
+
+private:
+    struct Connection;
+
+    void accept_loop();
+    void serve(std::shared_ptr<Connection> connection);
+
+    Handlers handlers_;
+    std::string path_;
+    int listen_fd_ = -1;
+    int wake_pipe_[2] = {-1, -1};  // Written by stop() to interrupt poll()
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> requests_{0};
+    std::thread accept_thread_;
+
+    std::mutex connections_mutex_;
+    std::vector<std::shared_ptr<Connection>> connections_;
+    std::vector<std::thread> client_threads_;
+};
+
+// Client side of the same protocol (voxtype --send)
+class IpcClient {
+public:
+    IpcClient() = default;
+    ~IpcClient();
+
+    IpcClient(const IpcClient&) = delete;
+    IpcClient& operator=(const IpcClient&) = delete;
+
+    bool connect(const std::string& path);
+    const std::string& error() const { return error_; }
+
+    // Hand audio over through shared memory. on_line receives every reply
+    // line, partials included; returns false on error (the error line is
+    // still delivered if the daemon sent one).
+    bool transcribe(Span<const float> samples, bool partials,
+                    const std::function<void(const std::string& line)>& on_line);
+    bool status(std::string& line);
+
+private:
+    bool read_line(std::string& line);
+
+    int fd_ = -1;
+    std::string buffer_;
+    std::string error_;
+};
+
+} // namespace whispr
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+namespace whispr {
+
+// One synthesized key transition (keycode in the backend's numbering)
+struct KeyEvent {
+    unsigned code;
+    bool press;
+
+    bool operator==(const KeyEvent& other) const { return code == other.code && press == other.press; }
+};
+
+// Events that tap `code` (with `shift_code` around it if `shift`) while the
+// user physically holds the modifier keys in `held`, e.g. the Right Alt
+// hotkey during streaming. Synthesized keys combine with held ones, so the
+// held modifiers are released for the tap and pressed again afterwards: the
+// character comes out as itself, not as an Alt shortcut or AltGr symbol.
+inline std::vector<KeyEvent> tap_events(unsigned code, bool shift, unsigned shift_code,
+                                        const std::vector<unsigned>& held) {
+    std::vector<KeyEvent> events;
+    events.reserve(held.size() * 2 + 4);
+
+    // A held Shift already gives the shifted level; only an unshifted key needs it released
+    const bool shift_held = std::find(held.begin(), held.end(), shift_code) != held.end();
+    for (unsigned key : held) {
+        if (!(shift && key == shift_code)) events.push_back({key, false});
+    }
+    if (shift && !shift_held) events.push_back({shift_code, true});
+    events.push_back({code, true});
+    events.push_back({code, false});
+    if (shift && !shift_held) events.push_back({shift_code, false});
+    for (auto it = held.rbegin(); it != held.rend(); ++it) {
+        if (!(shift && *it == shift_code)) events.push_back({*it, true});
+    }
+    return events;
+}
+
+} // namespace whispr
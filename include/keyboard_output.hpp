@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace whispr {
+
+// Types text into the focused window by synthesizing key events, so results
+// can be inserted without touching the user's clipboard
+class KeyboardOutput {
+public:
+    // Open the platform connection (X display / virtual keyboard). Done once
+    // at startup: a freshly created virtual keyboard isn't usable right away.
+    static bool initialize();
+    static void shutdown();
+
+    // Type UTF-8 text. Fails without typing anything if some character can't
+    // be produced by the backend (e.g. non-ASCII through a virtual keyboard).
+    static bool type_text(const std::string& text);
+
+    // Press Backspace `count` times
+    static bool erase(size_t count);
+
+    // Whether typed text comes out unchanged while the user holds a modifier
+    // (the hotkey). If not, typing has to wait for the key's release.
+    static bool ignores_held_keys();
+};
+
+} // namespace whispr
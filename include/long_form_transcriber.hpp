@@ -0,0 +1,108 @@
+#pragma once
+
+#include "transcriber.hpp"
+#include "audio_processor.hpp"
+#include "ring_buffer.hpp"
+#include "speech_chunker.hpp"
+#include "span.hpp"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+namespace whispr {
+
+struct LongFormConfig {
+    int sample_rate = 16000;
+    int chunk_ms = 24000;            // Look for a pause to cut at after this much audio
+    int max_chunk_ms = 28000;        // Cut by here; with the overlap a window stays under whisper's 30s
+    int overlap_ms = 1000;           // End of the previous chunk decoded again in front of the next
+    int min_pause_ms = 300;          // Silence long enough to cut in
+    float silence_threshold = 0.01f; // Frame RMS below this is silence
+    int intake_seconds = 30;         // Capture intake capacity: audio arriving while a chunk decodes
+};
+
+// Dictation of any length. Captured audio is cut into chunks at pauses as it
+// arrives and each chunk is decoded in the background while recording
+// continues, with the end of the previous chunk in front of it and the text
+// so far as the prompt. Chunk transcripts are stitched without the words the
+// overlap repeats. Memory stays at a couple of chunks however long the
+// recording runs, and finish() only has to decode the last one.
+class LongFormTranscriber {
+public:
+    // Receives all stitched raw text so far (trimmed) after each chunk
+    using CommitCallback = std::function<void(const std::string& committed_text)>;
+
+    LongFormTranscriber(Transcriber& transcriber, const LongFormConfig& config = {});
+    ~LongFormTranscriber();
+
+    // Start a new session (clears previous audio and text)
+    void begin();
+
+    // Append captured samples. Lock-free and allocation-free: safe to call
+    // from the real-time audio callback.
+    void feed(Span<const float> samples);
+
+    // Stop background decoding, decode the remaining chunks and return the full result
+    TranscriptionResult finish();
+
+    bool is_active() const { return active_.load(); }
+
+    // Optional gain stages (AGC + normalization) applied to each chunk.
+    // Fed samples are expected to be filtered already by the capture processor.
+    void set_audio_processor(std::unique_ptr<AudioProcessor> processor) { processor_ = std::move(processor); }
+
+    // Called on the decode thread while recording; never after finish() starts.
+    // Set before begin().
+    void set_commit_callback(CommitCallback callback) { commit_callback_ = std::move(callback); }
+
+private:
+    void decode_loop();
+
+    // Move everything the audio callback produced into the chunker (decode thread)
+    void drain_intake();
+
+    // Decode one chunk, append its text and recycle its buffer. False if it failed.
+    bool decode_chunk(AudioChunk& chunk);
+
+    std::string trimmed_text() const;
+
+    Transcriber& transcriber_;
+    LongFormConfig config_;
+    std::unique_ptr<AudioProcessor> processor_;
+    CommitCallback commit_callback_;
+
+    // Written by the audio callback, drained by the decode thread
+    SpscRingBuffer<float> intake_;
+    std::atomic<uint64_t> dropped_samples_{0};
+
+    // Used only to wake the decode thread for shutdown (never from the audio callback)
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    // Owned by the decode thread while active, by finish() afterwards
+    SpeechChunker chunker_;
+    std::deque<AudioChunk> pending_;     // Cut but not decoded yet, oldest first
+    std::vector<float> drain_scratch_;   // Intake is drained through this into the chunker
+    std::vector<float> overlap_;         // End of the last decoded chunk
+    std::vector<float> window_;          // Overlap + chunk, preprocessed for decoding
+    std::string text_;                   // Stitched raw text
+    std::vector<TranscriptionSegment> segments_;  // Timed against the whole recording
+    double confidence_sum_ = 0.0;        // Confidence weighted by decoded samples
+    size_t confidence_weight_ = 0;
+    size_t chunks_decoded_ = 0;
+    std::string error_;
+
+    std::thread decode_thread_;
+    std::atomic<bool> active_{false};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace whispr
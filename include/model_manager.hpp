@@ -0,0 +1,168 @@
+#pragma once
+
+#include "config.hpp"
+#include "state_pool.hpp"
+#include "cpu_topology.hpp"
+
+#include <string>
+#include <memory>
+#include <list>
+#include <deque>
+#include <set>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstdint>
+
+// Forward declare whisper types
+struct whisper_context;
+
+namespace whispr {
+
+// A GPU the ggml backends in this build can run whisper on
+struct GpuDevice {
+    int index;             // Position among GPUs (whisper_context_params::gpu_device)
+    std::string name;
+    std::string description;
+    size_t free_bytes;
+    size_t total_bytes;
+};
+
+// Empty when whisper.cpp was built without a GPU backend (Metal, CUDA, Vulkan)
+std::vector<GpuDevice> list_gpu_devices();
+
+// One loaded ggml model: the weights plus the pool of decode states that use
+// them. Shared by pointer, so a model that is switched away from or evicted
+// stays alive until the last in-flight decode is done with it.
+class WhisperModel {
+public:
+    // Load weights through a memory mapping of the model file (falls back to
+    // whisper's own file reader if mapping fails). With use_gpu, runs on GPU
+    // `gpu_device` with flash attention, and retries on the CPU if that fails.
+    static std::shared_ptr<WhisperModel> load(const std::string& path, size_t max_states, bool use_gpu,
+                                              int gpu_device = 0);
+
+    ~WhisperModel();
+
+    WhisperModel(const WhisperModel&) = delete;
+    WhisperModel& operator=(const WhisperModel&) = delete;
+
+    whisper_context* context() const { return ctx_; }
+    StatePool& states() { return states_; }
+    const std::string& path() const { return path_; }
+    int64_t load_ms() const { return load_ms_; }
+    uint64_t file_bytes() const { return file_bytes_; }
+    // Resident memory the load added (weights on the CPU plus decode states).
+    // Approximate: other threads allocating at the same time count too.
+    uint64_t memory_bytes() const { return memory_bytes_; }
+    bool on_gpu() const { return on_gpu_; }
+
+private:
+    WhisperModel() = default;
+
+    whisper_context* ctx_ = nullptr;
+    StatePool states_;
+    std::string path_;
+    int64_t load_ms_ = 0;
+    uint64_t file_bytes_ = 0;
+    uint64_t memory_bytes_ = 0;
+    bool on_gpu_ = false;
+};
+
+// Keeps up to `capacity` models loaded (least recently used is evicted) and
+// loads requested models on a background thread, so quality switches from the
+// tray never block the UI and switching back to a recent model is instant.
+// Each quality is loaded at one precision: the configured one, or for Auto
+// the one select_model_precision() picks for this machine, falling back to
+// whichever file of that quality is on disk.
+class ModelManager {
+public:
+    using ReadyCallback = std::function<void(std::shared_ptr<WhisperModel>)>;
+
+    // gpu_device < 0 picks the GPU with the most free memory
+    ModelManager(const std::string& model_dir, size_t capacity = 2, size_t max_states = 1, bool use_gpu = true,
+                 int gpu_device = -1, ModelPrecision precision = ModelPrecision::Auto);
+    ~ModelManager();
+
+    // Loaded model for a quality, loading it on the calling thread if needed.
+    // Returns nullptr if the model can't be loaded.
+    std::shared_ptr<WhisperModel> get(ModelQuality quality);
+
+    // Deliver the model on the loader thread (or immediately if already loaded)
+    void request(ModelQuality quality, ReadyCallback on_ready);
+
+    // Load in the background without using it yet
+    void preload(ModelQuality quality);
+
+    // Preload the quality a user is most likely to switch to from `current`
+    void preload_neighbor(ModelQuality current);
+
+    // Like request(), but always on the loader thread and with a decode state
+    // allocated before on_ready, so the first decode after an idle period pays
+    // for neither. Readahead of an unloaded model's file starts right away.
+    void wake(ModelQuality quality, ReadyCallback on_ready);
+
+    // Idle compaction: free the decode states no decode is using in every
+    // loaded model; the weights stay. Returns how many were freed.
+    size_t trim_states();
+
+    // Idle unload: drop every model from the cache (memory is freed once
+    // in-flight decodes let go). Their files stay open and mapped, but
+    // untouched, so they cost no resident memory and wake() can start
+    // paging them in before the loader thread gets to them.
+    void unload_all();
+
+    size_t loaded_count() const;
+
+    bool is_loaded(ModelQuality quality) const;
+    std::string path_for(ModelQuality quality) const;
+    ModelPrecision precision_for(ModelQuality quality) const;
+
+private:
+    struct Entry {
+        ModelQuality quality;
+        std::shared_ptr<WhisperModel> model;
+    };
+
+    struct LoadRequest {
+        ModelQuality quality;
+        ReadyCallback on_ready;
+        bool warm_state = false;  // Allocate a decode state before on_ready
+    };
+
+    struct ParkedFile;  // Mapping of an unloaded model's file
+
+    // Cache lookup; moves a hit to the front. Caller holds mutex_.
+    std::shared_ptr<WhisperModel> find_locked(ModelQuality quality);
+    void insert_locked(ModelQuality quality, std::shared_ptr<WhisperModel> model);
+
+    // Load outside the lock; concurrent requests for the same model wait for one load
+    std::shared_ptr<WhisperModel> load_shared(ModelQuality quality);
+
+    void loader_loop();
+
+    std::string model_dir_;
+    size_t capacity_;
+    size_t max_states_;
+    bool use_gpu_;         // Cleared once a GPU load fails, so later loads go straight to the CPU (guarded by mutex_)
+    int gpu_device_ = 0;
+    ModelPrecision precision_;
+    bool prefer_gpu_precision_ = false;  // A GPU was found at startup
+    CpuFeatures cpu_;
+    uint64_t available_mb_ = 0;          // At startup
+
+    std::list<Entry> lru_;        // Most recently used first
+    std::vector<std::shared_ptr<ParkedFile>> parked_;  // Unloaded while idle, not loaded again yet
+    std::set<int> loading_;       // Qualities currently being loaded
+    mutable std::mutex mutex_;
+    std::condition_variable loaded_cv_;
+
+    std::deque<LoadRequest> requests_;
+    std::condition_variable requests_cv_;
+    bool stopping_ = false;
+    std::thread loader_thread_;
+};
+
+} // namespace whispr
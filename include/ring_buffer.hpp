@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+namespace whispr {
+
+// Lock-free single-producer/single-consumer ring buffer for trivially copyable
+// elements. Storage is allocated once up front; write() and read() never
+// allocate or block, so the producer side is safe to use on a real-time thread.
+template <typename T>
+class SpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRingBuffer requires trivially copyable T");
+
+public:
+    SpscRingBuffer() = default;
+    explicit SpscRingBuffer(size_t capacity) { allocate(capacity); }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // (Re)allocate storage. Not thread-safe: only call while neither side is active.
+    void allocate(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;  // Power of two so indices wrap with a mask
+        storage_.reset(new T[size]);
+        mask_ = size - 1;
+        capacity_ = capacity;
+        reset();
+    }
+
+    // Drop all contents. Not thread-safe: only call while neither side is active.
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Producer: copy up to count elements in, returns number written
+    size_t write(const T* data, size_t count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t n = std::min(count, capacity_ - (head - tail));
+        if (n == 0) return 0;
+
+        const size_t start = head & mask_;
+        const size_t first = std::min(n, mask_ + 1 - start);
+        std::memcpy(storage_.get() + start, data, first * sizeof(T));
+        std::memcpy(storage_.get(), data + first, (n - first) * sizeof(T));
+
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer: copy up to count elements out, returns number read
+    size_t read(T* out, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t n = std::min(count, head - tail);
+        if (n == 0) return 0;
+
+        const size_t start = tail & mask_;
+        const size_t first = std::min(n, mask_ + 1 - start);
+        std::memcpy(out, storage_.get() + start, first * sizeof(T));
+        std::memcpy(out + first, storage_.get(), (n - first) * sizeof(T));
+
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer: elements ready to read
+    size_t read_available() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+
+    // Producer: free space
+    size_t write_available() const {
+        return capacity_ - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+    }
+
+private:
+    std::unique_ptr<T[]> storage_;
+    size_t mask_ = 0;
+    size_t capacity_ = 0;
+
+    // Monotonic indices on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> head_{0};  // Written by producer
+    alignas(64) std::atomic<size_t> tail_{0};  // Written by consumer
+};
+
+} // namespace whispr
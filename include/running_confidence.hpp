@@ -0,0 +1,56 @@
+#pragma once
+
+namespace whispr {
+
+// Mean token probability of a decode, accumulated while it runs rather than
+// in a second pass over the finished result. Tokens of finished segments are
+// committed once, as whisper reports each segment; the sequence still being
+// decoded counts provisionally and is replaced on every update, so a
+// temperature fallback that restarts it is never counted twice.
+// Not thread-safe: fed from the decoding thread's callbacks.
+class RunningConfidence {
+public:
+    // A token of a finished segment; special tokens (p <= 0) are skipped
+    void commit(int id, float p) {
+        if (id < 0 || p <= 0.0f) return;
+        committed_sum_ += p;
+        ++committed_tokens_;
+    }
+
+    // The finished segments replace the sequence they were decoded from
+    void end_segments() {
+        pending_sum_ = 0.0f;
+        pending_tokens_ = 0;
+    }
+
+    // Probabilities of the tokens decoded so far in the current sequence
+    void set_pending(float sum, int tokens) {
+        pending_sum_ = sum;
+        pending_tokens_ = tokens;
+    }
+
+    // Everything so far, the current sequence included
+    float value() const {
+        const int n = tokens();
+        return n > 0 ? (committed_sum_ + pending_sum_) / static_cast<float>(n) : 0.0f;
+    }
+    int tokens() const { return committed_tokens_ + pending_tokens_; }
+
+    // Finished segments only: the confidence of the final result
+    float committed() const {
+        return committed_tokens_ > 0 ? committed_sum_ / static_cast<float>(committed_tokens_) : 0.0f;
+    }
+
+    // Enough tokens to tell, and still below `floor`
+    bool below(float floor, int min_tokens) const {
+        return tokens() >= min_tokens && value() < floor;
+    }
+
+private:
+    float committed_sum_ = 0.0f;
+    int committed_tokens_ = 0;
+    float pending_sum_ = 0.0f;
+    int pending_tokens_ = 0;
+};
+
+} // namespace whispr
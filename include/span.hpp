@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+namespace whispr {
+
+// Minimal non-owning view over contiguous memory (std::span is C++20)
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    constexpr Span() noexcept = default;
+    constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+    constexpr Span(T* first, T* last) noexcept : data_(first), size_(static_cast<size_t>(last - first)) {}
+
+    // Views over vectors (const views bind to const and non-const vectors)
+    template <typename U, typename A,
+              typename = std::enable_if_t<std::is_convertible<U(*)[], T(*)[]>::value>>
+    Span(std::vector<U, A>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+    template <typename U, typename A,
+              typename = std::enable_if_t<std::is_convertible<const U(*)[], T(*)[]>::value>>
+    Span(const std::vector<U, A>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+    // Span<float> -> Span<const float>
+    template <typename U,
+              typename = std::enable_if_t<std::is_convertible<U(*)[], T(*)[]>::value>>
+    constexpr Span(const Span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+
+    constexpr T& operator[](size_t i) const noexcept { return data_[i]; }
+    constexpr T& front() const noexcept { return data_[0]; }
+    constexpr T& back() const noexcept { return data_[size_ - 1]; }
+
+    constexpr Span subspan(size_t offset, size_t count) const noexcept {
+        return Span(data_ + offset, count);
+    }
+    constexpr Span first(size_t count) const noexcept { return Span(data_, count); }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace whispr
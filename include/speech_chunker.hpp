@@ -0,0 +1,71 @@
+#pragma once
+
+#include "span.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace whispr {
+
+struct ChunkerConfig {
+    int sample_rate = 16000;
+    int target_ms = 20000;     // Start looking for a pause once a chunk is this long
+    int max_ms = 29000;        // Cut by here regardless (whisper decodes 30s windows)
+    int min_pause_ms = 300;    // Silence long enough to cut in
+    int min_speech_ms = 100;   // Less speech than this and a chunk is silence
+    float threshold = 0.01f;   // Frame RMS below this is silence
+};
+
+// A piece of a longer stream, cut in a pause where possible
+struct AudioChunk {
+    std::vector<float> samples;
+    int64_t start_sample = 0;  // Offset of samples[0] in the whole stream
+    bool has_speech = false;
+};
+
+// Splits an unbounded stream into whisper-sized chunks on the fly: after
+// target_ms the next pause of min_pause_ms is cut in its middle, and a chunk
+// that reaches max_ms without one is cut at its quietest 10ms frame in the
+// second half. Only the chunk being built is held; emitted buffers can be
+// handed back with recycle() so a long stream reuses the same few.
+class SpeechChunker {
+public:
+    using ChunkCallback = std::function<void(AudioChunk&& chunk)>;
+
+    SpeechChunker(const ChunkerConfig& config, ChunkCallback on_chunk);
+
+    // Append samples; may emit one or more chunks
+    void feed(Span<const float> samples);
+    // Emit whatever is left (end of stream) and start over at sample 0
+    void finish();
+
+    // Return an emitted chunk's buffer for reuse. Thread-safe.
+    void recycle(std::vector<float>&& buffer);
+
+private:
+    void push_frame(float rms);
+    void cut(size_t frames);
+    std::vector<float> take_buffer();
+
+    ChunkerConfig config_;
+    ChunkCallback on_chunk_;
+    size_t frame_;          // Samples per 10ms frame
+    size_t target_frames_;
+    size_t max_frames_;
+    size_t pause_frames_;
+    size_t speech_frames_;
+
+    std::vector<float> buffer_;     // Chunk being built
+    std::vector<float> frame_rms_;  // One per complete frame of buffer_
+    int64_t start_sample_ = 0;
+    size_t silent_run_ = 0;         // Trailing silent frames
+    float partial_sum_ = 0.0f;      // Squares of the incomplete frame
+    size_t partial_count_ = 0;
+
+    std::mutex pool_mutex_;
+    std::vector<std::vector<float>> pool_;
+};
+
+} // namespace whispr
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+// Forward declare whisper types
+struct whisper_context;
+struct whisper_state;
+
+namespace whispr {
+
+// Pool of whisper decode states sharing one loaded model. Each state carries
+// its own KV cache and compute buffers, so concurrent decodes only need one
+// state each; the weights stay in memory once. States are created lazily up
+// to the configured limit and reused afterwards.
+class StatePool {
+public:
+    // Exclusive use of one state; returned to the pool on destruction
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept : pool_(other.pool_), state_(other.state_) {
+            other.pool_ = nullptr;
+            other.state_ = nullptr;
+        }
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { release(); }
+
+        whisper_state* get() const { return state_; }
+        explicit operator bool() const { return state_ != nullptr; }
+
+        void release();
+
+    private:
+        friend class StatePool;
+        Lease(StatePool* pool, whisper_state* state) : pool_(pool), state_(state) {}
+
+        StatePool* pool_ = nullptr;
+        whisper_state* state_ = nullptr;
+    };
+
+    StatePool() = default;
+    ~StatePool();
+
+    StatePool(const StatePool&) = delete;
+    StatePool& operator=(const StatePool&) = delete;
+
+    // Attach to a model and create the first state (so allocation failures
+    // surface at startup rather than on the first job)
+    bool initialize(whisper_context* ctx, size_t max_states);
+
+    // Change the limit; existing states are kept
+    void set_max_states(size_t max_states);
+
+    // Wait for a free state, creating one if below the limit. Returns an empty
+    // lease if the pool was shut down or a new state couldn't be allocated.
+    Lease acquire();
+
+    // Wait for all leases to come back, then free every state
+    void shutdown();
+
+    // Free the states nobody is using (KV caches and compute buffers); later
+    // acquires create them again. Returns how many were freed.
+    size_t trim();
+
+    size_t max_states() const;
+    size_t created() const;
+
+private:
+    void give_back(whisper_state* state);
+
+    whisper_context* ctx_ = nullptr;
+    size_t max_states_ = 1;
+
+    std::vector<whisper_state*> all_;   // Every state created (owned)
+    std::vector<whisper_state*> free_;  // States not currently leased
+    size_t creating_ = 0;               // Allocations in progress outside the lock
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool closed_ = true;
+};
+
+} // namespace whispr
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "transcriber.hpp"
+#include "audio_processor.hpp"
+#include "ring_buffer.hpp"
+#include "span.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+namespace whispr {
+
+struct StreamingConfig {
+    int sample_rate = 16000;
+    int step_ms = 1000;         // Re-decode after this much new audio
+    int min_window_ms = 3000;   // Don't decode until this much uncommitted audio exists
+    int holdback_ms = 1500;     // Segments ending this close to the live edge stay uncommitted
+    int max_window_ms = 20000;  // Force a commit if the uncommitted window grows past this
+    int max_seconds = 30;       // Capacity of the capture intake and session buffer
+};
+
+// Decodes a rolling window of audio in the background while recording continues.
+// Segments that are safely behind the live edge are committed and never decoded
+// again, so finish() only has to decode the uncommitted tail.
+class StreamingTranscriber {
+public:
+    // Receives all committed raw text so far (trimmed) after each commit
+    using CommitCallback = std::function<void(const std::string& committed_text)>;
+
+    StreamingTranscriber(Transcriber& transcriber, const StreamingConfig& config = {});
+    ~StreamingTranscriber();
+
+    // Start a new session (clears previous audio and committed text)
+    void begin();
+
+    // Append captured samples. Lock-free and allocation-free: safe to call
+    // from the real-time audio callback.
+    void feed(Span<const float> samples);
+
+    // Stop background decoding, decode the remaining tail and return the full result
+    TranscriptionResult finish();
+
+    bool is_active() const { return active_.load(); }
+
+    // Optional gain stages (AGC + normalization) applied to each decode window.
+    // Fed samples are expected to be filtered already by the capture processor.
+    void set_audio_processor(std::unique_ptr<AudioProcessor> processor) { processor_ = std::move(processor); }
+
+    // Called on the decode thread while recording; never after finish() starts.
+    // Set before begin().
+    void set_commit_callback(CommitCallback callback) { commit_callback_ = std::move(callback); }
+
+private:
+    void decode_loop();
+
+    // Move everything the audio callback produced into audio_ (decode thread)
+    void drain_intake();
+
+    // Decode audio_[committed_samples_, end) and commit finished segments.
+    // Returns the decode result for the window.
+    TranscriptionResult decode_window(bool final_pass);
+
+    // View of audio_[start, end), preprocessed and padded in window_scratch_ if needed
+    Span<const float> prepare_window(size_t start, size_t end, bool pad);
+
+    // Samples that didn't fit into the session buffer
+    std::atomic<uint64_t> dropped_samples_{0};
+
+    Transcriber& transcriber_;
+    StreamingConfig config_;
+    std::unique_ptr<AudioProcessor> processor_;
+    CommitCallback commit_callback_;
+
+    // Written by the audio callback, drained by the decode thread
+    SpscRingBuffer<float> intake_;
+
+    // Used only to wake the decode thread for shutdown (never from the audio callback)
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    // Owned by the decode thread while active, by finish() afterwards
+    std::vector<float> audio_;
+    std::vector<float> window_scratch_;  // Reused for preprocessing/padding a window
+    size_t committed_samples_ = 0;
+    size_t last_decode_end_ = 0;
+    std::string committed_text_;
+    double committed_confidence_sum_ = 0.0;  // Confidence weighted by committed samples
+    size_t committed_weight_ = 0;
+
+    std::thread decode_thread_;
+    std::atomic<bool> active_{false};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace whispr
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "span.hpp"
+#include "audio_processor.hpp"
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+namespace whispr {
+
+struct VadConfig {
+    int sample_rate = 16000;
+    float threshold = 0.015f;  // Smoothed RMS that counts as speech
+    int min_speech_ms = 100;   // Shorter bursts are discarded
+    int padding_ms = 50;       // Kept on each side of a segment
+};
+
+// Voice activity detector that runs incrementally as audio arrives. Energy is
+// accumulated as running sums per 5ms hop (10ms windows), smoothed online and
+// fed through the speech/silence hysteresis, so segment boundaries are known
+// as soon as recording stops. All storage is allocated up front: feed() is
+// safe to call from the real-time audio callback.
+class StreamingVad {
+public:
+    StreamingVad(const VadConfig& config, size_t max_samples);
+
+    // Start a new utterance. Not thread-safe: only call while nothing feeds.
+    void reset();
+
+    // Append samples (audio thread). Samples past max_samples are ignored.
+    void feed(Span<const float> samples);
+
+    // Live state, readable from any thread while feeding
+    bool in_speech() const { return in_speech_.load(std::memory_order_relaxed); }
+    int trailing_silence_ms() const;
+
+    // Samples fed so far. Only read once feeding has stopped.
+    size_t samples_seen() const { return samples_; }
+
+    // Speech segments of everything fed, padded and merged (empty if none).
+    // Closes the utterance; call after feeding stops. gain is the linear gain
+    // applied to the audio afterwards: thresholds are relative to the final
+    // level, so the envelope is re-evaluated at threshold / gain when gain != 1.
+    std::vector<SampleRange> segments(float gain = 1.0f);
+
+    // First to last window above threshold, widened by min_silence_samples / 2
+    // on each side. Whole input if nothing qualifies or less than 100ms remains.
+    SampleRange speech_bounds(int min_silence_samples, float gain = 1.0f) const;
+
+private:
+    struct FrameRange {
+        size_t start;
+        size_t end;
+    };
+
+    // Frame-level hysteresis: 2 frames above threshold open a segment,
+    // 3 below close it
+    class Segmenter {
+    public:
+        Segmenter(float threshold, size_t min_frames, std::vector<FrameRange>* out)
+            : threshold_(threshold), min_frames_(min_frames), out_(out) {}
+
+        void push(float energy);
+        void finish();
+
+        bool in_speech() const { return in_speech_; }
+        int silence_frames() const { return consecutive_silence_; }
+
+    private:
+        float threshold_;
+        size_t min_frames_;
+        std::vector<FrameRange>* out_;
+
+        size_t frames_ = 0;
+        bool in_speech_ = false;
+        size_t speech_start_ = 0;
+        int consecutive_speech_ = 0;
+        int consecutive_silence_ = 0;
+    };
+
+    void push_frame(float rms);
+    void emit_smoothed(size_t index);
+    void flush();
+    std::vector<SampleRange> to_sample_ranges(const std::vector<FrameRange>& frames) const;
+
+    VadConfig config_;
+    size_t max_samples_;
+    size_t hop_;     // Samples per hop (5ms)
+    size_t window_;  // Two hops (10ms)
+    size_t min_speech_frames_;
+    size_t padding_frames_;
+
+    // Running sums: the current partial hop and the previous complete one
+    size_t samples_ = 0;
+    size_t block_fill_ = 0;
+    float block_sum_ = 0.0f;
+    float prev_block_sum_ = 0.0f;
+    bool have_prev_block_ = false;
+
+    std::vector<float> raw_;       // RMS per hop
+    std::vector<float> smoothed_;  // 5-tap moving average of raw_, trails it by 2 frames
+    std::vector<FrameRange> segments_;
+    Segmenter segmenter_;
+    bool flushed_ = false;
+
+    std::atomic<bool> in_speech_{false};
+    std::atomic<int> silence_frames_{0};
+};
+
+} // namespace whispr
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace whispr {
 
@@ -20,6 +21,11 @@ public:
     // Main processing function - applies all enabled transformations
     std::string process(const std::string& text) const;
 
+    // Same, writing into `out` (which must not alias `text`) so callers can
+    // reuse one buffer across calls. Only the enabled stages are compiled into
+    // the pipeline for the current config.
+    void process(std::string_view text, std::string& out) const;
+
     // Individual operations (public for testing)
     std::string remove_filler_words(const std::string& text) const;
     std::string fix_capitalization(const std::string& text) const;
@@ -27,6 +33,13 @@ public:
     std::string trim(const std::string& text) const;
     std::string ensure_punctuation(const std::string& text) const;
 
+    // `next` without its leading words that repeat the end of `committed`
+    // (compared ignoring case and punctuation), for joining transcripts of
+    // overlapping audio. A single repeated word only counts if it is longer
+    // than four letters, so a genuine "that that" survives.
+    static std::string drop_overlap(const std::string& committed, const std::string& next,
+                                    size_t max_words = 8);
+
     void set_config(const TextProcessorConfig& config) { config_ = config; }
     const TextProcessorConfig& get_config() const { return config_; }
 
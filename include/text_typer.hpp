@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <cstddef>
+
+namespace whispr {
+
+// Tracks what has been typed into the focused window for one recording and
+// brings it up to date with the latest text: erase back to the common prefix,
+// then type the rest. Streaming commits grow the text, so usually only new
+// words are typed; the final result fixes up anything formatting changed.
+// Not thread-safe; streaming updates and the final result never overlap.
+class TextTyper {
+public:
+    using TypeFn = std::function<bool(const std::string& text)>;
+    using EraseFn = std::function<bool(size_t count)>;  // Characters (code points)
+
+    TextTyper(TypeFn type, EraseFn erase);
+
+    // Returns false if erasing or typing failed. typed() is then what is
+    // actually on screen (a prefix of `text` if only typing failed).
+    bool update(const std::string& text);
+
+    const std::string& typed() const { return typed_; }
+    bool started() const { return started_; }
+
+    // Number of UTF-8 code points in text
+    static size_t count_chars(const std::string& text, size_t from = 0);
+
+private:
+    TypeFn type_;
+    EraseFn erase_;
+    std::string typed_;
+    bool started_ = false;
+};
+
+} // namespace whispr
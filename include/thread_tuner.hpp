@@ -0,0 +1,47 @@
+#pragma once
+
+#include "config.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace whispr {
+
+class Transcriber;
+
+// Fastest decode thread count per model and profile, measured on this machine
+// and kept in ~/.whispr/threads.txt. The best count depends on the core layout,
+// the model size and greedy vs beam search, so no single default fits.
+class ThreadTuner {
+public:
+    explicit ThreadTuner(std::string cache_path = default_cache_path());
+
+    // Stored result for a model file and profile, or 0 if not measured yet
+    int lookup(const std::string& model_path, const std::string& profile_name) const;
+
+    // Time a short synthetic clip at each candidate count with the transcriber's
+    // current model and store the fastest. Returns it, or 0 if cancelled/failed
+    // or another decode ran on the transcriber during a trial.
+    int tune(Transcriber& transcriber, const TranscriptionProfile& profile,
+             const std::atomic<bool>* cancel = nullptr);
+
+    // Counts worth trying on a machine with these cores (ascending, unique)
+    static std::vector<int> candidates(int performance_cores, int all_cores);
+
+    static std::string default_cache_path();
+
+private:
+    static std::string key(const std::string& model_path, const std::string& profile_name);
+    void load();
+    void save_locked() const;
+
+    std::string cache_path_;
+    int cpus_;                         // Results are discarded when this changes
+    std::map<std::string, int> best_;  // key -> threads
+    mutable std::mutex mutex_;
+};
+
+} // namespace whispr
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace whispr {
+
+// Pipeline stages, from the hotkey event to text appearing in the focused window
+enum class TraceStage : uint8_t {
+    HotkeyDispatch,   // OS key event -> our handler
+    CaptureStop,      // Stopping capture on release
+    QueueWait,        // Release -> a worker picks the recording up
+    Preprocess,       // AGC and normalization (AudioProcessor::finish)
+    Vad,              // Speech ranges and compaction
+    Mel,              // whisper_full until the encoder starts (mel spectrogram)
+    Encode,           // Encoder, until the first decoder step
+    Decode,           // Decoder steps to the end of whisper_full
+    Inference,        // Whole whisper_full call
+    TextProcess,      // TextProcessor
+    ClipboardSet,
+    Paste,
+    Type,             // Keystroke output
+    KeyToText,        // Hotkey release -> output done
+    ModelWake,        // Hotkey press -> model usable again after idling
+    Count
+};
+
+const char* trace_stage_name(TraceStage stage);
+
+// Low-overhead stage timing. Each thread appends to its own fixed-size ring,
+// so recording takes no locks; every event also lands in a per-stage log-scale
+// histogram for percentiles over the whole session. Disabled (the default),
+// record() is a single relaxed load. A thread's ring passes to the next new
+// thread once it exits, so there are only as many as threads ever ran at once.
+class Trace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Summary {
+        uint64_t count;
+        double p50_ms;
+        double p95_ms;
+        double p99_ms;
+        double max_ms;
+    };
+
+    static void enable();
+    static bool enabled();
+
+    static void record(TraceStage stage, Clock::time_point begin, Clock::time_point end);
+
+    // Tag this thread's following events with a recording, so one dictation can
+    // be followed across threads in the trace (0 = none)
+    static void set_job(uint64_t job);
+    // Label this thread in the trace viewer
+    static void name_thread(const char* name);
+    // Rings allocated so far
+    static size_t thread_buffers();
+
+    // Percentiles are bucket midpoints, within about 6% of the true value
+    static Summary summary(TraceStage stage);
+    static void print_report(std::ostream& out);
+
+    // Events still in the per-thread rings as Chrome trace JSON
+    // (chrome://tracing, Perfetto)
+    static bool write_chrome_trace(const std::string& path);
+};
+
+// Records the enclosing scope as one stage
+class TraceSpan {
+public:
+    explicit TraceSpan(TraceStage stage)
+        : stage_(stage), begin_(Trace::enabled() ? Trace::Clock::now() : Trace::Clock::time_point{}) {}
+    ~TraceSpan() {
+        if (begin_ != Trace::Clock::time_point{}) {
+            Trace::record(stage_, begin_, Trace::Clock::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    TraceStage stage_;
+    Trace::Clock::time_point begin_;
+};
+
+} // namespace whispr
@@ -4,21 +4,47 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "text_processor.hpp"
 #include "config.hpp"
+#include "span.hpp"
+#include "model_manager.hpp"
+#include "thread_tuner.hpp"
 
 // Forward declare whisper types
-struct whisper_context;
+struct whisper_state;
 
 namespace whispr {
 
+// A single decoded segment with timestamps relative to the start of the input
+struct TranscriptionSegment {
+    int64_t t0_ms;
+    int64_t t1_ms;
+    std::string text;      // Raw segment text (not post-processed)
+};
+
 struct TranscriptionResult {
     std::string text;
     std::string raw_text;  // Original unprocessed text
     int64_t duration_ms;
     float confidence;      // Average token probability (0.0 - 1.0)
     bool success;
+    bool stopped_early = false;  // Ended by DecodeOptions::stop_below; confidence is the running value
     std::string error;
+    std::vector<TranscriptionSegment> segments;
+};
+
+// Per-call overrides for a single decode
+struct DecodeOptions {
+    bool multi_segment = false;  // Always split into segments (streaming needs boundaries)
+    bool process_text = true;    // Run TextProcessor on the result
+    bool log_result = true;      // Print timing/result line to stdout
+    int n_threads = 0;           // Thread budget for this decode (0 = transcriber default)
+    std::string context;         // Transcript of the audio before this clip, prompted after the initial prompt
+    const std::atomic<bool>* cancel = nullptr;  // Abort the decode once this becomes true
+    float stop_below = 0.0f;     // Abort once the running confidence is this low (0 = never)
 };
 
 class Transcriber {
@@ -28,28 +54,71 @@ public:
     Transcriber();
     ~Transcriber();
 
-    // Initialize with model path
-    bool initialize(const std::string& model_path, int n_threads = 4);
+    // Initialize with model path. The weights are loaded once; up to max_states
+    // decodes can then run concurrently, each on its own whisper_state.
+    bool initialize(const std::string& model_path, int n_threads = 4, size_t max_states = 1);
+    // Initialize with an already loaded (possibly cached) model
+    bool initialize(std::shared_ptr<WhisperModel> model, int n_threads = 4);
     void shutdown();
-    bool is_initialized() const { return ctx_ != nullptr; }
+    bool is_initialized() const;
 
-    // Transcribe audio samples (16kHz mono float)
-    TranscriptionResult transcribe(const std::vector<float>& audio);
+    // Switch model and profile together, e.g. on a quality change. Decodes
+    // already running finish on the previous model.
+    void set_model(std::shared_ptr<WhisperModel> model, const TranscriptionProfile& profile);
+    std::shared_ptr<WhisperModel> model() const;
 
-    // Transcribe with specific profile (for adaptive quality)
-    TranscriptionResult transcribe_with_profile(const std::vector<float>& audio,
-                                                 const TranscriptionProfile& profile);
+    // Idle unload: drop the model (decodes already running keep theirs).
+    // While expect_model(true) is in effect, decodes without a model wait for
+    // the next set_model() instead of failing; expect_model(false) releases
+    // them after a failed load.
+    void release_model();
+    void expect_model(bool expected);
 
-    // Adaptive transcription: starts fast, retries with higher quality if low confidence
-    TranscriptionResult transcribe_adaptive(const std::vector<float>& audio,
+    // Transcribe audio samples (16kHz mono float). The samples are only read for
+    // the duration of the call, so any buffer can be passed without copying.
+    // Thread-safe: concurrent calls each lease a state (blocking if all are busy).
+    TranscriptionResult transcribe(Span<const float> audio);
+
+    // Transcribe with specific profile (for adaptive quality)
+    TranscriptionResult transcribe_with_profile(Span<const float> audio,
+                                                 const TranscriptionProfile& profile,
+                                                 const DecodeOptions& options = {});
+
+    // Adaptive transcription: starts fast, retries with higher quality if low confidence.
+    // The fast pass is abandoned mid-decode once its running confidence is
+    // clearly too low, rather than finished only to be retried.
+    // In speculative mode both passes start together, each on half its thread
+    // budget, and the accurate pass is cancelled as soon as the fast one is
+    // confident, so the worst case costs max(fast, accurate) rather than the sum.
+    TranscriptionResult transcribe_adaptive(Span<const float> audio,
                                             float confidence_threshold = 0.7f);
 
+    // Decode a second of silence with `profile`, so lazy buffer allocation, GPU
+    // pipeline compilation and page faults into the weights happen here rather
+    // than in the first real decode. Silence decodes to nothing; success and
+    // duration_ms are what matter.
+    TranscriptionResult warm_up(const TranscriptionProfile& profile);
+
     // Settings
     void set_language(const std::string& lang) { language_ = lang; }
     void set_translate(bool translate) { translate_ = translate; }
-    void set_profile(const TranscriptionProfile& profile) { profile_ = profile; }
-    void set_initial_prompt(const std::string& prompt) { initial_prompt_ = prompt; }
+    void set_profile(const TranscriptionProfile& profile);
+    // Tokenized once per model on first use, not on every decode. Safe to call
+    // while decodes run; they keep the prompt they started with.
+    void set_initial_prompt(const std::string& prompt);
     void set_progress_callback(ProgressCallback cb) { progress_cb_ = cb; }
+    void set_speculative(bool speculative) { speculative_ = speculative; }
+    // Automatic threading: decodes run on performance cores and, given a
+    // tuner, with its measured thread count for the model and profile.
+    // Set before decoding starts.
+    void set_auto_threads(std::shared_ptr<const ThreadTuner> tuner) {
+        auto_threads_ = true;
+        tuner_ = std::move(tuner);
+    }
+    TranscriptionProfile get_profile() const;
+    // Decodes begun so far, by anyone; a measurement that saw it move by more
+    // than its own decode shared the cores with another one
+    uint64_t decodes_started() const { return decodes_started_.load(std::memory_order_relaxed); }
 
     // Text processing settings
     void set_text_processing(bool enabled) { process_text_ = enabled; }
@@ -58,21 +127,53 @@ public:
         text_processor_ = TextProcessor(config);
     }
 
+    // Apply text post-processing (if enabled) to raw whisper output
+    std::string post_process(const std::string& raw_text) const;
+
+    // Same for text that is still growing (streaming commits): no sentence-final
+    // period is added, since more words may follow
+    std::string post_process_partial(const std::string& raw_text) const;
+
+    // Tokens `text` encodes to with the current model's tokenizer (-1 without a model)
+    int count_tokens(const std::string& text) const;
+    // Longest prompt whisper keeps; anything before that is dropped
+    int max_prompt_tokens() const;
+
 private:
-    whisper_context* ctx_ = nullptr;
+    // Weights and decode states; swapped atomically under model_mutex_
+    std::shared_ptr<WhisperModel> model_;
+    mutable std::mutex model_mutex_;
+    std::condition_variable model_cv_;  // Signalled by set_model() and expect_model()
+    bool model_expected_ = false;       // A reload is on its way; guarded by model_mutex_
     int n_threads_ = 4;
     std::string language_ = "en";
     bool translate_ = false;
     TranscriptionProfile profile_ = PROFILE_BALANCED;
-    std::string initial_prompt_;
     ProgressCallback progress_cb_;
+    bool speculative_ = false;
+    bool auto_threads_ = false;
+    std::shared_ptr<const ThreadTuner> tuner_;  // Optional with auto_threads_
+    std::atomic<uint64_t> decodes_started_{0};
 
     // Text post-processing
     TextProcessor text_processor_;
     bool process_text_ = true;  // Enabled by default
 
-    // Calculate confidence from token probabilities
-    float calculate_confidence() const;
+    // Initial prompt and its tokens for the model they were made with
+    using PromptTokens = std::vector<int32_t>;  // whisper_token
+    mutable std::mutex prompt_mutex_;
+    std::string initial_prompt_;
+    mutable std::shared_ptr<const PromptTokens> prompt_tokens_;
+    mutable std::weak_ptr<WhisperModel> prompt_model_;
+
+    // Cached tokens of the initial prompt for `model` (null if there is no prompt)
+    std::shared_ptr<const PromptTokens> prompt_tokens(const std::shared_ptr<WhisperModel>& model) const;
+
+    TranscriptionResult transcribe_adaptive_sequential(Span<const float> audio, float confidence_threshold);
+    TranscriptionResult transcribe_adaptive_speculative(Span<const float> audio, float confidence_threshold);
+
+    // Threads for one decode with `profile`: the tuned count if measured, else n_threads_
+    int thread_budget(const WhisperModel& model, const TranscriptionProfile& profile) const;
 };
 
 } // namespace whispr
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "transcriber.hpp"
+
+#include <memory>
+#include <functional>
+#include <deque>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace whispr {
+
+// Runs transcription jobs on dedicated threads that share the Transcriber.
+// With more than one thread, jobs decode concurrently (one whisper_state each),
+// but completion callbacks still fire one at a time in submission order.
+class TranscriptionWorker {
+public:
+    using Task = std::function<TranscriptionResult(Transcriber&)>;
+    using Completion = std::function<void(const TranscriptionResult&)>;
+
+    TranscriptionWorker(std::unique_ptr<Transcriber> transcriber, size_t max_pending = 4,
+                        size_t n_workers = 1);
+    ~TranscriptionWorker();
+
+    bool start();
+    // Finish running jobs, discard anything still queued and join the threads
+    void stop();
+
+    // Queue a job. Never blocks; returns false if the queue is full or stopped.
+    bool submit(Task task, Completion on_complete);
+
+    // Jobs queued or currently running
+    size_t pending() const { return pending_.load(); }
+    bool is_running() const { return running_.load(); }
+
+    // The transcriber is thread-safe for decoding, so other components
+    // (e.g. streaming sessions) may use it directly
+    Transcriber& transcriber() { return *transcriber_; }
+
+private:
+    struct Job {
+        uint64_t id;
+        Task task;
+        Completion on_complete;
+    };
+
+    struct Finished {
+        TranscriptionResult result;
+        Completion on_complete;
+    };
+
+    void run_loop();
+
+    // Fire callbacks for every finished job whose predecessors have all completed
+    void deliver_ready();
+
+    std::unique_ptr<Transcriber> transcriber_;
+    size_t max_pending_;
+    size_t n_workers_;
+
+    std::deque<Job> queue_;
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    uint64_t next_job_id_ = 0;
+
+    // Results that finished ahead of an earlier job, keyed by job id
+    std::map<uint64_t, Finished> finished_;
+    uint64_t next_to_deliver_ = 0;
+    std::mutex finished_mutex_;
+    std::mutex deliver_mutex_;  // Serializes callbacks
+
+    std::atomic<size_t> pending_{0};
+    std::atomic<bool> running_{false};
+    std::vector<std::thread> worker_threads_;
+};
+
+} // namespace whispr
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace whispr {
@@ -16,6 +19,12 @@ struct VocabularyConfig {
     }
 };
 
+// How often each vocabulary term appeared in transcriptions
+using TermUsage = std::unordered_map<std::string, uint32_t>;
+
+// Number of tokens a text encodes to
+using TokenCounter = std::function<int(const std::string&)>;
+
 class VocabularyLoader {
 public:
     // Load vocabulary from ~/.whispr/vocabulary.txt
@@ -25,10 +34,26 @@ public:
     static VocabularyConfig load_from_file(const std::string& path);
 
     // Build initial prompt from vocabulary config
-    // Optimized for whisper's 224 token limit
+    // Sized by estimate for whisper's 224 token limit
     static std::string build_initial_prompt(const VocabularyConfig& vocab,
                                             const std::string& base_prompt = "");
 
+    // Build a prompt of at most max_tokens as counted by `count_tokens`. When
+    // not every term fits, the most used ones are kept (ties: file order).
+    static std::string build_initial_prompt(const VocabularyConfig& vocab,
+                                            const std::string& base_prompt,
+                                            const TermUsage& usage,
+                                            const TokenCounter& count_tokens,
+                                            int max_tokens);
+
+    // Count vocabulary terms (whole words, any case) in transcribed text
+    static void count_usage(const VocabularyConfig& vocab, const std::string& text, TermUsage& usage);
+
+    // Usage counts persist across runs in ~/.whispr/vocabulary_usage.txt
+    static TermUsage load_usage(const std::string& path);
+    static bool save_usage(const std::string& path, const TermUsage& usage);
+    static std::string get_default_usage_path();
+
     // Get default vocabulary file path
     static std::string get_default_vocabulary_path();
 
@@ -36,8 +61,8 @@ public:
     static bool create_default_vocabulary_file();
 
 private:
-    // Truncate to approximate token count (rough estimate: 4 chars = 1 token)
-    static std::string truncate_to_tokens(const std::string& text, int max_tokens);
+    // Rough token estimate when no tokenizer is available: 4 chars = 1 token
+    static int estimate_tokens(const std::string& text);
 };
 
 } // namespace whispr
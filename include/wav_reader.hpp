@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace whispr {
+
+// Incremental WAV decoder: PCM 8/16/24/32-bit or 32-bit float, any channel
+// count and sample rate, delivered as mono float at target_rate in whatever
+// block size the caller reads. Only one block of the file is in memory at a
+// time, so recordings of any length can be read.
+class WavReader {
+public:
+    WavReader() = default;
+    ~WavReader();
+
+    WavReader(const WavReader&) = delete;
+    WavReader& operator=(const WavReader&) = delete;
+
+    // Read the header. On failure error() says why. "-" reads standard input.
+    bool open(const std::string& path, int target_rate = 16000);
+    // Read from a pipe, e.g. a decoder's stdout. The data chunk is read to the
+    // end of the stream whatever its header says, and the stream is left open.
+    bool open(FILE* stream, int target_rate = 16000);
+    void close();
+    bool is_open() const { return file_ != nullptr; }
+
+    // Up to max samples; fewer only at the end of the file (0 once it is done)
+    size_t read(float* out, size_t max);
+
+    int source_rate() const { return source_rate_; }
+    int channels() const { return channels_; }
+    int target_rate() const { return target_rate_; }
+    // Length at target_rate according to the header (0 if the writer left it open)
+    size_t total_samples() const;
+    const std::string& error() const { return error_; }
+
+    // Decode a whole file. Returns false (with the reason in error) on failure.
+    static bool read_all(const std::string& path, std::vector<float>& out,
+                         int target_rate = 16000, std::string* error = nullptr);
+
+private:
+    bool read_header(int target_rate);
+    // Deinterleave and mix down the next frames of the data chunk into in_
+    bool refill();
+    bool fail(const std::string& message);
+
+    FILE* file_ = nullptr;
+    bool owns_file_ = false;
+    bool streamed_ = false;     // Header sizes can't be trusted
+    std::string error_;
+    int format_ = 0;            // 1 = integer PCM, 3 = IEEE float
+    int channels_ = 0;
+    int bits_ = 0;
+    int source_rate_ = 0;
+    int target_rate_ = 16000;
+    uint64_t data_left_ = 0;    // Bytes of sample data not read yet
+    bool data_open_ended_ = false;  // Size unknown: read until end of file
+    uint64_t data_bytes_ = 0;
+
+    std::vector<uint8_t> raw_;  // Undecoded bytes of one block
+    std::vector<float> in_;     // Mono source-rate samples; in_[0] is carried over between blocks
+    double pos_ = 0.0;          // Next output position, in source samples from in_[0]
+    double step_ = 1.0;         // Source samples per output sample
+    bool eof_ = false;
+};
+
+} // namespace whispr
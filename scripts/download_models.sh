@@ -1,16 +1,32 @@
 #!/bin/bash
 # Download whisper.cpp models for different quality levels
+#
+# Usage: download_models.sh [MODEL_DIR] [PRECISION]
+#   PRECISION: f16 (default), q8, q5 or all. Quantized models that can't be
+#   downloaded are converted from the f16 model with whisper.cpp's quantize
+#   tool (set QUANTIZE=/path/to/tool if it isn't in whisper.cpp/build/bin).
 
 set -e
 
 MODEL_DIR="${1:-models}"
+PRECISION="${2:-f16}"
 BASE_URL="https://huggingface.co/ggerganov/whisper.cpp/resolve/main"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+
+case "$PRECISION" in
+    f16|q8|q5|all) ;;
+    *)
+        echo "Unknown precision: $PRECISION (use f16, q8, q5 or all)"
+        exit 1
+        ;;
+esac
 
 mkdir -p "$MODEL_DIR"
 
 echo "Whisper Model Downloader"
 echo "========================"
 echo "Models will be saved to: $MODEL_DIR"
+echo "Precision: $PRECISION"
 echo ""
 
 download_model() {
@@ -28,20 +44,84 @@ download_model() {
     echo "[$name] Done!"
 }
 
-echo "Available models:"
-echo "  1) tiny.en   - 75MB  (Fast mode, ~80% accuracy)"
-echo "  2) base.en   - 142MB (Balanced mode, ~85% accuracy)"
-echo "  3) small.en  - 466MB (Accurate mode, ~92% accuracy)"
-echo "  4) medium.en - 1.5GB (Best mode, ~95% accuracy)"
+find_quantize() {
+    if [ -n "$QUANTIZE" ]; then
+        echo "$QUANTIZE"
+        return
+    fi
+    for tool in "$SCRIPT_DIR/../whisper.cpp/build/bin/whisper-quantize" \
+                "$SCRIPT_DIR/../whisper.cpp/build/bin/quantize" \
+                "$SCRIPT_DIR/../build/whisper.cpp/bin/whisper-quantize" \
+                "$SCRIPT_DIR/../build/whisper.cpp/bin/quantize"; do
+        if [ -x "$tool" ]; then
+            echo "$tool"
+            return
+        fi
+    done
+    command -v whisper-quantize 2>/dev/null || command -v quantize 2>/dev/null || true
+}
+
+# Quantized variant: download it, or convert the f16 model if that fails
+quantized_model() {
+    local name=$1
+    local base=$2     # e.g. ggml-base.en
+    local type=$3     # q8_0, q5_1 or q5_0
+    local size=$4
+    local f16_size=$5
+    local filename="$base-$type.bin"
+
+    if [ -f "$MODEL_DIR/$filename" ]; then
+        echo "[$name] Already exists: $filename"
+        return
+    fi
+
+    echo "[$name] Downloading $filename ($size)..."
+    if curl -fL --progress-bar -o "$MODEL_DIR/$filename" "$BASE_URL/$filename"; then
+        echo "[$name] Done!"
+        return
+    fi
+    rm -f "$MODEL_DIR/$filename"
+
+    local tool
+    tool=$(find_quantize)
+    if [ -z "$tool" ]; then
+        echo "[$name] Download failed and no quantize tool found; build whisper.cpp's quantize or set QUANTIZE"
+        return 1
+    fi
+    download_model "$name" "$base.bin" "$f16_size"
+    echo "[$name] Converting $base.bin to $type..."
+    "$tool" "$MODEL_DIR/$base.bin" "$MODEL_DIR/$filename" "$type"
+    echo "[$name] Done!"
+}
+
+# One quality at the selected precision(s)
+fetch() {
+    local name=$1 base=$2 q5=$3 f16_size=$4 q8_size=$5 q5_size=$6
+    if [ "$PRECISION" = "f16" ] || [ "$PRECISION" = "all" ]; then
+        download_model "$name" "$base.bin" "$f16_size"
+    fi
+    if [ "$PRECISION" = "q8" ] || [ "$PRECISION" = "all" ]; then
+        quantized_model "$name" "$base" q8_0 "$q8_size" "$f16_size"
+    fi
+    if [ "$PRECISION" = "q5" ] || [ "$PRECISION" = "all" ]; then
+        quantized_model "$name" "$base" "$q5" "$q5_size" "$f16_size"
+    fi
+}
+
+echo "Available models (f16 / q8_0 / q5):"
+echo "  1) tiny.en   - 75MB  / 42MB  / 31MB  (Fast mode, ~80% accuracy)"
+echo "  2) base.en   - 142MB / 78MB  / 57MB  (Balanced mode, ~85% accuracy)"
+echo "  3) small.en  - 466MB / 252MB / 181MB (Accurate mode, ~92% accuracy)"
+echo "  4) medium.en - 1.5GB / 785MB / 514MB (Best mode, ~95% accuracy)"
 echo "  5) all       - Download all models"
 echo ""
 
 read -p "Select models to download (1-5, or comma-separated list like 1,2): " choice
 
-download_tiny() { download_model "Fast" "ggml-tiny.en.bin" "75MB"; }
-download_base() { download_model "Balanced" "ggml-base.en.bin" "142MB"; }
-download_small() { download_model "Accurate" "ggml-small.en.bin" "466MB"; }
-download_medium() { download_model "Best" "ggml-medium.en.bin" "1.5GB"; }
+download_tiny() { fetch "Fast" "ggml-tiny.en" q5_1 "75MB" "42MB" "31MB"; }
+download_base() { fetch "Balanced" "ggml-base.en" q5_1 "142MB" "78MB" "57MB"; }
+download_small() { fetch "Accurate" "ggml-small.en" q5_1 "466MB" "252MB" "181MB"; }
+download_medium() { fetch "Best" "ggml-medium.en" q5_0 "1.5GB" "785MB" "514MB"; }
 
 case "$choice" in
     1) download_tiny ;;
@@ -0,0 +1,113 @@
+#!/bin/bash
+# Fetch or generate the voxtype_bench corpus clips listed in
+# bench/corpus/manifest.tsv and check each against its sha256 there.
+#
+#   make_bench_corpus.sh             Generate missing clips with the system
+#                                    text-to-speech engine, then verify
+#   make_bench_corpus.sh --from URL  Download missing clips from URL/<clip>
+#                                    (a mirror of the pinned corpus), then verify
+#   make_bench_corpus.sh --pin       Record the hashes of the clips on disk in
+#                                    the manifest (after regenerating on purpose)
+#   --force                          Replace existing clips
+#
+# Existing clips are kept: results are only comparable while the audio stays
+# the same, and voxtype_bench refuses to report on clips that don't verify
+# (unless run with --unverified, which marks its results as such).
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+PROJECT_DIR="$(dirname "$SCRIPT_DIR")"
+CORPUS_DIR="$PROJECT_DIR/bench/corpus"
+MANIFEST="$CORPUS_DIR/manifest.tsv"
+FORCE=0
+PIN=0
+FROM=""
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --force) FORCE=1 ;;
+        --pin) PIN=1 ;;
+        --from) FROM="$2"; shift ;;
+        *) echo "Unknown option: $1"; exit 1 ;;
+    esac
+    shift
+done
+
+if command -v sha256sum > /dev/null; then
+    sha256() { sha256sum "$1" | cut -d' ' -f1; }
+else
+    sha256() { shasum -a 256 "$1" | cut -d' ' -f1; }
+fi
+
+# espeak writes 22.05 kHz; the corpus is stored at the bench's 16 kHz
+to_16k() {
+    if command -v sox > /dev/null; then
+        sox "$1" -r 16000 -c 1 -b 16 "$2"
+    elif command -v ffmpeg > /dev/null; then
+        ffmpeg -loglevel error -y -i "$1" -ar 16000 -ac 1 -sample_fmt s16 "$2"
+    else
+        echo "Resampling to 16 kHz needs sox or ffmpeg"
+        exit 1
+    fi
+    rm -f "$1"
+}
+
+if [ -n "$FROM" ]; then
+    produce() { curl -fsSL -o "$1" "$FROM/$(basename "$1")"; }
+elif command -v say > /dev/null; then
+    produce() { say -o "$1" --data-format=LEI16@16000 "$2"; }
+elif command -v espeak-ng > /dev/null; then
+    produce() { espeak-ng -w "$1.tmp.wav" "$2" && to_16k "$1.tmp.wav" "$1"; }
+elif command -v espeak > /dev/null; then
+    produce() { espeak -w "$1.tmp.wav" "$2" && to_16k "$1.tmp.wav" "$1"; }
+elif [ $PIN = 0 ]; then
+    echo "No text-to-speech engine found (say, espeak-ng or espeak); use --from URL"
+    exit 1
+fi
+
+if [ $PIN = 1 ]; then
+    updated="$(mktemp)"
+    while IFS= read -r line; do
+        case "$line" in ''|'#'*) echo "$line"; continue ;; esac
+        IFS=$'\t' read -r clip hash text <<< "$line"
+        if [ ! -f "$CORPUS_DIR/$clip" ]; then
+            echo "[$clip] Missing, run without --pin first" >&2
+            rm -f "$updated"
+            exit 1
+        fi
+        printf '%s\t%s\t%s\n' "$clip" "$(sha256 "$CORPUS_DIR/$clip")" "$text"
+    done < "$MANIFEST" > "$updated"
+    mv "$updated" "$MANIFEST"
+    echo "Pinned. Commit bench/corpus/*.wav together with manifest.tsv"
+    exit 0
+fi
+
+failed=0
+unpinned=0
+while IFS=$'\t' read -r clip hash text; do
+    case "$clip" in ''|'#'*) continue ;; esac
+    if [ ! -f "$CORPUS_DIR/$clip" ] || [ $FORCE = 1 ]; then
+        echo "[$clip] $text"
+        produce "$CORPUS_DIR/$clip" "$text"
+    fi
+    actual="$(sha256 "$CORPUS_DIR/$clip")"
+    if [ "$hash" = "unpinned" ]; then
+        unpinned=1
+    elif [ "$actual" != "$hash" ]; then
+        echo "[$clip] sha256 $actual does not match the manifest ($hash)"
+        failed=1
+    fi
+done < "$MANIFEST"
+
+if [ $failed = 1 ]; then
+    echo "The corpus doesn't match the pinned one; voxtype_bench won't report on it."
+    echo "Fetch the pinned clips (--from URL), or pin these with --pin if replacing the corpus on purpose."
+    exit 1
+fi
+if [ $unpinned = 1 ]; then
+    # Nothing to check against yet: the bench runs, but says the numbers aren't comparable
+    echo "Done. The manifest isn't pinned yet; run: ./build/voxtype_bench --unverified --json bench_results.json"
+    echo "Pin these clips with --pin and commit them to make results comparable."
+    exit 0
+fi
+echo "Done. Run: ./build/voxtype_bench --json bench_results.json"
@@ -1,6 +1,11 @@
 #include "app.hpp"
 #include "vocabulary.hpp"
+#include "cpu_topology.hpp"
+#include "trace.hpp"
+#include "speech_chunker.hpp"
 #include <iostream>
+#include <sstream>
+#include <algorithm>
 #include <thread>
 #include <chrono>
 
@@ -21,74 +26,202 @@ App::~App() {
 
 bool App::initialize(const Config& config) {
     config_ = config;
+    started_ = std::chrono::steady_clock::now();
+
+    if (config_.latency_report || !config_.trace_path.empty()) {
+        Trace::enable();
+    }
 
     // Initialize audio capture
     audio_ = std::make_unique<AudioCapture>(
         config_.sample_rate,
         config_.channels,
-        config_.frames_per_buffer
+        config_.frames_per_buffer,
+        config_.max_recording_seconds,
+        config_.preroll_ms
     );
 
-    if (!audio_->initialize()) {
+    if (audio_->initialize()) {
+        std::cout << "Audio capture initialized" << std::endl;
+    } else if (config_.daemon) {
+        // A headless daemon can still serve clients
+        std::cerr << "Failed to initialize audio capture, continuing without a microphone" << std::endl;
+    } else {
         std::cerr << "Failed to initialize audio capture" << std::endl;
         return false;
     }
-    std::cout << "Audio capture initialized" << std::endl;
 
     // Initialize audio processor if enabled
     if (config_.audio_preprocessing) {
         audio_processor_ = std::make_unique<AudioProcessor>(
             static_cast<float>(config_.sample_rate)
         );
+        // Filtering runs on the audio thread while recording; only the gain
+        // stages are left for after release
+        audio_->set_processor(audio_processor_.get());
         std::cout << "Audio preprocessing enabled" << std::endl;
     }
 
     // Initialize transcriber
-    transcriber_ = std::make_unique<Transcriber>();
-    if (!transcriber_->initialize(config_.get_model_path(), config_.n_threads)) {
+    auto transcriber = std::make_unique<Transcriber>();
+    // One decode state per parallel job (two when adaptive passes run
+    // speculatively side by side), plus one for the streaming or long-form session
+    const bool speculative = config_.adaptive_quality && config_.speculative_adaptive;
+    size_t parallel_jobs = static_cast<size_t>(std::max(config_.parallel_jobs, 1));
+    size_t max_states = parallel_jobs * (speculative ? 2 : 1) + (config_.streaming || config_.long_form ? 1 : 0);
+    models_ = std::make_unique<ModelManager>(
+        config_.model_dir,
+        static_cast<size_t>(std::max(config_.model_cache_size, 1)),
+        max_states,
+        config_.use_gpu,
+        config_.gpu_device,
+        config_.model_precision
+    );
+    // Auto: start from the performance cores, shared between parallel jobs
+    const bool auto_threads = config_.n_threads <= 0;
+    const int n_threads = auto_threads
+        ? std::max(1, performance_core_count() / static_cast<int>(parallel_jobs))
+        : config_.n_threads;
+    std::shared_ptr<WhisperModel> model = models_->get(config_.model_quality);
+    if (!transcriber->initialize(model, n_threads)) {
         std::cerr << "Failed to initialize transcriber" << std::endl;
         return false;
     }
-    transcriber_->set_language(config_.language);
-    transcriber_->set_translate(config_.translate);
-    transcriber_->set_profile(get_profile(config_.model_quality));
-
-    // Load user vocabulary and build initial prompt
-    auto user_vocab = VocabularyLoader::load_user_vocabulary();
-    std::string initial_prompt;
-    if (!user_vocab.empty()) {
-        initial_prompt = VocabularyLoader::build_initial_prompt(user_vocab, config_.initial_prompt);
-    } else {
-        initial_prompt = config_.initial_prompt;
-    }
-    if (!initial_prompt.empty()) {
-        transcriber_->set_initial_prompt(initial_prompt);
+    // What was actually loaded: Auto precision and missing files resolve at load time
+    std::cout << "Model: " << model->path() << " ("
+              << precision_name(models_->precision_for(config_.model_quality)) << ")" << std::endl;
+    if (auto_threads) {
+        // Measured counts assume one decode at a time
+        if (parallel_jobs == 1) {
+            thread_tuner_ = std::make_shared<ThreadTuner>();
+        }
+        transcriber->set_auto_threads(thread_tuner_);
+        std::cout << "Threads: " << n_threads << " (" << performance_core_count() << " performance of "
+                  << available_cpu_count() << " CPUs)" << std::endl;
     }
+    quality_.store(config_.model_quality);
+    requested_quality_.store(config_.model_quality);
+    transcriber->set_language(config_.language);
+    transcriber->set_translate(config_.translate);
+    transcriber->set_speculative(speculative);
+    transcriber->set_profile(get_profile(config_.model_quality));
 
     // Create default vocabulary file if it doesn't exist (for user reference)
     VocabularyLoader::create_default_vocabulary_file();
 
     std::cout << "Transcriber initialized (quality: " << get_profile(config_.model_quality).name << ")" << std::endl;
 
+    // Inference runs on a dedicated worker so the hotkey thread never blocks
+    worker_ = std::make_unique<TranscriptionWorker>(
+        std::move(transcriber),
+        static_cast<size_t>(config_.max_queued_jobs),
+        parallel_jobs
+    );
+    if (!worker_->start()) {
+        std::cerr << "Failed to start transcription worker" << std::endl;
+        return false;
+    }
+
+    // Load user vocabulary and build initial prompt; rebuilt only when the file changes
+    vocab_usage_ = VocabularyLoader::load_usage(VocabularyLoader::get_default_usage_path());
+    reload_vocabulary();
+    vocab_watcher_.start(VocabularyLoader::get_default_vocabulary_path(), [this]() {
+        std::cout << "Vocabulary changed, rebuilding prompt" << std::endl;
+        reload_vocabulary();
+    });
+
+    if (config_.warm_up) {
+        queue_warm_up();
+    } else {
+        start_thread_tuning();
+    }
+
+    if (config_.preload_models) {
+        models_->preload_neighbor(config_.model_quality);
+    }
+
+    // Captured audio goes to whichever session is listening: hands-free,
+    // long-form or streaming (at most one is active)
+    audio_->set_callback([this](Span<const float> chunk) {
+        if (ContinuousDictation* continuous = active_continuous_.load(std::memory_order_acquire)) {
+            continuous->feed(chunk);
+        } else if (LongFormTranscriber* session = active_long_.load(std::memory_order_acquire)) {
+            session->feed(chunk);
+        } else if (StreamingTranscriber* stream = active_stream_.load(std::memory_order_acquire)) {
+            stream->feed(chunk);
+        }
+    });
+
+    // Long-form mode: the session holds the audio, so recordings have no length limit
+    if (config_.long_form) {
+        audio_->set_keep_audio(false);
+        std::cout << "Long-form dictation enabled" << std::endl;
+    } else if (config_.streaming) {
+        // Streaming mode: feed captured audio to a background decoder while recording
+        std::cout << "Streaming transcription enabled" << std::endl;
+    }
+
     // Initialize hotkey manager
     hotkey_ = std::make_unique<HotkeyManager>();
     if (!hotkey_->initialize()) {
-        std::cerr << "Failed to initialize hotkey manager" << std::endl;
-        return false;
+        if (!config_.daemon) {
+            std::cerr << "Failed to initialize hotkey manager" << std::endl;
+            return false;
+        }
+        std::cerr << "Failed to initialize hotkey manager, serving socket clients only" << std::endl;
+        hotkey_.reset();
     }
-
-    // Set default hotkey if not specified
-    uint32_t keycode = config_.hotkey_keycode;
-    if (keycode == 0) {
+    if (hotkey_) {
+        // Set default hotkey if not specified
+        uint32_t keycode = config_.hotkey_keycode;
+        if (keycode == 0) {
 #ifdef PLATFORM_MACOS
-        keycode = 61;  // Right Option
+            keycode = 61;  // Right Option
 #elif PLATFORM_LINUX
-        keycode = 108; // Right Alt
+            keycode = 108; // Right Alt
 #endif
+        }
+        hotkey_->set_hotkey(keycode, config_.hotkey_modifiers);
+        hotkey_->set_callback([this](bool pressed, HotkeyManager::Clock::time_point when) {
+            on_hotkey(pressed, when);
+        });
+        std::cout << "Hotkey manager initialized" << std::endl;
+    }
+
+    // Daemon mode: other tools submit audio to the already loaded model
+    if (config_.daemon) {
+        IpcServer::Handlers handlers;
+        handlers.transcribe = [this](std::shared_ptr<SharedAudio> audio, bool partials, IpcServer::Reply reply) {
+            transcribe_for_client(std::move(audio), partials, std::move(reply));
+        };
+        handlers.status = [this]() { return ipc_status(); };
+        ipc_ = std::make_unique<IpcServer>(std::move(handlers));
+        const std::string path = config_.socket_path.empty() ? IpcServer::default_socket_path() : config_.socket_path;
+        if (!ipc_->start(path)) {
+            return false;
+        }
+    }
+
+    // Keep the clipboard connection open so each paste skips the setup
+    Clipboard::initialize();
+
+    if (config_.type_output) {
+        typing_ = KeyboardOutput::initialize();
+        if (!typing_) {
+            std::cerr << "Falling back to clipboard output" << std::endl;
+        }
+    }
+
+    if (config_.history) {
+        history_ = std::make_unique<HistoryStore>();
+        const std::string path = config_.history_path.empty() ? HistoryStore::default_path() : config_.history_path;
+        if (history_->open(path)) {
+            std::cout << "History: " << history_->size() << " dictation(s) in " << path << std::endl;
+        } else {
+            std::cerr << "History disabled: " << history_->error() << std::endl;
+            history_.reset();
+        }
     }
-    hotkey_->set_hotkey(keycode, config_.hotkey_modifiers);
-    hotkey_->set_callback([this](bool pressed) { on_hotkey(pressed); });
-    std::cout << "Hotkey manager initialized" << std::endl;
 
     // Create tray icon
     if (!create_tray_icon(this)) {
@@ -96,6 +229,11 @@ bool App::initialize(const Config& config) {
         // Continue anyway - not critical
     }
 
+    if (config_.idle_compact_minutes > 0 || config_.idle_unload_minutes > 0) {
+        last_activity_ = std::chrono::steady_clock::now();
+        idle_thread_ = std::thread([this]() { idle_loop(); });
+    }
+
     state_.store(AppState::Idle);
     return true;
 }
@@ -103,33 +241,102 @@ bool App::initialize(const Config& config) {
 void App::shutdown() {
     should_quit_.store(true);
 
+    // No client requests once shutdown starts
+    if (ipc_) {
+        ipc_->stop();
+        ipc_.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cv_.notify_all();
+    }
+    if (idle_thread_.joinable()) {
+        idle_thread_.join();
+    }
+
     if (hotkey_) {
         hotkey_->stop();
         hotkey_.reset();
     }
 
+    // While the worker still runs: the last utterance is submitted as it ends
+    {
+        std::lock_guard<std::mutex> lock(continuous_mutex_);
+        stop_continuous();
+    }
+
     if (audio_) {
         audio_->shutdown();
         audio_.reset();
     }
 
-    if (transcriber_) {
-        transcriber_->shutdown();
-        transcriber_.reset();
+    active_stream_.store(nullptr);
+    stream_session_.reset();
+    active_long_.store(nullptr);
+    long_session_.reset();
+
+    // Joins the loader thread first: its callbacks use the worker's transcriber
+    models_.reset();
+
+    tune_cancel_.store(true);
+    tune_paused_.store(true);
+    if (tune_thread_.joinable()) {
+        tune_thread_.join();
+    }
+
+    // Joins the worker thread; the Transcriber is freed with it
+    if (worker_) {
+        worker_->stop();
+        worker_.reset();
+    }
+
+    vocab_watcher_.stop();
+    {
+        std::lock_guard<std::mutex> lock(vocab_mutex_);
+        if (!vocab_usage_.empty()) {
+            VocabularyLoader::save_usage(VocabularyLoader::get_default_usage_path(), vocab_usage_);
+        }
+    }
+
+    if (config_.latency_report) {
+        Trace::print_report(std::cout);
+    }
+    if (!config_.trace_path.empty()) {
+        if (Trace::write_chrome_trace(config_.trace_path)) {
+            std::cout << "Trace written to " << config_.trace_path << std::endl;
+        } else {
+            std::cerr << "Failed to write trace: " << config_.trace_path << std::endl;
+        }
     }
 
+    KeyboardOutput::shutdown();
+    Clipboard::shutdown();
     destroy_tray_icon();
+
+    // After the tray: its menu reads entries from the log
+    history_.reset();
 }
 
 int App::run() {
-    if (!hotkey_->start()) {
+    if (hotkey_ && !hotkey_->start()) {
         std::cerr << "Failed to start hotkey listener" << std::endl;
         return 1;
     }
 
     std::cout << "\n=== VoxType Ready ===" << std::endl;
-    std::cout << "Hold the hotkey to record, release to transcribe and paste." << std::endl;
-    std::cout << "Menu bar icon should appear in your menu bar.\n" << std::endl;
+    if (hotkey_) {
+        std::cout << "Hold the hotkey to record, release to transcribe and paste." << std::endl;
+        std::cout << "Menu bar icon should appear in your menu bar." << std::endl;
+    }
+    if (ipc_) {
+        std::cout << "Serving transcriptions on " << ipc_->path() << std::endl;
+    }
+    std::cout << std::endl;
+
+    if (config_.continuous) {
+        set_continuous(true);
+    }
 
 #ifdef PLATFORM_MACOS
     // On macOS, run the NSApplication event loop
@@ -144,128 +351,850 @@ int App::run() {
     return 0;
 }
 
-void App::on_hotkey(bool pressed) {
+void App::on_hotkey(bool pressed, std::chrono::steady_clock::time_point when) {
     // Skip hotkey if disabled
     if (!enabled_.load()) {
         return;
     }
 
+    Trace::name_thread("hotkey");
+    Trace::record(TraceStage::HotkeyDispatch, when, std::chrono::steady_clock::now());
+
+    // Hands-free: a press goes back to push-to-talk (the release then finds
+    // no recording to stop)
+    if (continuous_.load()) {
+        if (pressed) set_continuous(false);
+        return;
+    }
+
     if (pressed) {
         start_recording();
     } else {
-        stop_recording();
+        stop_recording(when);
     }
 }
 
 void App::start_recording() {
-    if (state_.load() != AppState::Idle) return;
+    if (state_.load() == AppState::Recording) return;
 
-    // Check cooldown to prevent rapid re-recording glitches
+    // Check cooldown to prevent rapid re-recording glitches; a warm stream is
+    // never restarted, so it doesn't need one
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - last_recording_end_).count();
-    if (elapsed < MIN_RECORDING_INTERVAL_MS && last_recording_end_.time_since_epoch().count() > 0) {
+    if (!audio_->is_warm() && elapsed < MIN_RECORDING_INTERVAL_MS &&
+        last_recording_end_.time_since_epoch().count() > 0) {
         return;  // Too soon after last recording
     }
 
+    // Recording may start while earlier recordings are still being transcribed;
+    // the worker can move Transcribing -> Idle concurrently, so retry the swap
+    AppState current = state_.load();
+    do {
+        if (current == AppState::Recording) return;
+    } while (!state_.compare_exchange_weak(current, AppState::Recording));
+
     std::cout << "Recording..." << std::endl;
-    state_.store(AppState::Recording);
     update_tray_state(AppState::Recording);
+    pause_thread_tuning();
+
+    // Before the capture buffers are touched: an idle compaction may be freeing them
+    wake_model();
+    recording_started_ = std::chrono::steady_clock::now();
+
+    if (config_.long_form) {
+        LongFormConfig long_config;
+        long_config.sample_rate = config_.sample_rate;
+        long_config.overlap_ms = config_.long_form_overlap_ms;
+        long_config.silence_threshold = config_.silence_threshold;
+        long_session_ = std::make_shared<LongFormTranscriber>(worker_->transcriber(), long_config);
+        if (config_.audio_preprocessing) {
+            long_session_->set_audio_processor(
+                std::make_unique<AudioProcessor>(static_cast<float>(config_.sample_rate)));
+        }
+        if (typing_) {
+            // Type each chunk's text as soon as it is decoded
+            typer_ = std::make_shared<TextTyper>(KeyboardOutput::type_text, KeyboardOutput::erase);
+            long_session_->set_commit_callback([this, typer = typer_](const std::string& committed) {
+                type_partial(*typer, committed);
+            });
+        }
+        long_session_->begin();
+        active_long_.store(long_session_.get(), std::memory_order_release);
+    } else if (config_.streaming) {
+        StreamingConfig stream_config;
+        stream_config.sample_rate = config_.sample_rate;
+        stream_config.step_ms = config_.streaming_step_ms;
+        stream_config.holdback_ms = config_.streaming_holdback_ms;
+        stream_config.max_seconds = config_.max_recording_seconds;
+        stream_session_ = std::make_shared<StreamingTranscriber>(worker_->transcriber(), stream_config);
+        if (config_.audio_preprocessing) {
+            stream_session_->set_audio_processor(
+                std::make_unique<AudioProcessor>(static_cast<float>(config_.sample_rate)));
+        }
+        if (typing_) {
+            // Type committed segments as they are decoded
+            typer_ = std::make_shared<TextTyper>(KeyboardOutput::type_text, KeyboardOutput::erase);
+            stream_session_->set_commit_callback([this, typer = typer_](const std::string& committed) {
+                type_partial(*typer, committed);
+            });
+        }
+        stream_session_->begin();
+        active_stream_.store(stream_session_.get(), std::memory_order_release);
+    } else if (config_.trim_silence) {
+        // Find speech while recording so no VAD pass is left for after release
+        VadConfig vad_config;
+        vad_config.sample_rate = config_.sample_rate;
+        if (config_.enhanced_vad) {
+            vad_config.threshold = config_.silence_threshold * 1.5f;  // Slightly higher threshold for robustness
+        } else {
+            vad_config.threshold = config_.silence_threshold;
+        }
+        vad_config.min_speech_ms = config_.min_silence_ms;
+        vad_config.padding_ms = config_.vad_padding_ms;
+        vad_ = std::make_shared<StreamingVad>(vad_config, audio_->max_samples());
+    }
+    audio_->set_vad(vad_.get());
 
+    if (audio_processor_) {
+        audio_processor_->reset();  // Fresh filter state and stats for this recording
+    }
     audio_->start_recording();
 }
 
-void App::stop_recording() {
-    if (state_.load() != AppState::Recording) return;
+void App::stop_recording(std::chrono::steady_clock::time_point released) {
+    // Hands-free listening is Recording too, but only stop_continuous() ends it
+    if (state_.load() != AppState::Recording || continuous_.load()) return;
+
+    const uint64_t job = ++trace_job_;
+    Trace::set_job(job);
 
-    audio_->stop_recording();
-    state_.store(AppState::Transcribing);
+    // Waits for the callback, so no feed() is in flight afterwards
+    {
+        TraceSpan span(TraceStage::CaptureStop);
+        audio_->stop_recording();
+    }
+    audio_->set_vad(nullptr);
+    active_stream_.store(nullptr, std::memory_order_release);
+    active_long_.store(nullptr, std::memory_order_release);
+    last_recording_end_ = std::chrono::steady_clock::now();
+    note_activity(true);
+    const int64_t audio_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        last_recording_end_ - recording_started_).count() + config_.preroll_ms;
+
+    AppState expected = AppState::Recording;
+    state_.compare_exchange_strong(expected, AppState::Transcribing);
     update_tray_state(AppState::Transcribing);
 
+    TranscriptionWorker::Task task;
+    if (long_session_) {
+        // Every chunk but the last was decoded while the key was held
+        auto session = std::move(long_session_);
+        task = [session, job, submitted = std::chrono::steady_clock::now()](Transcriber&) {
+            Trace::set_job(job);
+            Trace::record(TraceStage::QueueWait, submitted, std::chrono::steady_clock::now());
+            return session->finish();
+        };
+    } else if (stream_session_) {
+        // Most of the recording was decoded while the key was held; only the tail remains
+        auto session = std::move(stream_session_);
+        task = [session, job, submitted = std::chrono::steady_clock::now()](Transcriber&) {
+            Trace::set_job(job);
+            Trace::record(TraceStage::QueueWait, submitted, std::chrono::steady_clock::now());
+            return session->finish();
+        };
+    } else {
+        auto audio_data = audio_->get_recorded_audio();
+        if (audio_data.empty()) {
+            std::cerr << "No audio recorded" << std::endl;
+            vad_.reset();
+            update_idle_state();
+            return;
+        }
+        // Snapshot the capture-time stats; the processor is reused by the next recording
+        AudioStats stats = audio_processor_ ? audio_processor_->stats() : AudioStats{};
+        task = [this, audio = std::move(audio_data), stats, vad = std::move(vad_), job,
+                submitted = std::chrono::steady_clock::now()](Transcriber& transcriber) mutable {
+            Trace::name_thread("transcription");
+            Trace::set_job(job);
+            Trace::record(TraceStage::QueueWait, submitted, std::chrono::steady_clock::now());
+            return transcribe_recording(transcriber, audio, stats, vad.get());
+        };
+    }
+
     std::cout << "Transcribing..." << std::endl;
 
-    // Get recorded audio
-    auto audio_data = audio_->get_recorded_audio();
+    outputs_in_flight_.fetch_add(1);
+    auto on_complete = [this, typer = std::move(typer_), released, job, audio_ms](const TranscriptionResult& result) {
+        Trace::set_job(job);
+        finish_transcription(result, typer.get(), released, audio_ms);
+    };
+    if (!worker_->submit(std::move(task), std::move(on_complete))) {
+        std::cerr << "Transcription queue full, dropping recording" << std::endl;
+        outputs_in_flight_.fetch_sub(1);
+        update_idle_state();
+    }
+}
 
-    if (audio_data.empty()) {
-        std::cerr << "No audio recorded" << std::endl;
-        state_.store(AppState::Idle);
-        update_tray_state(AppState::Idle);
+void App::set_continuous(bool continuous) {
+    std::lock_guard<std::mutex> lock(continuous_mutex_);
+    if (continuous) {
+        start_continuous();
+    } else {
+        stop_continuous();
+    }
+}
+
+void App::start_continuous() {
+    if (continuous_.load() || !audio_ || !worker_) return;
+
+    // Earlier recordings may still be transcribing; their text comes out first
+    AppState current = state_.load();
+    do {
+        if (current == AppState::Recording) {
+            std::cerr << "Finish the current recording before going hands-free" << std::endl;
+            return;
+        }
+    } while (!state_.compare_exchange_weak(current, AppState::Recording));
+
+    continuous_.store(true);
+    std::cout << "Hands-free dictation on: pause to send each utterance, press the hotkey to stop" << std::endl;
+    update_tray_state(AppState::Recording);
+    pause_thread_tuning();
+    update_tray_continuous(true);
+
+    // Before the capture buffers are touched: an idle compaction may be freeing them
+    wake_model();
+
+    ContinuousConfig continuous_config;
+    continuous_config.sample_rate = config_.sample_rate;
+    continuous_config.end_silence_ms = config_.continuous_end_silence_ms;
+    continuous_config.silence_threshold = config_.silence_threshold;
+    continuous_output_started_ = std::make_shared<bool>(false);
+    continuous_session_ = std::make_shared<ContinuousDictation>(continuous_config, [this](AudioChunk&& utterance) {
+        submit_utterance(std::move(utterance));
+    });
+    continuous_session_->begin();
+
+    // Capture never stops, so nothing is kept in the bounded recording buffer
+    audio_->set_vad(nullptr);
+    audio_->set_keep_audio(false);
+    if (audio_processor_) {
+        audio_processor_->reset();
+    }
+    active_continuous_.store(continuous_session_.get(), std::memory_order_release);
+    audio_->start_recording();
+}
+
+void App::stop_continuous() {
+    if (!continuous_.load()) return;
+
+    // Waits for the callback, so no feed() is in flight afterwards
+    if (audio_) {
+        audio_->stop_recording();
+        audio_->set_keep_audio(!config_.long_form);
+    }
+    active_continuous_.store(nullptr, std::memory_order_release);
+
+    // Submits what was said since the last pause
+    continuous_session_->end();
+    std::cout << "Hands-free dictation off (" << continuous_session_->utterances() << " utterance(s))" << std::endl;
+    continuous_session_.reset();
+    continuous_.store(false);
+
+    last_recording_end_ = std::chrono::steady_clock::now();
+    note_activity(true);
+
+    AppState expected = AppState::Recording;
+    if (state_.compare_exchange_strong(expected, AppState::Transcribing)) {
+        update_tray_state(AppState::Transcribing);
+    }
+    update_idle_state();
+    update_tray_continuous(false);
+}
+
+void App::submit_utterance(AudioChunk&& utterance) {
+    std::shared_ptr<ContinuousDictation> session = continuous_session_;
+    if (!enabled_.load()) {
+        session->recycle(std::move(utterance.samples));
         return;
     }
 
-    // Preprocess audio if enabled
+    const auto endpoint = std::chrono::steady_clock::now();
+    const uint64_t job = ++trace_job_;
+    Trace::set_job(job);
+    note_activity(true);
+    const int64_t audio_ms = static_cast<int64_t>(utterance.samples.size()) * 1000 / config_.sample_rate;
+    std::cout << "Utterance (" << audio_ms << "ms), transcribing..." << std::endl;
+
+    TranscriptionWorker::Task task = [this, session, audio = std::move(utterance.samples), job,
+                                      submitted = endpoint](Transcriber& transcriber) mutable {
+        Trace::name_thread("transcription");
+        Trace::set_job(job);
+        Trace::record(TraceStage::QueueWait, submitted, std::chrono::steady_clock::now());
+        // Capture filtered it already; gain stages use this utterance's own level
+        TranscriptionResult result = transcribe_recording(transcriber, audio, AudioProcessor::measure(audio), nullptr);
+        session->recycle(std::move(audio));
+        return result;
+    };
+
+    // Completions run one at a time in order, so the flag needs no lock
+    outputs_in_flight_.fetch_add(1);
+    auto on_complete = [this, started = continuous_output_started_, endpoint, job, audio_ms](const TranscriptionResult& result) {
+        Trace::set_job(job);
+        const bool output = result.success && !result.text.empty();
+        finish_transcription(result, nullptr, endpoint, audio_ms, output && *started);
+        if (output) *started = true;
+    };
+    if (!worker_->submit(std::move(task), std::move(on_complete))) {
+        std::cerr << "Transcription queue full, dropping utterance" << std::endl;
+        outputs_in_flight_.fetch_sub(1);
+    }
+}
+
+void App::set_quality(ModelQuality quality) {
+    if (!models_ || !worker_) return;
+
+    requested_quality_.store(quality);
+    if (quality == quality_.load()) return;
+
+    if (!models_->is_loaded(quality)) {
+        std::cout << "Loading " << get_profile(quality).name << " model in the background..." << std::endl;
+    }
+
+    // Runs right away when cached, otherwise on the model loader thread
+    models_->request(quality, [this, quality](std::shared_ptr<WhisperModel> model) {
+        if (!model) {
+            std::cerr << "Failed to switch to " << get_profile(quality).name << " model" << std::endl;
+            return;
+        }
+        if (requested_quality_.load() != quality) return;  // Superseded by a later switch
+
+        worker_->transcriber().set_model(std::move(model), get_profile(quality));
+        quality_.store(quality);
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            if (!waking_) residency_ = Residency::Loaded;
+            last_activity_ = std::chrono::steady_clock::now();
+        }
+        std::cout << "Quality switched to " << get_profile(quality).name << std::endl;
+        start_thread_tuning();
+
+        if (config_.preload_models) {
+            models_->preload_neighbor(quality);
+        }
+    });
+}
+
+void App::transcribe_for_client(std::shared_ptr<SharedAudio> audio, bool partials, IpcServer::Reply reply) {
+    // Decodes wait for the model if it was unloaded
+    wake_model();
+
+    auto task = [this, audio, partials, reply](Transcriber& transcriber) {
+        Trace::name_thread("transcription");
+        auto start_time = std::chrono::steady_clock::now();
+        Span<float> samples = audio->samples();
+
+        // The whole pipeline runs here: nothing was filtered during capture
+        if (config_.audio_preprocessing) {
+            AudioProcessor processor(static_cast<float>(config_.sample_rate));
+            processor.process(samples);
+        }
+
+        DecodeOptions options;
+        options.multi_segment = true;  // Segments carry the timestamps
+        options.log_result = false;
+        if (!partials) {
+            return transcriber.transcribe_with_profile(samples, transcriber.get_profile(), options);
+        }
+
+        // Partials: decode pause-cut chunks in order with the text so far as
+        // context, and reply after each one
+        options.process_text = false;
+        TranscriptionResult result;
+        result.success = true;
+        result.confidence = 0.0f;
+        double confidence_sum = 0.0;
+        size_t weight = 0;
+
+        ChunkerConfig chunk_config;
+        chunk_config.sample_rate = config_.sample_rate;
+        chunk_config.threshold = config_.silence_threshold;
+        SpeechChunker* chunker_ptr = nullptr;
+        SpeechChunker chunker(chunk_config, [&](AudioChunk&& chunk) {
+            if (chunk.has_speech && result.success) {
+                options.context = result.raw_text;
+                TranscriptionResult part = transcriber.transcribe_with_profile(chunk.samples, transcriber.get_profile(), options);
+                if (part.success) {
+                    const int64_t offset_ms = chunk.start_sample * 1000 / config_.sample_rate;
+                    for (const TranscriptionSegment& segment : part.segments) {
+                        result.segments.push_back({segment.t0_ms + offset_ms, segment.t1_ms + offset_ms, segment.text});
+                        result.raw_text += segment.text;
+                    }
+                    confidence_sum += static_cast<double>(part.confidence) * chunk.samples.size();
+                    weight += chunk.samples.size();
+                    reply(IpcServer::partial_json(transcriber.post_process_partial(result.raw_text)), false);
+                } else {
+                    result.success = false;
+                    result.error = part.error;
+                }
+            }
+            chunker_ptr->recycle(std::move(chunk.samples));
+        });
+        chunker_ptr = &chunker;
+        chunker.feed(samples);
+        chunker.finish();
+
+        size_t first = result.raw_text.find_first_not_of(" \t\n\r");
+        size_t last = result.raw_text.find_last_not_of(" \t\n\r");
+        result.raw_text = first == std::string::npos ? "" : result.raw_text.substr(first, last - first + 1);
+        result.text = transcriber.post_process(result.raw_text);
+        result.confidence = weight > 0 ? static_cast<float>(confidence_sum / static_cast<double>(weight)) : 0.0f;
+        result.duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time).count();
+        return result;
+    };
+    auto on_complete = [this, reply](const TranscriptionResult& result) {
+        reply(IpcServer::result_json(result), true);
+        note_activity();
+    };
+
+    // Same bounded queue as dictation: a full queue is reported, not waited on
+    if (!worker_->submit(std::move(task), std::move(on_complete))) {
+        reply(IpcServer::error_json("transcription queue full, try again"), true);
+    }
+}
+
+std::string App::ipc_status() const {
+    const char* state = "idle";
+    switch (state_.load()) {
+        case AppState::Recording: state = "recording"; break;
+        case AppState::Transcribing: state = "transcribing"; break;
+        case AppState::Error: state = "error"; break;
+        default: break;
+    }
+    std::shared_ptr<WhisperModel> model = worker_->transcriber().model();
+    const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - started_).count();
+
+    std::ostringstream out;
+    out << "\"state\":\"" << state << "\""
+        << ",\"quality\":" << IpcServer::quote(get_profile(quality_.load()).name)
+        << ",\"model\":" << IpcServer::quote(model ? model->path() : "")
+        << ",\"gpu\":" << (model && model->on_gpu() ? "true" : "false")
+        << ",\"model_mb\":" << (model ? model->memory_bytes() / (1024 * 1024) : 0)
+        << ",\"pending\":" << worker_->pending()
+        << ",\"requests\":" << (ipc_ ? ipc_->requests() : 0)
+        << ",\"hotkey\":" << (hotkey_ ? "true" : "false")
+        << ",\"uptime_s\":" << uptime;
+
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    const char* residency = waking_ ? "waking"
+        : residency_ == Residency::Compact ? "compact"
+        : residency_ == Residency::Unloaded ? "unloaded" : "loaded";
+    out << ",\"residency\":\"" << residency << "\""
+        << ",\"rss_mb\":" << resident_memory_bytes() / (1024 * 1024)
+        << ",\"last_wake_ms\":" << last_wake_ms_;
+    return out.str();
+}
+
+TranscriptionResult App::transcribe_recording(Transcriber& transcriber, std::vector<float>& audio_data,
+                                              const AudioStats& stats, StreamingVad* vad) {
+    TranscriptionResult result;
+    result.success = true;  // Nothing to transcribe is not a failure
+    result.confidence = 0.0f;
+    result.duration_ms = 0;
+
+    // High-pass and noise gate already ran during capture; apply AGC and
+    // normalization using the energy gathered there
+    float gain = 1.0f;
     if (audio_processor_) {
-        audio_processor_->process(audio_data);
-        audio_processor_->reset();  // Reset filter state for next recording
+        TraceSpan span(TraceStage::Preprocess);
+        gain = audio_processor_->finish(audio_data, stats);
     }
 
-    // Trim silence / extract speech for better accuracy
-    if (config_.trim_silence) {
+    // Trim silence / extract speech for better accuracy. The detector already
+    // ran during capture; thresholds apply to the final level, so pass the gain.
+    // Speech is compacted to the front of the capture buffer in place, so no
+    // intermediate copies are made.
+    if (vad) {
+        TraceSpan span(TraceStage::Vad);
+        std::vector<SampleRange> ranges;
         if (config_.enhanced_vad) {
             // Use enhanced VAD with multi-segment speech extraction
-            audio_data = AudioProcessor::extract_speech(
-                audio_data,
-                config_.silence_threshold * 1.5f,  // Slightly higher threshold for robustness
-                config_.min_silence_ms,
-                config_.vad_padding_ms,
-                config_.sample_rate
-            );
+            ranges = vad->segments(gain);
         } else {
             // Use simple start/end trimming
             int min_silence_samples = (config_.min_silence_ms * config_.sample_rate) / 1000;
-            audio_data = AudioProcessor::trim_silence(
-                audio_data,
-                config_.silence_threshold,
-                min_silence_samples,
-                config_.sample_rate
-            );
+            ranges.push_back(vad->speech_bounds(min_silence_samples, gain));
+        }
+
+        if (!ranges.empty()) {
+            audio_data.resize(AudioProcessor::compact(audio_data, ranges));  // Shrink only
         }
 
         if (audio_data.empty()) {
             std::cerr << "No speech detected in recording" << std::endl;
-            state_.store(AppState::Idle);
-            update_tray_state(AppState::Idle);
-            return;
+            return result;
         }
     }
 
     // Whisper requires minimum 100ms of audio - pad with silence if too short
+    // (the capture buffer is reserved for the full recording, so this never reallocates)
     int min_samples = config_.sample_rate / 10;  // 100ms
     if (static_cast<int>(audio_data.size()) < min_samples) {
         audio_data.resize(min_samples, 0.0f);  // Pad with silence
     }
 
     // Transcribe (use adaptive mode if enabled)
-    TranscriptionResult result;
     if (config_.adaptive_quality) {
-        result = transcriber_->transcribe_adaptive(audio_data);
-    } else {
-        result = transcriber_->transcribe(audio_data);
+        return transcriber.transcribe_adaptive(audio_data);
     }
+    return transcriber.transcribe(audio_data);
+}
 
+void App::finish_transcription(const TranscriptionResult& result, TextTyper* typer,
+                               std::chrono::steady_clock::time_point released, int64_t audio_ms,
+                               bool separate) {
     if (result.success && !result.text.empty()) {
-        on_transcription_complete(result.text);
+        on_transcription_complete(separate ? " " + result.text : result.text, typer);
+        auto done = std::chrono::steady_clock::now();
+        Trace::record(TraceStage::KeyToText, released, done);
+        auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(done - released);
+        std::cout << "Key-to-text latency: " << latency.count() << "ms" << std::endl;
+        record_history(result, audio_ms, latency.count());
     } else if (!result.success) {
         std::cerr << "Transcription failed: " << result.error << std::endl;
     }
 
-    // Record timestamp for cooldown check
-    last_recording_end_ = std::chrono::steady_clock::now();
+    outputs_in_flight_.fetch_sub(1);
+    update_idle_state();
+    note_activity();
+}
 
-    state_.store(AppState::Idle);
-    update_tray_state(AppState::Idle);
+void App::record_history(const TranscriptionResult& result, int64_t audio_ms, int64_t key_to_text_ms) {
+    if (!history_) return;
+
+    HistoryEntry entry;
+    entry.text = result.text;
+    entry.raw_text = result.raw_text;
+    entry.confidence = result.confidence;
+    entry.timings.audio_ms = static_cast<uint32_t>(std::max<int64_t>(audio_ms, 0));
+    entry.timings.decode_ms = static_cast<uint32_t>(std::max<int64_t>(result.duration_ms, 0));
+    entry.timings.key_to_text_ms = static_cast<uint32_t>(std::max<int64_t>(key_to_text_ms, 0));
+    if (!history_->append(entry)) {
+        std::cerr << "Failed to save history: " << history_->error() << std::endl;
+        return;
+    }
+    update_tray_history();
+}
+
+void App::reload_vocabulary() {
+    Transcriber& transcriber = worker_->transcriber();
+    VocabularyConfig vocab = VocabularyLoader::load_user_vocabulary();
+
+    std::lock_guard<std::mutex> lock(vocab_mutex_);
+    vocab_ = std::move(vocab);
+    // Unloaded while idle: no tokenizer to fit the prompt with; rebuilt on wake
+    if (!transcriber.model()) return;
+
+    std::string initial_prompt = config_.initial_prompt;
+    if (!vocab_.empty()) {
+        // The models share one tokenizer, so this budget holds across quality switches
+        initial_prompt = VocabularyLoader::build_initial_prompt(
+            vocab_, config_.initial_prompt, vocab_usage_,
+            [&transcriber](const std::string& text) { return transcriber.count_tokens(text); },
+            transcriber.max_prompt_tokens());
+        std::cout << "Initial prompt: " << transcriber.count_tokens(initial_prompt) << "/"
+                  << transcriber.max_prompt_tokens() << " tokens" << std::endl;
+    }
+    transcriber.set_initial_prompt(initial_prompt);
+}
+
+void App::queue_warm_up() {
+    // One per worker so each warms its own decode state, leaving room in the queue for recordings
+    const bool adaptive = config_.adaptive_quality;
+    const bool speculative = adaptive && config_.speculative_adaptive;
+    const size_t count = std::min<size_t>(std::max(config_.parallel_jobs, 1),
+                                          std::max(config_.max_queued_jobs - 1, 1));
+    for (size_t i = 0; i < count; ++i) {
+        auto task = [adaptive, speculative](Transcriber& transcriber) {
+            if (!adaptive) return transcriber.warm_up(transcriber.get_profile());
+
+            // Adaptive decodes start with the fast profile, and the retry's beam
+            // search allocates its own decoders. A speculative retry runs on a
+            // second state alongside, so both warm at once to lease two states.
+            TranscriptionResult accurate;
+            std::thread accurate_thread;
+            if (speculative) {
+                accurate_thread = std::thread([&]() { accurate = transcriber.warm_up(PROFILE_OPTIMIZED); });
+            }
+            TranscriptionResult result = transcriber.warm_up(PROFILE_FAST);
+            if (speculative) {
+                accurate_thread.join();
+            } else if (result.success) {
+                accurate = transcriber.warm_up(PROFILE_OPTIMIZED);
+            }
+            if (!result.success) return result;
+            if (!accurate.success) return accurate;
+            result.duration_ms = speculative ? std::max(result.duration_ms, accurate.duration_ms)
+                                             : result.duration_ms + accurate.duration_ms;
+            return result;
+        };
+        // Completions run in submission order, so the last one ends the warm-up
+        auto on_complete = [this, last = i + 1 == count](const TranscriptionResult& result) {
+            if (result.success) {
+                std::cout << "Warm-up decode took " << result.duration_ms << "ms" << std::endl;
+            } else {
+                std::cerr << "Warm-up decode failed: " << result.error << std::endl;
+            }
+            update_idle_state();
+            if (last) start_thread_tuning();
+        };
+        if (!worker_->submit(std::move(task), std::move(on_complete))) {
+            start_thread_tuning();
+            return;
+        }
+    }
+}
+
+void App::start_thread_tuning() {
+    if (!thread_tuner_) return;
+
+    std::lock_guard<std::mutex> lock(tune_mutex_);
+    if (tune_running_) {
+        tune_again_ = true;
+        return;
+    }
+    if (tune_thread_.joinable()) {
+        tune_thread_.join();  // Finished; it only exits after clearing tune_running_
+    }
+    tune_running_ = true;
+    tune_thread_ = std::thread([this]() { run_thread_tuning(); });
+}
+
+void App::run_thread_tuning() {
+    Transcriber& transcriber = worker_->transcriber();
+
+    while (!tune_cancel_.load()) {
+        // Every profile this model may decode with; stored ones are skipped,
+        // so after the first run this costs nothing
+        std::vector<TranscriptionProfile> profiles = {transcriber.get_profile()};
+        if (config_.adaptive_quality) {
+            profiles.push_back(PROFILE_FAST);
+            profiles.push_back(PROFILE_OPTIMIZED);
+        }
+
+        std::shared_ptr<WhisperModel> model = transcriber.model();
+        for (const auto& profile : profiles) {
+            if (tune_cancel_.load() || !model) break;
+            // Started by a model switch mid-recording: wait for idle
+            if (state_.load() != AppState::Idle) tune_paused_.store(true);
+            if (tune_paused_.load()) break;
+            // Cut short by a recording or another decode alongside: measured
+            // again at the next idle
+            if (thread_tuner_->lookup(model->path(), profile.name) == 0 &&
+                thread_tuner_->tune(transcriber, profile, &tune_paused_) == 0) {
+                tune_paused_.store(true);
+                break;
+            }
+        }
+
+        // Decided under the lock, so a switch request is never lost
+        std::lock_guard<std::mutex> lock(tune_mutex_);
+        if (!tune_again_) {
+            tune_running_ = false;
+            return;
+        }
+        tune_again_ = false;
+    }
+
+    std::lock_guard<std::mutex> lock(tune_mutex_);
+    tune_running_ = false;
+}
+
+void App::pause_thread_tuning() {
+    if (thread_tuner_) tune_paused_.store(true);
+}
+
+void App::resume_thread_tuning() {
+    // Profiles already measured are skipped, so this only finishes what was cut off
+    if (thread_tuner_ && !tune_cancel_.load() && tune_paused_.exchange(false)) {
+        start_thread_tuning();
+    }
+}
+
+void App::note_activity(bool recording_stopped) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    last_activity_ = std::chrono::steady_clock::now();
+    if (recording_stopped) last_stop_ = last_activity_;
 }
 
-void App::on_transcription_complete(const std::string& text) {
-    // Add to history for menu bar display
-    add_to_history(text);
+void App::idle_loop() {
+    using std::chrono::minutes;
+    const auto check_interval = std::chrono::seconds(15);
+
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    while (!should_quit_.load()) {
+        idle_cv_.wait_for(lock, check_interval);
+        if (should_quit_.load()) break;
+
+        // Only truly idle: nothing recording, queued or being tuned
+        if (waking_ || state_.load() != AppState::Idle || worker_->pending() > 0) continue;
+        {
+            std::lock_guard<std::mutex> tune_lock(tune_mutex_);
+            if (tune_running_) continue;
+        }
+
+        const auto idle = std::chrono::steady_clock::now() - last_activity_;
+        if (residency_ != Residency::Unloaded && config_.idle_unload_minutes > 0 &&
+            idle >= minutes(config_.idle_unload_minutes)) {
+            // Held across the unload so a hotkey press waits for it and then wakes
+            unload_idle();
+        } else if (residency_ == Residency::Loaded && config_.idle_compact_minutes > 0 &&
+                   idle >= minutes(config_.idle_compact_minutes)) {
+            compact_idle();
+        }
+    }
+}
+
+void App::compact_idle() {
+    const uint64_t before = resident_memory_bytes();
+    const size_t states = models_->trim_states();
+    if (audio_) audio_->release_buffers();
+    release_free_memory();
+    residency_ = Residency::Compact;
+
+    std::cout << "Idle " << config_.idle_compact_minutes << " min: freed " << states
+              << " decode state(s) and capture buffers, RSS " << before / (1024 * 1024) << " -> "
+              << resident_memory_bytes() / (1024 * 1024) << " MB" << std::endl;
+}
+
+void App::unload_idle() {
+    const uint64_t before = resident_memory_bytes();
+    worker_->transcriber().release_model();
+    models_->unload_all();
+    if (audio_) audio_->release_buffers();
+    release_free_memory();
+    residency_ = Residency::Unloaded;
+
+    std::cout << "Idle " << config_.idle_unload_minutes << " min: model unloaded, RSS "
+              << before / (1024 * 1024) << " -> " << resident_memory_bytes() / (1024 * 1024) << " MB" << std::endl;
+}
+
+void App::wake_model() {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    last_activity_ = std::chrono::steady_clock::now();
+    if (residency_ == Residency::Loaded || waking_) return;
+
+    const bool reload = residency_ == Residency::Unloaded;
+    waking_ = true;
+    wake_started_ = last_activity_;
+    if (reload) {
+        // Decodes started meanwhile (streaming, the release) wait for it
+        worker_->transcriber().expect_model(true);
+    }
+    std::cout << (reload ? "Reloading model..." : "Allocating decode state...") << std::endl;
+    models_->wake(quality_.load(), [this, reload](std::shared_ptr<WhisperModel> model) {
+        finish_wake(std::move(model), reload);
+    });
+}
+
+void App::finish_wake(std::shared_ptr<WhisperModel> model, bool reloaded) {
+    Transcriber& transcriber = worker_->transcriber();
+    if (reloaded) {
+        if (model) {
+            transcriber.set_model(model, transcriber.get_profile());
+            reload_vocabulary();  // Skipped while there was no tokenizer
+        } else {
+            transcriber.expect_model(false);  // Waiting decodes fail instead of hanging
+        }
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    Trace::record(TraceStage::ModelWake, wake_started_, now);
+    waking_ = false;
+    if (!model) {
+        std::cerr << "Failed to wake the model" << std::endl;
+        return;
+    }
+    residency_ = Residency::Loaded;
+    last_activity_ = now;
+    last_wake_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(now - wake_started_).count();
+
+    // Whatever finished before the user stopped talking was hidden
+    std::cout << "Model awake in " << last_wake_ms_ << "ms (";
+    if (last_stop_ > wake_started_) {
+        std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(now - last_stop_).count()
+                  << "ms after release";
+    } else {
+        std::cout << "hidden behind recording";
+    }
+    std::cout << ", RSS " << resident_memory_bytes() / (1024 * 1024) << " MB)" << std::endl;
+}
+
+void App::update_idle_state() {
+    // Never override Recording: a new recording may have started meanwhile
+    AppState next = worker_->pending() > 0 ? AppState::Transcribing : AppState::Idle;
+    AppState current = state_.load();
+    while (current != AppState::Recording && current != next) {
+        if (state_.compare_exchange_weak(current, next)) {
+            update_tray_state(next);
+            break;
+        }
+    }
+    if (state_.load() == AppState::Idle) resume_thread_tuning();
+}
+
+void App::type_partial(TextTyper& typer, const std::string& committed_text) {
+    // Text from earlier recordings must land first; this one then types at the end
+    if (!typer.started() && outputs_in_flight_.load() > 0) return;
+    if (!worker_) return;
+    // The hotkey is still held; a backend that can't type past it catches up on release
+    if (!KeyboardOutput::ignores_held_keys() && state_.load() == AppState::Recording) return;
+
+    typer.update(worker_->transcriber().post_process_partial(committed_text));
+}
+
+void App::on_transcription_complete(const std::string& text, TextTyper* typer) {
+    {
+        // Most dictated terms win the prompt budget next time it is built
+        std::lock_guard<std::mutex> lock(vocab_mutex_);
+        VocabularyLoader::count_usage(vocab_, text, vocab_usage_);
+    }
+
+    if (typing_) {
+        TextTyper fresh(KeyboardOutput::type_text, KeyboardOutput::erase);
+        TextTyper& output = typer ? *typer : fresh;
+        // Usually only the uncommitted tail is left to type
+        bool typed_all;
+        {
+            TraceSpan span(TraceStage::Type);
+            typed_all = output.update(text);
+        }
+        if (typed_all) return;
+
+        // Some characters can't be typed by this backend; paste the rest
+        const std::string& typed = output.typed();
+        if (text.compare(0, typed.size(), typed) == 0 && Clipboard::set_text(text.substr(typed.size()))) {
+            Clipboard::paste();
+        } else {
+            std::cerr << "Failed to type transcription" << std::endl;
+        }
+        return;
+    }
 
     if (config_.auto_paste) {
         // Set clipboard and paste
-        if (Clipboard::set_text(text)) {
-            // Delay to ensure clipboard is fully set before pasting
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // set_text returns once the contents are being served, so no delay is needed
+        bool copied;
+        {
+            TraceSpan span(TraceStage::ClipboardSet);
+            copied = Clipboard::set_text(text);
+        }
+        if (copied) {
+            TraceSpan span(TraceStage::Paste);
             Clipboard::paste();
         } else {
             std::cerr << "Failed to set clipboard" << std::endl;
@@ -1,13 +1,18 @@
 #include "audio_capture.hpp"
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <thread>
 
 namespace whispr {
 
-AudioCapture::AudioCapture(int sample_rate, int channels, int frames_per_buffer)
+AudioCapture::AudioCapture(int sample_rate, int channels, int frames_per_buffer,
+                           int max_recording_seconds, int preroll_ms)
     : sample_rate_(sample_rate)
     , channels_(channels)
-    , frames_per_buffer_(frames_per_buffer) {
+    , frames_per_buffer_(frames_per_buffer)
+    , max_samples_(static_cast<size_t>(sample_rate) * max_recording_seconds)
+    , preroll_samples_(static_cast<size_t>(std::max(preroll_ms, 0)) * sample_rate / 1000) {
 }
 
 AudioCapture::~AudioCapture() {
@@ -17,6 +22,14 @@ AudioCapture::~AudioCapture() {
 bool AudioCapture::initialize() {
     if (initialized_.load()) return true;
 
+    // Allocate everything up front so the audio thread never touches the heap
+    ring_.allocate(max_samples());
+    recorded_.reserve(max_samples());
+    scratch_.resize(static_cast<size_t>(std::max(frames_per_buffer_, 512)));
+    preroll_.assign(preroll_samples_, 0.0f);
+    preroll_pos_ = 0;
+    preroll_fill_ = 0;
+
     PaError err = Pa_Initialize();
     if (err != paNoError) {
         std::cerr << "PortAudio init failed: " << Pa_GetErrorText(err) << std::endl;
@@ -52,6 +65,20 @@ bool AudioCapture::initialize() {
         return false;
     }
 
+    if (is_warm()) {
+        // Runs for the app's lifetime; idle callbacks only copy into the pre-roll
+        err = Pa_StartStream(stream_);
+        if (err != paNoError) {
+            std::cerr << "Failed to start stream: " << Pa_GetErrorText(err) << std::endl;
+            Pa_CloseStream(stream_);
+            stream_ = nullptr;
+            Pa_Terminate();
+            return false;
+        }
+        std::cout << "Audio input kept open for " << (preroll_samples_ * 1000 / sample_rate_)
+                  << "ms pre-roll" << std::endl;
+    }
+
     initialized_.store(true);
     return true;
 }
@@ -62,6 +89,9 @@ void AudioCapture::shutdown() {
     stop_recording();
 
     if (stream_) {
+        if (is_warm()) {
+            Pa_StopStream(stream_);
+        }
         Pa_CloseStream(stream_);
         stream_ = nullptr;
     }
@@ -73,8 +103,19 @@ void AudioCapture::shutdown() {
 bool AudioCapture::start_recording() {
     if (!initialized_.load() || recording_.load()) return false;
 
+    if (buffers_released_) {
+        // The audio thread only writes the ring while recording, so this is safe with a warm stream
+        ring_.allocate(max_samples());
+        buffers_released_ = false;
+    }
     clear_buffer();
 
+    if (is_warm()) {
+        // Already streaming; the next callback prepends the pre-roll
+        recording_.store(true);
+        return true;
+    }
+
     PaError err = Pa_StartStream(stream_);
     if (err != paNoError) {
         std::cerr << "Failed to start stream: " << Pa_GetErrorText(err) << std::endl;
@@ -90,6 +131,15 @@ bool AudioCapture::stop_recording() {
 
     recording_.store(false);
 
+    if (is_warm()) {
+        // A callback that saw recording_ set may still be writing; it's at most
+        // one buffer of work, and the caller reads the ring right after this
+        while (in_callback_.load()) {
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
     PaError err = Pa_StopStream(stream_);
     if (err != paNoError) {
         std::cerr << "Failed to stop stream: " << Pa_GetErrorText(err) << std::endl;
@@ -100,14 +150,41 @@ bool AudioCapture::stop_recording() {
 }
 
 std::vector<float> AudioCapture::get_recorded_audio() {
-    std::lock_guard<std::mutex> lock(buffer_mutex_);
-    return audio_buffer_;
+    // Single memcpy out of the ring into the preallocated vector, then move it out
+    size_t available = ring_.read_available();
+    recorded_.resize(available);
+    ring_.read(recorded_.data(), available);
+
+    if (dropped_samples_.load() > 0) {
+        std::cerr << "Recording exceeded buffer, dropped " << dropped_samples_.load()
+                  << " samples" << std::endl;
+    }
+    if (overflow_count_.load() > 0) {
+        std::cerr << "Audio input overflowed " << overflow_count_.load() << " time(s)" << std::endl;
+    }
+
+    return std::move(recorded_);
 }
 
 void AudioCapture::clear_buffer() {
-    std::lock_guard<std::mutex> lock(buffer_mutex_);
-    audio_buffer_.clear();
-    audio_buffer_.reserve(sample_rate_ * 30);  // Reserve for 30 seconds
+    // Only called while the audio thread is not recording
+    ring_.reset();
+    dropped_samples_.store(0);
+    overflow_count_.store(0);
+
+    // Replace the buffer handed out by the last get_recorded_audio()
+    recorded_.clear();
+    if (keep_audio_) {
+        recorded_.reserve(max_samples_);
+    }
+}
+
+void AudioCapture::release_buffers() {
+    if (recording_.load() || buffers_released_) return;
+
+    ring_.allocate(0);
+    std::vector<float>().swap(recorded_);
+    buffers_released_ = true;
 }
 
 int AudioCapture::pa_callback(const void* input, void* output,
@@ -117,24 +194,96 @@ int AudioCapture::pa_callback(const void* input, void* output,
                               void* user_data) {
     (void)output;
     (void)time_info;
-    (void)status_flags;
 
+    // Real-time thread: no locks, no allocation
     auto* capture = static_cast<AudioCapture*>(user_data);
-    if (!capture->recording_.load()) return paContinue;
+    if (!input) return paContinue;
 
     const float* in = static_cast<const float*>(input);
 
-    {
-        std::lock_guard<std::mutex> lock(capture->buffer_mutex_);
-        capture->audio_buffer_.insert(capture->audio_buffer_.end(), in, in + frame_count);
+    // Pairs with stop_recording(): either it sees us busy, or we see it stopped
+    capture->in_callback_.store(true);
+    if (!capture->recording_.load()) {
+        capture->in_callback_.store(false, std::memory_order_release);
+        capture->was_recording_ = false;
+        // Idle with a warm stream: no processing, just remember the latest audio
+        capture->remember(in, frame_count);
+        return paContinue;
     }
 
-    if (capture->callback_) {
-        std::vector<float> chunk(in, in + frame_count);
-        capture->callback_(chunk);
+    if (status_flags & paInputOverflow) {
+        capture->overflow_count_.fetch_add(1, std::memory_order_relaxed);
     }
 
+    if (!capture->was_recording_) {
+        capture->was_recording_ = true;
+        capture->flush_preroll();
+    }
+    capture->capture(in, frame_count);
+
+    capture->in_callback_.store(false, std::memory_order_release);
     return paContinue;
 }
 
+void AudioCapture::capture(const float* samples, size_t count) {
+    if (!processor_) {
+        deliver(samples, count);
+        return;
+    }
+
+    // PortAudio may hand us more frames than requested; filter in scratch-sized chunks
+    size_t offset = 0;
+    while (offset < count) {
+        size_t n = std::min(scratch_.size(), count - offset);
+        std::memcpy(scratch_.data(), samples + offset, n * sizeof(float));
+        Span<float> block(scratch_.data(), n);
+        processor_->process_block(block);
+        deliver(block.data(), n);
+        offset += n;
+    }
+}
+
+void AudioCapture::remember(const float* samples, size_t count) {
+    if (preroll_samples_ == 0) return;
+
+    if (count >= preroll_samples_) {
+        samples += count - preroll_samples_;
+        count = preroll_samples_;
+    }
+    size_t first = std::min(count, preroll_samples_ - preroll_pos_);
+    std::memcpy(preroll_.data() + preroll_pos_, samples, first * sizeof(float));
+    std::memcpy(preroll_.data(), samples + first, (count - first) * sizeof(float));
+
+    preroll_pos_ = (preroll_pos_ + count) % preroll_samples_;
+    preroll_fill_ = std::min(preroll_fill_ + count, preroll_samples_);
+}
+
+void AudioCapture::flush_preroll() {
+    if (preroll_fill_ == 0) return;
+
+    // Oldest sample sits at the write position once the ring has wrapped
+    if (preroll_fill_ < preroll_samples_) {
+        capture(preroll_.data(), preroll_fill_);
+    } else {
+        capture(preroll_.data() + preroll_pos_, preroll_samples_ - preroll_pos_);
+        capture(preroll_.data(), preroll_pos_);
+    }
+    preroll_pos_ = 0;
+    preroll_fill_ = 0;
+}
+
+void AudioCapture::deliver(const float* samples, size_t count) {
+    size_t written = keep_audio_ ? ring_.write(samples, count) : count;
+    if (written < count) {
+        dropped_samples_.fetch_add(count - written, std::memory_order_relaxed);
+    }
+    if (vad_) {
+        vad_->feed(Span<const float>(samples, written));  // Exactly what was recorded
+    }
+
+    if (callback_) {
+        callback_(Span<const float>(samples, count));
+    }
+}
+
 } // namespace whispr
@@ -1,6 +1,14 @@
 #include "audio_processor.hpp"
+#include "streaming_vad.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -8,16 +16,188 @@
 
 namespace whispr {
 
+// Vectorized kernels for the gain stages. Each lane performs exactly the same
+// float operations as the scalar fallback, so results are bit-identical.
+namespace {
+
+constexpr float AGC_CLIP_LEVEL = 0.9f;
+
+inline float agc_sample(float sample, float gain) {
+    sample *= gain;
+    // Soft clip using tanh for natural compression
+    if (std::abs(sample) > AGC_CLIP_LEVEL) {
+        sample = AGC_CLIP_LEVEL * std::tanh(sample / AGC_CLIP_LEVEL);
+    }
+    return sample;
+}
+
+inline float clip_sample(float sample, float gain) {
+    sample *= gain;
+    if (sample > 1.0f) sample = 1.0f;
+    if (sample < -1.0f) sample = -1.0f;
+    return sample;
+}
+
+// Apply AGC gain with soft clipping in place; returns the peak of the output
+float agc_apply(float* data, size_t n, float gain) {
+    size_t i = 0;
+    float peak = 0.0f;
+
+#if defined(__AVX__)
+    const __m256 v_gain = _mm256_set1_ps(gain);
+    const __m256 v_clip = _mm256_set1_ps(AGC_CLIP_LEVEL);
+    const __m256 v_abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 v_peak = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        __m256 y = _mm256_mul_ps(_mm256_loadu_ps(data + i), v_gain);
+        __m256 a = _mm256_and_ps(y, v_abs);
+        if (_mm256_movemask_ps(_mm256_cmp_ps(a, v_clip, _CMP_GT_OQ)) != 0) {
+            // Rare: at least one lane needs tanh, finish this block in scalar
+            for (size_t j = i; j < i + 8; ++j) {
+                data[j] = agc_sample(data[j], gain);
+                peak = std::max(peak, std::abs(data[j]));
+            }
+            continue;
+        }
+        _mm256_storeu_ps(data + i, y);
+        v_peak = _mm256_max_ps(v_peak, a);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, v_peak);
+    for (float lane : lanes) peak = std::max(peak, lane);
+#elif defined(__SSE2__)
+    const __m128 v_gain = _mm_set1_ps(gain);
+    const __m128 v_clip = _mm_set1_ps(AGC_CLIP_LEVEL);
+    const __m128 v_abs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 v_peak = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 y = _mm_mul_ps(_mm_loadu_ps(data + i), v_gain);
+        __m128 a = _mm_and_ps(y, v_abs);
+        if (_mm_movemask_ps(_mm_cmpgt_ps(a, v_clip)) != 0) {
+            for (size_t j = i; j < i + 4; ++j) {
+                data[j] = agc_sample(data[j], gain);
+                peak = std::max(peak, std::abs(data[j]));
+            }
+            continue;
+        }
+        _mm_storeu_ps(data + i, y);
+        v_peak = _mm_max_ps(v_peak, a);
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, v_peak);
+    for (float lane : lanes) peak = std::max(peak, lane);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t v_gain = vdupq_n_f32(gain);
+    const float32x4_t v_clip = vdupq_n_f32(AGC_CLIP_LEVEL);
+    float32x4_t v_peak = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t y = vmulq_f32(vld1q_f32(data + i), v_gain);
+        float32x4_t a = vabsq_f32(y);
+        if (vmaxvq_u32(vcgtq_f32(a, v_clip)) != 0) {
+            for (size_t j = i; j < i + 4; ++j) {
+                data[j] = agc_sample(data[j], gain);
+                peak = std::max(peak, std::abs(data[j]));
+            }
+            continue;
+        }
+        vst1q_f32(data + i, y);
+        v_peak = vmaxq_f32(v_peak, a);
+    }
+    peak = std::max(peak, vmaxvq_f32(v_peak));
+#endif
+
+    for (; i < n; ++i) {
+        data[i] = agc_sample(data[i], gain);
+        peak = std::max(peak, std::abs(data[i]));
+    }
+    return peak;
+}
+
+float peak_abs(const float* data, size_t n) {
+    size_t i = 0;
+    float peak = 0.0f;
+
+#if defined(__AVX__)
+    const __m256 v_abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 v_peak = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        v_peak = _mm256_max_ps(v_peak, _mm256_and_ps(_mm256_loadu_ps(data + i), v_abs));
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, v_peak);
+    for (float lane : lanes) peak = std::max(peak, lane);
+#elif defined(__SSE2__)
+    const __m128 v_abs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 v_peak = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        v_peak = _mm_max_ps(v_peak, _mm_and_ps(_mm_loadu_ps(data + i), v_abs));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, v_peak);
+    for (float lane : lanes) peak = std::max(peak, lane);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float32x4_t v_peak = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        v_peak = vmaxq_f32(v_peak, vabsq_f32(vld1q_f32(data + i)));
+    }
+    peak = vmaxvq_f32(v_peak);
+#endif
+
+    for (; i < n; ++i) {
+        peak = std::max(peak, std::abs(data[i]));
+    }
+    return peak;
+}
+
+// Multiply by gain and hard-limit to [-1, 1] in place
+void gain_clip(float* data, size_t n, float gain) {
+    size_t i = 0;
+
+#if defined(__AVX__)
+    const __m256 v_gain = _mm256_set1_ps(gain);
+    const __m256 v_hi = _mm256_set1_ps(1.0f);
+    const __m256 v_lo = _mm256_set1_ps(-1.0f);
+    for (; i + 8 <= n; i += 8) {
+        __m256 y = _mm256_mul_ps(_mm256_loadu_ps(data + i), v_gain);
+        _mm256_storeu_ps(data + i, _mm256_max_ps(_mm256_min_ps(y, v_hi), v_lo));
+    }
+#elif defined(__SSE2__)
+    const __m128 v_gain = _mm_set1_ps(gain);
+    const __m128 v_hi = _mm_set1_ps(1.0f);
+    const __m128 v_lo = _mm_set1_ps(-1.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 y = _mm_mul_ps(_mm_loadu_ps(data + i), v_gain);
+        _mm_storeu_ps(data + i, _mm_max_ps(_mm_min_ps(y, v_hi), v_lo));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t v_gain = vdupq_n_f32(gain);
+    const float32x4_t v_hi = vdupq_n_f32(1.0f);
+    const float32x4_t v_lo = vdupq_n_f32(-1.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t y = vmulq_f32(vld1q_f32(data + i), v_gain);
+        vst1q_f32(data + i, vmaxq_f32(vminq_f32(y, v_hi), v_lo));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        data[i] = clip_sample(data[i], gain);
+    }
+}
+
+} // namespace
+
 AudioProcessor::AudioProcessor(float sample_rate)
     : config_()
     , sample_rate_(sample_rate) {
     design_highpass_filter();
+    design_noise_gate();
 }
 
 AudioProcessor::AudioProcessor(float sample_rate, const Config& config)
     : config_(config)
     , sample_rate_(sample_rate) {
     design_highpass_filter();
+    design_noise_gate();
 }
 
 void AudioProcessor::design_highpass_filter() {
@@ -35,35 +215,115 @@ void AudioProcessor::design_highpass_filter() {
     a2_ = (1.0f - alpha) / a0;
 }
 
+void AudioProcessor::design_noise_gate() {
+    // Envelope follower coefficients (computed once, not per call)
+    attack_coef_ = 1.0f - std::exp(-1.0f / (config_.noise_gate_attack * sample_rate_));
+    release_coef_ = 1.0f - std::exp(-1.0f / (config_.noise_gate_release * sample_rate_));
+}
+
 void AudioProcessor::reset() {
     x1_ = x2_ = y1_ = y2_ = 0.0f;
     gate_env_ = 0.0f;
+    stats_ = AudioStats{};
     design_highpass_filter();
+    design_noise_gate();
 }
 
-void AudioProcessor::process(std::vector<float>& audio) {
+void AudioProcessor::process(Span<float> audio) {
     if (audio.empty()) return;
 
-    // Apply processing in order
-    if (config_.enable_highpass) {
-        apply_highpass(audio);
+    // Stats cover this buffer only; filter state carries over as before
+    stats_ = AudioStats{};
+    process_block(audio);
+    finish(audio);
+}
+
+void AudioProcessor::process_block(Span<float> audio) {
+    const bool highpass = config_.enable_highpass;
+    const bool gate = config_.enable_noise_gate;
+    const float threshold = config_.noise_gate_threshold;
+
+    // Both stages are recursive, so they run sample by sample; fusing them keeps
+    // the data in registers and gathers the AGC energy in the same pass
+    float x1 = x1_, x2 = x2_, y1 = y1_, y2 = y2_;
+    float env = gate_env_;
+    float sum_sq = stats_.sum_sq;
+
+    for (size_t i = 0; i < audio.size(); ++i) {
+        float sample = audio[i];
+
+        if (highpass) {
+            float y0 = b0_ * sample + b1_ * x1 + b2_ * x2 - a1_ * y1 - a2_ * y2;
+            x2 = x1;
+            x1 = sample;
+            y2 = y1;
+            y1 = y0;
+            sample = y0;
+        }
+
+        if (gate) {
+            float abs_sample = std::abs(sample);
+            if (abs_sample > env) {
+                env += attack_coef_ * (abs_sample - env);
+            } else {
+                env += release_coef_ * (abs_sample - env);
+            }
+            if (env < threshold) {
+                // Soft knee: gradual attenuation instead of hard cut
+                float ratio = env / threshold;
+                sample *= ratio * ratio;  // Quadratic rolloff
+            }
+        }
+
+        audio[i] = sample;
+        sum_sq += sample * sample;
     }
 
-    if (config_.enable_noise_gate) {
-        apply_noise_gate(audio);
+    x1_ = x1; x2_ = x2; y1_ = y1; y2_ = y2;
+    gate_env_ = env;
+    stats_.sum_sq = sum_sq;
+    stats_.count += audio.size();
+}
+
+AudioStats AudioProcessor::measure(Span<const float> audio) {
+    AudioStats stats;
+    for (float sample : audio) {
+        stats.sum_sq += sample * sample;
     }
+    stats.count = audio.size();
+    return stats;
+}
+
+float AudioProcessor::finish(Span<float> audio, const AudioStats& stats) const {
+    if (audio.empty()) return 1.0f;
+
+    // Peak of the AGC output falls out of the AGC pass; -1 means "not known yet".
+    // (The tanh soft clip is discontinuous at the clip level, so the peak can't be
+    // derived from the input peak.)
+    float peak = -1.0f;
+    float total_gain = 1.0f;
 
     // Apply AGC before normalization for consistent levels
-    if (config_.enable_agc) {
-        apply_agc(audio);
+    if (config_.enable_agc && stats.count > 0) {
+        float rms = std::sqrt(stats.sum_sq / stats.count);
+        float gain = agc_gain(rms);
+        if (gain > 0.0f) {
+            peak = agc_apply(audio.data(), audio.size(), gain);
+            total_gain *= gain;
+        }
     }
 
     if (config_.enable_normalization) {
-        apply_normalization(audio);
+        if (peak < 0.0f) {
+            peak = peak_abs(audio.data(), audio.size());
+        }
+        total_gain *= normalize(audio, peak);
     }
+
+    return total_gain;
 }
 
-void AudioProcessor::apply_highpass(std::vector<float>& audio) {
+void AudioProcessor::apply_highpass(Span<float> audio) {
     // Apply biquad filter: y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
     for (size_t i = 0; i < audio.size(); ++i) {
         float x0 = audio[i];
@@ -79,19 +339,16 @@ void AudioProcessor::apply_highpass(std::vector<float>& audio) {
     }
 }
 
-void AudioProcessor::apply_noise_gate(std::vector<float>& audio) {
+void AudioProcessor::apply_noise_gate(Span<float> audio) {
     // Envelope follower with attack/release for smooth gating
-    float attack_coef = 1.0f - std::exp(-1.0f / (config_.noise_gate_attack * sample_rate_));
-    float release_coef = 1.0f - std::exp(-1.0f / (config_.noise_gate_release * sample_rate_));
-
     for (size_t i = 0; i < audio.size(); ++i) {
         float abs_sample = std::abs(audio[i]);
 
         // Envelope follower
         if (abs_sample > gate_env_) {
-            gate_env_ += attack_coef * (abs_sample - gate_env_);
+            gate_env_ += attack_coef_ * (abs_sample - gate_env_);
         } else {
-            gate_env_ += release_coef * (abs_sample - gate_env_);
+            gate_env_ += release_coef_ * (abs_sample - gate_env_);
         }
 
         // Gate: if envelope below threshold, attenuate
@@ -103,20 +360,14 @@ void AudioProcessor::apply_noise_gate(std::vector<float>& audio) {
     }
 }
 
-void AudioProcessor::apply_normalization(std::vector<float>& audio) {
+void AudioProcessor::apply_normalization(Span<float> audio) {
     if (audio.empty()) return;
+    normalize(audio, peak_abs(audio.data(), audio.size()));
+}
 
-    // Find peak
-    float peak = 0.0f;
-    for (float sample : audio) {
-        float abs_sample = std::abs(sample);
-        if (abs_sample > peak) {
-            peak = abs_sample;
-        }
-    }
-
+float AudioProcessor::normalize(Span<float> audio, float peak) const {
     // Avoid division by zero and don't amplify very quiet signals
-    if (peak < 0.001f) return;  // -60dB threshold
+    if (peak < 0.001f) return 1.0f;  // -60dB threshold
 
     // Calculate gain to reach target peak
     float gain = config_.target_peak / peak;
@@ -124,57 +375,48 @@ void AudioProcessor::apply_normalization(std::vector<float>& audio) {
     // Limit gain to avoid excessive amplification of quiet recordings
     gain = std::min(gain, 10.0f);  // Max 20dB boost
 
-    // Apply gain
-    for (float& sample : audio) {
-        sample *= gain;
-        // Soft clip to prevent any possibility of clipping
-        if (sample > 1.0f) sample = 1.0f;
-        if (sample < -1.0f) sample = -1.0f;
-    }
+    // Apply gain, clipping to prevent any possibility of clipping
+    gain_clip(audio.data(), audio.size(), gain);
+    return gain;
 }
 
-void AudioProcessor::apply_agc(std::vector<float>& audio) {
+void AudioProcessor::apply_agc(Span<float> audio) {
     if (audio.empty()) return;
 
     // Calculate current RMS level
-    float sum_sq = 0.0f;
-    for (float sample : audio) {
-        sum_sq += sample * sample;
+    float rms = std::sqrt(measure(audio).sum_sq / audio.size());
+    float gain = agc_gain(rms);
+    if (gain > 0.0f) {
+        agc_apply(audio.data(), audio.size(), gain);
     }
-    float rms = std::sqrt(sum_sq / audio.size());
+}
 
+float AudioProcessor::agc_gain(float rms) const {
     // Avoid division by zero
-    if (rms < 0.0001f) return;  // Too quiet to process
+    if (rms < 0.0001f) return 0.0f;  // Too quiet to process
 
     // Calculate gain needed to reach target RMS
     float gain = config_.agc_target_rms / rms;
 
     // Clamp gain to configured limits
-    gain = std::max(config_.agc_min_gain, std::min(gain, config_.agc_max_gain));
-
-    // Apply gain with soft clipping
-    for (float& sample : audio) {
-        sample *= gain;
-        // Soft clip using tanh for natural compression
-        if (std::abs(sample) > 0.9f) {
-            sample = 0.9f * std::tanh(sample / 0.9f);
-        }
-    }
+    return std::max(config_.agc_min_gain, std::min(gain, config_.agc_max_gain));
 }
 
-std::vector<float> AudioProcessor::trim_silence(const std::vector<float>& audio,
-                                                  float threshold,
-                                                  int min_silence_samples,
-                                                  int sample_rate) {
-    if (audio.empty()) return audio;
+SampleRange AudioProcessor::find_speech_bounds(Span<const float> audio,
+                                               float threshold,
+                                               int min_silence_samples,
+                                               int sample_rate) {
+    const SampleRange whole{0, audio.size()};
+    if (audio.empty()) return whole;
 
     // Use a sliding window to detect voice activity
-    int window_size = sample_rate / 100;  // 10ms window
+    size_t window_size = static_cast<size_t>(sample_rate / 100);  // 10ms window
     if (window_size < 1) window_size = 1;
+    const size_t hop = window_size / 2 > 0 ? window_size / 2 : 1;
 
     // Find start of speech (first window above threshold)
     size_t start_idx = 0;
-    for (size_t i = 0; i + window_size <= audio.size(); i += window_size / 2) {
+    for (size_t i = 0; i + window_size <= audio.size(); i += hop) {
         // Calculate RMS energy of window
         float sum_sq = 0.0f;
         for (size_t j = i; j < i + window_size && j < audio.size(); ++j) {
@@ -192,7 +434,7 @@ std::vector<float> AudioProcessor::trim_silence(const std::vector<float>& audio,
 
     // Find end of speech (last window above threshold)
     size_t end_idx = audio.size();
-    for (size_t i = audio.size(); i >= window_size; i -= window_size / 2) {
+    for (size_t i = audio.size(); i >= window_size; i -= hop) {
         size_t win_start = i - window_size;
 
         // Calculate RMS energy of window
@@ -211,49 +453,53 @@ std::vector<float> AudioProcessor::trim_silence(const std::vector<float>& audio,
 
     // Sanity checks
     if (start_idx >= end_idx || end_idx - start_idx < static_cast<size_t>(sample_rate / 10)) {
-        // Less than 100ms of audio or invalid range, return original
-        return audio;
+        // Less than 100ms of audio or invalid range, keep everything
+        return whole;
     }
 
-    // Return trimmed audio
-    return std::vector<float>(audio.begin() + start_idx, audio.begin() + end_idx);
+    return {start_idx, end_idx};
 }
 
-std::vector<float> AudioProcessor::calculate_energy(const std::vector<float>& audio,
-                                                     int window_size,
-                                                     int hop_size) {
-    if (audio.empty() || window_size <= 0) return {};
-
-    std::vector<float> energy;
-    energy.reserve(audio.size() / hop_size + 1);
+std::vector<float> AudioProcessor::trim_silence(const std::vector<float>& audio,
+                                                  float threshold,
+                                                  int min_silence_samples,
+                                                  int sample_rate) {
+    SampleRange range = find_speech_bounds(audio, threshold, min_silence_samples, sample_rate);
+    return std::vector<float>(audio.begin() + range.start, audio.begin() + range.end);
+}
 
-    for (size_t i = 0; i + window_size <= audio.size(); i += hop_size) {
-        float sum_sq = 0.0f;
-        for (size_t j = i; j < i + window_size; ++j) {
-            sum_sq += audio[j] * audio[j];
-        }
-        energy.push_back(std::sqrt(sum_sq / window_size));  // RMS
-    }
+std::vector<SampleRange> AudioProcessor::detect_speech(Span<const float> audio,
+                                                        float threshold,
+                                                        int min_speech_ms,
+                                                        int padding_ms,
+                                                        int sample_rate) {
+    if (audio.empty()) return {};
+
+    // Same detector that runs during capture, fed the whole buffer at once
+    VadConfig config;
+    config.sample_rate = sample_rate;
+    config.threshold = threshold;
+    config.min_speech_ms = min_speech_ms;
+    config.padding_ms = padding_ms;
+
+    StreamingVad vad(config, audio.size());
+    vad.feed(audio);
+    return vad.segments();
+}
 
-    // Smooth the energy curve with a simple moving average
-    if (energy.size() > 3) {
-        std::vector<float> smoothed(energy.size());
-        for (size_t i = 0; i < energy.size(); ++i) {
-            float sum = 0.0f;
-            int count = 0;
-            for (int j = -2; j <= 2; ++j) {
-                int idx = static_cast<int>(i) + j;
-                if (idx >= 0 && idx < static_cast<int>(energy.size())) {
-                    sum += energy[idx];
-                    count++;
-                }
-            }
-            smoothed[i] = sum / count;
+size_t AudioProcessor::compact(Span<float> audio, const std::vector<SampleRange>& ranges) {
+    size_t write_pos = 0;
+    for (const auto& range : ranges) {
+        size_t end = std::min(range.end, audio.size());
+        if (range.start >= end) continue;
+        size_t count = end - range.start;
+        // Ranges are sorted and disjoint, so the source never lies behind write_pos
+        if (range.start != write_pos) {
+            std::memmove(audio.data() + write_pos, audio.data() + range.start, count * sizeof(float));
         }
-        return smoothed;
+        write_pos += count;
     }
-
-    return energy;
+    return write_pos;
 }
 
 std::vector<float> AudioProcessor::extract_speech(const std::vector<float>& audio,
@@ -261,96 +507,11 @@ std::vector<float> AudioProcessor::extract_speech(const std::vector<float>& audi
                                                    int min_speech_ms,
                                                    int padding_ms,
                                                    int sample_rate) {
-    if (audio.empty()) return audio;
-
-    int window_size = sample_rate / 100;  // 10ms
-    int hop_size = sample_rate / 200;     // 5ms
-
-    // Calculate smoothed energy envelope
-    auto energy = calculate_energy(audio, window_size, hop_size);
-    if (energy.empty()) return audio;
-
-    // Find speech segments (regions above threshold)
-    int min_speech_frames = (min_speech_ms * sample_rate) / (1000 * hop_size);
-    int padding_frames = (padding_ms * sample_rate) / (1000 * hop_size);
-
-    struct Segment {
-        size_t start;
-        size_t end;
-    };
-    std::vector<Segment> segments;
-
-    bool in_speech = false;
-    size_t speech_start = 0;
-    int consecutive_speech = 0;
-    int consecutive_silence = 0;
-
-    for (size_t i = 0; i < energy.size(); ++i) {
-        if (energy[i] > threshold) {
-            consecutive_speech++;
-            consecutive_silence = 0;
-
-            if (!in_speech && consecutive_speech >= 2) {
-                // Start of speech segment
-                in_speech = true;
-                speech_start = i > 1 ? i - 1 : 0;
-            }
-        } else {
-            consecutive_silence++;
-
-            if (in_speech && consecutive_silence >= 3) {
-                // End of speech segment
-                in_speech = false;
-                size_t speech_end = i;
-
-                // Only keep segments longer than minimum
-                if (speech_end - speech_start >= static_cast<size_t>(min_speech_frames)) {
-                    segments.push_back({speech_start, speech_end});
-                }
-                consecutive_speech = 0;
-            }
-        }
-    }
-
-    // Handle case where speech extends to end
-    if (in_speech) {
-        if (energy.size() - speech_start >= static_cast<size_t>(min_speech_frames)) {
-            segments.push_back({speech_start, energy.size()});
-        }
-    }
-
-    // If no valid segments found, return original
-    if (segments.empty()) {
-        return audio;
-    }
-
-    // Merge close segments and add padding
-    std::vector<Segment> merged_segments;
-    for (const auto& seg : segments) {
-        // Add padding
-        size_t padded_start = seg.start > static_cast<size_t>(padding_frames) ?
-                             seg.start - padding_frames : 0;
-        size_t padded_end = std::min(seg.end + padding_frames, energy.size());
-
-        // Check if we can merge with previous segment
-        if (!merged_segments.empty() && padded_start <= merged_segments.back().end) {
-            merged_segments.back().end = padded_end;
-        } else {
-            merged_segments.push_back({padded_start, padded_end});
-        }
-    }
-
-    // Convert frame indices to sample indices and extract audio
-    std::vector<float> result;
-    for (const auto& seg : merged_segments) {
-        size_t sample_start = seg.start * hop_size;
-        size_t sample_end = std::min(seg.end * hop_size + window_size, audio.size());
-
-        result.insert(result.end(),
-                     audio.begin() + sample_start,
-                     audio.begin() + sample_end);
-    }
+    auto ranges = detect_speech(audio, threshold, min_speech_ms, padding_ms, sample_rate);
+    if (ranges.empty()) return audio;
 
+    std::vector<float> result(audio);
+    result.resize(compact(result, ranges));
     return result.empty() ? audio : result;
 }
 
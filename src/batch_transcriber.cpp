@@ -0,0 +1,379 @@
+#include "batch_transcriber.hpp"
+#include "audio_processor.hpp"
+#include "cpu_topology.hpp"
+#include "model_manager.hpp"
+#include "speech_chunker.hpp"
+#include "transcription_worker.hpp"
+#include "vocabulary.hpp"
+#include "wav_reader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace whispr {
+
+namespace {
+
+constexpr int SAMPLE_RATE = 16000;
+constexpr size_t READ_BLOCK = SAMPLE_RATE / 2;  // Samples per read: 500ms
+
+using Clock = std::chrono::steady_clock;
+
+std::string shell_quote(const std::string& s) {
+    std::string out = "'";
+    for (char c : s) {
+        if (c == '\'') {
+            out += "'\\''";
+        } else {
+            out += c;
+        }
+    }
+    return out + "'";
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+// 01:02:03,456
+std::string srt_time(int64_t ms) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%02lld:%02lld:%02lld,%03lld",
+                  static_cast<long long>(ms / 3600000), static_cast<long long>(ms / 60000 % 60),
+                  static_cast<long long>(ms / 1000 % 60), static_cast<long long>(ms % 1000));
+    return buf;
+}
+
+} // namespace
+
+bool parse_output_format(const std::string& name, OutputFormat& format) {
+    if (name == "txt") format = OutputFormat::Text;
+    else if (name == "json") format = OutputFormat::Json;
+    else if (name == "srt") format = OutputFormat::Srt;
+    else return false;
+    return true;
+}
+
+const char* output_extension(OutputFormat format) {
+    switch (format) {
+        case OutputFormat::Json: return ".json";
+        case OutputFormat::Srt: return ".srt";
+        default: return ".txt";
+    }
+}
+
+BatchTranscriber::BatchTranscriber(const Config& config)
+    : config_(config) {
+}
+
+std::vector<std::string> BatchTranscriber::find_inputs(const std::string& dir) {
+    static const char* EXTENSIONS[] = {".wav", ".flac", ".opus", ".ogg", ".mp3", ".m4a", ".aac", ".webm"};
+
+    std::vector<std::string> inputs;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file()) continue;
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        for (const char* known : EXTENSIONS) {
+            if (ext == known) {
+                inputs.push_back(entry.path().string());
+                break;
+            }
+        }
+    }
+    if (ec) {
+        std::cerr << "Failed to read directory " << dir << ": " << ec.message() << std::endl;
+    }
+    std::sort(inputs.begin(), inputs.end());
+    return inputs;
+}
+
+std::string BatchTranscriber::output_path_for(const std::string& input, OutputFormat format) const {
+    std::filesystem::path path(input);
+    if (!config_.output_dir.empty()) {
+        path = std::filesystem::path(config_.output_dir) / path.filename();
+    }
+    path.replace_extension(output_extension(format));
+    return path.string();
+}
+
+void BatchTranscriber::acquire_slot() {
+    std::unique_lock<std::mutex> lock(slots_mutex_);
+    slots_cv_.wait(lock, [this]() { return in_flight_ < max_in_flight_; });
+    ++in_flight_;
+}
+
+void BatchTranscriber::release_slot() {
+    {
+        std::lock_guard<std::mutex> lock(slots_mutex_);
+        --in_flight_;
+    }
+    slots_cv_.notify_all();
+}
+
+int BatchTranscriber::run(const std::vector<std::string>& inputs, OutputFormat format) {
+    const int total = static_cast<int>(inputs.size());
+    const size_t jobs = static_cast<size_t>(std::max(config_.parallel_jobs, 1));
+
+    // One model, one decode state per worker
+    ModelManager models(config_.model_dir, 1, jobs, config_.use_gpu, config_.gpu_device, config_.model_precision);
+    std::shared_ptr<WhisperModel> model = models.get(config_.model_quality);
+    if (!model) {
+        std::cerr << "Failed to load model: " << models.path_for(config_.model_quality) << std::endl;
+        return total;
+    }
+    std::cout << "Model: " << model->path() << " ("
+              << precision_name(models.precision_for(config_.model_quality)) << ")" << std::endl;
+
+    auto transcriber = std::make_unique<Transcriber>();
+    const bool auto_threads = config_.n_threads <= 0;
+    const int n_threads = auto_threads
+        ? std::max(1, performance_core_count() / static_cast<int>(jobs))
+        : config_.n_threads;
+    transcriber->initialize(model, n_threads);
+    if (auto_threads) {
+        transcriber->set_auto_threads(nullptr);  // Tuned counts assume one decode at a time
+    }
+    transcriber->set_language(config_.language);
+    transcriber->set_translate(config_.translate);
+    transcriber->set_profile(get_profile(config_.model_quality));
+
+    std::string initial_prompt = config_.initial_prompt;
+    VocabularyConfig vocab = VocabularyLoader::load_user_vocabulary();
+    if (!vocab.empty()) {
+        Transcriber* t = transcriber.get();
+        initial_prompt = VocabularyLoader::build_initial_prompt(
+            vocab, config_.initial_prompt,
+            VocabularyLoader::load_usage(VocabularyLoader::get_default_usage_path()),
+            [t](const std::string& text) { return t->count_tokens(text); },
+            t->max_prompt_tokens());
+    }
+    transcriber->set_initial_prompt(initial_prompt);
+
+    const Transcriber* text_processor = transcriber.get();
+    std::cout << "Batch: " << total << " file(s), " << jobs << " parallel job(s), "
+              << n_threads << " threads each" << std::endl;
+
+    // Two chunks per worker: one decoding, one read ahead
+    max_in_flight_ = jobs * 2;
+    TranscriptionWorker worker(std::move(transcriber), max_in_flight_, jobs);
+    if (!worker.start()) {
+        std::cerr << "Failed to start transcription worker" << std::endl;
+        return total;
+    }
+
+    if (!config_.output_dir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(config_.output_dir, ec);
+    }
+
+    ChunkerConfig chunk_config;
+    chunk_config.sample_rate = SAMPLE_RATE;
+    chunk_config.threshold = config_.silence_threshold;
+    chunk_config.min_speech_ms = config_.min_silence_ms;
+
+    const TranscriptionProfile profile = get_profile(config_.model_quality);
+    const bool preprocess = config_.audio_preprocessing;
+    std::atomic<int> failed{0};
+    std::shared_ptr<FileResult> current;
+
+    // Outlives every chunk job, which hand their buffers back to it
+    SpeechChunker chunker(chunk_config, [&](AudioChunk&& chunk) {
+        auto job = std::make_shared<AudioChunk>(std::move(chunk));
+        const int64_t offset_ms = job->start_sample * 1000 / SAMPLE_RATE;
+        std::shared_ptr<FileResult> file = current;
+
+        acquire_slot();
+        bool queued = worker.submit(
+            [job, profile, preprocess, &chunker](Transcriber& transcriber) {
+                TranscriptionResult result;
+                result.success = true;  // A chunk of silence is not a failure
+                result.confidence = 0.0f;
+                result.duration_ms = 0;
+                if (job->has_speech) {
+                    if (preprocess) {
+                        AudioProcessor processor(static_cast<float>(SAMPLE_RATE));
+                        processor.process(job->samples);
+                    }
+                    DecodeOptions options;
+                    options.multi_segment = true;  // Segments carry the timestamps
+                    options.process_text = false;
+                    options.log_result = false;
+                    result = transcriber.transcribe_with_profile(job->samples, profile, options);
+                }
+                chunker.recycle(std::move(job->samples));
+                return result;
+            },
+            [this, file, offset_ms](const TranscriptionResult& result) {
+                if (!result.success) {
+                    file->failed = true;
+                    file->error = result.error;
+                }
+                for (const TranscriptionSegment& segment : result.segments) {
+                    file->segments.push_back({segment.t0_ms + offset_ms, segment.t1_ms + offset_ms, segment.text});
+                }
+                release_slot();
+            });
+        if (!queued) {
+            release_slot();
+            file->failed = true;
+            file->error = "transcription queue closed";
+        }
+    });
+
+    std::vector<float> block(READ_BLOCK);
+    for (int index = 0; index < total && !cancelled_.load(); ++index) {
+        const std::string& path = inputs[static_cast<size_t>(index)];
+        const auto started = Clock::now();
+
+        // WAV directly; anything else (FLAC, Opus, ...) decoded by ffmpeg to a pipe
+        WavReader reader;
+        FILE* pipe = nullptr;
+        if (!reader.open(path, SAMPLE_RATE) && std::filesystem::exists(path)) {
+            const std::string command = "ffmpeg -nostdin -v error -i " + shell_quote(path) +
+                                        " -f wav -acodec pcm_s16le -ac 1 -ar 16000 -";
+            pipe = popen(command.c_str(), "r");
+            reader.open(pipe, SAMPLE_RATE);
+        }
+        if (!reader.is_open()) {
+            std::cerr << "[" << index + 1 << "/" << total << "] " << path << ": cannot decode ("
+                      << reader.error() << "; FLAC, Opus and MP3 need ffmpeg)" << std::endl;
+            if (pipe) pclose(pipe);
+            failed.fetch_add(1);
+            continue;
+        }
+
+        current = std::make_shared<FileResult>();
+        current->path = path;
+        current->output_path = output_path_for(path, format);
+
+        int64_t samples = 0;
+        size_t n;
+        while (!cancelled_.load() && (n = reader.read(block.data(), block.size())) > 0) {
+            chunker.feed(Span<const float>(block.data(), n));
+            samples += static_cast<int64_t>(n);
+        }
+        chunker.finish();
+        reader.close();
+        if (pipe && pclose(pipe) != 0 && samples == 0) {
+            current->failed = true;
+            current->error = "ffmpeg failed";
+        }
+        current->duration_ms = samples * 1000 / SAMPLE_RATE;
+
+        // Completions run in submission order: once this one runs, every
+        // chunk of the file has been delivered
+        std::shared_ptr<FileResult> file = current;
+        const bool cancelled = cancelled_.load();
+        acquire_slot();
+        bool queued = worker.submit(
+            [](Transcriber&) {
+                TranscriptionResult done;
+                done.success = true;
+                done.confidence = 0.0f;
+                done.duration_ms = 0;
+                return done;
+            },
+            [this, file, format, text_processor, started, index, total, cancelled, &failed](const TranscriptionResult&) {
+                release_slot();
+                std::cout << "[" << index + 1 << "/" << total << "] " << file->path << ": ";
+                if (cancelled) {
+                    std::cout << "cancelled" << std::endl;
+                    failed.fetch_add(1);
+                    return;
+                }
+                if (file->failed || !write_output(*file, format, *text_processor)) {
+                    std::cout << "failed" << (file->error.empty() ? "" : " (" + file->error + ")") << std::endl;
+                    failed.fetch_add(1);
+                    return;
+                }
+                const double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+                std::cout << std::fixed << std::setprecision(1) << file->duration_ms / 1000.0 << "s of audio in "
+                          << seconds << "s -> " << file->output_path << std::endl;
+            });
+        if (!queued) {
+            release_slot();
+            failed.fetch_add(1);
+        }
+    }
+
+    // Everything submitted has been delivered once all slots are free
+    {
+        std::unique_lock<std::mutex> lock(slots_mutex_);
+        slots_cv_.wait(lock, [this]() { return in_flight_ == 0; });
+    }
+    worker.stop();
+
+    return failed.load();
+}
+
+bool BatchTranscriber::write_output(const FileResult& file, OutputFormat format,
+                                    const Transcriber& transcriber) const {
+    std::ofstream out(file.output_path);
+    if (!out) return false;
+
+    std::string raw;
+    for (const Segment& segment : file.segments) raw += segment.text;
+
+    switch (format) {
+        case OutputFormat::Text:
+            out << transcriber.post_process(raw) << "\n";
+            break;
+        case OutputFormat::Srt: {
+            int index = 1;
+            for (const Segment& segment : file.segments) {
+                std::string text = transcriber.post_process(segment.text);
+                if (text.empty()) continue;
+                out << index++ << "\n" << srt_time(segment.t0_ms) << " --> " << srt_time(segment.t1_ms)
+                    << "\n" << text << "\n\n";
+            }
+            break;
+        }
+        case OutputFormat::Json: {
+            out << "{\"file\":";
+            write_json_string(out, file.path);
+            out << ",\"duration_ms\":" << file.duration_ms << ",\"text\":";
+            write_json_string(out, transcriber.post_process(raw));
+            out << ",\"segments\":[";
+            bool first = true;
+            for (const Segment& segment : file.segments) {
+                std::string text = transcriber.post_process(segment.text);
+                if (text.empty()) continue;
+                out << (first ? "\n" : ",\n") << "{\"start_ms\":" << segment.t0_ms << ",\"end_ms\":" << segment.t1_ms
+                    << ",\"text\":";
+                write_json_string(out, text);
+                out << "}";
+                first = false;
+            }
+            out << "\n]}\n";
+            break;
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace whispr
@@ -0,0 +1,103 @@
+#include "continuous_dictation.hpp"
+#include <chrono>
+
+namespace whispr {
+
+namespace {
+
+// Every pause long enough ends an utterance, however short it was
+ChunkerConfig chunker_config(const ContinuousConfig& config) {
+    ChunkerConfig chunker;
+    chunker.sample_rate = config.sample_rate;
+    chunker.target_ms = 0;
+    chunker.max_ms = config.max_utterance_ms;
+    chunker.min_pause_ms = config.end_silence_ms;
+    chunker.min_speech_ms = config.min_speech_ms;
+    chunker.threshold = config.silence_threshold;
+    return chunker;
+}
+
+} // namespace
+
+ContinuousDictation::ContinuousDictation(const ContinuousConfig& config, UtteranceCallback on_utterance)
+    : config_(config)
+    , on_utterance_(std::move(on_utterance))
+    , chunker_(chunker_config(config), [this](AudioChunk&& chunk) { on_chunk(std::move(chunk)); }) {
+    intake_.allocate(static_cast<size_t>(config_.sample_rate) * config_.intake_seconds);
+    drain_scratch_.resize(4096);
+}
+
+ContinuousDictation::~ContinuousDictation() {
+    end();
+}
+
+void ContinuousDictation::begin() {
+    if (active_.load()) return;
+
+    intake_.reset();
+    dropped_samples_.store(0);
+    utterances_.store(0);
+
+    stopping_.store(false);
+    active_.store(true);
+    listen_thread_ = std::thread([this]() { listen_loop(); });
+}
+
+void ContinuousDictation::feed(Span<const float> samples) {
+    if (!active_.load(std::memory_order_acquire) || stopping_.load(std::memory_order_relaxed)) return;
+
+    size_t written = intake_.write(samples.data(), samples.size());
+    if (written < samples.size()) {
+        dropped_samples_.fetch_add(samples.size() - written, std::memory_order_relaxed);
+    }
+}
+
+void ContinuousDictation::end() {
+    if (!active_.load()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_.store(true);
+    }
+    wake_cv_.notify_all();
+    if (listen_thread_.joinable()) {
+        listen_thread_.join();
+    }
+
+    // Whatever was said since the last pause
+    drain_intake();
+    chunker_.finish();
+    active_.store(false);
+}
+
+void ContinuousDictation::drain_intake() {
+    size_t n;
+    while ((n = intake_.read(drain_scratch_.data(), drain_scratch_.size())) > 0) {
+        chunker_.feed(Span<const float>(drain_scratch_.data(), n));
+    }
+}
+
+void ContinuousDictation::listen_loop() {
+    // The audio callback can't signal us without risking a lock, so poll the
+    // intake; this bounds how late an endpoint is noticed
+    const auto poll_interval = std::chrono::milliseconds(20);
+
+    while (!stopping_.load()) {
+        drain_intake();
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, poll_interval, [this]() { return stopping_.load(); });
+    }
+}
+
+void ContinuousDictation::on_chunk(AudioChunk&& chunk) {
+    // Silence between utterances is cut off like any other pause
+    if (!chunk.has_speech) {
+        chunker_.recycle(std::move(chunk.samples));
+        return;
+    }
+    utterances_.fetch_add(1);
+    on_utterance_(std::move(chunk));
+}
+
+} // namespace whispr
@@ -0,0 +1,13 @@
+#include "file_watcher.hpp"
+
+namespace whispr {
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+// Platform-specific implementations in platform/*/file_watcher_*.cpp
+
+} // namespace whispr
@@ -0,0 +1,405 @@
+#include "history_store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace whispr {
+
+namespace {
+
+constexpr char MAGIC[8] = {'V', 'X', 'H', 'I', 'S', 'T', '0', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t INITIAL_BYTES = 64 * 1024;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t used;          // Bytes of header and complete records; written after each record
+    uint8_t padding[40];
+};
+static_assert(sizeof(FileHeader) == 64, "history header layout");
+
+// Followed by text_bytes of text, raw_bytes of raw text and zero padding to 8 bytes
+struct RecordHeader {
+    uint32_t size;          // Whole record, padding included
+    uint32_t crc;           // CRC-32 of everything after this field
+    int64_t time_ms;
+    float confidence;
+    uint32_t audio_ms;
+    uint32_t decode_ms;
+    uint32_t key_to_text_ms;
+    uint32_t text_bytes;
+    uint32_t raw_bytes;
+};
+static_assert(sizeof(RecordHeader) == 40, "history record layout");
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    static const auto table = []() {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+size_t record_size(size_t text_bytes, size_t raw_bytes) {
+    return (sizeof(RecordHeader) + text_bytes + raw_bytes + 7) & ~static_cast<size_t>(7);
+}
+
+// Sorted union of posting lists
+void merge_into(std::vector<uint32_t>& out, const std::vector<uint32_t>& list) {
+    std::vector<uint32_t> merged;
+    merged.reserve(out.size() + list.size());
+    std::set_union(out.begin(), out.end(), list.begin(), list.end(), std::back_inserter(merged));
+    out.swap(merged);
+}
+
+} // namespace
+
+HistoryStore::~HistoryStore() {
+    close();
+}
+
+std::string HistoryStore::default_path() {
+    const char* home = std::getenv("HOME");
+    if (!home) return "";
+    return std::string(home) + "/.whispr/history.log";
+}
+
+bool HistoryStore::is_open() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_ != nullptr;
+}
+
+bool HistoryStore::map_file(size_t bytes) {
+    // The old mapping stays usable if growing fails
+    if (!read_only_ && ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+        error_ = std::string("cannot grow history log: ") + std::strerror(errno);
+        return false;
+    }
+    void* mapping = mmap(nullptr, bytes, read_only_ ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        error_ = std::string("cannot map history log: ") + std::strerror(errno);
+        return false;
+    }
+    if (data_) munmap(data_, mapped_);
+    data_ = static_cast<uint8_t*>(mapping);
+    mapped_ = bytes;
+    return true;
+}
+
+bool HistoryStore::open(const std::string& path, bool read_only) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    read_only_ = read_only;
+    error_.clear();
+
+    if (!read_only) {
+        // Usually ~/.whispr, which may not exist yet
+        size_t slash = path.rfind('/');
+        if (slash != std::string::npos && slash > 0) mkdir(path.substr(0, slash).c_str(), 0700);
+    }
+    fd_ = ::open(path.c_str(), read_only ? O_RDONLY | O_CLOEXEC : O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0) {
+        error_ = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (!read_only && flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        error_ = path + " is in use by another voxtype";
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        error_ = "cannot stat " + path;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    const size_t file_bytes = static_cast<size_t>(st.st_size);
+    const bool fresh = file_bytes == 0 && !read_only;
+
+    bool ok = fresh ? map_file(INITIAL_BYTES)
+                    : file_bytes >= sizeof(FileHeader) && map_file(file_bytes);
+    FileHeader header;
+    if (ok && fresh) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.used = sizeof(FileHeader);
+        std::memcpy(data_, &header, sizeof(header));
+    } else if (ok) {
+        std::memcpy(&header, data_, sizeof(header));
+        ok = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION;
+    }
+    if (!ok) {
+        if (error_.empty()) error_ = path + " is not a voxtype history log";
+        if (data_) munmap(data_, mapped_);
+        data_ = nullptr;
+        mapped_ = 0;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    // Index every complete record; stop at the first torn or corrupt one
+    const size_t limit = static_cast<size_t>(std::min<uint64_t>(header.used, mapped_));
+    size_t offset = sizeof(FileHeader);
+    HistoryEntry entry;
+    while (offset + sizeof(RecordHeader) <= limit) {
+        RecordHeader record;
+        std::memcpy(&record, data_ + offset, sizeof(record));
+        if (record.size < sizeof(RecordHeader) || record.size > limit - offset ||
+            record.size != record_size(record.text_bytes, record.raw_bytes) ||
+            crc32(data_ + offset + 8, record.size - 8) != record.crc) {
+            break;
+        }
+        offsets_.push_back(offset);
+        read_locked(offsets_.size() - 1, entry);
+        index_locked(static_cast<uint32_t>(offsets_.size() - 1), entry.text, entry.raw_text);
+        offset += record.size;
+    }
+    used_ = offset;
+    if (!read_only && header.used != used_) {
+        // Drop the torn tail so the next append overwrites it
+        header.used = used_;
+        std::memcpy(data_, &header, sizeof(header));
+    }
+    return true;
+}
+
+void HistoryStore::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data_) {
+        if (!read_only_) msync(data_, mapped_, MS_ASYNC);
+        munmap(data_, mapped_);
+        data_ = nullptr;
+        mapped_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);  // Releases the lock
+        fd_ = -1;
+    }
+    used_ = 0;
+    offsets_.clear();
+    index_.clear();
+}
+
+bool HistoryStore::append(HistoryEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!data_ || read_only_) {
+        error_ = "history log is not open for writing";
+        return false;
+    }
+
+    if (entry.time_ms == 0) {
+        entry.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    const size_t size = record_size(entry.text.size(), entry.raw_text.size());
+    if (used_ + size > mapped_ && !map_file(std::max(mapped_ * 2, used_ + size))) {
+        return false;
+    }
+
+    RecordHeader record;
+    record.size = static_cast<uint32_t>(size);
+    record.crc = 0;
+    record.time_ms = entry.time_ms;
+    record.confidence = entry.confidence;
+    record.audio_ms = entry.timings.audio_ms;
+    record.decode_ms = entry.timings.decode_ms;
+    record.key_to_text_ms = entry.timings.key_to_text_ms;
+    record.text_bytes = static_cast<uint32_t>(entry.text.size());
+    record.raw_bytes = static_cast<uint32_t>(entry.raw_text.size());
+
+    uint8_t* out = data_ + used_;
+    std::memcpy(out, &record, sizeof(record));
+    std::memcpy(out + sizeof(record), entry.text.data(), entry.text.size());
+    std::memcpy(out + sizeof(record) + entry.text.size(), entry.raw_text.data(), entry.raw_text.size());
+    const size_t end = sizeof(record) + entry.text.size() + entry.raw_text.size();
+    std::memset(out + end, 0, size - end);
+    record.crc = crc32(out + 8, size - 8);
+    std::memcpy(out + 4, &record.crc, sizeof(record.crc));
+
+    // The record is complete before the header counts it
+    std::atomic_thread_fence(std::memory_order_release);
+    const uint64_t used = used_ + size;
+    std::memcpy(data_ + offsetof(FileHeader, used), &used, sizeof(used));
+
+    offsets_.push_back(used_);
+    used_ += size;
+    index_locked(static_cast<uint32_t>(offsets_.size() - 1), entry.text, entry.raw_text);
+    entry.id = offsets_.size();
+    return true;
+}
+
+bool HistoryStore::read_locked(size_t index, HistoryEntry& entry) const {
+    if (index >= offsets_.size()) return false;
+
+    const uint8_t* in = data_ + offsets_[index];
+    RecordHeader record;
+    std::memcpy(&record, in, sizeof(record));
+    entry.id = index + 1;
+    entry.time_ms = record.time_ms;
+    entry.confidence = record.confidence;
+    entry.timings.audio_ms = record.audio_ms;
+    entry.timings.decode_ms = record.decode_ms;
+    entry.timings.key_to_text_ms = record.key_to_text_ms;
+    entry.text.assign(reinterpret_cast<const char*>(in + sizeof(record)), record.text_bytes);
+    entry.raw_text.assign(reinterpret_cast<const char*>(in + sizeof(record) + record.text_bytes), record.raw_bytes);
+    return true;
+}
+
+bool HistoryStore::get(uint64_t id, HistoryEntry& entry) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return id > 0 && read_locked(static_cast<size_t>(id - 1), entry);
+}
+
+size_t HistoryStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return offsets_.size();
+}
+
+std::vector<std::string> HistoryStore::words(const std::string& text) {
+    std::vector<std::string> result;
+    std::string word;
+    for (char ch : text) {
+        const unsigned char c = static_cast<unsigned char>(ch);
+        if (c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) {
+            word += ch;
+        } else if (c >= 'A' && c <= 'Z') {
+            word += static_cast<char>(c - 'A' + 'a');
+        } else if (c == '\'') {
+            continue;  // Part of the word: "don't" is found as "dont"
+        } else if (!word.empty()) {
+            result.push_back(std::move(word));
+            word.clear();
+        }
+    }
+    if (!word.empty()) result.push_back(std::move(word));
+    return result;
+}
+
+void HistoryStore::index_locked(uint32_t index, const std::string& text, const std::string& raw_text) {
+    // Raw text too: a search finds what was said even where processing changed it
+    std::vector<std::string> all = words(text);
+    std::vector<std::string> raw = words(raw_text);
+    all.insert(all.end(), raw.begin(), raw.end());
+    std::sort(all.begin(), all.end());
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+
+    // Entries are indexed in order, so each posting list stays sorted
+    for (std::string& word : all) {
+        index_[std::move(word)].push_back(index);
+    }
+}
+
+std::vector<uint64_t> HistoryStore::search_locked(const std::string& query, size_t limit, size_t* matches) const {
+    const std::vector<std::string> terms = words(query);
+    const bool prefix_last = !query.empty() && query.back() != ' ';
+    if (matches) *matches = 0;
+    if (terms.empty()) return {};
+
+    std::vector<uint32_t> hits;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        std::vector<uint32_t> term_hits;
+        if (i + 1 == terms.size() && prefix_last) {
+            // Every word starting with the term sorts right after it
+            for (auto it = index_.lower_bound(terms[i]);
+                 it != index_.end() && it->first.compare(0, terms[i].size(), terms[i]) == 0; ++it) {
+                merge_into(term_hits, it->second);
+            }
+        } else {
+            auto it = index_.find(terms[i]);
+            if (it != index_.end()) term_hits = it->second;
+        }
+
+        if (i == 0) {
+            hits.swap(term_hits);
+        } else {
+            std::vector<uint32_t> both;
+            std::set_intersection(hits.begin(), hits.end(), term_hits.begin(), term_hits.end(),
+                                  std::back_inserter(both));
+            hits.swap(both);
+        }
+        if (hits.empty()) return {};
+    }
+
+    if (matches) *matches = hits.size();
+    std::vector<uint64_t> ids;
+    for (auto it = hits.rbegin(); it != hits.rend() && ids.size() < limit; ++it) {
+        ids.push_back(static_cast<uint64_t>(*it) + 1);
+    }
+    return ids;
+}
+
+std::vector<uint64_t> HistoryStore::search(const std::string& query, size_t limit) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return search_locked(query, limit, nullptr);
+}
+
+HistorySnapshot HistoryStore::snapshot(size_t count, size_t preview_chars, const std::string& query) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HistorySnapshot snapshot;
+    snapshot.query = query;
+
+    std::vector<uint64_t> ids;
+    if (words(query).empty()) {
+        snapshot.matches = offsets_.size();
+        for (size_t i = offsets_.size(); i > 0 && ids.size() < count; --i) ids.push_back(i);
+    } else {
+        ids = search_locked(query, count, &snapshot.matches);
+    }
+
+    HistoryEntry entry;
+    snapshot.items.reserve(ids.size());
+    for (uint64_t id : ids) {
+        if (!read_locked(static_cast<size_t>(id - 1), entry)) continue;
+        snapshot.items.push_back({id, entry.time_ms, entry.confidence, preview(entry.text, preview_chars)});
+    }
+    return snapshot;
+}
+
+std::string HistoryStore::preview(const std::string& text, size_t max_chars) {
+    std::string out;
+    size_t chars = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        const bool starts_char = (c & 0xC0) != 0x80;
+        if (starts_char && chars == max_chars) {
+            // Cut: make room for the ellipsis
+            size_t keep = max_chars > 3 ? max_chars - 3 : 0;
+            size_t pos = 0;
+            for (size_t n = 0; pos < out.size(); ++pos) {
+                if ((static_cast<unsigned char>(out[pos]) & 0xC0) != 0x80 && n++ == keep) break;
+            }
+            out.resize(pos);
+            out += "...";
+            return out;
+        }
+        if (starts_char) ++chars;
+        out += (c == '\n' || c == '\r' || c == '\t') ? ' ' : text[i];
+    }
+    return out;
+}
+
+} // namespace whispr
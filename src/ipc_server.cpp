@@ -0,0 +1,596 @@
+#include "ipc_server.hpp"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <condition_variable>
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+
+namespace whispr {
+
+namespace {
+
+constexpr size_t MAX_SAMPLES = 16000u * 60 * 60;  // An hour of audio
+constexpr size_t MAX_LINE = 4096;
+constexpr int MAX_FDS = 4;                        // Descriptors accepted per message
+constexpr size_t MAX_PENDING_FDS = 8;             // Received but not yet claimed by a request
+
+void no_sigpipe(int fd) {
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#else
+    (void)fd;
+#endif
+}
+
+bool send_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool fill_address(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+bool starts_with(const std::string& text, const char* prefix) {
+    return text.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+std::vector<std::string> split_words(const std::string& line) {
+    std::istringstream in(line);
+    std::vector<std::string> words;
+    std::string word;
+    while (in >> word) words.push_back(word);
+    return words;
+}
+
+} // namespace
+
+// Client connection; outlives its thread while a queued transcription still holds a reply
+struct IpcServer::Connection {
+    int fd = -1;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+
+    std::mutex write_mutex;
+
+    // Set by the final reply of the request in progress
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+
+    // Client thread only
+    std::string in;          // Bytes received but not consumed
+    std::deque<int> fds;     // Descriptors received but not claimed by a request (bounded)
+
+    ~Connection() {
+        for (int received : fds) ::close(received);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool send_line(const std::string& json) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        std::string line = json + "\n";
+        return send_all(fd, line.data(), line.size());
+    }
+
+    // Append whatever arrives next to `in`, collecting passed descriptors
+    bool receive() {
+        char data[65536];
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS)];
+        iovec iov{data, sizeof(data)};
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+#ifdef MSG_CMSG_CLOEXEC
+        const int flags = MSG_CMSG_CLOEXEC;  // Never leak a client's memory into a child process
+#else
+        const int flags = 0;
+#endif
+        ssize_t n;
+        do {
+            n = ::recvmsg(fd, &message, flags);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) return false;
+
+        bool overflow = (message.msg_flags & MSG_CTRUNC) != 0;
+        for (cmsghdr* c = CMSG_FIRSTHDR(&message); c; c = CMSG_NXTHDR(&message, c)) {
+            if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+            const size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < count; ++i) {
+                int received;
+                std::memcpy(&received, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+#ifndef MSG_CMSG_CLOEXEC
+                fcntl(received, F_SETFD, FD_CLOEXEC);
+#endif
+                // Descriptors sent without requests to claim them would pile up otherwise
+                if (fds.size() >= MAX_PENDING_FDS) {
+                    ::close(received);
+                    overflow = true;
+                    continue;
+                }
+                fds.push_back(received);
+            }
+        }
+        // Truncated or excess descriptors: the stream no longer lines up with
+        // the requests, so drop the client rather than pair audio wrongly
+        if (overflow) {
+            std::cerr << "IPC: client sent too many descriptors, disconnecting" << std::endl;
+            return false;
+        }
+        in.append(data, static_cast<size_t>(n));
+        return true;
+    }
+};
+
+std::shared_ptr<SharedAudio> SharedAudio::map(int fd, size_t samples, std::string& error) {
+    const size_t bytes = samples * sizeof(float);
+#ifdef F_GET_SEALS
+    // An unsealed file could be truncated by the client while mapped, and the
+    // daemon would take SIGBUS reading it
+    const int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+        error = "shared memory must be a memfd sealed against shrinking (F_SEAL_SHRINK)";
+        return nullptr;
+    }
+#else
+    // No sealing to keep the client from truncating the file under the mapping
+    (void)fd;
+    error = "shared memory is not supported on this platform (use 'inline')";
+    return nullptr;
+#endif
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < bytes) {
+        error = "shared memory is smaller than " + std::to_string(samples) + " samples";
+        return nullptr;
+    }
+
+    // Private writable mapping: the daemon's writes get their own pages
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        error = std::string("cannot map shared memory: ") + std::strerror(errno);
+        return nullptr;
+    }
+
+    std::shared_ptr<SharedAudio> audio(new SharedAudio());
+    audio->mapping_ = mapping;
+    audio->mapping_bytes_ = bytes;
+    audio->data_ = static_cast<float*>(mapping);
+    audio->size_ = samples;
+    return audio;
+}
+
+std::shared_ptr<SharedAudio> SharedAudio::own(std::vector<float>&& samples) {
+    std::shared_ptr<SharedAudio> audio(new SharedAudio());
+    audio->owned_ = std::move(samples);
+    audio->data_ = audio->owned_.data();
+    audio->size_ = audio->owned_.size();
+    return audio;
+}
+
+SharedAudio::~SharedAudio() {
+    if (mapping_) munmap(mapping_, mapping_bytes_);
+}
+
+IpcServer::IpcServer(Handlers handlers)
+    : handlers_(std::move(handlers)) {
+}
+
+IpcServer::~IpcServer() {
+    stop();
+}
+
+std::string IpcServer::default_socket_path() {
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime && *runtime) return std::string(runtime) + "/voxtype.sock";
+    const char* home = std::getenv("HOME");
+    if (!home) return "/tmp/voxtype-" + std::to_string(getuid()) + ".sock";
+    return std::string(home) + "/.whispr/voxtype.sock";
+}
+
+bool IpcServer::start(const std::string& path) {
+    if (listen_fd_ >= 0) return true;
+
+    sockaddr_un address;
+    if (!fill_address(path, address)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return false;
+    }
+
+    // Private directory for the default ~/.whispr location
+    const size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        mkdir(path.substr(0, slash).c_str(), 0700);
+    }
+
+    // A socket file nobody answers on was left by a daemon that didn't exit cleanly
+    int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0) {
+        const bool live = ::connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        ::close(probe);
+        if (live) {
+            std::cerr << "Another voxtype daemon is listening on " << path << std::endl;
+            return false;
+        }
+    }
+    ::unlink(path.c_str());
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Failed to create socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    fcntl(listen_fd_, F_SETFD, FD_CLOEXEC);
+
+    // Owner only from the moment the file exists
+    const mode_t old_mask = umask(0177);
+    const bool bound = ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    umask(old_mask);
+    if (!bound || ::listen(listen_fd_, 16) != 0 || ::pipe(wake_pipe_) != 0) {
+        std::cerr << "Failed to listen on " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    path_ = path;
+    stopping_.store(false);
+    accept_thread_ = std::thread([this]() { accept_loop(); });
+    std::cout << "Listening on " << path_ << std::endl;
+    return true;
+}
+
+void IpcServer::stop() {
+    if (listen_fd_ < 0) return;
+
+    stopping_.store(true);
+    if (wake_pipe_[1] >= 0) {
+        char byte = 1;
+        ssize_t ignored = ::write(wake_pipe_[1], &byte, 1);
+        (void)ignored;
+    }
+    if (accept_thread_.joinable()) {
+        accept_thread_.join();
+    }
+
+    std::vector<std::shared_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections.swap(connections_);
+    }
+    for (auto& connection : connections) {
+        ::shutdown(connection->fd, SHUT_RDWR);  // Unblocks its recvmsg()
+        {
+            std::lock_guard<std::mutex> lock(connection->done_mutex);
+        }
+        connection->done_cv.notify_all();
+    }
+    for (auto& connection : connections) {
+        if (connection->thread.joinable()) connection->thread.join();
+    }
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    for (int& fd : wake_pipe_) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    ::unlink(path_.c_str());
+}
+
+void IpcServer::accept_loop() {
+    while (!stopping_.load()) {
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_pipe_[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "IPC poll failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        if (stopping_.load() || (fds[1].revents & POLLIN)) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) continue;
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        no_sigpipe(fd);
+
+        auto connection = std::make_shared<Connection>();
+        connection->fd = fd;
+
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        // Reap clients that have disconnected
+        for (auto it = connections_.begin(); it != connections_.end();) {
+            if ((*it)->finished.load()) {
+                (*it)->thread.join();
+                it = connections_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        connection->thread = std::thread([this, connection]() { serve(connection); });
+        connections_.push_back(connection);
+    }
+}
+
+void IpcServer::serve(std::shared_ptr<Connection> connection) {
+    Connection& c = *connection;
+
+    while (!stopping_.load()) {
+        size_t newline = c.in.find('\n');
+        if (newline == std::string::npos) {
+            if (c.in.size() > MAX_LINE || !c.receive()) break;
+            continue;
+        }
+        std::string line = c.in.substr(0, newline);
+        c.in.erase(0, newline + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        const std::vector<std::string> words = split_words(line);
+        if (words.empty()) continue;
+
+        if (words[0] == "STATUS") {
+            std::string fields = handlers_.status ? handlers_.status() : std::string();
+            c.send_line("{\"type\":\"status\"" + (fields.empty() ? "" : "," + fields) + "}");
+            continue;
+        }
+
+        if (words[0] != "TRANSCRIBE" || words.size() < 2) {
+            c.send_line(error_json("unknown request: " + line));
+            continue;
+        }
+
+        const size_t samples = static_cast<size_t>(std::strtoull(words[1].c_str(), nullptr, 10));
+        bool inline_audio = false;
+        bool partials = false;
+        for (size_t i = 2; i < words.size(); ++i) {
+            if (words[i] == "inline") inline_audio = true;
+            else if (words[i] == "partial") partials = true;
+        }
+        if (samples == 0 || samples > MAX_SAMPLES) {
+            c.send_line(error_json("sample count must be between 1 and " + std::to_string(MAX_SAMPLES)));
+            continue;
+        }
+
+        std::shared_ptr<SharedAudio> audio;
+        std::string error;
+        if (inline_audio) {
+            const size_t bytes = samples * sizeof(float);
+            while (c.in.size() < bytes && c.receive()) {}
+            if (c.in.size() < bytes) break;  // Disconnected mid-request
+            std::vector<float> owned(samples);
+            std::memcpy(owned.data(), c.in.data(), bytes);
+            c.in.erase(0, bytes);
+            audio = SharedAudio::own(std::move(owned));
+        } else if (c.fds.empty()) {
+            error = "no shared memory descriptor with the request (use 'inline' to send samples on the socket)";
+        } else {
+            const int fd = c.fds.front();
+            c.fds.pop_front();
+            audio = SharedAudio::map(fd, samples, error);
+            ::close(fd);  // The mapping stays valid
+        }
+        if (!audio) {
+            c.send_line(error_json(error));
+            continue;
+        }
+
+        requests_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(c.done_mutex);
+            c.done = false;
+        }
+        Reply reply = [connection](const std::string& json, bool final) {
+            bool sent = connection->send_line(json);
+            if (final) {
+                {
+                    std::lock_guard<std::mutex> lock(connection->done_mutex);
+                    connection->done = true;
+                }
+                connection->done_cv.notify_all();
+            }
+            return sent;
+        };
+        handlers_.transcribe(std::move(audio), partials, std::move(reply));
+
+        // One request at a time per connection; replies keep their order
+        std::unique_lock<std::mutex> lock(c.done_mutex);
+        c.done_cv.wait(lock, [&]() { return c.done || stopping_.load(); });
+    }
+
+    ::shutdown(c.fd, SHUT_RDWR);  // A dropped client sees EOF now, not when it's reaped
+    c.finished.store(true);
+}
+
+std::string IpcServer::quote(const std::string& text) {
+    std::ostringstream out;
+    out << '"';
+    for (char ch : text) {
+        switch (ch) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(ch)
+                        << std::dec << std::setfill(' ');
+                } else {
+                    out << ch;
+                }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+std::string IpcServer::partial_json(const std::string& text) {
+    return "{\"type\":\"partial\",\"text\":" + quote(text) + "}";
+}
+
+std::string IpcServer::result_json(const TranscriptionResult& result) {
+    if (!result.success) return error_json(result.error);
+
+    std::ostringstream out;
+    out << "{\"type\":\"result\",\"text\":" << quote(result.text)
+        << ",\"raw_text\":" << quote(result.raw_text)
+        << ",\"confidence\":" << std::fixed << std::setprecision(3) << result.confidence
+        << ",\"duration_ms\":" << result.duration_ms << ",\"segments\":[";
+    for (size_t i = 0; i < result.segments.size(); ++i) {
+        const TranscriptionSegment& segment = result.segments[i];
+        out << (i ? "," : "") << "{\"start_ms\":" << segment.t0_ms << ",\"end_ms\":" << segment.t1_ms
+            << ",\"text\":" << quote(segment.text) << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+std::string IpcServer::error_json(const std::string& error) {
+    return "{\"type\":\"error\",\"error\":" + quote(error) + "}";
+}
+
+IpcClient::~IpcClient() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool IpcClient::connect(const std::string& path) {
+    sockaddr_un address;
+    if (!fill_address(path, address)) {
+        error_ = "socket path too long";
+        return false;
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        error_ = "cannot connect to " + path + ": " + std::strerror(errno) + " (is voxtype --daemon running?)";
+        return false;
+    }
+    no_sigpipe(fd_);
+    return true;
+}
+
+bool IpcClient::read_line(std::string& line) {
+    for (;;) {
+        size_t newline = buffer_.find('\n');
+        if (newline != std::string::npos) {
+            line = buffer_.substr(0, newline);
+            buffer_.erase(0, newline + 1);
+            return true;
+        }
+        char data[4096];
+        ssize_t n = ::recv(fd_, data, sizeof(data), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            error_ = "daemon closed the connection";
+            return false;
+        }
+        buffer_.append(data, static_cast<size_t>(n));
+    }
+}
+
+bool IpcClient::status(std::string& line) {
+    const char request[] = "STATUS\n";
+    if (!send_all(fd_, request, sizeof(request) - 1)) {
+        error_ = "send failed";
+        return false;
+    }
+    return read_line(line);
+}
+
+bool IpcClient::transcribe(Span<const float> samples, bool partials,
+                           const std::function<void(const std::string& line)>& on_line) {
+    const size_t bytes = samples.size() * sizeof(float);
+
+#ifdef F_ADD_SEALS
+    // Anonymous shared memory; the daemon maps it from the passed descriptor
+    int memory = memfd_create("voxtype-audio", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memory < 0 || ftruncate(memory, static_cast<off_t>(bytes)) != 0) {
+        error_ = std::string("cannot create shared memory: ") + std::strerror(errno);
+        if (memory >= 0) ::close(memory);
+        return false;
+    }
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0);
+    if (mapping == MAP_FAILED) {
+        error_ = std::string("cannot map shared memory: ") + std::strerror(errno);
+        ::close(memory);
+        return false;
+    }
+    std::memcpy(mapping, samples.data(), bytes);
+    munmap(mapping, bytes);  // F_SEAL_WRITE fails while a writable shared mapping exists
+
+    // Sealed, the daemon can rely on the size and contents not changing under it
+    if (fcntl(memory, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+        error_ = std::string("cannot seal shared memory: ") + std::strerror(errno);
+        ::close(memory);
+        return false;
+    }
+
+    const std::string request = "TRANSCRIBE " + std::to_string(samples.size()) + (partials ? " partial" : "") + "\n";
+    iovec iov{const_cast<char*>(request.data()), request.size()};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* c = CMSG_FIRSTHDR(&message);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(c), &memory, sizeof(int));
+
+    const bool sent = ::sendmsg(fd_, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(request.size());
+    ::close(memory);  // The daemon holds its own reference now
+#else
+    // shm_open files can't be sealed, so the daemon won't map them: copy
+    // the samples through the socket instead
+    const std::string request = "TRANSCRIBE " + std::to_string(samples.size()) + " inline" +
+                                (partials ? " partial" : "") + "\n";
+    const bool sent = send_all(fd_, request.data(), request.size()) &&
+                      send_all(fd_, reinterpret_cast<const char*>(samples.data()), bytes);
+#endif
+    if (!sent) {
+        error_ = std::string("send failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    std::string line;
+    while (read_line(line)) {
+        on_line(line);
+        if (starts_with(line, "{\"type\":\"result\"")) return true;
+        if (starts_with(line, "{\"type\":\"error\"")) {
+            error_ = "daemon reported an error";
+            return false;
+        }
+    }
+    return false;
+}
+
+} // namespace whispr
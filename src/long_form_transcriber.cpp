@@ -0,0 +1,238 @@
+#include "long_form_transcriber.hpp"
+#include "text_processor.hpp"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+namespace whispr {
+
+namespace {
+
+// Prompt context: whisper keeps at most half its text context of prompt
+// tokens, so a few hundred characters of the latest text is plenty
+constexpr size_t CONTEXT_CHARS = 600;
+
+ChunkerConfig chunker_config(const LongFormConfig& config) {
+    ChunkerConfig chunker;
+    chunker.sample_rate = config.sample_rate;
+    chunker.target_ms = config.chunk_ms;
+    chunker.max_ms = config.max_chunk_ms;
+    chunker.min_pause_ms = config.min_pause_ms;
+    chunker.threshold = config.silence_threshold;
+    return chunker;
+}
+
+} // namespace
+
+LongFormTranscriber::LongFormTranscriber(Transcriber& transcriber, const LongFormConfig& config)
+    : transcriber_(transcriber)
+    , config_(config)
+    , chunker_(chunker_config(config), [this](AudioChunk&& chunk) { pending_.push_back(std::move(chunk)); }) {
+    intake_.allocate(static_cast<size_t>(config_.sample_rate) * config_.intake_seconds);
+    drain_scratch_.resize(4096);
+    const size_t overlap_samples = static_cast<size_t>(config_.overlap_ms) * config_.sample_rate / 1000;
+    overlap_.reserve(overlap_samples);
+    window_.reserve(overlap_samples + static_cast<size_t>(config_.max_chunk_ms) * config_.sample_rate / 1000);
+}
+
+LongFormTranscriber::~LongFormTranscriber() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_.store(true);
+    }
+    wake_cv_.notify_all();
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
+}
+
+void LongFormTranscriber::begin() {
+    if (active_.load()) return;
+
+    intake_.reset();
+    dropped_samples_.store(0);
+    pending_.clear();
+    overlap_.clear();
+    text_.clear();
+    segments_.clear();
+    confidence_sum_ = 0.0;
+    confidence_weight_ = 0;
+    chunks_decoded_ = 0;
+    error_.clear();
+
+    stopping_.store(false);
+    active_.store(true);
+    decode_thread_ = std::thread([this]() { decode_loop(); });
+}
+
+void LongFormTranscriber::feed(Span<const float> samples) {
+    if (!active_.load(std::memory_order_acquire) || stopping_.load(std::memory_order_relaxed)) return;
+
+    size_t written = intake_.write(samples.data(), samples.size());
+    if (written < samples.size()) {
+        dropped_samples_.fetch_add(samples.size() - written, std::memory_order_relaxed);
+    }
+}
+
+void LongFormTranscriber::drain_intake() {
+    size_t n;
+    while ((n = intake_.read(drain_scratch_.data(), drain_scratch_.size())) > 0) {
+        chunker_.feed(Span<const float>(drain_scratch_.data(), n));
+    }
+}
+
+void LongFormTranscriber::decode_loop() {
+    // The audio callback can't signal us without risking a lock, so poll the intake
+    const auto poll_interval = std::chrono::milliseconds(50);
+
+    while (!stopping_.load()) {
+        drain_intake();
+
+        if (!pending_.empty()) {
+            AudioChunk chunk = std::move(pending_.front());
+            pending_.pop_front();
+            decode_chunk(chunk);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, poll_interval, [this]() { return stopping_.load(); });
+    }
+}
+
+bool LongFormTranscriber::decode_chunk(AudioChunk& chunk) {
+    bool ok = true;
+
+    if (chunk.has_speech) {
+        // Previous chunk's end first, so words cut at the boundary are heard whole
+        window_.assign(overlap_.begin(), overlap_.end());
+        window_.insert(window_.end(), chunk.samples.begin(), chunk.samples.end());
+        if (processor_) {
+            // Capture already filtered the samples; only the gain stages depend on the window
+            processor_->finish(window_, AudioProcessor::measure(window_));
+        }
+        // Whisper requires minimum 100ms of audio
+        const size_t min_samples = config_.sample_rate / 10;
+        if (window_.size() < min_samples) window_.resize(min_samples, 0.0f);
+
+        DecodeOptions options;
+        options.multi_segment = true;
+        options.process_text = false;
+        options.log_result = false;
+        options.context = text_.size() > CONTEXT_CHARS ? text_.substr(text_.size() - CONTEXT_CHARS) : text_;
+
+        TranscriptionResult result = transcriber_.transcribe_with_profile(window_, transcriber_.get_profile(), options);
+        if (result.success) {
+            // Segments inside the overlap were already transcribed with the previous chunk
+            const int64_t overlap_ms = static_cast<int64_t>(overlap_.size()) * 1000 / config_.sample_rate;
+            const int64_t offset_ms = chunk.start_sample * 1000 / config_.sample_rate - overlap_ms;
+            bool first = true;
+            for (const TranscriptionSegment& segment : result.segments) {
+                if (segment.t1_ms <= overlap_ms) continue;
+                std::string piece = first ? TextProcessor::drop_overlap(text_, segment.text) : segment.text;
+                first = false;
+                if (piece.find_first_not_of(" \t\n\r") == std::string::npos) continue;
+                text_ += piece;
+                segments_.push_back({segment.t0_ms + offset_ms, segment.t1_ms + offset_ms, piece});
+            }
+            confidence_sum_ += static_cast<double>(result.confidence) * chunk.samples.size();
+            confidence_weight_ += chunk.samples.size();
+        } else {
+            std::cerr << "Long-form chunk at " << (chunk.start_sample / config_.sample_rate)
+                      << "s failed: " << result.error << std::endl;
+            error_ = result.error;
+            ok = false;
+        }
+        ++chunks_decoded_;
+    }
+
+    // Keep the end of this chunk for the next one; silence needs no context
+    overlap_.clear();
+    if (chunk.has_speech) {
+        const size_t overlap_samples = static_cast<size_t>(config_.overlap_ms) * config_.sample_rate / 1000;
+        const size_t keep = std::min(overlap_samples, chunk.samples.size());
+        overlap_.assign(chunk.samples.end() - static_cast<std::ptrdiff_t>(keep), chunk.samples.end());
+    }
+
+    // Hand the buffer back so the next chunk reuses it
+    const int64_t end_sample = chunk.start_sample + static_cast<int64_t>(chunk.samples.size());
+    chunker_.recycle(std::move(chunk.samples));
+
+    if (ok && chunk.has_speech) {
+        std::cout << "Long-form: chunk " << chunks_decoded_ << " done, "
+                  << (end_sample * 1000 / config_.sample_rate) << "ms final" << std::endl;
+        if (commit_callback_ && !stopping_.load()) {
+            std::string committed = trimmed_text();
+            if (!committed.empty()) commit_callback_(committed);
+        }
+    }
+    return ok;
+}
+
+std::string LongFormTranscriber::trimmed_text() const {
+    size_t first = text_.find_first_not_of(" \t\n\r");
+    size_t last = text_.find_last_not_of(" \t\n\r");
+    return first == std::string::npos ? std::string() : text_.substr(first, last - first + 1);
+}
+
+TranscriptionResult LongFormTranscriber::finish() {
+    TranscriptionResult result;
+    result.success = false;
+    result.confidence = 0.0f;
+    result.duration_ms = 0;
+
+    if (!active_.load()) {
+        result.error = "Long-form session not active";
+        return result;
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_.store(true);
+    }
+    wake_cv_.notify_all();
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
+
+    // Whatever arrived after the decode thread's last drain, then the unfinished chunk
+    drain_intake();
+    chunker_.finish();
+    if (dropped_samples_.load() > 0) {
+        std::cerr << "Long-form intake full, dropped " << dropped_samples_.load() << " samples" << std::endl;
+    }
+
+    const size_t remaining = pending_.size();
+    while (!pending_.empty()) {
+        AudioChunk chunk = std::move(pending_.front());
+        pending_.pop_front();
+        decode_chunk(chunk);
+    }
+    active_.store(false);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    // Keep what was transcribed even if a chunk failed; fail only if nothing was
+    if (text_.empty() && !error_.empty()) {
+        result.error = error_;
+        return result;
+    }
+
+    result.raw_text = trimmed_text();
+    result.text = transcriber_.post_process(result.raw_text);
+    result.confidence = confidence_weight_ > 0
+        ? static_cast<float>(confidence_sum_ / static_cast<double>(confidence_weight_)) : 0.0f;
+    result.segments = std::move(segments_);
+    result.success = true;
+
+    std::cout << "Transcription [Long-form] " << chunks_decoded_ << " chunk(s), " << remaining
+              << " after release, took " << result.duration_ms << "ms (conf: "
+              << static_cast<int>(result.confidence * 100) << "%): \"" << result.text << "\"" << std::endl;
+
+    return result;
+}
+
+} // namespace whispr
@@ -1,16 +1,27 @@
 #include "app.hpp"
+#include "batch_transcriber.hpp"
 #include "config.hpp"
+#include "history_store.hpp"
+#include "ipc_server.hpp"
+#include "wav_reader.hpp"
 #include <iostream>
 #include <csignal>
 #include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
 
 static whispr::App* g_app = nullptr;
+static whispr::BatchTranscriber* g_batch = nullptr;
 
 void signal_handler(int signum) {
     std::cout << "\nReceived signal " << signum << ", shutting down..." << std::endl;
     if (g_app) {
         g_app->quit();
     }
+    if (g_batch) {
+        g_batch->cancel();
+    }
 }
 
 void print_usage(const char* program) {
@@ -18,11 +29,39 @@ void print_usage(const char* program) {
               << "\nOptions:\n"
               << "  -q, --quality MODE  Quality mode: fast, balanced, accurate, best (default: balanced)\n"
               << "  -m, --model-dir DIR Directory containing models (default: models)\n"
-              << "  -t, --threads N     Number of CPU threads (default: 4)\n"
+              << "  -p, --precision P   Model weights: auto, f16, q8, q5 (default: auto, from CPU, RAM and GPU)\n"
+              << "  -t, --threads N     Number of CPU threads (default: tuned for this machine)\n"
+              << "  -j, --jobs N        Recordings transcribed in parallel (default: 1)\n"
               << "  -l, --language LANG Language code (default: en)\n"
               << "  -k, --keycode N     Hotkey keycode (default: Right Option/Alt)\n"
               << "  --no-paste          Don't auto-paste, just copy to clipboard\n"
+              << "  --type              Type text into the focused window instead of pasting\n"
               << "  --no-preprocess     Disable audio preprocessing\n"
+              << "  --no-gpu            Run inference on the CPU only\n"
+              << "  --no-warmup         Skip the warm-up decode at startup\n"
+              << "  --latency           Print per-stage latency percentiles on exit\n"
+              << "  --trace FILE        Write a Chrome trace of every pipeline stage on exit\n"
+              << "  --gpu-device N      GPU to use (default: the one with the most free memory)\n"
+              << "  --stream            Transcribe while recording (lower release-to-paste latency)\n"
+              << "  --long              No recording limit: decode in pause-cut chunks while recording\n"
+              << "  --continuous        Start hands-free: transcribe each utterance when you pause (hotkey stops)\n"
+              << "  --end-silence MS    Hands-free: pause that ends an utterance (default: 700)\n"
+              << "  --preroll MS        Keep the microphone open and include MS of audio from before the key press\n"
+              << "  --idle-compact MIN  Free decode buffers after MIN idle minutes (default: 5, 0 = never)\n"
+              << "  --idle-unload MIN   Unload the model after MIN idle minutes (default: 30, 0 = never)\n"
+              << "  -i, --input FILE    Transcribe FILE and exit (repeatable; WAV, or FLAC/Opus/MP3 via ffmpeg)\n"
+              << "  --batch DIR         Transcribe every audio file in DIR and exit\n"
+              << "  --format FMT        Batch output: txt, json or srt (default: txt)\n"
+              << "  --output-dir DIR    Write batch output here (default: next to each input)\n"
+              << "  --daemon            Also serve transcriptions to other tools on a Unix socket\n"
+              << "  --socket PATH       Daemon socket (default: $XDG_RUNTIME_DIR/voxtype.sock)\n"
+              << "  --send FILE         Transcribe a WAV file with the running daemon and print its replies\n"
+              << "  --partial           With --send: print partial text as chunks are decoded\n"
+              << "  --status            Print the running daemon's status\n"
+              << "  --history           Print the 20 most recent dictations\n"
+              << "  --search QUERY      Print dictations containing every word of QUERY\n"
+              << "  --history-file PATH History log (default: ~/.whispr/history.log)\n"
+              << "  --no-history        Don't save dictations\n"
               << "  -h, --help          Show this help\n"
               << "\nQuality Modes:\n"
               << "  fast     - Fastest, ~80% accuracy (tiny.en model)\n"
@@ -39,8 +78,78 @@ void print_usage(const char* program) {
               << std::endl;
 }
 
+// Client of a running daemon: one request, replies printed as JSON lines
+int run_client(const whispr::Config& config, const std::string& send_path, bool partial) {
+    const std::string socket_path = config.socket_path.empty()
+        ? whispr::IpcServer::default_socket_path() : config.socket_path;
+    whispr::IpcClient client;
+    if (!client.connect(socket_path)) {
+        std::cerr << client.error() << std::endl;
+        return 1;
+    }
+
+    if (send_path.empty()) {
+        std::string line;
+        if (!client.status(line)) {
+            std::cerr << client.error() << std::endl;
+            return 1;
+        }
+        std::cout << line << std::endl;
+        return 0;
+    }
+
+    std::vector<float> samples;
+    std::string error;
+    if (!whispr::WavReader::read_all(send_path, samples, config.sample_rate, &error)) {
+        std::cerr << send_path << ": " << error << std::endl;
+        return 1;
+    }
+    const bool ok = client.transcribe(samples, partial, [](const std::string& line) {
+        std::cout << line << std::endl;
+    });
+    if (!ok) {
+        std::cerr << client.error() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Saved dictations, newest first: all of them, or those matching `query`
+int run_history(const whispr::Config& config, const std::string& query) {
+    const std::string path = config.history_path.empty() ? whispr::HistoryStore::default_path() : config.history_path;
+    whispr::HistoryStore history;
+    if (!history.open(path, true)) {
+        std::cout << "No history yet (" << path << ")" << std::endl;
+        return 0;
+    }
+
+    const size_t count = query.empty() ? 20 : history.size();
+    whispr::HistorySnapshot snapshot = history.snapshot(count, 200, query);
+    for (const auto& item : snapshot.items) {
+        std::time_t seconds = static_cast<std::time_t>(item.time_ms / 1000);
+        std::tm local{};
+        localtime_r(&seconds, &local);
+        char when[32];
+        std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M", &local);
+
+        std::cout << when << "  " << static_cast<int>(item.confidence * 100.0f + 0.5f) << "%  "
+                  << item.preview << std::endl;
+    }
+    if (snapshot.items.empty()) {
+        std::cout << (query.empty() ? "No history yet" : "No matches") << std::endl;
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     whispr::Config config;
+    std::vector<std::string> inputs;  // Files for batch mode (--input, --batch)
+    bool batch = false;
+    std::string send_path;            // Client mode (--send, --status)
+    bool client = false;
+    bool partial = false;
+    bool show_history = false;        // --history, --search
+    std::string history_query;
 
     // Parse arguments
     for (int i = 1; i < argc; ++i) {
@@ -67,9 +176,20 @@ int main(int argc, char* argv[]) {
         else if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--model-dir") == 0) && i + 1 < argc) {
             config.model_dir = argv[++i];
         }
+        else if ((strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--precision") == 0) && i + 1 < argc) {
+            const char* precision = argv[++i];
+            if (!whispr::parse_model_precision(precision, config.model_precision)) {
+                std::cerr << "Unknown model precision: " << precision << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
         else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) && i + 1 < argc) {
             config.n_threads = std::atoi(argv[++i]);
         }
+        else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+            config.parallel_jobs = std::atoi(argv[++i]);
+        }
         else if ((strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--language") == 0) && i + 1 < argc) {
             config.language = argv[++i];
         }
@@ -79,9 +199,92 @@ int main(int argc, char* argv[]) {
         else if (strcmp(argv[i], "--no-paste") == 0) {
             config.auto_paste = false;
         }
+        else if (strcmp(argv[i], "--type") == 0) {
+            config.type_output = true;
+        }
         else if (strcmp(argv[i], "--no-preprocess") == 0) {
             config.audio_preprocessing = false;
         }
+        else if (strcmp(argv[i], "--no-gpu") == 0) {
+            config.use_gpu = false;
+        }
+        else if (strcmp(argv[i], "--no-warmup") == 0) {
+            config.warm_up = false;
+        }
+        else if (strcmp(argv[i], "--latency") == 0) {
+            config.latency_report = true;
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            config.trace_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--gpu-device") == 0 && i + 1 < argc) {
+            config.gpu_device = std::atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stream") == 0) {
+            config.streaming = true;
+        }
+        else if (strcmp(argv[i], "--long") == 0) {
+            config.long_form = true;
+        }
+        else if (strcmp(argv[i], "--continuous") == 0) {
+            config.continuous = true;
+        }
+        else if (strcmp(argv[i], "--end-silence") == 0 && i + 1 < argc) {
+            config.continuous_end_silence_ms = std::atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--preroll") == 0 && i + 1 < argc) {
+            config.preroll_ms = std::atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--idle-compact") == 0 && i + 1 < argc) {
+            config.idle_compact_minutes = std::atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--idle-unload") == 0 && i + 1 < argc) {
+            config.idle_unload_minutes = std::atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) && i + 1 < argc) {
+            inputs.push_back(argv[++i]);
+            batch = true;
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            std::vector<std::string> found = whispr::BatchTranscriber::find_inputs(argv[++i]);
+            inputs.insert(inputs.end(), found.begin(), found.end());
+            batch = true;
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            config.output_format = argv[++i];
+        }
+        else if (strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc) {
+            config.output_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--daemon") == 0) {
+            config.daemon = true;
+        }
+        else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            config.socket_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--send") == 0 && i + 1 < argc) {
+            send_path = argv[++i];
+            client = true;
+        }
+        else if (strcmp(argv[i], "--partial") == 0) {
+            partial = true;
+        }
+        else if (strcmp(argv[i], "--status") == 0) {
+            client = true;
+        }
+        else if (strcmp(argv[i], "--history") == 0) {
+            show_history = true;
+        }
+        else if (strcmp(argv[i], "--search") == 0 && i + 1 < argc) {
+            history_query = argv[++i];
+            show_history = true;
+        }
+        else if (strcmp(argv[i], "--history-file") == 0 && i + 1 < argc) {
+            config.history_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--no-history") == 0) {
+            config.history = false;
+        }
         else {
             std::cerr << "Unknown option: " << argv[i] << std::endl;
             print_usage(argv[0]);
@@ -89,21 +292,63 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (client) {
+        return run_client(config, send_path, partial);
+    }
+    if (show_history) {
+        return run_history(config, history_query);
+    }
+
     // Setup signal handlers
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
+    // Headless: transcribe files and exit
+    if (batch) {
+        whispr::OutputFormat format;
+        if (!whispr::parse_output_format(config.output_format, format)) {
+            std::cerr << "Unknown output format: " << config.output_format << std::endl;
+            return 1;
+        }
+        if (inputs.empty()) {
+            std::cerr << "No audio files to transcribe" << std::endl;
+            return 1;
+        }
+
+        whispr::BatchTranscriber batch_transcriber(config);
+        g_batch = &batch_transcriber;
+        int failed = batch_transcriber.run(inputs, format);
+        g_batch = nullptr;
+
+        if (failed > 0) {
+            std::cerr << failed << " of " << inputs.size() << " file(s) failed" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     // Create and initialize app
     whispr::App app;
     g_app = &app;
 
     std::cout << "VoxType - Voice to Text\n" << std::endl;
     std::cout << "Quality: " << whispr::get_profile(config.model_quality).name << std::endl;
-    std::cout << "Model: " << config.get_model_path() << std::endl;
-    std::cout << "Threads: " << config.n_threads << std::endl;
+    if (config.n_threads > 0) {
+        std::cout << "Threads: " << config.n_threads << std::endl;
+    } else {
+        std::cout << "Threads: auto" << std::endl;
+    }
+    std::cout << "Parallel jobs: " << config.parallel_jobs << std::endl;
     std::cout << "Language: " << config.language << std::endl;
     std::cout << "Auto-paste: " << (config.auto_paste ? "yes" : "no") << std::endl;
+    std::cout << "Type output: " << (config.type_output ? "yes" : "no") << std::endl;
     std::cout << "Audio preprocessing: " << (config.audio_preprocessing ? "yes" : "no") << std::endl;
+    std::cout << "Streaming: " << (config.streaming ? "yes" : "no") << std::endl;
+    std::cout << "Long-form: " << (config.long_form ? "yes" : "no") << std::endl;
+    std::cout << "Hands-free: " << (config.continuous ? "yes" : "no") << std::endl;
+    std::cout << "Daemon: " << (config.daemon ? "yes" : "no") << std::endl;
+    std::cout << "Idle compact/unload: " << config.idle_compact_minutes << "/" << config.idle_unload_minutes
+              << " min" << std::endl;
     std::cout << std::endl;
 
     if (!app.initialize(config)) {
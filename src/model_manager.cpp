@@ -0,0 +1,437 @@
+#include "model_manager.hpp"
+#include "whisper.h"
+#include "ggml-backend.h"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace whispr {
+
+namespace {
+
+// Read-only mapping of a model file, served to whisper through a custom loader.
+// Reads are memcpy's out of the page cache instead of buffered stdio, and the
+// kernel keeps the pages cached across restarts.
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+
+    bool open(const std::string& path, bool prefetch = true) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps the file referenced
+        if (mapping == MAP_FAILED) return false;
+
+        data = static_cast<const uint8_t*>(mapping);
+        size = static_cast<size_t>(st.st_size);
+        offset = 0;
+
+        // Whisper reads the file front to back exactly once
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        if (prefetch) madvise(mapping, size, MADV_WILLNEED);
+        return true;
+    }
+
+    // Start reading the whole file into the page cache in the background
+    void prefetch() {
+        if (data) madvise(const_cast<uint8_t*>(data), size, MADV_WILLNEED);
+    }
+
+    void close() {
+        if (data) {
+            munmap(const_cast<uint8_t*>(data), size);
+            data = nullptr;
+        }
+    }
+
+    static size_t read(void* ctx, void* output, size_t read_size) {
+        auto* file = static_cast<MappedFile*>(ctx);
+        size_t n = std::min(read_size, file->size - file->offset);
+        std::memcpy(output, file->data + file->offset, n);
+        file->offset += n;
+        return n;
+    }
+
+    static bool eof(void* ctx) {
+        auto* file = static_cast<MappedFile*>(ctx);
+        return file->offset >= file->size;
+    }
+
+    static void close_cb(void* ctx) {
+        static_cast<MappedFile*>(ctx)->close();
+    }
+};
+
+const char* quality_name(ModelQuality quality) {
+    return get_profile(quality).name;
+}
+
+// Weights only; decode states come from the pool
+whisper_context* init_context(const std::string& path, const whisper_context_params& cparams,
+                              uint64_t& file_bytes) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return whisper_init_from_file_with_params_no_state(path.c_str(), cparams);
+    }
+    file_bytes = file.size;
+
+    whisper_model_loader loader;
+    loader.context = &file;
+    loader.read = &MappedFile::read;
+    loader.eof = &MappedFile::eof;
+    loader.close = &MappedFile::close_cb;
+
+    whisper_context* ctx = whisper_init_with_params_no_state(&loader, cparams);
+    file.close();  // Weights are copied into whisper's buffers; idempotent if the loader closed it
+    return ctx;
+}
+
+} // namespace
+
+std::vector<GpuDevice> list_gpu_devices() {
+    std::vector<GpuDevice> devices;
+    for (size_t i = 0; i < ggml_backend_dev_count(); ++i) {
+        ggml_backend_dev_t dev = ggml_backend_dev_get(i);
+        if (ggml_backend_dev_type(dev) != GGML_BACKEND_DEVICE_TYPE_GPU) continue;
+
+        GpuDevice device;
+        device.index = static_cast<int>(devices.size());
+        device.name = ggml_backend_dev_name(dev);
+        device.description = ggml_backend_dev_description(dev);
+        device.free_bytes = 0;
+        device.total_bytes = 0;
+        ggml_backend_dev_memory(dev, &device.free_bytes, &device.total_bytes);
+        devices.push_back(std::move(device));
+    }
+    return devices;
+}
+
+std::shared_ptr<WhisperModel> WhisperModel::load(const std::string& path, size_t max_states, bool use_gpu,
+                                                 int gpu_device) {
+    auto start_time = std::chrono::steady_clock::now();
+    const uint64_t rss_before = resident_memory_bytes();
+
+    struct whisper_context_params cparams = whisper_context_default_params();
+    cparams.use_gpu = use_gpu;
+    cparams.gpu_device = gpu_device;
+    // Supported by the Metal, CUDA and Vulkan backends; a large share of decode time on GPU
+    cparams.flash_attn = use_gpu;
+
+    std::shared_ptr<WhisperModel> model(new WhisperModel());
+    model->path_ = path;
+    model->on_gpu_ = use_gpu;
+
+    model->ctx_ = init_context(path, cparams, model->file_bytes_);
+    if (!model->ctx_ && use_gpu) {
+        // Out of device memory, driver trouble, ...: the CPU still works
+        std::cerr << "GPU initialization failed, falling back to CPU" << std::endl;
+        cparams.use_gpu = false;
+        cparams.flash_attn = false;
+        model->on_gpu_ = false;
+        model->ctx_ = init_context(path, cparams, model->file_bytes_);
+    }
+
+    if (!model->ctx_) {
+        std::cerr << "Failed to load whisper model: " << path << std::endl;
+        return nullptr;
+    }
+
+    if (!model->states_.initialize(model->ctx_, max_states)) {
+        return nullptr;  // Destructor frees the context
+    }
+
+    auto end_time = std::chrono::steady_clock::now();
+    model->load_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    const uint64_t rss_after = resident_memory_bytes();
+    model->memory_bytes_ = rss_after > rss_before ? rss_after - rss_before : 0;
+
+    std::cout << "Loaded whisper model: " << path << " (" << (model->file_bytes_ / (1024 * 1024))
+              << " MB file, +" << (model->memory_bytes_ / (1024 * 1024)) << " MB resident, "
+              << model->load_ms_ << "ms, " << (model->on_gpu_ ? "GPU" : "CPU") << ")" << std::endl;
+    return model;
+}
+
+WhisperModel::~WhisperModel() {
+    states_.shutdown();
+    if (ctx_) {
+        whisper_free(ctx_);
+        ctx_ = nullptr;
+    }
+}
+
+struct ModelManager::ParkedFile {
+    std::string path;
+    MappedFile file;
+
+    ~ParkedFile() { file.close(); }
+};
+
+ModelManager::ModelManager(const std::string& model_dir, size_t capacity, size_t max_states, bool use_gpu,
+                           int gpu_device, ModelPrecision precision)
+    : model_dir_(model_dir)
+    , capacity_(std::max<size_t>(capacity, 1))
+    , max_states_(max_states)
+    , use_gpu_(use_gpu)
+    , precision_(precision)
+    , cpu_(cpu_features())
+    , available_mb_(available_memory_mb()) {
+    if (use_gpu_) {
+        std::vector<GpuDevice> devices = list_gpu_devices();
+        if (devices.empty()) {
+            std::cout << "No GPU backend available, running on CPU" << std::endl;
+            use_gpu_ = false;
+        } else {
+            const GpuDevice* chosen = nullptr;
+            if (gpu_device >= static_cast<int>(devices.size())) {
+                std::cerr << "GPU " << gpu_device << " not found, choosing automatically" << std::endl;
+            } else if (gpu_device >= 0) {
+                chosen = &devices[gpu_device];
+            }
+            for (const auto& device : devices) {
+                std::cout << "GPU " << device.index << ": " << device.description << " [" << device.name << "], "
+                          << (device.free_bytes / (1024 * 1024)) << "/" << (device.total_bytes / (1024 * 1024))
+                          << " MB free" << std::endl;
+                // Most free memory is the least likely to be busy with something else
+                if (gpu_device < 0 && (!chosen || device.free_bytes > chosen->free_bytes)) {
+                    chosen = &device;
+                }
+            }
+            if (!chosen) chosen = &devices.front();
+            gpu_device_ = chosen->index;
+            std::cout << "Using GPU " << gpu_device_ << std::endl;
+        }
+    }
+    prefer_gpu_precision_ = use_gpu_;
+    if (precision_ == ModelPrecision::Auto) {
+        std::cout << "Model precision: auto (" << (prefer_gpu_precision_ ? "GPU" : "CPU")
+                  << (cpu_.avx512 ? ", AVX-512" : cpu_.avx2 ? ", AVX2" : cpu_.neon ? ", NEON" : ", no SIMD")
+                  << ", " << available_mb_ << " MB available)" << std::endl;
+    }
+    loader_thread_ = std::thread([this]() { loader_loop(); });
+}
+
+ModelManager::~ModelManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        requests_.clear();
+    }
+    requests_cv_.notify_all();
+    if (loader_thread_.joinable()) {
+        loader_thread_.join();
+    }
+}
+
+std::string ModelManager::path_for(ModelQuality quality) const {
+    return model_dir_ + "/" + get_model_filename(quality, precision_for(quality));
+}
+
+ModelPrecision ModelManager::precision_for(ModelQuality quality) const {
+    const ModelPrecision wanted = precision_ != ModelPrecision::Auto
+        ? precision_
+        : select_model_precision(quality, prefer_gpu_precision_, cpu_.fast_int8(), available_mb_);
+
+    // Nearest precision that is on disk: towards accuracy first, then size
+    ModelPrecision order[3];
+    switch (wanted) {
+        case ModelPrecision::Q8: order[0] = ModelPrecision::Q8; order[1] = ModelPrecision::F16; order[2] = ModelPrecision::Q5; break;
+        case ModelPrecision::Q5: order[0] = ModelPrecision::Q5; order[1] = ModelPrecision::Q8; order[2] = ModelPrecision::F16; break;
+        default: order[0] = ModelPrecision::F16; order[1] = ModelPrecision::Q8; order[2] = ModelPrecision::Q5; break;
+    }
+    for (ModelPrecision precision : order) {
+        struct stat st;
+        if (stat((model_dir_ + "/" + get_model_filename(quality, precision)).c_str(), &st) == 0) {
+            return precision;
+        }
+    }
+    return wanted;  // Nothing on disk; fail on the preferred name
+}
+
+bool ModelManager::is_loaded(ModelQuality quality) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : lru_) {
+        if (entry.quality == quality) return true;
+    }
+    return false;
+}
+
+std::shared_ptr<WhisperModel> ModelManager::find_locked(ModelQuality quality) {
+    for (auto it = lru_.begin(); it != lru_.end(); ++it) {
+        if (it->quality == quality) {
+            lru_.splice(lru_.begin(), lru_, it);
+            return lru_.front().model;
+        }
+    }
+    return nullptr;
+}
+
+void ModelManager::insert_locked(ModelQuality quality, std::shared_ptr<WhisperModel> model) {
+    lru_.push_front({quality, std::move(model)});
+    while (lru_.size() > capacity_) {
+        // In-flight decodes keep their own reference; memory is freed after them
+        std::cout << "Evicting " << quality_name(lru_.back().quality) << " model from cache" << std::endl;
+        lru_.pop_back();
+    }
+}
+
+std::shared_ptr<WhisperModel> ModelManager::load_shared(ModelQuality quality) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const int key = static_cast<int>(quality);
+
+    // Another thread may already be loading it
+    loaded_cv_.wait(lock, [&]() { return loading_.count(key) == 0; });
+    if (auto model = find_locked(quality)) return model;
+
+    loading_.insert(key);
+    const bool use_gpu = use_gpu_;
+    lock.unlock();
+
+    const ModelPrecision precision = precision_for(quality);
+    if (precision_ != ModelPrecision::Auto && precision != precision_) {
+        std::cerr << "No " << precision_name(precision_) << " " << quality_name(quality)
+                  << " model, loading " << precision_name(precision) << " instead" << std::endl;
+    }
+    auto model = WhisperModel::load(path_for(quality), max_states_, use_gpu, gpu_device_);
+
+    lock.lock();
+    loading_.erase(key);
+    if (model) {
+        if (!model->on_gpu()) use_gpu_ = false;
+        insert_locked(quality, model);
+        parked_.erase(std::remove_if(parked_.begin(), parked_.end(),
+                                     [&](const std::shared_ptr<ParkedFile>& parked) { return parked->path == model->path(); }),
+                      parked_.end());
+    }
+    lock.unlock();
+    loaded_cv_.notify_all();
+    return model;
+}
+
+std::shared_ptr<WhisperModel> ModelManager::get(ModelQuality quality) {
+    return load_shared(quality);
+}
+
+void ModelManager::request(ModelQuality quality, ReadyCallback on_ready) {
+    std::shared_ptr<WhisperModel> hot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hot = find_locked(quality);
+        if (!hot) {
+            requests_.push_back({quality, std::move(on_ready)});
+        }
+    }
+
+    if (hot) {
+        if (on_ready) on_ready(hot);
+        return;
+    }
+    requests_cv_.notify_one();
+}
+
+void ModelManager::preload(ModelQuality quality) {
+    request(quality, nullptr);
+}
+
+void ModelManager::preload_neighbor(ModelQuality current) {
+    if (capacity_ < 2) return;  // Would just evict the model in use
+
+    // Users mostly step up one level when results aren't good enough
+    switch (current) {
+        case ModelQuality::Fast: preload(ModelQuality::Balanced); break;
+        case ModelQuality::Balanced: preload(ModelQuality::Accurate); break;
+        case ModelQuality::Accurate: preload(ModelQuality::Best); break;
+        case ModelQuality::Best: preload(ModelQuality::Accurate); break;
+    }
+}
+
+void ModelManager::wake(ModelQuality quality, ReadyCallback on_ready) {
+    const std::string path = path_for(quality);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& parked : parked_) {
+            if (parked->path == path) parked->file.prefetch();
+        }
+        LoadRequest request;
+        request.quality = quality;
+        request.on_ready = std::move(on_ready);
+        request.warm_state = true;
+        requests_.push_back(std::move(request));
+    }
+    requests_cv_.notify_one();
+}
+
+size_t ModelManager::trim_states() {
+    std::vector<std::shared_ptr<WhisperModel>> models;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : lru_) models.push_back(entry.model);
+    }
+    size_t freed = 0;
+    for (const auto& model : models) {
+        freed += model->states().trim();
+    }
+    return freed;
+}
+
+void ModelManager::unload_all() {
+    std::list<Entry> unloaded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unloaded.swap(lru_);
+        for (const auto& entry : unloaded) {
+            auto parked = std::make_shared<ParkedFile>();
+            parked->path = entry.model->path();
+            if (parked->file.open(parked->path, false)) {
+                parked_.push_back(std::move(parked));
+            }
+        }
+    }
+    // Freed here unless a decode still holds one
+    for (const auto& entry : unloaded) {
+        std::cout << "Unloading " << quality_name(entry.quality) << " model" << std::endl;
+    }
+}
+
+size_t ModelManager::loaded_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+void ModelManager::loader_loop() {
+    while (true) {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            requests_cv_.wait(lock, [this]() { return stopping_ || !requests_.empty(); });
+            if (stopping_) return;
+
+            request = std::move(requests_.front());
+            requests_.pop_front();
+        }
+
+        auto model = load_shared(request.quality);
+        if (model && request.warm_state) {
+            // Created on first acquire, back in the pool when the lease ends
+            StatePool::Lease lease = model->states().acquire();
+        }
+        if (request.on_ready) {
+            request.on_ready(model);  // nullptr if loading failed
+        }
+    }
+}
+
+} // namespace whispr
@@ -4,9 +4,20 @@
 #include <cstring>
 #include <array>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
 
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
+#include <X11/keysym.h>
 #include <X11/extensions/XTest.h>
 
 namespace whispr {
@@ -23,31 +34,445 @@ static std::string exec_command(const char* cmd) {
     return result;
 }
 
+// Helper to feed text to a command's stdin
+static bool pipe_to_command(const char* cmd, const std::string& text) {
+    FILE* pipe = popen(cmd, "w");
+    if (!pipe) return false;
+    fwrite(text.c_str(), 1, text.length(), pipe);
+    return pclose(pipe) == 0;
+}
+
+namespace {
+
+// Owns the CLIPBOARD selection from an invisible window and answers paste
+// requests from other clients on a background thread, so setting the
+// clipboard is a couple of X requests instead of spawning xclip.
+class X11Selection {
+public:
+    bool open();
+    void close();
+
+    // Take ownership of the clipboard with `text`. Returns once the server has
+    // confirmed us as the owner, so a paste issued right after will be served.
+    bool own(const std::string& text);
+
+    // Current clipboard contents from whichever client owns it. Returns false
+    // if the owner didn't answer in time or uses incremental transfer.
+    bool read(std::string& out);
+
+    // Ctrl+V through XTest on the same connection
+    bool send_paste();
+
+private:
+    void event_loop();
+    void wake();
+    void handle_request(const XSelectionRequestEvent& request);
+    void handle_notify(const XSelectionEvent& event);
+
+    Display* display_ = nullptr;
+    Window window_ = 0;
+    Atom clipboard_ = None;
+    Atom targets_ = None;
+    Atom utf8_ = None;
+    Atom text_atom_ = None;
+    Atom incr_ = None;
+    Atom property_ = None;
+    size_t max_bytes_ = 0;   // Largest reply that fits one ChangeProperty request
+
+    std::thread thread_;
+    int wake_fd_ = -1;
+    bool stopping_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string text_;       // Served while we own the selection
+    bool owned_ = false;
+
+    // Pending read()
+    bool converting_ = false;
+    bool convert_done_ = false;
+    bool convert_ok_ = false;
+    std::string converted_;
+};
+
+bool X11Selection::open() {
+    // The event thread and callers share one connection
+    XInitThreads();
+
+    display_ = XOpenDisplay(nullptr);
+    if (!display_) return false;
+
+    window_ = XCreateSimpleWindow(display_, DefaultRootWindow(display_), 0, 0, 1, 1, 0, 0, 0);
+    clipboard_ = XInternAtom(display_, "CLIPBOARD", False);
+    targets_ = XInternAtom(display_, "TARGETS", False);
+    utf8_ = XInternAtom(display_, "UTF8_STRING", False);
+    text_atom_ = XInternAtom(display_, "TEXT", False);
+    incr_ = XInternAtom(display_, "INCR", False);
+    property_ = XInternAtom(display_, "VOXTYPE_SELECTION", False);
+
+    long max_request = XExtendedMaxRequestSize(display_);
+    if (max_request == 0) max_request = XMaxRequestSize(display_);
+    max_bytes_ = static_cast<size_t>(max_request) * 4 - 128;  // Leave room for the request header
+
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ < 0) {
+        XDestroyWindow(display_, window_);
+        XCloseDisplay(display_);
+        display_ = nullptr;
+        return false;
+    }
+
+    XFlush(display_);
+    stopping_ = false;
+    thread_ = std::thread([this]() { event_loop(); });
+    return true;
+}
+
+void X11Selection::close() {
+    if (!display_) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    ::close(wake_fd_);
+    wake_fd_ = -1;
+    XDestroyWindow(display_, window_);
+    XCloseDisplay(display_);
+    display_ = nullptr;
+}
+
+void X11Selection::wake() {
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd_, &one, sizeof(one));
+    (void)written;  // Counter saturation still leaves it readable
+}
+
+void X11Selection::event_loop() {
+    pollfd fds[2] = {
+        {ConnectionNumber(display_), POLLIN, 0},
+        {wake_fd_, POLLIN, 0}
+    };
+
+    while (true) {
+        // Other threads' round-trips can pull events into Xlib's queue without
+        // the socket becoming readable again, so drain the queue on every wakeup
+        while (XPending(display_) > 0) {
+            XEvent event;
+            XNextEvent(display_, &event);
+
+            switch (event.type) {
+                case SelectionRequest:
+                    handle_request(event.xselectionrequest);
+                    break;
+                case SelectionNotify:
+                    handle_notify(event.xselection);
+                    break;
+                case SelectionClear:
+                    if (event.xselectionclear.selection == clipboard_) {
+                        // Another client copied something
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        owned_ = false;
+                        text_.clear();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (poll(fds, 2, -1) < 0) continue;
+        if (fds[1].revents & POLLIN) {
+            uint64_t count;
+            ssize_t got = ::read(wake_fd_, &count, sizeof(count));
+            (void)got;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) return;
+        }
+    }
+}
+
+void X11Selection::handle_request(const XSelectionRequestEvent& request) {
+    XSelectionEvent reply{};
+    reply.type = SelectionNotify;
+    reply.display = request.display;
+    reply.requestor = request.requestor;
+    reply.selection = request.selection;
+    reply.target = request.target;
+    reply.time = request.time;
+    reply.property = None;  // Refused unless filled in below
+
+    // Obsolete clients pass None and expect the target as property
+    Atom property = request.property != None ? request.property : request.target;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (request.selection == clipboard_ && owned_) {
+            if (request.target == targets_) {
+                Atom supported[] = {targets_, utf8_, XA_STRING, text_atom_};
+                XChangeProperty(display_, request.requestor, property, XA_ATOM, 32, PropModeReplace,
+                                reinterpret_cast<unsigned char*>(supported), 4);
+                reply.property = property;
+            } else if (request.target == utf8_ || request.target == XA_STRING || request.target == text_atom_) {
+                Atom type = request.target == XA_STRING ? XA_STRING : utf8_;
+                XChangeProperty(display_, request.requestor, property, type, 8, PropModeReplace,
+                                reinterpret_cast<const unsigned char*>(text_.data()),
+                                static_cast<int>(text_.size()));
+                reply.property = property;
+            }
+        }
+    }
+
+    XSendEvent(display_, request.requestor, False, NoEventMask, reinterpret_cast<XEvent*>(&reply));
+    XFlush(display_);
+}
+
+void X11Selection::handle_notify(const XSelectionEvent& event) {
+    if (event.requestor != window_ || event.selection != clipboard_) return;
+
+    bool ok = false;
+    std::string data;
+    if (event.property != None) {
+        Atom type = None;
+        int format = 0;
+        unsigned long count = 0;
+        unsigned long remaining = 0;
+        unsigned char* value = nullptr;
+
+        if (XGetWindowProperty(display_, window_, event.property, 0, static_cast<long>(max_bytes_ / 4),
+                               True, AnyPropertyType, &type, &format, &count, &remaining, &value) == Success) {
+            // INCR transfers are rare for text; leave them to the external tools
+            if (type != incr_ && format == 8 && remaining == 0) {
+                data.assign(reinterpret_cast<const char*>(value), count);
+                ok = true;
+            }
+            if (value) XFree(value);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!converting_) return;  // Timed out meanwhile
+        converted_ = std::move(data);
+        convert_ok_ = ok;
+        convert_done_ = true;
+    }
+    cv_.notify_all();
+}
+
+bool X11Selection::own(const std::string& text) {
+    if (text.size() > max_bytes_) return false;  // Would need INCR
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        text_ = text;
+        owned_ = true;
+    }
+
+    XSetSelectionOwner(display_, clipboard_, window_, CurrentTime);
+    // Round-trip: once this returns the server routes requests to us
+    bool ok = XGetSelectionOwner(display_, clipboard_) == window_;
+    wake();
+
+    if (!ok) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        owned_ = false;
+        text_.clear();
+    }
+    return ok;
+}
+
+bool X11Selection::read(std::string& out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (owned_) {
+        out = text_;
+        return true;
+    }
+    converting_ = true;
+    convert_done_ = false;
+    lock.unlock();
+
+    XConvertSelection(display_, clipboard_, utf8_, property_, window_, CurrentTime);
+    XFlush(display_);
+    wake();
+
+    lock.lock();
+    bool answered = cv_.wait_for(lock, std::chrono::milliseconds(500), [this]() { return convert_done_; });
+    converting_ = false;
+    if (!answered || !convert_ok_) return false;
+
+    out = std::move(converted_);
+    return true;
+}
+
+bool X11Selection::send_paste() {
+    KeyCode ctrl_keycode = XKeysymToKeycode(display_, XK_Control_L);
+    KeyCode v_keycode = XKeysymToKeycode(display_, XK_v);
+
+    if (ctrl_keycode == 0 || v_keycode == 0) {
+        std::cerr << "Failed to get keycodes" << std::endl;
+        return false;
+    }
+
+    XTestFakeKeyEvent(display_, ctrl_keycode, True, 0);
+    XTestFakeKeyEvent(display_, v_keycode, True, 0);
+    XTestFakeKeyEvent(display_, v_keycode, False, 0);
+    XTestFakeKeyEvent(display_, ctrl_keycode, False, 0);
+    XSync(display_, False);
+    return true;
+}
+
+// Virtual keyboard for synthesizing paste where XTest can't reach (native
+// Wayland clients). Created once: compositors take a moment to pick up a new
+// input device, so creating it per paste would lose the first keystrokes.
+class UinputKeyboard {
+public:
+    bool open();
+    void close();
+    bool send_paste();
+
+private:
+    bool emit(uint16_t type, uint16_t code, int32_t value);
+
+    int fd_ = -1;
+};
+
+bool UinputKeyboard::open() {
+    fd_ = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) return false;
+
+    struct uinput_setup setup;
+    std::memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x1209;
+    setup.id.product = 0x7678;
+    std::strncpy(setup.name, "voxtype virtual keyboard", UINPUT_MAX_NAME_SIZE - 1);
+
+    if (ioctl(fd_, UI_SET_EVBIT, EV_KEY) < 0 ||
+        ioctl(fd_, UI_SET_KEYBIT, KEY_LEFTCTRL) < 0 ||
+        ioctl(fd_, UI_SET_KEYBIT, KEY_V) < 0 ||
+        ioctl(fd_, UI_DEV_SETUP, &setup) < 0 ||
+        ioctl(fd_, UI_DEV_CREATE) < 0) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void UinputKeyboard::close() {
+    if (fd_ < 0) return;
+    ioctl(fd_, UI_DEV_DESTROY);
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool UinputKeyboard::emit(uint16_t type, uint16_t code, int32_t value) {
+    struct input_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    return write(fd_, &event, sizeof(event)) == static_cast<ssize_t>(sizeof(event));
+}
+
+bool UinputKeyboard::send_paste() {
+    if (fd_ < 0) return false;
+
+    const std::pair<uint16_t, int32_t> sequence[] = {
+        {KEY_LEFTCTRL, 1}, {KEY_V, 1}, {KEY_V, 0}, {KEY_LEFTCTRL, 0}
+    };
+    for (const auto& key : sequence) {
+        if (!emit(EV_KEY, key.first, key.second) || !emit(EV_SYN, SYN_REPORT, 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct LinuxClipboardState {
+    bool wayland = false;    // Native Wayland session (XTest only reaches XWayland clients)
+    bool have_x11 = false;
+    X11Selection x11;
+    bool have_uinput = false;
+    UinputKeyboard keyboard;
+};
+
+} // namespace
+
+static LinuxClipboardState* g_clipboard = nullptr;
+
+bool Clipboard::initialize() {
+    if (g_clipboard) return true;
+
+    g_clipboard = new LinuxClipboardState();
+    const char* wayland_display = std::getenv("WAYLAND_DISPLAY");
+    g_clipboard->wayland = wayland_display && *wayland_display;
+
+    g_clipboard->have_x11 = std::getenv("DISPLAY") && g_clipboard->x11.open();
+    if (g_clipboard->wayland) {
+        g_clipboard->have_uinput = g_clipboard->keyboard.open();
+        if (!g_clipboard->have_uinput) {
+            std::cerr << "Cannot open /dev/uinput; paste will only reach XWayland windows" << std::endl;
+        }
+    }
+
+    if (g_clipboard->wayland) {
+        std::cout << "Clipboard: Wayland (wl-copy" << (g_clipboard->have_uinput ? ", uinput paste)" : ")") << std::endl;
+    } else if (g_clipboard->have_x11) {
+        std::cout << "Clipboard: native X11 selection" << std::endl;
+    } else {
+        std::cout << "Clipboard: no X display, using xclip/xsel" << std::endl;
+    }
+    return true;
+}
+
+void Clipboard::shutdown() {
+    if (!g_clipboard) return;
+    g_clipboard->keyboard.close();
+    g_clipboard->x11.close();
+    delete g_clipboard;
+    g_clipboard = nullptr;
+}
+
 bool Clipboard::set_text(const std::string& text) {
-    // Use xclip or xsel for clipboard
-    // First try xclip
-    FILE* pipe = popen("xclip -selection clipboard 2>/dev/null", "w");
-    if (pipe) {
-        fwrite(text.c_str(), 1, text.length(), pipe);
-        int ret = pclose(pipe);
-        if (ret == 0) return true;
+    if (g_clipboard && g_clipboard->wayland) {
+        // wl-copy leaves a child process serving the selection
+        if (pipe_to_command("wl-copy 2>/dev/null", text)) return true;
     }
 
-    // Try xsel
-    pipe = popen("xsel --clipboard --input 2>/dev/null", "w");
-    if (pipe) {
-        fwrite(text.c_str(), 1, text.length(), pipe);
-        int ret = pclose(pipe);
-        if (ret == 0) return true;
+    if (g_clipboard && g_clipboard->have_x11 && g_clipboard->x11.own(text)) {
+        return true;
     }
 
+    // Fall back to external tools (no display connection, or text too large
+    // for a single property transfer)
+    if (pipe_to_command("xclip -selection clipboard 2>/dev/null", text)) return true;
+    if (pipe_to_command("xsel --clipboard --input 2>/dev/null", text)) return true;
+
     std::cerr << "Failed to set clipboard. Install xclip or xsel." << std::endl;
     return false;
 }
 
 std::string Clipboard::get_text() {
+    if (g_clipboard && g_clipboard->wayland) {
+        std::string result = exec_command("wl-paste --no-newline 2>/dev/null");
+        if (!result.empty()) return result;
+    }
+
+    std::string result;
+    if (g_clipboard && g_clipboard->have_x11 && g_clipboard->x11.read(result)) {
+        return result;
+    }
+
     // Try xclip first
-    std::string result = exec_command("xclip -selection clipboard -o 2>/dev/null");
+    result = exec_command("xclip -selection clipboard -o 2>/dev/null");
     if (!result.empty()) return result;
 
     // Try xsel
@@ -56,6 +481,14 @@ std::string Clipboard::get_text() {
 }
 
 bool Clipboard::paste() {
+    if (g_clipboard && g_clipboard->have_uinput && g_clipboard->keyboard.send_paste()) {
+        return true;
+    }
+    if (g_clipboard && g_clipboard->have_x11) {
+        return g_clipboard->x11.send_paste();
+    }
+
+    // Not initialized: one-off connection
     Display* display = XOpenDisplay(nullptr);
     if (!display) {
         std::cerr << "Failed to open X display" << std::endl;
@@ -72,19 +505,9 @@ bool Clipboard::paste() {
         return false;
     }
 
-    // Press Ctrl
     XTestFakeKeyEvent(display, ctrl_keycode, True, 0);
-    XFlush(display);
-
-    // Press V
     XTestFakeKeyEvent(display, v_keycode, True, 0);
-    XFlush(display);
-
-    // Release V
     XTestFakeKeyEvent(display, v_keycode, False, 0);
-    XFlush(display);
-
-    // Release Ctrl
     XTestFakeKeyEvent(display, ctrl_keycode, False, 0);
     XFlush(display);
 
@@ -0,0 +1,168 @@
+#include "cpu_topology.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <sched.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace whispr {
+
+namespace {
+
+// Parse a kernel CPU list such as "0-7,16-23"
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        char* end = nullptr;
+        long first = std::strtol(list.c_str() + pos, &end, 10);
+        if (end == list.c_str() + pos) break;
+        long last = first;
+        pos = static_cast<size_t>(end - list.c_str());
+        if (pos < list.size() && list[pos] == '-') {
+            last = std::strtol(list.c_str() + pos + 1, &end, 10);
+            pos = static_cast<size_t>(end - list.c_str());
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+        if (pos < list.size() && list[pos] == ',') ++pos;
+        else break;
+    }
+    return cpus;
+}
+
+long read_number(const std::string& path) {
+    std::ifstream file(path);
+    long value = -1;
+    if (file >> value) return value;
+    return -1;
+}
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// Allowed CPUs of the fastest class
+std::vector<int> performance_cpus() {
+    const std::vector<int> allowed = allowed_cpus();
+    auto is_allowed = [&](int cpu) {
+        for (int a : allowed) {
+            if (a == cpu) return true;
+        }
+        return false;
+    };
+
+    // Intel hybrid parts expose the P-cores as their own PMU
+    std::ifstream core_list("/sys/devices/cpu_core/cpus");
+    std::string list;
+    if (std::getline(core_list, list)) {
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(list)) {
+            if (is_allowed(cpu)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) return cpus;
+    }
+
+    // ARM big.LITTLE reports relative capacity; otherwise compare peak clocks.
+    // Favored cores boost a little higher than their siblings, so anything
+    // within 10% of the fastest counts.
+    std::vector<long> speed(allowed.size(), -1);
+    long fastest = -1;
+    for (size_t i = 0; i < allowed.size(); ++i) {
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(allowed[i]);
+        speed[i] = read_number(base + "/cpu_capacity");
+        if (speed[i] < 0) speed[i] = read_number(base + "/cpufreq/cpuinfo_max_freq");
+        if (speed[i] > fastest) fastest = speed[i];
+    }
+    if (fastest <= 0) return allowed;
+
+    std::vector<int> cpus;
+    for (size_t i = 0; i < allowed.size(); ++i) {
+        if (speed[i] * 10 >= fastest * 9) cpus.push_back(allowed[i]);
+    }
+    return cpus.empty() ? allowed : cpus;
+}
+
+// A "Name:   1234 kB" line of a /proc file, in kB (-1 if missing)
+long read_kb_field(const char* path, const char* name) {
+    std::ifstream file(path);
+    std::string line;
+    const size_t len = std::strlen(name);
+    while (std::getline(file, line)) {
+        if (line.compare(0, len, name) == 0) {
+            return std::strtol(line.c_str() + len, nullptr, 10);
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+CpuFeatures cpu_features() {
+    CpuFeatures features;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.avx512 = __builtin_cpu_supports("avx512f");
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+    features.neon = true;  // Mandatory on AArch64
+#endif
+    return features;
+}
+
+uint64_t available_memory_mb() {
+    long kb = read_kb_field("/proc/meminfo", "MemAvailable:");
+    return kb > 0 ? static_cast<uint64_t>(kb) / 1024 : 0;
+}
+
+uint64_t resident_memory_bytes() {
+    long kb = read_kb_field("/proc/self/status", "VmRSS:");
+    return kb > 0 ? static_cast<uint64_t>(kb) * 1024 : 0;
+}
+
+void release_free_memory() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
+int performance_core_count() {
+    size_t n = performance_cpus().size();
+    return n > 0 ? static_cast<int>(n) : available_cpu_count();
+}
+
+int available_cpu_count() {
+    size_t n = allowed_cpus().size();
+    return n > 0 ? static_cast<int>(n) : 1;
+}
+
+bool pin_to_performance_cores() {
+    const std::vector<int> cpus = performance_cpus();
+    if (cpus.empty()) return false;
+    if (cpus.size() == allowed_cpus().size()) return true;  // Nothing slower to avoid
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    // New threads (ggml's workers) inherit the mask
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        std::cerr << "Failed to pin inference thread to performance cores" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace whispr
@@ -0,0 +1,121 @@
+#include "file_watcher.hpp"
+#include <iostream>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+namespace whispr {
+
+// Editors touch a file several times per save; wait for them to settle
+static const int SETTLE_MS = 200;
+
+struct LinuxWatcherState {
+    int inotify_fd = -1;
+    int wake_fd = -1;      // Signalled by stop()
+    std::string name;      // File name within the watched directory
+    FileWatcher::Callback callback;
+    std::thread thread;
+};
+
+namespace {
+
+// Returns true if any queued event is about the watched file
+bool drain_events(LinuxWatcherState* state) {
+    alignas(inotify_event) char buffer[4096];
+    bool matched = false;
+    ssize_t len;
+    while ((len = read(state->inotify_fd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + len;) {
+            auto* change = reinterpret_cast<inotify_event*>(p);
+            if (change->len > 0 && state->name == change->name) {
+                matched = true;
+            }
+            p += sizeof(inotify_event) + change->len;
+        }
+    }
+    return matched;
+}
+
+void run_loop(LinuxWatcherState* state) {
+    bool pending = false;
+
+    while (true) {
+        pollfd fds[2] = {
+            {state->inotify_fd, POLLIN, 0},
+            {state->wake_fd, POLLIN, 0},
+        };
+        // Block until something happens; once a change is seen, only until it settles
+        int n = poll(fds, 2, pending ? SETTLE_MS : -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "File watcher failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        if (fds[1].revents) return;
+
+        if (n == 0) {
+            pending = false;
+            state->callback();
+            continue;
+        }
+
+        if (fds[0].revents && drain_events(state)) {
+            pending = true;
+        }
+    }
+}
+
+} // namespace
+
+bool FileWatcher::start(const std::string& path, Callback callback) {
+    if (platform_handle_) return true;
+
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+    if (dir.empty()) dir = "/";
+
+    auto* state = new LinuxWatcherState();
+    state->name = slash == std::string::npos ? path : path.substr(slash + 1);
+    state->callback = std::move(callback);
+    state->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    state->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    // Rewritten in place, saved via rename, or removed
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+    if (state->inotify_fd < 0 || state->wake_fd < 0 ||
+        inotify_add_watch(state->inotify_fd, dir.c_str(), mask) < 0) {
+        std::cerr << "Failed to watch " << path << ": " << std::strerror(errno) << std::endl;
+        if (state->inotify_fd >= 0) close(state->inotify_fd);
+        if (state->wake_fd >= 0) close(state->wake_fd);
+        delete state;
+        return false;
+    }
+
+    state->thread = std::thread(run_loop, state);
+    platform_handle_ = state;
+    return true;
+}
+
+void FileWatcher::stop() {
+    auto* state = static_cast<LinuxWatcherState*>(platform_handle_);
+    if (!state) return;
+
+    uint64_t one = 1;
+    ssize_t written = write(state->wake_fd, &one, sizeof(one));
+    (void)written;
+    if (state->thread.joinable()) {
+        state->thread.join();
+    }
+
+    close(state->inotify_fd);
+    close(state->wake_fd);
+    delete state;
+    platform_handle_ = nullptr;
+}
+
+} // namespace whispr
@@ -1,28 +1,123 @@
 #include "hotkey_manager.hpp"
 #include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
 #include <fcntl.h>
 #include <unistd.h>
+#include <dirent.h>
 #include <linux/input.h>
-#include <sys/select.h>
-
-#ifdef HAS_LIBEVDEV
-#include <libevdev/libevdev.h>
-#endif
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
 
 namespace whispr {
 
+static const char* INPUT_DIR = "/dev/input";
+
 struct LinuxHotkeyState {
-    int keyboard_fd = -1;
-#ifdef HAS_LIBEVDEV
-    struct libevdev* dev = nullptr;
-#endif
+    int epoll_fd = -1;
+    int wake_fd = -1;      // Signalled by stop()
+    int inotify_fd = -1;   // New devices under /dev/input
+    std::map<int, std::string> devices;  // Open keyboards: fd -> path
     HotkeyManager* manager = nullptr;
     uint32_t target_keycode = 0;
     bool key_pressed = false;
+    int pressed_fd = -1;    // Device the hotkey is held on
+    std::set<int> dropping;  // Devices that overflowed, skipping events until the next SYN_REPORT
 };
 
 static LinuxHotkeyState* g_state = nullptr;
 
+namespace {
+
+bool test_bit(const unsigned long* bits, unsigned int bit) {
+    const unsigned int per_long = sizeof(unsigned long) * 8;
+    return (bits[bit / per_long] >> (bit % per_long)) & 1UL;
+}
+
+// Kernel event time (CLOCK_MONOTONIC, see add_device) as a steady_clock time
+HotkeyManager::Clock::time_point event_time(const input_event& ev) {
+    auto since_boot = std::chrono::seconds(ev.input_event_sec) + std::chrono::microseconds(ev.input_event_usec);
+    return HotkeyManager::Clock::time_point(
+        std::chrono::duration_cast<HotkeyManager::Clock::duration>(since_boot));
+}
+
+bool is_event_node(const char* name) {
+    return std::strncmp(name, "event", 5) == 0;
+}
+
+// Open a device if it can produce the hotkey. Devices are found by
+// capability rather than by path, so USB and Bluetooth keyboards work too.
+bool add_device(LinuxHotkeyState* state, const std::string& path) {
+    for (const auto& device : state->devices) {
+        if (device.second == path) return true;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    unsigned long key_bits[KEY_MAX / (sizeof(unsigned long) * 8) + 1] = {};
+    char name[256] = "";
+    ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+
+    bool usable = ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(key_bits)), key_bits) >= 0 &&
+                  state->target_keycode <= KEY_MAX && test_bit(key_bits, state->target_keycode);
+    // Our own virtual keyboards would only echo what we type
+    if (usable && std::strncmp(name, "voxtype", 7) == 0) usable = false;
+
+    if (!usable) {
+        close(fd);
+        return false;
+    }
+
+    // Timestamps comparable with std::chrono::steady_clock
+    int clock_id = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clock_id);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(state->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        close(fd);
+        return false;
+    }
+
+    state->devices[fd] = path;
+    std::cout << "Using keyboard: " << path << " (" << name << ")" << std::endl;
+    return true;
+}
+
+void scan_devices(LinuxHotkeyState* state) {
+    DIR* dir = opendir(INPUT_DIR);
+    if (!dir) return;
+    while (dirent* entry = readdir(dir)) {
+        if (is_event_node(entry->d_name)) {
+            add_device(state, std::string(INPUT_DIR) + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+}
+
+void close_all(LinuxHotkeyState* state) {
+    for (const auto& device : state->devices) {
+        close(device.first);
+    }
+    state->devices.clear();
+    for (int* fd : {&state->inotify_fd, &state->wake_fd, &state->epoll_fd}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+} // namespace
+
 bool HotkeyManager::initialize() {
     if (platform_handle_) return true;
 
@@ -37,14 +132,7 @@ void HotkeyManager::shutdown() {
     stop();
 
     if (g_state) {
-#ifdef HAS_LIBEVDEV
-        if (g_state->dev) {
-            libevdev_free(g_state->dev);
-        }
-#endif
-        if (g_state->keyboard_fd >= 0) {
-            close(g_state->keyboard_fd);
-        }
+        close_all(g_state);
         delete g_state;
         g_state = nullptr;
     }
@@ -57,43 +145,36 @@ bool HotkeyManager::start() {
 
     g_state->target_keycode = keycode_;
     g_state->key_pressed = false;
+    g_state->pressed_fd = -1;
 
-    // Try to find keyboard device
-    const char* keyboard_paths[] = {
-        "/dev/input/event0",
-        "/dev/input/event1",
-        "/dev/input/event2",
-        "/dev/input/by-path/platform-i8042-serio-0-event-kbd",
-        nullptr
-    };
+    g_state->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    g_state->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (g_state->epoll_fd < 0 || g_state->wake_fd < 0) {
+        std::cerr << "Failed to set up input event polling" << std::endl;
+        close_all(g_state);
+        return false;
+    }
 
-    for (int i = 0; keyboard_paths[i]; ++i) {
-        int fd = open(keyboard_paths[i], O_RDONLY | O_NONBLOCK);
-        if (fd >= 0) {
-#ifdef HAS_LIBEVDEV
-            int rc = libevdev_new_from_fd(fd, &g_state->dev);
-            if (rc >= 0) {
-                // Check if it's a keyboard
-                if (libevdev_has_event_type(g_state->dev, EV_KEY) &&
-                    libevdev_has_event_code(g_state->dev, EV_KEY, KEY_A)) {
-                    g_state->keyboard_fd = fd;
-                    std::cout << "Using keyboard: " << keyboard_paths[i] << std::endl;
-                    break;
-                }
-                libevdev_free(g_state->dev);
-                g_state->dev = nullptr;
-            }
-#else
-            g_state->keyboard_fd = fd;
-            std::cout << "Using keyboard: " << keyboard_paths[i] << std::endl;
-            break;
-#endif
-            close(fd);
-        }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = g_state->wake_fd;
+    epoll_ctl(g_state->epoll_fd, EPOLL_CTL_ADD, g_state->wake_fd, &event);
+
+    // Hotplug: udev creates the node, then fixes up its permissions (IN_ATTRIB)
+    g_state->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (g_state->inotify_fd >= 0 &&
+        inotify_add_watch(g_state->inotify_fd, INPUT_DIR, IN_CREATE | IN_ATTRIB) >= 0) {
+        event.data.fd = g_state->inotify_fd;
+        epoll_ctl(g_state->epoll_fd, EPOLL_CTL_ADD, g_state->inotify_fd, &event);
+    } else {
+        std::cerr << "Keyboard hotplug detection unavailable" << std::endl;
     }
 
-    if (g_state->keyboard_fd < 0) {
+    scan_devices(g_state);
+
+    if (g_state->devices.empty()) {
         std::cerr << "Failed to open keyboard device. Try running with sudo or add user to input group." << std::endl;
+        close_all(g_state);
         return false;
     }
 
@@ -111,59 +192,111 @@ void HotkeyManager::stop() {
     if (!running_.load()) return;
 
     running_.store(false);
+    if (g_state && g_state->wake_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(g_state->wake_fd, &one, sizeof(one));
+        (void)written;
+    }
 
     if (listener_thread_.joinable()) {
         listener_thread_.join();
     }
+
+    if (g_state) {
+        close_all(g_state);
+    }
 }
 
 void HotkeyManager::run_loop() {
-    struct input_event ev;
+    LinuxHotkeyState* state = g_state;
+
+    auto set_pressed = [&](bool pressed, int fd, Clock::time_point when) {
+        if (pressed == state->key_pressed) return;
+        state->key_pressed = pressed;
+        state->pressed_fd = pressed ? fd : -1;
+        if (callback_) callback_(pressed, when);
+    };
+
+    auto remove_device = [&](int fd) {
+        std::cout << "Keyboard removed: " << state->devices[fd] << std::endl;
+        epoll_ctl(state->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        state->devices.erase(fd);
+        state->dropping.erase(fd);
+        // Unplugged mid-press: the release will never arrive
+        if (fd == state->pressed_fd) set_pressed(false, fd, Clock::now());
+    };
+
+    epoll_event events[16];
+    input_event input[64];
 
     while (running_.load()) {
-        fd_set fds;
-        FD_ZERO(&fds);
-        FD_SET(g_state->keyboard_fd, &fds);
-
-        struct timeval tv;
-        tv.tv_sec = 0;
-        tv.tv_usec = 100000; // 100ms timeout
-
-        int ret = select(g_state->keyboard_fd + 1, &fds, nullptr, nullptr, &tv);
-        if (ret <= 0) continue;
-
-#ifdef HAS_LIBEVDEV
-        int rc;
-        do {
-            rc = libevdev_next_event(g_state->dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-            if (rc == 0 && ev.type == EV_KEY && ev.code == g_state->target_keycode) {
-                bool pressed = (ev.value == 1);
-                bool released = (ev.value == 0);
-
-                if (pressed && !g_state->key_pressed) {
-                    g_state->key_pressed = true;
-                    if (callback_) callback_(true);
-                } else if (released && g_state->key_pressed) {
-                    g_state->key_pressed = false;
-                    if (callback_) callback_(false);
+        // Blocks until a key event, a hotplug event or stop(); no polling timeout
+        int n = epoll_wait(state->epoll_fd, events, 16, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+
+            if (fd == state->wake_fd) {
+                return;
+            }
+
+            if (fd == state->inotify_fd) {
+                alignas(inotify_event) char buffer[4096];
+                ssize_t len;
+                while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+                    for (char* p = buffer; p < buffer + len;) {
+                        auto* change = reinterpret_cast<inotify_event*>(p);
+                        if (change->len > 0 && is_event_node(change->name)) {
+                            add_device(state, std::string(INPUT_DIR) + "/" + change->name);
+                        }
+                        p += sizeof(inotify_event) + change->len;
+                    }
+                }
+                continue;
+            }
+
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                remove_device(fd);
+                continue;
+            }
+
+            ssize_t len;
+            while ((len = read(fd, input, sizeof(input))) > 0) {
+                const size_t count = static_cast<size_t>(len) / sizeof(input_event);
+                for (size_t k = 0; k < count; ++k) {
+                    const input_event& ev = input[k];
+                    if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+                        // Kernel buffer overflowed: what follows up to the next SYN_REPORT
+                        // is a partial frame (see the evdev docs), so it is skipped
+                        state->dropping.insert(fd);
+                    } else if (state->dropping.count(fd)) {
+                        if (ev.type != EV_SYN || ev.code != SYN_REPORT) continue;
+                        // Resynchronized: ask the device for the real key state
+                        state->dropping.erase(fd);
+                        unsigned long key_state[KEY_MAX / (sizeof(unsigned long) * 8) + 1] = {};
+                        if (ioctl(fd, EVIOCGKEY(sizeof(key_state)), key_state) >= 0) {
+                            bool down = test_bit(key_state, state->target_keycode);
+                            if (down || fd == state->pressed_fd) set_pressed(down, fd, Clock::now());
+                        }
+                    } else if (ev.type == EV_KEY && ev.code == state->target_keycode) {
+                        // value 2 is autorepeat
+                        if (ev.value == 1) {
+                            set_pressed(true, fd, event_time(ev));
+                        } else if (ev.value == 0) {
+                            set_pressed(false, fd, event_time(ev));
+                        }
+                    }
                 }
             }
-        } while (rc == 0 || rc == 1);
-#else
-        ssize_t n = read(g_state->keyboard_fd, &ev, sizeof(ev));
-        if (n == sizeof(ev) && ev.type == EV_KEY && ev.code == g_state->target_keycode) {
-            bool pressed = (ev.value == 1);
-            bool released = (ev.value == 0);
-
-            if (pressed && !g_state->key_pressed) {
-                g_state->key_pressed = true;
-                if (callback_) callback_(true);
-            } else if (released && g_state->key_pressed) {
-                g_state->key_pressed = false;
-                if (callback_) callback_(false);
+            if (len < 0 && errno == ENODEV) {
+                remove_device(fd);
             }
         }
-#endif
     }
 }
 
@@ -0,0 +1,403 @@
+#include "keyboard_output.hpp"
+#include "key_tap.hpp"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+
+namespace whispr {
+
+namespace {
+
+// Decode UTF-8 into code points. Returns false on malformed input.
+bool decode_utf8(const std::string& text, std::vector<uint32_t>& out) {
+    out.clear();
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        size_t len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        if (len == 0 || i + len > text.size()) return false;
+
+        uint32_t cp = len == 1 ? c : c & (0xFF >> (len + 1));
+        for (size_t k = 1; k < len; ++k) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (next & 0x3F);
+        }
+        out.push_back(cp);
+        i += len;
+    }
+    return true;
+}
+
+struct EvdevKey {
+    uint16_t code;
+    bool shift;
+};
+
+// Key that produces an ASCII character on a US layout. A virtual keyboard
+// only sends key positions; the compositor applies the user's layout.
+bool us_key_for(uint32_t cp, EvdevKey& key) {
+    static const uint16_t LETTERS[26] = {
+        KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M,
+        KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z
+    };
+    static const uint16_t DIGITS[10] = {
+        KEY_0, KEY_1, KEY_2, KEY_3, KEY_4, KEY_5, KEY_6, KEY_7, KEY_8, KEY_9
+    };
+    // Shifted digit row: ) ! @ # $ % ^ & * (
+    static const char SHIFTED_DIGITS[] = ")!@#$%^&*(";
+    static const struct { char plain; char shifted; uint16_t code; } SYMBOLS[] = {
+        {'-', '_', KEY_MINUS}, {'=', '+', KEY_EQUAL}, {'[', '{', KEY_LEFTBRACE}, {']', '}', KEY_RIGHTBRACE},
+        {';', ':', KEY_SEMICOLON}, {'\'', '"', KEY_APOSTROPHE}, {'`', '~', KEY_GRAVE},
+        {'\\', '|', KEY_BACKSLASH}, {',', '<', KEY_COMMA}, {'.', '>', KEY_DOT}, {'/', '?', KEY_SLASH}
+    };
+
+    if (cp >= 'a' && cp <= 'z') { key = {LETTERS[cp - 'a'], false}; return true; }
+    if (cp >= 'A' && cp <= 'Z') { key = {LETTERS[cp - 'A'], true}; return true; }
+    if (cp >= '0' && cp <= '9') { key = {DIGITS[cp - '0'], false}; return true; }
+    if (cp == ' ') { key = {KEY_SPACE, false}; return true; }
+    if (cp == '\n') { key = {KEY_ENTER, false}; return true; }
+    if (cp == '\t') { key = {KEY_TAB, false}; return true; }
+    if (cp >= 0x80) return false;
+
+    if (const char* digit = std::strchr(SHIFTED_DIGITS, static_cast<int>(cp))) {
+        key = {DIGITS[digit - SHIFTED_DIGITS], true};
+        return true;
+    }
+    for (const auto& symbol : SYMBOLS) {
+        if (static_cast<char>(cp) == symbol.plain) { key = {symbol.code, false}; return true; }
+        if (static_cast<char>(cp) == symbol.shifted) { key = {symbol.code, true}; return true; }
+    }
+    return false;
+}
+
+// Virtual keyboard for native Wayland sessions, where XTest can't reach
+class UinputTyper {
+public:
+    bool open();
+    void close();
+    bool type(const std::vector<uint32_t>& text);
+    bool erase(size_t count);
+
+private:
+    bool emit(uint16_t type, uint16_t code, int32_t value);
+    bool tap(uint16_t code, bool shift);
+
+    int fd_ = -1;
+};
+
+bool UinputTyper::open() {
+    fd_ = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) return false;
+
+    bool ok = ioctl(fd_, UI_SET_EVBIT, EV_KEY) >= 0;
+    // Everything on a standard keyboard
+    for (int code = KEY_ESC; ok && code <= KEY_MICMUTE; ++code) {
+        ok = ioctl(fd_, UI_SET_KEYBIT, code) >= 0;
+    }
+
+    struct uinput_setup setup;
+    std::memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x1209;
+    setup.id.product = 0x7679;
+    std::strncpy(setup.name, "voxtype virtual typing keyboard", UINPUT_MAX_NAME_SIZE - 1);
+
+    if (!ok || ioctl(fd_, UI_DEV_SETUP, &setup) < 0 || ioctl(fd_, UI_DEV_CREATE) < 0) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void UinputTyper::close() {
+    if (fd_ < 0) return;
+    ioctl(fd_, UI_DEV_DESTROY);
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool UinputTyper::emit(uint16_t type, uint16_t code, int32_t value) {
+    struct input_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    return write(fd_, &event, sizeof(event)) == static_cast<ssize_t>(sizeof(event));
+}
+
+bool UinputTyper::tap(uint16_t code, bool shift) {
+    bool ok = true;
+    if (shift) ok = emit(EV_KEY, KEY_LEFTSHIFT, 1) && emit(EV_SYN, SYN_REPORT, 0);
+    ok = ok && emit(EV_KEY, code, 1) && emit(EV_SYN, SYN_REPORT, 0);
+    ok = ok && emit(EV_KEY, code, 0) && emit(EV_SYN, SYN_REPORT, 0);
+    if (shift) ok = emit(EV_KEY, KEY_LEFTSHIFT, 0) && emit(EV_SYN, SYN_REPORT, 0) && ok;
+    return ok;
+}
+
+bool UinputTyper::type(const std::vector<uint32_t>& text) {
+    std::vector<EvdevKey> keys(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (!us_key_for(text[i], keys[i])) return false;  // Check everything before typing anything
+    }
+    for (const EvdevKey& key : keys) {
+        if (!tap(key.code, key.shift)) return false;
+    }
+    return true;
+}
+
+bool UinputTyper::erase(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!tap(KEY_BACKSPACE, false)) return false;
+    }
+    return true;
+}
+
+// XTest typing. Characters missing from the current keymap are typed by
+// temporarily binding their keysym to a spare keycode.
+class XTestTyper {
+public:
+    bool open();
+    void close();
+    bool type(const std::vector<uint32_t>& text);
+    bool erase(size_t count);
+
+private:
+    static KeySym keysym_for(uint32_t cp);
+    // Modifier keys the user is holding right now (the hotkey, while streaming)
+    std::vector<unsigned> held_modifiers() const;
+    void tap(KeyCode code, bool shift, const std::vector<unsigned>& held);
+
+    Display* display_ = nullptr;
+    int min_keycode_ = 0;
+    int max_keycode_ = 0;
+    KeyCode shift_ = 0;
+    KeyCode spare_ = 0;   // Unmapped keycode used for characters not in the keymap
+    std::vector<unsigned> modifier_keys_;  // Keycodes bound to any modifier
+};
+
+bool XTestTyper::open() {
+    display_ = XOpenDisplay(nullptr);
+    if (!display_) return false;
+
+    int event_base, error_base, major, minor;
+    if (!XTestQueryExtension(display_, &event_base, &error_base, &major, &minor)) {
+        XCloseDisplay(display_);
+        display_ = nullptr;
+        return false;
+    }
+
+    XDisplayKeycodes(display_, &min_keycode_, &max_keycode_);
+    shift_ = XKeysymToKeycode(display_, XK_Shift_L);
+
+    if (XModifierKeymap* modifiers = XGetModifierMapping(display_)) {
+        for (int i = 0; i < 8 * modifiers->max_keypermod; ++i) {
+            KeyCode code = modifiers->modifiermap[i];
+            if (code != 0 && std::find(modifier_keys_.begin(), modifier_keys_.end(), code) == modifier_keys_.end()) {
+                modifier_keys_.push_back(code);
+            }
+        }
+        XFreeModifiermap(modifiers);
+    }
+
+    // Find a keycode with no symbols bound
+    int per_keycode = 0;
+    KeySym* map = XGetKeyboardMapping(display_, static_cast<KeyCode>(min_keycode_),
+                                      max_keycode_ - min_keycode_ + 1, &per_keycode);
+    if (map) {
+        for (int code = max_keycode_; code >= min_keycode_ && spare_ == 0; --code) {
+            bool unused = true;
+            for (int j = 0; j < per_keycode; ++j) {
+                if (map[(code - min_keycode_) * per_keycode + j] != NoSymbol) unused = false;
+            }
+            if (unused) spare_ = static_cast<KeyCode>(code);
+        }
+        XFree(map);
+    }
+    return true;
+}
+
+void XTestTyper::close() {
+    if (!display_) return;
+    XCloseDisplay(display_);
+    display_ = nullptr;
+}
+
+KeySym XTestTyper::keysym_for(uint32_t cp) {
+    if (cp == '\n') return XK_Return;
+    if (cp == '\t') return XK_Tab;
+    // Latin-1 keysyms equal their code points; everything else uses the Unicode range
+    if ((cp >= 0x20 && cp <= 0x7E) || (cp >= 0xA0 && cp <= 0xFF)) return cp;
+    return 0x01000000 | cp;
+}
+
+std::vector<unsigned> XTestTyper::held_modifiers() const {
+    char keys[32];
+    XQueryKeymap(display_, keys);
+    std::vector<unsigned> held;
+    for (unsigned code : modifier_keys_) {
+        if (keys[code / 8] & (1 << (code % 8))) held.push_back(code);
+    }
+    return held;
+}
+
+void XTestTyper::tap(KeyCode code, bool shift, const std::vector<unsigned>& held) {
+    // Fake events merge with the core keyboard state, physically held keys included
+    for (const KeyEvent& event : tap_events(code, shift, shift_, held)) {
+        XTestFakeKeyEvent(display_, event.code, event.press ? True : False, 0);
+    }
+}
+
+bool XTestTyper::type(const std::vector<uint32_t>& text) {
+    // Fetched per call so layout switches are picked up
+    int per_keycode = 0;
+    const int n_keycodes = max_keycode_ - min_keycode_ + 1;
+    KeySym* map = XGetKeyboardMapping(display_, static_cast<KeyCode>(min_keycode_), n_keycodes, &per_keycode);
+    if (!map) return false;
+
+    struct Press {
+        KeyCode code;
+        bool shift;
+        KeySym remap;   // Bound to the spare keycode first if not NoSymbol
+    };
+    std::vector<Press> presses;
+    presses.reserve(text.size());
+
+    bool ok = true;
+    for (uint32_t cp : text) {
+        KeySym sym = keysym_for(cp);
+        Press press{0, false, NoSymbol};
+        for (int code = 0; code < n_keycodes && press.code == 0; ++code) {
+            // Only the unshifted and shifted levels of the first group
+            for (int level = 0; level < 2 && level < per_keycode; ++level) {
+                if (map[code * per_keycode + level] == sym) {
+                    press = {static_cast<KeyCode>(code + min_keycode_), level == 1, NoSymbol};
+                    break;
+                }
+            }
+        }
+        if (press.code == 0) {
+            if (spare_ == 0) {
+                ok = false;
+                break;
+            }
+            press = {spare_, false, sym};
+        }
+        presses.push_back(press);
+    }
+    XFree(map);
+    if (!ok) return false;
+
+    const std::vector<unsigned> held = held_modifiers();
+    bool remapped = false;
+    for (const Press& press : presses) {
+        if (press.remap != NoSymbol) {
+            KeySym sym = press.remap;
+            XChangeKeyboardMapping(display_, spare_, 1, &sym, 1);
+            XSync(display_, False);  // Mapping must be in place before the key event
+            remapped = true;
+        }
+        tap(press.code, press.shift, held);
+    }
+
+    if (remapped) {
+        KeySym none = NoSymbol;
+        XChangeKeyboardMapping(display_, spare_, 1, &none, 1);
+    }
+    XSync(display_, False);
+    return true;
+}
+
+bool XTestTyper::erase(size_t count) {
+    KeyCode backspace = XKeysymToKeycode(display_, XK_BackSpace);
+    if (backspace == 0) return false;
+    const std::vector<unsigned> held = held_modifiers();
+    for (size_t i = 0; i < count; ++i) {
+        tap(backspace, false, held);
+    }
+    XSync(display_, False);
+    return true;
+}
+
+struct LinuxKeyboardState {
+    bool use_uinput = false;
+    UinputTyper uinput;
+    XTestTyper xtest;
+};
+
+} // namespace
+
+static LinuxKeyboardState* g_keyboard = nullptr;
+
+bool KeyboardOutput::initialize() {
+    if (g_keyboard) return true;
+
+    g_keyboard = new LinuxKeyboardState();
+    const char* wayland_display = std::getenv("WAYLAND_DISPLAY");
+    const bool wayland = wayland_display && *wayland_display;
+
+    // XTest only reaches XWayland clients, so prefer uinput on Wayland
+    if (wayland && g_keyboard->uinput.open()) {
+        g_keyboard->use_uinput = true;
+        std::cout << "Keyboard output: uinput virtual keyboard (US layout, ASCII)" << std::endl;
+        return true;
+    }
+    if (g_keyboard->xtest.open()) {
+        std::cout << "Keyboard output: XTest" << std::endl;
+        return true;
+    }
+    if (!wayland && g_keyboard->uinput.open()) {
+        g_keyboard->use_uinput = true;
+        std::cout << "Keyboard output: uinput virtual keyboard (US layout, ASCII)" << std::endl;
+        return true;
+    }
+
+    std::cerr << "Keyboard output unavailable (no X display, cannot open /dev/uinput)" << std::endl;
+    delete g_keyboard;
+    g_keyboard = nullptr;
+    return false;
+}
+
+void KeyboardOutput::shutdown() {
+    if (!g_keyboard) return;
+    g_keyboard->uinput.close();
+    g_keyboard->xtest.close();
+    delete g_keyboard;
+    g_keyboard = nullptr;
+}
+
+bool KeyboardOutput::type_text(const std::string& text) {
+    if (!g_keyboard) return false;
+
+    std::vector<uint32_t> code_points;
+    if (!decode_utf8(text, code_points)) return false;
+
+    return g_keyboard->use_uinput ? g_keyboard->uinput.type(code_points)
+                                  : g_keyboard->xtest.type(code_points);
+}
+
+bool KeyboardOutput::ignores_held_keys() {
+    // The kernel drops a release for a key the virtual keyboard never
+    // pressed, and compositors merge modifiers across keyboards, so uinput
+    // can't type past a held hotkey
+    return g_keyboard && !g_keyboard->use_uinput;
+}
+
+bool KeyboardOutput::erase(size_t count) {
+    if (!g_keyboard) return false;
+    return g_keyboard->use_uinput ? g_keyboard->uinput.erase(count)
+                                  : g_keyboard->xtest.erase(count);
+}
+
+} // namespace whispr
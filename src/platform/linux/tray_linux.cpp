@@ -39,4 +39,13 @@ void update_tray_state(AppState state) {
     std::cout << "[Whispr] " << state_str << std::endl;
 }
 
+void update_tray_history() {
+    // No menu to refresh; the log is searched with --history and --search
+}
+
+void update_tray_continuous(bool continuous) {
+    // No menu to toggle from; hands-free starts with --continuous
+    std::cout << "[Whispr] Hands-free " << (continuous ? "on" : "off") << std::endl;
+}
+
 } // namespace whispr
@@ -5,6 +5,13 @@
 
 namespace whispr {
 
+bool Clipboard::initialize() {
+    return true;  // NSPasteboard needs no setup
+}
+
+void Clipboard::shutdown() {
+}
+
 bool Clipboard::set_text(const std::string& text) {
     @autoreleasepool {
         NSPasteboard* pasteboard = [NSPasteboard generalPasteboard];
@@ -16,6 +23,7 @@ bool Clipboard::set_text(const std::string& text) {
             return false;
         }
 
+        // Synchronous: the pasteboard server has the contents once this returns
         BOOL success = [pasteboard setString:nsText forType:NSPasteboardTypeString];
         return success == YES;
     }
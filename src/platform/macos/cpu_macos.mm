@@ -0,0 +1,74 @@
+#include "cpu_topology.hpp"
+#include <iostream>
+#include <pthread.h>
+#include <sys/qos.h>
+#include <sys/sysctl.h>
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+
+namespace whispr {
+
+static int sysctl_int(const char* name) {
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname(name, &value, &size, nullptr, 0) != 0) return 0;
+    return value;
+}
+
+CpuFeatures cpu_features() {
+    CpuFeatures features;
+#if defined(__aarch64__) || defined(__arm64__)
+    features.neon = true;
+#else
+    features.avx2 = sysctl_int("hw.optional.avx2_0") != 0;
+    features.avx512 = sysctl_int("hw.optional.avx512f") != 0;
+#endif
+    return features;
+}
+
+uint64_t available_memory_mb() {
+    // Free plus reclaimable (inactive, purgeable) pages, roughly what Activity Monitor calls available
+    vm_statistics64_data_t stats;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    if (host_statistics64(mach_host_self(), HOST_VM_INFO64, reinterpret_cast<host_info64_t>(&stats), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    const uint64_t pages = static_cast<uint64_t>(stats.free_count) + stats.inactive_count + stats.purgeable_count;
+    return pages * static_cast<uint64_t>(vm_page_size) / (1024 * 1024);
+}
+
+uint64_t resident_memory_bytes() {
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+}
+
+void release_free_memory() {
+    malloc_zone_pressure_relief(nullptr, 0);
+}
+
+int performance_core_count() {
+    // perflevel0 is the fastest cluster on Apple Silicon; absent on Intel Macs
+    int n = sysctl_int("hw.perflevel0.logicalcpu");
+    return n > 0 ? n : available_cpu_count();
+}
+
+int available_cpu_count() {
+    int n = sysctl_int("hw.logicalcpu");
+    return n > 0 ? n : 1;
+}
+
+bool pin_to_performance_cores() {
+    // There is no affinity API; user-interactive QoS keeps the scheduler on P-cores,
+    // and threads created afterwards inherit it
+    if (pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) != 0) {
+        std::cerr << "Failed to raise inference thread QoS" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace whispr
@@ -0,0 +1,88 @@
+#import <Foundation/Foundation.h>
+#include <CoreServices/CoreServices.h>
+#include "file_watcher.hpp"
+#include <iostream>
+#include <cstring>
+
+namespace whispr {
+
+// Editors touch a file several times per save; FSEvents coalesces within this window
+static const CFTimeInterval SETTLE_SECONDS = 0.2;
+
+struct MacWatcherState {
+    FSEventStreamRef stream = nullptr;
+    dispatch_queue_t queue = nullptr;
+    std::string name;      // File name within the watched directory
+    FileWatcher::Callback callback;
+};
+
+static void on_fs_events(ConstFSEventStreamRef, void* info, size_t count, void* paths,
+                         const FSEventStreamEventFlags*, const FSEventStreamEventId*) {
+    auto* state = static_cast<MacWatcherState*>(info);
+    char** event_paths = static_cast<char**>(paths);
+
+    // Paths come back with symlinks resolved, so compare only the file name
+    for (size_t i = 0; i < count; ++i) {
+        const char* slash = std::strrchr(event_paths[i], '/');
+        const char* name = slash ? slash + 1 : event_paths[i];
+        if (state->name == name) {
+            state->callback();
+            return;
+        }
+    }
+}
+
+bool FileWatcher::start(const std::string& path, Callback callback) {
+    if (platform_handle_) return true;
+
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+
+    auto* state = new MacWatcherState();
+    state->name = slash == std::string::npos ? path : path.substr(slash + 1);
+    state->callback = std::move(callback);
+
+    @autoreleasepool {
+        NSArray* paths = @[[NSString stringWithUTF8String:dir.c_str()]];
+        FSEventStreamContext context = {0, state, nullptr, nullptr, nullptr};
+        state->stream = FSEventStreamCreate(kCFAllocatorDefault, on_fs_events, &context,
+                                            (CFArrayRef)paths, kFSEventStreamEventIdSinceNow,
+                                            SETTLE_SECONDS, kFSEventStreamCreateFlagFileEvents);
+    }
+    if (!state->stream) {
+        std::cerr << "Failed to watch " << path << std::endl;
+        delete state;
+        return false;
+    }
+
+    state->queue = dispatch_queue_create("voxtype.file_watcher", DISPATCH_QUEUE_SERIAL);
+    FSEventStreamSetDispatchQueue(state->stream, state->queue);
+    if (!FSEventStreamStart(state->stream)) {
+        std::cerr << "Failed to watch " << path << std::endl;
+        FSEventStreamInvalidate(state->stream);
+        FSEventStreamRelease(state->stream);
+        dispatch_release(state->queue);
+        delete state;
+        return false;
+    }
+
+    platform_handle_ = state;
+    return true;
+}
+
+void FileWatcher::stop() {
+    auto* state = static_cast<MacWatcherState*>(platform_handle_);
+    if (!state) return;
+
+    FSEventStreamStop(state->stream);
+    FSEventStreamInvalidate(state->stream);
+    FSEventStreamRelease(state->stream);
+    // Let a callback already dispatched finish before the state goes away
+    dispatch_sync(state->queue, ^{});
+    dispatch_release(state->queue);
+
+    delete state;
+    platform_handle_ = nullptr;
+}
+
+} // namespace whispr
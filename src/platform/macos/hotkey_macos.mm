@@ -3,6 +3,7 @@
 #import <CoreGraphics/CoreGraphics.h>
 #include "hotkey_manager.hpp"
 #include <iostream>
+#include <mach/mach_time.h>
 
 namespace whispr {
 
@@ -130,6 +131,19 @@ static CGEventRef event_callback(CGEventTapProxy proxy, CGEventType type,
 
     CGKeyCode keycode = static_cast<CGKeyCode>(CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode));
 
+    // Event timestamps are mach_absolute_time ticks; convert the event's age so
+    // the result is on the steady clock regardless of its epoch
+    static mach_timebase_info_data_t timebase = [] {
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+        return info;
+    }();
+    uint64_t now_ticks = mach_absolute_time();
+    uint64_t event_ticks = CGEventGetTimestamp(event);
+    uint64_t age_ticks = now_ticks > event_ticks ? now_ticks - event_ticks : 0;
+    auto when = HotkeyManager::Clock::now() -
+                std::chrono::nanoseconds(age_ticks * timebase.numer / timebase.denom);
+
     // Check for our target key
     // For modifier keys (like Option), we use kCGEventFlagsChanged
     if (type == kCGEventFlagsChanged) {
@@ -142,12 +156,12 @@ static CGEventRef event_callback(CGEventTapProxy proxy, CGEventType type,
         if (right_option_pressed && !state->key_pressed) {
             state->key_pressed = true;
             if (state->manager->callback_) {
-                state->manager->callback_(true);
+                state->manager->callback_(true, when);
             }
         } else if (!right_option_pressed && state->key_pressed && keycode == state->target_keycode) {
             state->key_pressed = false;
             if (state->manager->callback_) {
-                state->manager->callback_(false);
+                state->manager->callback_(false, when);
             }
         }
     }
@@ -0,0 +1,104 @@
+#import <Cocoa/Cocoa.h>
+#import <Carbon/Carbon.h>
+#include "keyboard_output.hpp"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+namespace whispr {
+
+static CGEventSourceRef g_source = nullptr;
+
+// Longer strings attached to a single key event are silently truncated
+static const NSUInteger MAX_CHARS_PER_EVENT = 20;
+
+bool KeyboardOutput::initialize() {
+    if (g_source) return true;
+    g_source = CGEventSourceCreate(kCGEventSourceStateHIDSystemState);
+    if (!g_source) {
+        std::cerr << "Failed to create event source" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void KeyboardOutput::shutdown() {
+    if (g_source) {
+        CFRelease(g_source);
+        g_source = nullptr;
+    }
+}
+
+bool KeyboardOutput::type_text(const std::string& text) {
+    if (!g_source) return false;
+
+    @autoreleasepool {
+        NSString* nsText = [NSString stringWithUTF8String:text.c_str()];
+        if (!nsText) {
+            std::cerr << "Failed to create NSString from text" << std::endl;
+            return false;
+        }
+
+        const NSUInteger length = [nsText length];
+        std::vector<UniChar> chars(length);
+        [nsText getCharacters:chars.data() range:NSMakeRange(0, length)];
+
+        // The string rides on a key event; the virtual keycode is ignored
+        for (NSUInteger i = 0; i < length;) {
+            NSUInteger n = std::min(MAX_CHARS_PER_EVENT, length - i);
+            if (i + n < length && CFStringIsSurrogateHighCharacter(chars[i + n - 1])) {
+                --n;  // Keep surrogate pairs together
+            }
+
+            CGEventRef keyDown = CGEventCreateKeyboardEvent(g_source, 0, true);
+            CGEventRef keyUp = CGEventCreateKeyboardEvent(g_source, 0, false);
+            if (!keyDown || !keyUp) {
+                if (keyDown) CFRelease(keyDown);
+                if (keyUp) CFRelease(keyUp);
+                return false;
+            }
+
+            // The HID-state source carries the held hotkey's Option flag
+            CGEventSetFlags(keyDown, 0);
+            CGEventSetFlags(keyUp, 0);
+            CGEventKeyboardSetUnicodeString(keyDown, n, &chars[i]);
+            CGEventKeyboardSetUnicodeString(keyUp, n, &chars[i]);
+            CGEventPost(kCGHIDEventTap, keyDown);
+            CGEventPost(kCGHIDEventTap, keyUp);
+
+            CFRelease(keyDown);
+            CFRelease(keyUp);
+            i += n;
+        }
+        return true;
+    }
+}
+
+bool KeyboardOutput::ignores_held_keys() {
+    // Every event has its modifier flags cleared
+    return true;
+}
+
+bool KeyboardOutput::erase(size_t count) {
+    if (!g_source) return false;
+
+    for (size_t i = 0; i < count; ++i) {
+        CGEventRef keyDown = CGEventCreateKeyboardEvent(g_source, kVK_Delete, true);
+        CGEventRef keyUp = CGEventCreateKeyboardEvent(g_source, kVK_Delete, false);
+        if (!keyDown || !keyUp) {
+            if (keyDown) CFRelease(keyDown);
+            if (keyUp) CFRelease(keyUp);
+            return false;
+        }
+        // Option+Delete would erase a whole word
+        CGEventSetFlags(keyDown, 0);
+        CGEventSetFlags(keyUp, 0);
+        CGEventPost(kCGHIDEventTap, keyDown);
+        CGEventPost(kCGHIDEventTap, keyUp);
+        CFRelease(keyDown);
+        CFRelease(keyUp);
+    }
+    return true;
+}
+
+} // namespace whispr
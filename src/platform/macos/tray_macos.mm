@@ -9,9 +9,12 @@ static NSStatusItem* g_status_item = nil;
 static BOOL g_status_ready = NO;
 static BOOL g_enabled = YES;
 
-// Transcription history
-static std::vector<std::string> g_history;
+// Transcription history: the listed entries only (main thread); the full
+// text is read from the app's history log when one is copied
+static whispr::HistorySnapshot g_history;
+static std::string g_history_query;  // Search shown instead of the recent entries (main thread)
 static const size_t MAX_HISTORY = 5;
+static const size_t HISTORY_PREVIEW_CHARS = 40;
 
 // Cache SF Symbol images for performance
 static NSImage* g_icon_idle = nil;
@@ -93,6 +96,7 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
 - (void)updateQualityMenu;
 - (void)updateHistoryMenu;
 - (void)updateEnabledState;
+- (void)updateContinuousState:(BOOL)continuous;
 @end
 
 @implementation VoxTypeAppDelegate
@@ -140,6 +144,13 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
             enableItem.state = NSControlStateValueOn;
             [menu addItem:enableItem];
 
+            // Hands-free toggle: listen continuously, transcribe at each pause
+            NSMenuItem *continuousItem = [[NSMenuItem alloc] initWithTitle:@"Hands-Free Dictation" action:@selector(toggleContinuous:) keyEquivalent:@""];
+            continuousItem.target = self;
+            continuousItem.tag = 160;
+            continuousItem.state = g_app && g_app->is_continuous() ? NSControlStateValueOn : NSControlStateValueOff;
+            [menu addItem:continuousItem];
+
             [menu addItem:[NSMenuItem separatorItem]];
 
             // History section header
@@ -163,6 +174,18 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
             noHistoryItem.tag = 410;
             [menu addItem:noHistoryItem];
 
+            // Search the whole history log
+            NSMenuItem *searchItem = [[NSMenuItem alloc] initWithTitle:@"Search History..." action:@selector(searchHistory:) keyEquivalent:@"f"];
+            searchItem.target = self;
+            searchItem.tag = 420;
+            [menu addItem:searchItem];
+
+            NSMenuItem *recentItem = [[NSMenuItem alloc] initWithTitle:@"Show Recent" action:@selector(showRecentHistory:) keyEquivalent:@""];
+            recentItem.target = self;
+            recentItem.tag = 421;
+            recentItem.hidden = YES;
+            [menu addItem:recentItem];
+
             [menu addItem:[NSMenuItem separatorItem]];
 
             // Quality submenu
@@ -207,6 +230,9 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
             g_status_item.visible = YES;
             g_status_ready = YES;
 
+            // Entries saved by earlier sessions
+            [self updateHistoryMenu];
+
             NSLog(@"Status bar item created successfully");
         } else {
             NSLog(@"Failed to create status bar item");
@@ -226,6 +252,31 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
     NSLog(@"VoxType %@", g_enabled ? @"enabled" : @"disabled");
 }
 
+- (void)toggleContinuous:(id)sender {
+    (void)sender;
+    if (!g_app) return;
+
+    // Updates the checkmark through update_tray_continuous()
+    g_app->set_continuous(!g_app->is_continuous());
+    NSLog(@"Hands-free dictation %@", g_app->is_continuous() ? @"on" : @"off");
+}
+
+- (void)updateContinuousState:(BOOL)continuous {
+    if (!g_status_ready || !g_status_item) return;
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSMenuItem *continuousItem = [g_status_item.menu itemWithTag:160];
+        if (continuousItem) {
+            continuousItem.state = continuous ? NSControlStateValueOn : NSControlStateValueOff;
+        }
+
+        NSMenuItem *statusItem = [g_status_item.menu itemWithTag:100];
+        if (statusItem && g_enabled) {
+            statusItem.title = continuous ? @"VoxType - Listening" : @"VoxType - Ready";
+        }
+    });
+}
+
 - (void)updateEnabledState {
     if (!g_status_ready || !g_status_item) return;
 
@@ -259,20 +310,47 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
     NSMenuItem *item = (NSMenuItem *)sender;
     NSInteger index = item.tag - 401;
 
-    if (index >= 0 && index < (NSInteger)g_history.size()) {
-        NSString *text = [NSString stringWithUTF8String:g_history[index].c_str()];
+    const whispr::HistoryStore* history = g_app ? g_app->history() : nullptr;
+    whispr::HistoryEntry entry;
+    if (history && index >= 0 && index < (NSInteger)g_history.items.size() &&
+        history->get(g_history.items[index].id, entry)) {
+        NSString *text = [NSString stringWithUTF8String:entry.text.c_str()];
         [[NSPasteboard generalPasteboard] clearContents];
         [[NSPasteboard generalPasteboard] setString:text forType:NSPasteboardTypeString];
         NSLog(@"Copied to clipboard: %@", text);
     }
 }
 
+- (void)searchHistory:(id)sender {
+    (void)sender;
+    if (!g_app || !g_app->history()) return;
+
+    NSAlert *alert = [[NSAlert alloc] init];
+    alert.messageText = @"Search History";
+    alert.informativeText = @"Words from any dictation; the last one may be partial.";
+    [alert addButtonWithTitle:@"Search"];
+    [alert addButtonWithTitle:@"Cancel"];
+    NSTextField *field = [[NSTextField alloc] initWithFrame:NSMakeRect(0, 0, 260, 24)];
+    field.stringValue = [NSString stringWithUTF8String:g_history_query.c_str()];
+    alert.accessoryView = field;
+    alert.window.initialFirstResponder = field;
+
+    [NSApp activateIgnoringOtherApps:YES];
+    if ([alert runModal] != NSAlertFirstButtonReturn) return;
+
+    g_history_query = field.stringValue.UTF8String ? field.stringValue.UTF8String : "";
+    [self updateHistoryMenu];
+}
+
+- (void)showRecentHistory:(id)sender {
+    (void)sender;
+    g_history_query.clear();
+    [self updateHistoryMenu];
+}
+
 - (void)updateHistoryMenu {
     if (!g_status_ready || !g_status_item) return;
 
-    // Capture a copy of history for thread safety
-    std::vector<std::string> history_copy = g_history;
-
     dispatch_async(dispatch_get_main_queue(), ^{
         // Re-validate on main thread
         if (!g_status_ready || !g_status_item) return;
@@ -283,18 +361,26 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
         NSMenu *menu = statusItem.menu;
         if (!menu || ![menu isKindOfClass:[NSMenu class]]) return;
 
+        // Only the listed entries with short previews, however long the history is
+        const whispr::HistoryStore* history = g_app ? g_app->history() : nullptr;
+        g_history = history ? history->snapshot(MAX_HISTORY, HISTORY_PREVIEW_CHARS, g_history_query)
+                            : whispr::HistorySnapshot();
+        const bool searching = !g_history_query.empty();
+
+        NSMenuItem *header = [menu itemWithTag:400];
+        if (header) {
+            header.title = searching
+                ? [NSString stringWithFormat:@"Matching \"%s\" (%zu):", g_history_query.c_str(), g_history.matches]
+                : @"Recent Transcriptions:";
+        }
+
         // Update history items
         for (size_t i = 0; i < MAX_HISTORY; i++) {
             NSMenuItem *item = [menu itemWithTag:401 + i];
             if (!item) continue;
 
-            if (i < history_copy.size()) {
-                std::string text = history_copy[i];
-                // Truncate long text
-                if (text.length() > 40) {
-                    text = text.substr(0, 37) + "...";
-                }
-                item.title = [NSString stringWithFormat:@"  %s", text.c_str()];
+            if (i < g_history.items.size()) {
+                item.title = [NSString stringWithFormat:@"  %s", g_history.items[i].preview.c_str()];
                 item.hidden = NO;
             } else {
                 item.hidden = YES;
@@ -304,8 +390,13 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
         // Show/hide "no history" placeholder
         NSMenuItem *noHistoryItem = [menu itemWithTag:410];
         if (noHistoryItem) {
-            noHistoryItem.hidden = !history_copy.empty();
+            noHistoryItem.title = searching ? @"  (no matches)" : @"  (none yet)";
+            noHistoryItem.hidden = !g_history.items.empty();
         }
+        NSMenuItem *searchItem = [menu itemWithTag:420];
+        if (searchItem) searchItem.hidden = history == nullptr;
+        NSMenuItem *recentItem = [menu itemWithTag:421];
+        if (recentItem) recentItem.hidden = !searching;
     });
 }
 
@@ -336,6 +427,7 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
     (void)sender;
     g_current_quality = whispr::ModelQuality::Fast;
     [self updateQualityMenu];
+    if (g_app) g_app->set_quality(g_current_quality);
     NSLog(@"Quality set to Fast");
 }
 
@@ -343,6 +435,7 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
     (void)sender;
     g_current_quality = whispr::ModelQuality::Balanced;
     [self updateQualityMenu];
+    if (g_app) g_app->set_quality(g_current_quality);
     NSLog(@"Quality set to Balanced");
 }
 
@@ -350,6 +443,7 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
     (void)sender;
     g_current_quality = whispr::ModelQuality::Accurate;
     [self updateQualityMenu];
+    if (g_app) g_app->set_quality(g_current_quality);
     NSLog(@"Quality set to Accurate");
 }
 
@@ -357,6 +451,7 @@ static whispr::ModelQuality g_current_quality = whispr::ModelQuality::Balanced;
     (void)sender;
     g_current_quality = whispr::ModelQuality::Best;
     [self updateQualityMenu];
+    if (g_app) g_app->set_quality(g_current_quality);
     NSLog(@"Quality set to Best");
 }
 
@@ -381,6 +476,7 @@ namespace whispr {
 
 bool create_tray_icon(App* app) {
     g_app = app;
+    g_current_quality = app->quality();
     return true;
 }
 
@@ -392,20 +488,16 @@ void destroy_tray_icon() {
     g_app = nil;
 }
 
-void add_to_history(const std::string& text) {
-    if (text.empty()) return;
-
-    // Add to front
-    g_history.insert(g_history.begin(), text);
-
-    // Keep max size
-    if (g_history.size() > MAX_HISTORY) {
-        g_history.pop_back();
+void update_tray_history() {
+    // The menu takes its snapshot on the main thread
+    if (g_delegate) {
+        [g_delegate updateHistoryMenu];
     }
+}
 
-    // Update menu
+void update_tray_continuous(bool continuous) {
     if (g_delegate) {
-        [g_delegate updateHistoryMenu];
+        [g_delegate updateContinuousState:continuous ? YES : NO];
     }
 }
 
@@ -0,0 +1,111 @@
+#include "speech_chunker.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace whispr {
+
+SpeechChunker::SpeechChunker(const ChunkerConfig& config, ChunkCallback on_chunk)
+    : config_(config)
+    , on_chunk_(std::move(on_chunk)) {
+    frame_ = static_cast<size_t>(std::max(config_.sample_rate / 100, 1));
+    auto frames = [](int ms) { return static_cast<size_t>(std::max(ms, 10) / 10); };
+    max_frames_ = frames(config_.max_ms);
+    target_frames_ = std::min(frames(config_.target_ms), max_frames_);
+    pause_frames_ = frames(config_.min_pause_ms);
+    speech_frames_ = frames(config_.min_speech_ms);
+
+    buffer_ = take_buffer();
+    frame_rms_.reserve(max_frames_ + 1);
+}
+
+void SpeechChunker::feed(Span<const float> samples) {
+    for (float s : samples) {
+        buffer_.push_back(s);
+        partial_sum_ += s * s;
+        if (++partial_count_ == frame_) {
+            const float rms = std::sqrt(partial_sum_ / static_cast<float>(frame_));
+            partial_sum_ = 0.0f;
+            partial_count_ = 0;
+            push_frame(rms);
+        }
+    }
+}
+
+void SpeechChunker::push_frame(float rms) {
+    frame_rms_.push_back(rms);
+    silent_run_ = rms < config_.threshold ? silent_run_ + 1 : 0;
+
+    const size_t n = frame_rms_.size();
+    if (n >= target_frames_ && silent_run_ >= pause_frames_) {
+        cut(n - silent_run_ / 2);  // Middle of the pause: padding on both sides
+    } else if (n >= max_frames_) {
+        auto quietest = std::min_element(frame_rms_.begin() + static_cast<std::ptrdiff_t>(n / 2), frame_rms_.end());
+        cut(static_cast<size_t>(quietest - frame_rms_.begin()) + 1);
+    }
+}
+
+void SpeechChunker::cut(size_t frames) {
+    const size_t samples = frames * frame_;
+
+    AudioChunk chunk;
+    chunk.start_sample = start_sample_;
+    const size_t speech = static_cast<size_t>(std::count_if(
+        frame_rms_.begin(), frame_rms_.begin() + static_cast<std::ptrdiff_t>(frames),
+        [this](float rms) { return rms >= config_.threshold; }));
+    chunk.has_speech = speech >= speech_frames_;
+
+    // The tail past the cut starts the next chunk
+    std::vector<float> next = take_buffer();
+    next.assign(buffer_.begin() + static_cast<std::ptrdiff_t>(samples), buffer_.end());
+    buffer_.resize(samples);
+    chunk.samples = std::move(buffer_);
+    buffer_ = std::move(next);
+
+    frame_rms_.erase(frame_rms_.begin(), frame_rms_.begin() + static_cast<std::ptrdiff_t>(frames));
+    silent_run_ = std::min(silent_run_, frame_rms_.size());
+    start_sample_ += static_cast<int64_t>(samples);
+
+    on_chunk_(std::move(chunk));
+}
+
+void SpeechChunker::finish() {
+    if (!buffer_.empty()) {
+        AudioChunk chunk;
+        chunk.start_sample = start_sample_;
+        const size_t speech = static_cast<size_t>(std::count_if(
+            frame_rms_.begin(), frame_rms_.end(),
+            [this](float rms) { return rms >= config_.threshold; }));
+        chunk.has_speech = speech >= speech_frames_;
+        chunk.samples = std::move(buffer_);
+        buffer_ = take_buffer();
+        on_chunk_(std::move(chunk));
+    }
+
+    frame_rms_.clear();
+    start_sample_ = 0;
+    silent_run_ = 0;
+    partial_sum_ = 0.0f;
+    partial_count_ = 0;
+}
+
+void SpeechChunker::recycle(std::vector<float>&& buffer) {
+    buffer.clear();
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    pool_.push_back(std::move(buffer));
+}
+
+std::vector<float> SpeechChunker::take_buffer() {
+    std::vector<float> buffer;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (!pool_.empty()) {
+            buffer = std::move(pool_.back());
+            pool_.pop_back();
+        }
+    }
+    buffer.clear();
+    buffer.reserve((max_frames_ + 1) * frame_);  // No-op for a recycled buffer
+    return buffer;
+}
+
+} // namespace whispr
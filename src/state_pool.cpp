@@ -0,0 +1,136 @@
+#include "state_pool.hpp"
+#include "whisper.h"
+#include <iostream>
+#include <algorithm>
+
+namespace whispr {
+
+StatePool::Lease& StatePool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        state_ = other.state_;
+        other.pool_ = nullptr;
+        other.state_ = nullptr;
+    }
+    return *this;
+}
+
+void StatePool::Lease::release() {
+    if (pool_ && state_) {
+        pool_->give_back(state_);
+    }
+    pool_ = nullptr;
+    state_ = nullptr;
+}
+
+StatePool::~StatePool() {
+    shutdown();
+}
+
+bool StatePool::initialize(whisper_context* ctx, size_t max_states) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!closed_) return true;
+
+    ctx_ = ctx;
+    max_states_ = std::max<size_t>(max_states, 1);
+
+    whisper_state* state = whisper_init_state(ctx_);
+    if (!state) {
+        std::cerr << "Failed to allocate whisper state" << std::endl;
+        return false;
+    }
+    all_.push_back(state);
+    free_.push_back(state);
+    closed_ = false;
+    return true;
+}
+
+void StatePool::set_max_states(size_t max_states) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_states_ = std::max<size_t>(max_states, 1);
+    }
+    cv_.notify_all();
+}
+
+StatePool::Lease StatePool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() {
+        return closed_ || !free_.empty() || all_.size() + creating_ < max_states_;
+    });
+    if (closed_) return {};
+
+    if (!free_.empty()) {
+        whisper_state* state = free_.back();
+        free_.pop_back();
+        return Lease(this, state);
+    }
+
+    // Below the limit: allocate a new state outside the lock (buffers are sized
+    // by the model, so this is the expensive part; it only happens once per slot)
+    ++creating_;
+    lock.unlock();
+    whisper_state* state = whisper_init_state(ctx_);
+    lock.lock();
+    --creating_;
+
+    if (!state || closed_) {
+        if (state) whisper_free_state(state);  // Shut down meanwhile
+        cv_.notify_all();
+        if (!closed_) std::cerr << "Failed to allocate whisper state" << std::endl;
+        return {};
+    }
+    all_.push_back(state);
+    std::cout << "Allocated whisper state " << all_.size() << "/" << max_states_ << std::endl;
+    return Lease(this, state);
+}
+
+void StatePool::give_back(whisper_state* state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(state);
+    }
+    cv_.notify_all();  // Both acquire() and shutdown() wait on this
+}
+
+void StatePool::shutdown() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_) return;
+    closed_ = true;
+    cv_.notify_all();  // Fail pending acquires
+
+    // Leased states are still decoding; wait for them before freeing
+    cv_.wait(lock, [this]() { return free_.size() == all_.size() && creating_ == 0; });
+    for (whisper_state* state : all_) {
+        whisper_free_state(state);
+    }
+    all_.clear();
+    free_.clear();
+    ctx_ = nullptr;
+}
+
+size_t StatePool::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) return 0;
+
+    const size_t freed = free_.size();
+    for (whisper_state* state : free_) {
+        whisper_free_state(state);
+        all_.erase(std::find(all_.begin(), all_.end(), state));
+    }
+    free_.clear();
+    return freed;
+}
+
+size_t StatePool::max_states() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_states_;
+}
+
+size_t StatePool::created() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return all_.size();
+}
+
+} // namespace whispr
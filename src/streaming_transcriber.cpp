@@ -0,0 +1,238 @@
+#include "streaming_transcriber.hpp"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+namespace whispr {
+
+StreamingTranscriber::StreamingTranscriber(Transcriber& transcriber, const StreamingConfig& config)
+    : transcriber_(transcriber)
+    , config_(config) {
+    const size_t capacity = static_cast<size_t>(config_.sample_rate) * config_.max_seconds;
+    intake_.allocate(capacity);
+    audio_.reserve(capacity);
+    window_scratch_.reserve(capacity);
+}
+
+StreamingTranscriber::~StreamingTranscriber() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_.store(true);
+    }
+    wake_cv_.notify_all();
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
+}
+
+void StreamingTranscriber::begin() {
+    if (active_.load()) return;
+
+    intake_.reset();
+    audio_.clear();
+    dropped_samples_.store(0);
+    committed_samples_ = 0;
+    last_decode_end_ = 0;
+    committed_text_.clear();
+    committed_confidence_sum_ = 0.0;
+    committed_weight_ = 0;
+
+    stopping_.store(false);
+    active_.store(true);
+    decode_thread_ = std::thread([this]() { decode_loop(); });
+}
+
+void StreamingTranscriber::feed(Span<const float> samples) {
+    if (!active_.load(std::memory_order_acquire) || stopping_.load(std::memory_order_relaxed)) return;
+
+    size_t written = intake_.write(samples.data(), samples.size());
+    if (written < samples.size()) {
+        dropped_samples_.fetch_add(samples.size() - written, std::memory_order_relaxed);
+    }
+}
+
+void StreamingTranscriber::drain_intake() {
+    size_t available = intake_.read_available();
+    size_t room = audio_.capacity() - audio_.size();
+    if (available > room) {
+        // Session buffer full; leave the rest in the intake (feed() counts drops once it fills)
+        available = room;
+    }
+    if (available == 0) return;
+
+    size_t old_size = audio_.size();
+    audio_.resize(old_size + available);  // Within reserved capacity, no reallocation
+    intake_.read(audio_.data() + old_size, available);
+}
+
+void StreamingTranscriber::decode_loop() {
+    const size_t step_samples = static_cast<size_t>(config_.step_ms) * config_.sample_rate / 1000;
+    const size_t min_window_samples = static_cast<size_t>(config_.min_window_ms) * config_.sample_rate / 1000;
+
+    // The audio callback can't signal us without risking a lock, so poll the intake
+    const auto poll_interval = std::chrono::milliseconds(std::min(config_.step_ms, 50));
+
+    while (!stopping_.load()) {
+        drain_intake();
+
+        if (audio_.size() >= last_decode_end_ + step_samples &&
+            audio_.size() - committed_samples_ >= min_window_samples) {
+            decode_window(false);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, poll_interval, [this]() { return stopping_.load(); });
+    }
+}
+
+Span<const float> StreamingTranscriber::prepare_window(size_t start, size_t end, bool pad) {
+    // Whisper requires minimum 100ms of audio
+    const size_t min_samples = config_.sample_rate / 10;
+    const bool needs_pad = pad && end - start < min_samples;
+
+    // Decode straight from the session buffer when nothing has to be modified
+    if (!processor_ && !needs_pad) {
+        return Span<const float>(audio_.data() + start, end - start);
+    }
+
+    window_scratch_.assign(audio_.begin() + start, audio_.begin() + end);
+    if (processor_) {
+        // Capture already filtered the samples; only the gain stages depend on the window
+        processor_->finish(window_scratch_, AudioProcessor::measure(window_scratch_));
+    }
+    if (needs_pad) {
+        window_scratch_.resize(min_samples, 0.0f);
+    }
+
+    return window_scratch_;
+}
+
+TranscriptionResult StreamingTranscriber::decode_window(bool final_pass) {
+    const size_t end = audio_.size();
+    const size_t start = committed_samples_;
+
+    TranscriptionResult result;
+    result.success = true;
+    result.confidence = 0.0f;
+    result.duration_ms = 0;
+    if (end <= start) return result;
+
+    // Pad the final tail with silence if it is very short
+    auto window = prepare_window(start, end, final_pass);
+    last_decode_end_ = end;
+
+    DecodeOptions options;
+    options.multi_segment = !final_pass;
+    options.process_text = false;
+    options.log_result = false;
+
+    result = transcriber_.transcribe_with_profile(window, transcriber_.get_profile(), options);
+    if (!result.success || final_pass || result.segments.size() < 2) {
+        return result;
+    }
+
+    // Commit every segment that ends safely behind the live edge, but always keep
+    // the last one open since it may still be cut mid-word
+    const int64_t window_ms = static_cast<int64_t>(end - start) * 1000 / config_.sample_rate;
+    const int64_t commit_limit_ms = window_ms - config_.holdback_ms;
+    const bool force = window_ms >= config_.max_window_ms;
+
+    size_t n_commit = 0;
+    for (size_t i = 0; i + 1 < result.segments.size(); ++i) {
+        if (result.segments[i].t1_ms <= commit_limit_ms || force) {
+            n_commit = i + 1;
+        } else {
+            break;
+        }
+    }
+    if (n_commit == 0) return result;
+
+    size_t advance = static_cast<size_t>(result.segments[n_commit - 1].t1_ms) * config_.sample_rate / 1000;
+    advance = std::min(advance, end - start);
+    if (advance == 0) return result;
+
+    for (size_t i = 0; i < n_commit; ++i) {
+        committed_text_ += result.segments[i].text;
+    }
+    committed_confidence_sum_ += static_cast<double>(result.confidence) * advance;
+    committed_weight_ += advance;
+    committed_samples_ = start + advance;
+
+    std::cout << "Streaming: committed " << n_commit << " segment(s), "
+              << (committed_samples_ * 1000 / config_.sample_rate) << "ms final" << std::endl;
+
+    if (commit_callback_) {
+        size_t first = committed_text_.find_first_not_of(" \t\n\r");
+        size_t last = committed_text_.find_last_not_of(" \t\n\r");
+        if (first != std::string::npos) {
+            commit_callback_(committed_text_.substr(first, last - first + 1));
+        }
+    }
+
+    return result;
+}
+
+TranscriptionResult StreamingTranscriber::finish() {
+    TranscriptionResult result;
+    result.success = false;
+    result.confidence = 0.0f;
+    result.duration_ms = 0;
+
+    if (!active_.load()) {
+        result.error = "Streaming session not active";
+        return result;
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_.store(true);
+    }
+    wake_cv_.notify_all();
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
+
+    // Pick up whatever arrived after the decode thread's last drain
+    drain_intake();
+    if (dropped_samples_.load() > 0) {
+        std::cerr << "Streaming buffer full, dropped " << dropped_samples_.load() << " samples" << std::endl;
+    }
+
+    const size_t tail_samples = audio_.size() - committed_samples_;
+
+    // Only the uncommitted tail is decoded after release
+    auto tail = decode_window(true);
+    active_.store(false);
+
+    if (!tail.success) {
+        result.error = tail.error;
+        return result;
+    }
+
+    std::string raw = committed_text_ + tail.raw_text;
+    size_t first = raw.find_first_not_of(" \t\n\r");
+    size_t last = raw.find_last_not_of(" \t\n\r");
+    raw = (first == std::string::npos) ? "" : raw.substr(first, last - first + 1);
+
+    double weight = static_cast<double>(committed_weight_ + tail_samples);
+    double conf_sum = committed_confidence_sum_ + static_cast<double>(tail.confidence) * tail_samples;
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    result.raw_text = raw;
+    result.text = transcriber_.post_process(raw);
+    result.confidence = weight > 0.0 ? static_cast<float>(conf_sum / weight) : 0.0f;
+    result.duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    result.success = true;
+
+    std::cout << "Transcription [Streaming] tail " << (tail_samples * 1000 / config_.sample_rate)
+              << "ms took " << result.duration_ms << "ms (conf: "
+              << static_cast<int>(result.confidence * 100) << "%): \"" << result.text << "\"" << std::endl;
+
+    return result;
+}
+
+} // namespace whispr
@@ -0,0 +1,219 @@
+#include "streaming_vad.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace whispr {
+
+void StreamingVad::Segmenter::push(float energy) {
+    const size_t i = frames_++;
+
+    if (energy > threshold_) {
+        consecutive_speech_++;
+        consecutive_silence_ = 0;
+
+        if (!in_speech_ && consecutive_speech_ >= 2) {
+            // Start of speech segment
+            in_speech_ = true;
+            speech_start_ = i > 1 ? i - 1 : 0;
+        }
+    } else {
+        consecutive_silence_++;
+
+        if (in_speech_ && consecutive_silence_ >= 3) {
+            // End of speech segment; only keep segments longer than minimum
+            in_speech_ = false;
+            if (i - speech_start_ >= min_frames_) {
+                out_->push_back({speech_start_, i});
+            }
+            consecutive_speech_ = 0;
+        }
+    }
+}
+
+void StreamingVad::Segmenter::finish() {
+    // Handle case where speech extends to end
+    if (in_speech_ && frames_ - speech_start_ >= min_frames_) {
+        out_->push_back({speech_start_, frames_});
+    }
+    in_speech_ = false;
+}
+
+StreamingVad::StreamingVad(const VadConfig& config, size_t max_samples)
+    : config_(config)
+    , max_samples_(max_samples)
+    , hop_(static_cast<size_t>(std::max(config.sample_rate / 200, 1)))
+    , window_(hop_ * 2)
+    , min_speech_frames_(static_cast<size_t>(std::max(config.min_speech_ms, 0)) * config.sample_rate / (1000 * hop_))
+    , padding_frames_(static_cast<size_t>(std::max(config.padding_ms, 0)) * config.sample_rate / (1000 * hop_))
+    , segmenter_(config.threshold, min_speech_frames_, &segments_) {
+    const size_t max_frames = max_samples_ / hop_ + 1;
+    raw_.reserve(max_frames);
+    smoothed_.reserve(max_frames);
+    // A closed segment spans at least 2 speech + 3 silence frames
+    segments_.reserve(max_frames / 5 + 2);
+}
+
+void StreamingVad::reset() {
+    samples_ = 0;
+    block_fill_ = 0;
+    block_sum_ = 0.0f;
+    prev_block_sum_ = 0.0f;
+    have_prev_block_ = false;
+    raw_.clear();
+    smoothed_.clear();
+    segments_.clear();
+    segmenter_ = Segmenter(config_.threshold, min_speech_frames_, &segments_);
+    flushed_ = false;
+    in_speech_.store(false);
+    silence_frames_.store(0);
+}
+
+void StreamingVad::feed(Span<const float> samples) {
+    if (flushed_) return;
+
+    const size_t n = std::min(samples.size(), max_samples_ - samples_);
+    for (size_t i = 0; i < n; ++i) {
+        block_sum_ += samples[i] * samples[i];
+        if (++block_fill_ < hop_) continue;
+
+        // A 10ms window is two consecutive 5ms hops
+        if (have_prev_block_) {
+            push_frame(std::sqrt((prev_block_sum_ + block_sum_) / window_));
+        }
+        prev_block_sum_ = block_sum_;
+        have_prev_block_ = true;
+        block_sum_ = 0.0f;
+        block_fill_ = 0;
+    }
+    samples_ += n;
+}
+
+int StreamingVad::trailing_silence_ms() const {
+    return static_cast<int>(silence_frames_.load(std::memory_order_relaxed) * hop_ * 1000 / config_.sample_rate);
+}
+
+void StreamingVad::push_frame(float rms) {
+    raw_.push_back(rms);
+
+    // The centered average needs two frames of lookahead. Very short inputs
+    // (3 frames or fewer) are left unsmoothed, so hold back until a 4th arrives.
+    const size_t count = raw_.size();
+    if (count == 4) {
+        emit_smoothed(0);
+        emit_smoothed(1);
+    } else if (count > 4) {
+        emit_smoothed(count - 3);
+    }
+}
+
+void StreamingVad::emit_smoothed(size_t index) {
+    const size_t lo = index >= 2 ? index - 2 : 0;
+    const size_t hi = std::min(index + 2, raw_.size() - 1);
+
+    float sum = 0.0f;
+    for (size_t j = lo; j <= hi; ++j) {
+        sum += raw_[j];
+    }
+    float value = sum / static_cast<float>(hi - lo + 1);
+
+    smoothed_.push_back(value);
+    segmenter_.push(value);
+    in_speech_.store(segmenter_.in_speech(), std::memory_order_relaxed);
+    silence_frames_.store(segmenter_.silence_frames(), std::memory_order_relaxed);
+}
+
+void StreamingVad::flush() {
+    if (flushed_) return;
+    flushed_ = true;
+
+    if (raw_.size() <= 3) {
+        for (float rms : raw_) {
+            smoothed_.push_back(rms);
+            segmenter_.push(rms);
+        }
+    } else {
+        // Last two frames average over whatever lookahead exists
+        for (size_t i = smoothed_.size(); i < raw_.size(); ++i) {
+            emit_smoothed(i);
+        }
+    }
+    segmenter_.finish();
+    in_speech_.store(false);
+}
+
+std::vector<SampleRange> StreamingVad::segments(float gain) {
+    flush();
+
+    if (gain == 1.0f || gain <= 0.0f) {
+        return to_sample_ranges(segments_);
+    }
+
+    // Only the frame-level hysteresis is repeated; no sample is touched again
+    std::vector<FrameRange> rescaled;
+    Segmenter segmenter(config_.threshold / gain, min_speech_frames_, &rescaled);
+    for (float value : smoothed_) {
+        segmenter.push(value);
+    }
+    segmenter.finish();
+    return to_sample_ranges(rescaled);
+}
+
+std::vector<SampleRange> StreamingVad::to_sample_ranges(const std::vector<FrameRange>& frames) const {
+    if (frames.empty()) return {};
+
+    // Merge close segments and add padding
+    const size_t n_frames = smoothed_.size();
+    std::vector<FrameRange> merged;
+    for (const auto& seg : frames) {
+        size_t padded_start = seg.start > padding_frames_ ? seg.start - padding_frames_ : 0;
+        size_t padded_end = std::min(seg.end + padding_frames_, n_frames);
+
+        if (!merged.empty() && padded_start <= merged.back().end) {
+            merged.back().end = padded_end;
+        } else {
+            merged.push_back({padded_start, padded_end});
+        }
+    }
+
+    // Convert frame indices to sample indices. The analysis window reaches past
+    // the last hop, so clamp each start to the previous end to keep ranges disjoint.
+    std::vector<SampleRange> ranges;
+    ranges.reserve(merged.size());
+    for (const auto& seg : merged) {
+        size_t sample_start = seg.start * hop_;
+        size_t sample_end = std::min(seg.end * hop_ + window_, samples_);
+        if (!ranges.empty()) {
+            sample_start = std::max(sample_start, ranges.back().end);
+        }
+        if (sample_start < sample_end) {
+            ranges.push_back({sample_start, sample_end});
+        }
+    }
+
+    return ranges;
+}
+
+SampleRange StreamingVad::speech_bounds(int min_silence_samples, float gain) const {
+    const SampleRange whole{0, samples_};
+    const float threshold = gain > 0.0f ? config_.threshold / gain : config_.threshold;
+    const size_t margin = static_cast<size_t>(std::max(min_silence_samples, 0) / 2);
+
+    auto first = std::find_if(raw_.begin(), raw_.end(), [threshold](float rms) { return rms > threshold; });
+    if (first == raw_.end()) return whole;
+    auto last = std::find_if(raw_.rbegin(), raw_.rend(), [threshold](float rms) { return rms > threshold; });
+
+    // Back up a bit for attack, add some tail for release
+    size_t first_start = static_cast<size_t>(first - raw_.begin()) * hop_;
+    size_t last_end = static_cast<size_t>(raw_.rend() - last - 1) * hop_ + window_;
+    size_t start = first_start > margin ? first_start - margin : 0;
+    size_t end = std::min(last_end + margin, samples_);
+
+    // Less than 100ms of audio or invalid range, keep everything
+    if (start >= end || end - start < static_cast<size_t>(config_.sample_rate / 10)) {
+        return whole;
+    }
+
+    return {start, end};
+}
+
+} // namespace whispr
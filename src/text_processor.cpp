@@ -1,108 +1,494 @@
 #include "text_processor.hpp"
 #include <cctype>
-#include <regex>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
 
 namespace whispr {
 
 TextProcessor::TextProcessor(const TextProcessorConfig& config)
     : config_(config) {}
 
-std::string TextProcessor::process(const std::string& text) const {
-    if (text.empty()) return text;
+namespace {
 
-    std::string result = text;
+// Hand-written scanners for the filler rules. Each rule mirrors one ECMAScript
+// pattern exactly (noted above it), including \b, \s and \w semantics and the
+// backtracking outcomes, but matches in a single forward scan without any
+// backtracking machinery or per-pattern allocation.
+
+inline bool is_word(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return std::isalnum(u) || u == '_';
+}
+
+inline bool is_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+inline bool is_ascii_alpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// \b immediately before position i, where s[i] is known to be a word character
+inline bool word_starts_at(const std::string& s, size_t i) {
+    return i == 0 || !is_word(s[i - 1]);
+}
+
+// \b immediately after position i, where s[i - 1] is known to be a word character
+inline bool word_ends_at(const std::string& s, size_t i) {
+    return i >= s.size() || !is_word(s[i]);
+}
+
+inline size_t skip_spaces(const std::string& s, size_t i) {
+    while (i < s.size() && is_space(s[i])) ++i;
+    return i;
+}
 
-    // Order matters: remove fillers first, then fix spacing, then capitalize, then punctuation
-    if (config_.remove_fillers) {
-        result = remove_filler_words(result);
+// Case-insensitive literal (lit is lowercase)
+inline bool has_ci(const std::string& s, size_t i, const char* lit) {
+    for (; *lit; ++lit, ++i) {
+        if (i >= s.size() || lower(s[i]) != *lit) return false;
     }
+    return true;
+}
+
+inline bool has(const std::string& s, size_t i, const char* lit) {
+    for (; *lit; ++lit, ++i) {
+        if (i >= s.size() || s[i] != *lit) return false;
+    }
+    return true;
+}
+
+template <typename Pred>
+inline size_t run_of(const std::string& s, size_t i, Pred pred) {
+    while (i < s.size() && pred(s[i])) ++i;
+    return i;
+}
+
+// Width of the word at i if it is one of the listed words (case-insensitive), else 0
+inline size_t word_in_ci(const std::string& s, size_t i, const char* const* words, size_t n_words) {
+    for (size_t k = 0; k < n_words; ++k) {
+        if (has_ci(s, i, words[k])) {
+            size_t end = i + std::strlen(words[k]);
+            if (word_ends_at(s, end)) return end - i;
+        }
+    }
+    return 0;
+}
 
-    if (config_.fix_spacing) {
-        result = fix_spacing(result);
+struct Match {
+    size_t end = 0;          // One past the match; on failure, the next start worth trying
+    size_t group_begin = 0;  // Capture group 1 ($1)
+    size_t group_end = 0;
+};
+
+// regex_replace equivalent for non-empty patterns: scan left to right, replace
+// non-overlapping matches. Anchored rules (^) are only tried at position 0.
+// Returns true if anything matched.
+template <typename Matcher, typename Replacer>
+bool replace_all(const std::string& in, std::string& out, bool anchored, Matcher match, Replacer replace) {
+    out.clear();
+    size_t copied = 0;
+    size_t p = 0;
+    bool any = false;
+
+    while (p < in.size()) {
+        Match m;
+        m.end = p + 1;
+        if (match(in, p, m)) {
+            out.append(in, copied, p - copied);
+            replace(in, m, out);
+            copied = p = m.end;
+            any = true;
+            if (anchored) break;
+        } else {
+            if (anchored) break;
+            p = std::max(m.end, p + 1);
+        }
     }
 
-    if (config_.auto_capitalize) {
-        result = fix_capitalization(result);
+    if (!any) return false;
+    out.append(in, copied, std::string::npos);
+    return true;
+}
+
+// Apply one rule, swapping buffers so `text` always holds the latest result.
+// Returns true if it changed anything.
+template <typename Matcher, typename Replacer>
+bool apply(std::string& text, std::string& scratch, bool anchored, Matcher match, Replacer replace) {
+    if (!replace_all(text, scratch, anchored, match, replace)) return false;
+    text.swap(scratch);
+    return true;
+}
+
+auto replace_with(const char* literal) {
+    return [literal](const std::string&, const Match&, std::string& out) { out += literal; };
+}
+
+auto group_then(const char* suffix) {
+    return [suffix](const std::string& in, const Match& m, std::string& out) {
+        out.append(in, m.group_begin, m.group_end - m.group_begin);
+        out += suffix;
+    };
+}
+
+// ,?\s*\b<word>\b,?\s*  -- shared shape of the um/uh and "you know" rules.
+// word_end(s, w) returns the end of an acceptable word at w, or 0.
+template <typename WordEnd>
+bool match_padded_word(const std::string& s, size_t p, Match& m, WordEnd word_end) {
+    size_t w = p;
+    if (w < s.size() && s[w] == ',') ++w;
+    w = skip_spaces(s, w);
+
+    size_t e = (w < s.size() && is_word(s[w]) && word_starts_at(s, w)) ? word_end(s, w) : 0;
+    if (e == 0) {
+        // Every start between p and w reaches the same word and fails the same way
+        m.end = w > p ? w : p + 1;
+        return false;
     }
 
-    if (config_.trim_whitespace) {
-        result = trim(result);
+    if (e < s.size() && s[e] == ',') ++e;
+    m.end = skip_spaces(s, e);
+    return true;
+}
+
+// [Uu]+[HhMm]+ | [Uu]+[Hh]+ | [Ee]+[Rr]+ | [Aa]+[Hh]+ | [Hh][Mm]+  (each followed by \b)
+size_t filler_word_end(const std::string& s, size_t w) {
+    auto one_of = [](const char* set) {
+        return [set](char c) { return std::strchr(set, c) != nullptr && c != '\0'; };
+    };
+    auto two_runs = [&](size_t i, const char* first, const char* second) -> size_t {
+        size_t mid = run_of(s, i, one_of(first));
+        if (mid == i) return 0;
+        size_t end = run_of(s, mid, one_of(second));
+        if (end == mid || !word_ends_at(s, end)) return 0;
+        return end;
+    };
+
+    size_t e;
+    if ((e = two_runs(w, "Uu", "HhMm"))) return e;
+    if ((e = two_runs(w, "Uu", "Hh"))) return e;
+    if ((e = two_runs(w, "Ee", "Rr"))) return e;
+    if ((e = two_runs(w, "Aa", "Hh"))) return e;
+    if (s[w] == 'H' || s[w] == 'h') {
+        size_t end = run_of(s, w + 1, one_of("Mm"));
+        if (end > w + 1 && word_ends_at(s, end)) return end;
     }
+    return 0;
+}
 
-    if (config_.ensure_punctuation) {
-        result = ensure_punctuation(result);
+// [Yy]ou know\b
+size_t you_know_end(const std::string& s, size_t w) {
+    if ((s[w] != 'Y' && s[w] != 'y') || !has(s, w + 1, "ou know")) return 0;
+    return word_ends_at(s, w + 8) ? w + 8 : 0;
+}
+
+// (^|[.!?]\s*)[Ii] mean,?\s*
+bool match_i_mean(const std::string& s, size_t p, Match& m) {
+    size_t i;
+    if (p == 0 && (has(s, 0, "I mean") || has(s, 0, "i mean"))) {
+        i = 0;
+    } else if (s[p] == '.' || s[p] == '!' || s[p] == '?') {
+        i = skip_spaces(s, p + 1);
+        if (!(has(s, i, "I mean") || has(s, i, "i mean"))) return false;
+    } else {
+        return false;
     }
 
-    return result;
+    m.group_begin = p;
+    m.group_end = i;
+    size_t e = i + 6;
+    if (e < s.size() && s[e] == ',') ++e;
+    m.end = skip_spaces(s, e);
+    return true;
 }
 
-std::string TextProcessor::remove_filler_words(const std::string& text) const {
-    std::string result = text;
+// ,\s*like,\s*  (icase)
+bool match_comma_like(const std::string& s, size_t p, Match& m) {
+    if (s[p] != ',') return false;
+    size_t i = skip_spaces(s, p + 1);
+    if (!has_ci(s, i, "like,")) return false;
+    m.end = skip_spaces(s, i + 5);
+    return true;
+}
 
-    // Helper regex patterns (static for performance)
-    // Extended um/uh/er/ah patterns - catches "um", "umm", "ummm", "uh", "uhh", "uhhh", etc.
-    static const std::regex simple_fillers_with_comma(
-        R"(,?\s*\b[Uu]+[HhMm]+\b,?\s*|,?\s*\b[Uu]+[Hh]+\b,?\s*|,?\s*\b[Ee]+[Rr]+\b,?\s*|,?\s*\b[Aa]+[Hh]+\b,?\s*|,?\s*\b[Hh][Mm]+\b,?\s*)",
-        std::regex::ECMAScript
-    );
-    static const std::regex you_know(
-        R"(,?\s*\b[Yy]ou know\b,?\s*)",
-        std::regex::ECMAScript
-    );
-    static const std::regex i_mean(
-        R"((^|[.!?]\s*)[Ii] mean,?\s*)",
-        std::regex::ECMAScript
-    );
-    // Catch ", like," and also " like " when preceded by certain words (filler pattern)
-    static const std::regex like_filler_commas(
-        R"(,\s*like,\s*)",
-        std::regex::ECMAScript | std::regex::icase
-    );
-    // Catch "like" as filler in specific safe patterns:
-    // - "was like" when not followed by "a/an/the" (comparison)
-    // - "is like" when not followed by "a/an/the"
-    static const std::regex like_filler_after_words(
-        R"(\b(was|is)\s+like\s+(?!(a|an|the|that|this|what|how|who)\b))",
-        std::regex::ECMAScript | std::regex::icase
-    );
-    // Catch "like" at start of sentence (filler)
-    static const std::regex like_start_filler(
-        R"(^[Ll]ike\s+(?=[a-z]))",
-        std::regex::ECMAScript
-    );
-    // Catch "so like" at start
-    static const std::regex so_like_start(
-        R"(^[Ss]o\s+like\s+)",
-        std::regex::ECMAScript
-    );
-    // Catch "and like" / "but like" / "or like" mid-sentence
-    static const std::regex conj_like_filler(
-        R"(\b(and|but|or)\s+like\s+(?=[a-z]))",
-        std::regex::ECMAScript | std::regex::icase
-    );
-    // Catch "should/could/would/might like <verb>" (filler before verb)
-    static const std::regex modal_like_verb(
-        R"(\b(should|could|would|might|must|can|will)\s+like\s+(?=[a-z]+\b))",
-        std::regex::ECMAScript | std::regex::icase
-    );
-    // Catch "so" at start when it's a filler (followed by common patterns)
-    static const std::regex so_start_filler(
-        R"(^[Ss]o\s+(?=I\s|we\s|you\s|they\s|he\s|she\s|it\s|the\s|a\s|an\s|basically|actually|um|uh))",
-        std::regex::ECMAScript
-    );
-    static const std::regex right_end(
-        R"(,\s*right\s*[.?]?\s*$)",
-        std::regex::ECMAScript | std::regex::icase
-    );
-    static const std::regex double_comma(R"(,\s*,)");
-    static const std::regex double_space(R"(\s{2,})");
-    static const std::regex leading_ws(R"(^\s+)");
-    static const std::regex orphan_comma_start(R"(^\s*,\s*)");
-    // Catch repeated/stuttered words (e.g., "I I" or "the the")
-    static const std::regex stuttered_words(
-        R"(\b(\w+)\s+\1\b)",
-        std::regex::ECMAScript | std::regex::icase
-    );
+// \b(<words>)\s+like\s+  followed by a lookahead tested by `ok(s, i, spaces)`.
+// Returns the end of the match (after the spaces the lookahead accepted), or 0.
+template <typename Lookahead>
+bool match_word_like(const std::string& s, size_t p, Match& m,
+                     const char* const* words, size_t n_words, Lookahead ok) {
+    if (!is_word(s[p]) || !word_starts_at(s, p)) return false;
+
+    size_t w_end = 0;
+    for (size_t k = 0; k < n_words; ++k) {
+        if (has_ci(s, p, words[k])) {
+            w_end = p + std::strlen(words[k]);
+            break;
+        }
+    }
+    if (w_end == 0) return false;
+
+    size_t i = skip_spaces(s, w_end);
+    if (i == w_end || !has_ci(s, i, "like")) return false;
+    size_t spaces_begin = i + 4;
+    size_t spaces_end = skip_spaces(s, spaces_begin);
+    if (spaces_end == spaces_begin) return false;
+
+    size_t end = ok(s, spaces_begin, spaces_end);
+    if (end == 0) return false;
+
+    m.group_begin = p;
+    m.group_end = w_end;
+    m.end = end;
+    return true;
+}
+
+const char* const WAS_IS[] = {"was", "is"};
+const char* const CONJUNCTIONS[] = {"and", "but", "or"};
+const char* const MODALS[] = {"should", "could", "would", "might", "must", "can", "will"};
+const char* const COMPARISON_WORDS[] = {"a", "an", "the", "that", "this", "what", "how", "who"};
+
+// \b(was|is)\s+like\s+(?!(a|an|the|that|this|what|how|who)\b)  (icase)
+bool match_was_like(const std::string& s, size_t p, Match& m) {
+    return match_word_like(s, p, m, WAS_IS, 2, [](const std::string& str, size_t begin, size_t end) -> size_t {
+        if (word_in_ci(str, end, COMPARISON_WORDS, 8) == 0) return end;
+        // Backtracking hands back one space; the lookahead then sees a space and passes
+        return end - begin >= 2 ? end - 1 : 0;
+    });
+}
+
+// \b(and|but|or)\s+like\s+(?=[a-z])  (icase, so [a-z] also matches uppercase)
+bool match_conj_like(const std::string& s, size_t p, Match& m) {
+    return match_word_like(s, p, m, CONJUNCTIONS, 3, [](const std::string& str, size_t, size_t end) -> size_t {
+        return end < str.size() && is_ascii_alpha(str[end]) ? end : 0;
+    });
+}
+
+// \b(should|could|would|might|must|can|will)\s+like\s+(?=[a-z]+\b)  (icase)
+bool match_modal_like(const std::string& s, size_t p, Match& m) {
+    return match_word_like(s, p, m, MODALS, 7, [](const std::string& str, size_t, size_t end) -> size_t {
+        size_t letters = run_of(str, end, is_ascii_alpha);
+        return letters > end && word_ends_at(str, letters) ? end : 0;
+    });
+}
+
+// ^[Ll]ike\s+(?=[a-z])
+bool match_like_start(const std::string& s, size_t, Match& m) {
+    if (!(has(s, 0, "Like") || has(s, 0, "like"))) return false;
+    size_t e = skip_spaces(s, 4);
+    if (e == 4 || e >= s.size() || s[e] < 'a' || s[e] > 'z') return false;
+    m.end = e;
+    return true;
+}
+
+// ^[Ss]o\s+like\s+
+bool match_so_like_start(const std::string& s, size_t, Match& m) {
+    if (!(has(s, 0, "So") || has(s, 0, "so"))) return false;
+    size_t i = skip_spaces(s, 2);
+    if (i == 2 || !has(s, i, "like")) return false;
+    size_t e = skip_spaces(s, i + 4);
+    if (e == i + 4) return false;
+    m.end = e;
+    return true;
+}
+
+// ^[Ss]o\s+(?=I\s|we\s|you\s|they\s|he\s|she\s|it\s|the\s|a\s|an\s|basically|actually|um|uh)
+bool match_so_start(const std::string& s, size_t, Match& m) {
+    static const char* const FOLLOWED_BY_SPACE[] = {"I", "we", "you", "they", "he", "she", "it", "the", "a", "an"};
+    static const char* const PREFIXES[] = {"basically", "actually", "um", "uh"};
+
+    if (!(has(s, 0, "So") || has(s, 0, "so"))) return false;
+    size_t e = skip_spaces(s, 2);
+    if (e == 2) return false;
+
+    bool ok = false;
+    for (const char* word : FOLLOWED_BY_SPACE) {
+        size_t len = std::strlen(word);
+        if (has(s, e, word) && e + len < s.size() && is_space(s[e + len])) {
+            ok = true;
+            break;
+        }
+    }
+    for (const char* prefix : PREFIXES) {
+        if (ok) break;
+        ok = has(s, e, prefix);
+    }
+    if (!ok) return false;
+
+    m.end = e;
+    return true;
+}
+
+// \s{2,}
+bool match_space_run(const std::string& s, size_t p, Match& m) {
+    if (!is_space(s[p])) return false;
+    size_t e = skip_spaces(s, p + 1);
+    m.end = e;
+    return e - p >= 2;  // On failure, e is also the next start worth trying
+}
+
+// ^\s+
+bool match_leading_space(const std::string& s, size_t, Match& m) {
+    size_t e = skip_spaces(s, 0);
+    m.end = e;
+    return e > 0;
+}
+
+// ,\s*right\s*[.?]?\s*$  (icase)
+bool match_right_end(const std::string& s, size_t p, Match& m) {
+    if (s[p] != ',') return false;
+    size_t i = skip_spaces(s, p + 1);
+    if (!has_ci(s, i, "right")) return false;
+    i = skip_spaces(s, i + 5);
+    if (i < s.size() && (s[i] == '.' || s[i] == '?')) ++i;
+    i = skip_spaces(s, i);
+    if (i != s.size()) return false;
+    m.end = i;
+    return true;
+}
+
+// \b(\w+)\s+\1\b  (icase)
+bool match_stutter(const std::string& s, size_t p, Match& m) {
+    if (!is_word(s[p]) || !word_starts_at(s, p)) return false;
+
+    // The group can only be the whole word: a shorter one leaves a word character before \s+
+    size_t w_end = run_of(s, p, is_word);
+    size_t next = skip_spaces(s, w_end);
+    if (next == w_end) {
+        m.end = w_end;
+        return false;
+    }
+
+    const size_t len = w_end - p;
+    if (next + len > s.size()) return false;
+    for (size_t k = 0; k < len; ++k) {
+        if (lower(s[p + k]) != lower(s[next + k])) return false;
+    }
+    if (!word_ends_at(s, next + len)) return false;
+
+    m.group_begin = p;
+    m.group_end = w_end;
+    m.end = next + len;
+    return true;
+}
+
+// ,\s*,
+bool match_double_comma(const std::string& s, size_t p, Match& m) {
+    if (s[p] != ',') return false;
+    size_t i = skip_spaces(s, p + 1);
+    if (i >= s.size() || s[i] != ',') return false;
+    m.end = i + 1;
+    return true;
+}
+
+// ^\s*,\s*
+bool match_orphan_comma(const std::string& s, size_t, Match& m) {
+    size_t i = skip_spaces(s, 0);
+    if (i >= s.size() || s[i] != ',') return false;
+    m.end = skip_spaces(s, i + 1);
+    return true;
+}
+
+// What the unanchored rules need in the text to match at all; each is exact
+// for its rule (never absent when the rule would match)
+enum Trigger : unsigned {
+    HAS_FILLER = 1u << 0,        // A word that is all um, uh, er, ah, hmm
+    HAS_YOU_KNOW = 1u << 1,
+    HAS_I_MEAN = 1u << 2,        // At a word start ("I meant" counts, as in the pattern)
+    HAS_LIKE = 1u << 3,          // The word like, each like rule's anchor
+    HAS_RIGHT = 1u << 4,         // The word right
+    HAS_REPEAT = 1u << 5,        // The same word twice with only spaces between
+    HAS_DOUBLE_COMMA = 1u << 6,  // Two commas with only spaces between
+    HAS_SPACE_RUN = 1u << 7,     // Two whitespace characters in a row
+};
+
+// One pass over the words of `s` collecting the triggers present
+unsigned scan_triggers(const std::string& s) {
+    unsigned found = 0;
+    size_t prev_word = 0;
+    size_t prev_len = 0;      // 0 when something other than spaces follows the last word
+    bool after_comma = false;  // Only spaces since the last comma
+
+    size_t i = 0;
+    while (i < s.size()) {
+        const char c = s[i];
+        if (is_space(c)) {
+            if (i + 1 < s.size() && is_space(s[i + 1])) found |= HAS_SPACE_RUN;
+            ++i;
+            continue;
+        }
+        if (!is_word(c)) {
+            if (c == ',' && after_comma) found |= HAS_DOUBLE_COMMA;
+            after_comma = c == ',';
+            prev_len = 0;
+            ++i;
+            continue;
+        }
+
+        // A whole word (\w+), so i is a word start
+        const size_t end = run_of(s, i, is_word);
+        const size_t len = end - i;
+        if (filler_word_end(s, i)) found |= HAS_FILLER;
+        if (you_know_end(s, i)) found |= HAS_YOU_KNOW;
+        if ((c == 'I' || c == 'i') && has(s, i + 1, " mean")) found |= HAS_I_MEAN;
+        if (len == 4 && has_ci(s, i, "like")) found |= HAS_LIKE;
+        if (len == 5 && has_ci(s, i, "right")) found |= HAS_RIGHT;
+        if (len == prev_len) {
+            size_t k = 0;
+            while (k < len && lower(s[prev_word + k]) == lower(s[i + k])) ++k;
+            if (k == len) found |= HAS_REPEAT;
+        }
+        prev_word = i;
+        prev_len = len;
+        after_comma = false;
+        i = end;
+    }
+    return found;
+}
+
+// Triggers of the current text, scanned again only after a rule changed it
+struct Triggers {
+    unsigned found = 0;
+    bool stale = true;
+
+    bool any(const std::string& text, unsigned triggers) {
+        if (stale) {
+            found = scan_triggers(text);
+            stale = false;
+        }
+        return (found & triggers) != 0;
+    }
+};
+
+void collapse_spacing(std::string& text, std::string& scratch, Triggers& triggers) {
+    if (triggers.any(text, HAS_SPACE_RUN) && apply(text, scratch, false, match_space_run, replace_with(" "))) {
+        triggers.stale = true;
+    }
+    if (apply(text, scratch, true, match_leading_space, replace_with(""))) triggers.stale = true;
+}
+
+// Filler removal on `result` in place; scratch and prev are working buffers.
+// The rules are applied one after another, each to the previous one's output
+// as the patterns they mirror were, and that order decides some outcomes (a
+// filler removed early can complete "you know" for the next rule). So rather
+// than merging them into one scan, which changes such results, a single scan
+// of the words first finds which rules can match at all, and only those run;
+// a dictation without fillers costs that one scan per stage instead of one
+// per rule.
+void remove_fillers_in_place(std::string& result, std::string& scratch, std::string& prev) {
+    Triggers triggers;
+    // Runs `rule` if its trigger is in the text; anchored rules only look at
+    // the start, so they need no trigger
+    auto run = [&](unsigned trigger, bool anchored, auto match, auto replace) {
+        if (trigger != 0 && !triggers.any(result, trigger)) return;
+        if (apply(result, scratch, anchored, match, replace)) triggers.stale = true;
+    };
 
     // Run filler removal in a loop since removing one filler may expose another
     bool filler_changed = true;
@@ -110,31 +496,34 @@ std::string TextProcessor::remove_filler_words(const std::string& text) const {
     while (filler_changed && filler_iterations < 5) {
         filler_changed = false;
         filler_iterations++;
-        std::string prev = result;
+        prev = result;
 
         // Remove simple fillers (um, uh, uhh, er, ah, hmm)
-        result = std::regex_replace(result, simple_fillers_with_comma, " ");
+        run(HAS_FILLER, false, [](const std::string& s, size_t p, Match& m) {
+            return match_padded_word(s, p, m, filler_word_end);
+        }, replace_with(" "));
         // Remove "you know" phrase
-        result = std::regex_replace(result, you_know, " ");
+        run(HAS_YOU_KNOW, false, [](const std::string& s, size_t p, Match& m) {
+            return match_padded_word(s, p, m, you_know_end);
+        }, replace_with(" "));
         // Remove "I mean" at start or after punctuation
-        result = std::regex_replace(result, i_mean, "$1");
+        run(HAS_I_MEAN, false, match_i_mean, group_then(""));
         // Remove ", like," as filler
-        result = std::regex_replace(result, like_filler_commas, " ");
+        run(HAS_LIKE, false, match_comma_like, replace_with(" "));
         // Remove "like" after was/is when not a comparison
-        result = std::regex_replace(result, like_filler_after_words, "$1 ");
+        run(HAS_LIKE, false, match_was_like, group_then(" "));
         // Remove "like" at sentence start
-        result = std::regex_replace(result, like_start_filler, "");
+        run(0, true, match_like_start, replace_with(""));
         // Remove "so like" at start
-        result = std::regex_replace(result, so_like_start, "");
+        run(0, true, match_so_like_start, replace_with(""));
         // Remove "and/but/or like" mid-sentence
-        result = std::regex_replace(result, conj_like_filler, "$1 ");
+        run(HAS_LIKE, false, match_conj_like, group_then(" "));
         // Remove "should/could/would like" before verb
-        result = std::regex_replace(result, modal_like_verb, "$1 ");
+        run(HAS_LIKE, false, match_modal_like, group_then(" "));
         // Remove "so" at start when it's a filler
-        result = std::regex_replace(result, so_start_filler, "");
+        run(0, true, match_so_start, replace_with(""));
         // Clean up spacing
-        result = std::regex_replace(result, double_space, " ");
-        result = std::regex_replace(result, leading_ws, "");
+        collapse_spacing(result, scratch, triggers);
 
         if (result != prev) {
             filler_changed = true;
@@ -142,16 +531,15 @@ std::string TextProcessor::remove_filler_words(const std::string& text) const {
     }
 
     // Remove "right" at end (tag question filler)
-    result = std::regex_replace(result, right_end, ".");
+    run(HAS_RIGHT, false, match_right_end, replace_with("."));
 
     // Remove stuttered/repeated words
-    result = std::regex_replace(result, stuttered_words, "$1");
+    run(HAS_REPEAT, false, match_stutter, group_then(""));
 
     // Final cleanup of spacing and commas
-    result = std::regex_replace(result, double_comma, ",");
-    result = std::regex_replace(result, double_space, " ");
-    result = std::regex_replace(result, leading_ws, "");
-    result = std::regex_replace(result, orphan_comma_start, "");
+    run(HAS_DOUBLE_COMMA, false, match_double_comma, replace_with(","));
+    collapse_spacing(result, scratch, triggers);
+    run(0, true, match_orphan_comma, replace_with(""));
 
     // Step 7: Remove start-of-sentence fillers (so, basically, actually, like)
     // Run in a loop since removing one might expose another
@@ -160,188 +548,342 @@ std::string TextProcessor::remove_filler_words(const std::string& text) const {
     while (changed && iterations < 5) {
         changed = false;
         iterations++;
-        std::string prev = result;
 
+        size_t pos = 0;
         // "so," at start (only with comma - "so" alone might be meaningful)
         if (result.size() >= 3 && (result[0] == 'S' || result[0] == 's') &&
             result[1] == 'o' && result[2] == ',') {
-            size_t pos = 3;
-            while (pos < result.size() && std::isspace(static_cast<unsigned char>(result[pos]))) pos++;
-            result = result.substr(pos);
-            changed = true;
+            pos = skip_spaces(result, 3);
         }
         // "basically" at start
-        else if (result.size() >= 9 &&
-            (result.substr(0, 9) == "Basically" || result.substr(0, 9) == "basically")) {
-            size_t pos = 9;
+        else if (has(result, 0, "Basically") || has(result, 0, "basically")) {
+            pos = 9;
             if (pos < result.size() && result[pos] == ',') pos++;
-            while (pos < result.size() && std::isspace(static_cast<unsigned char>(result[pos]))) pos++;
-            result = result.substr(pos);
-            changed = true;
+            pos = skip_spaces(result, pos);
         }
         // "actually" at start
-        else if (result.size() >= 8 &&
-            (result.substr(0, 8) == "Actually" || result.substr(0, 8) == "actually")) {
-            size_t pos = 8;
+        else if (has(result, 0, "Actually") || has(result, 0, "actually")) {
+            pos = 8;
             if (pos < result.size() && result[pos] == ',') pos++;
-            while (pos < result.size() && std::isspace(static_cast<unsigned char>(result[pos]))) pos++;
-            result = result.substr(pos);
-            changed = true;
+            pos = skip_spaces(result, pos);
         }
         // "like," at start
-        else if (result.size() >= 5 &&
-            (result.substr(0, 5) == "Like," || result.substr(0, 5) == "like,")) {
-            size_t pos = 5;
-            while (pos < result.size() && std::isspace(static_cast<unsigned char>(result[pos]))) pos++;
-            result = result.substr(pos);
+        else if (has(result, 0, "Like,") || has(result, 0, "like,")) {
+            pos = skip_spaces(result, 5);
+        }
+
+        if (pos > 0) {
+            result.erase(0, pos);
             changed = true;
+            triggers.stale = true;
         }
     }
 
     // Final cleanup
-    result = std::regex_replace(result, double_space, " ");
-    result = std::regex_replace(result, leading_ws, "");
-
-    return result;
+    collapse_spacing(result, scratch, triggers);
 }
 
-std::string TextProcessor::fix_capitalization(const std::string& text) const {
-    if (text.empty()) return text;
+inline bool is_punctuation(char c) {
+    return c == '.' || c == ',' || c == '!' || c == '?' || c == ':' || c == ';';
+}
 
-    std::string result = text;
+// Capitalize the first letter of each sentence. Only letters change, so this
+// can also run on characters as another stage emits them.
+struct SentenceCase {
     bool capitalize_next = true;
 
-    for (size_t i = 0; i < result.size(); ++i) {
-        char c = result[i];
-
+    char operator()(char c) {
         if (capitalize_next && std::isalpha(static_cast<unsigned char>(c))) {
-            result[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
             capitalize_next = false;
-        } else if (c == '.' || c == '!' || c == '?') {
-            capitalize_next = true;
+            return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
         }
-    }
-
-    // Fix standalone 'i' -> 'I'
-    // Match ' i ' or start 'i ' or ' i' end or "i'" (i'm, i've, i'll, i'd)
-    static const std::regex standalone_i(R"((?:^|\s)i(?:\s|'|$))");
-
-    std::string fixed;
-    fixed.reserve(result.size() + 10);
-
-    std::sregex_iterator it(result.begin(), result.end(), standalone_i);
-    std::sregex_iterator end;
-
-    size_t last_pos = 0;
-    while (it != end) {
-        std::smatch match = *it;
-        size_t match_start = static_cast<size_t>(match.position());
-        size_t match_len = static_cast<size_t>(match.length());
-
-        // Append text before match
-        fixed.append(result, last_pos, match_start - last_pos);
-
-        // Append match with 'i' -> 'I'
-        std::string matched = match.str();
-        for (char& mc : matched) {
-            if (mc == 'i') mc = 'I';
+        if (c == '.' || c == '!' || c == '?') {
+            capitalize_next = true;
         }
-        fixed.append(matched);
-
-        last_pos = match_start + match_len;
-        ++it;
+        return c;
     }
+};
 
-    // Append remaining text
-    fixed.append(result, last_pos, result.size() - last_pos);
-
-    return fixed;
-}
-
-std::string TextProcessor::fix_spacing(const std::string& text) const {
-    if (text.empty()) return text;
-
-    std::string result;
-    result.reserve(text.size());
+inline char keep_case(char c) { return c; }
 
+// Normalize spacing from `text` into `out`, passing every emitted character
+// through `emit` (dropping a space never changes what a case pass decides)
+template <typename Emit>
+void append_spaced(std::string_view text, std::string& out, Emit emit) {
     bool last_was_space = true; // Start true to trim leading spaces
     bool last_was_punctuation = false;
 
-    for (size_t i = 0; i < text.size(); ++i) {
-        char c = text[i];
-
+    for (char c : text) {
         if (std::isspace(static_cast<unsigned char>(c))) {
             // Only add space if last char wasn't space and we're not at the end
             if (!last_was_space) {
-                result += ' ';
+                out += ' ';
                 last_was_space = true;
             }
             last_was_punctuation = false;
-        } else if (c == '.' || c == ',' || c == '!' || c == '?' || c == ':' || c == ';') {
+        } else if (is_punctuation(c)) {
             // Remove space before punctuation
-            if (!result.empty() && result.back() == ' ') {
-                result.pop_back();
+            if (!out.empty() && out.back() == ' ') {
+                out.pop_back();
             }
-            result += c;
+            out += emit(c);
             last_was_space = false;
             last_was_punctuation = true;
         } else {
             // Regular character
             // Add space after punctuation if needed
             if (last_was_punctuation && !last_was_space && c != '\'' && c != '"') {
-                result += ' ';
+                out += ' ';
             }
-            result += c;
+            out += emit(c);
             last_was_space = false;
             last_was_punctuation = false;
         }
     }
+}
 
-    return result;
+void capitalize_sentences(std::string& text) {
+    SentenceCase sentence_case;
+    for (char& c : text) {
+        c = sentence_case(c);
+    }
 }
 
-std::string TextProcessor::trim(const std::string& text) const {
-    if (text.empty()) return text;
+// Fix standalone 'i' -> 'I'
+// Match ' i ' or start 'i ' or ' i' end or "i'" (i'm, i've, i'll, i'd):
+// (?:^|\s)i(?:\s|'|$), with matches consuming the trailing space, so in
+// "i i i" the middle one is skipped exactly as regex iteration would
+void fix_standalone_i(std::string& text) {
+    size_t p = 0;
+    while (p < text.size()) {
+        size_t i;
+        if (p == 0 && text[0] == 'i') {
+            i = 0;
+        } else if (is_space(text[p]) && p + 1 < text.size() && text[p + 1] == 'i') {
+            i = p + 1;
+        } else {
+            ++p;
+            continue;
+        }
+
+        size_t after = i + 1;
+        if (after < text.size() && !is_space(text[after]) && text[after] != '\'') {
+            ++p;  // Part of a longer word
+            continue;
+        }
 
-    size_t start = 0;
+        text[i] = 'I';
+        p = after < text.size() ? after + 1 : after;
+    }
+}
+
+void trim_in_place(std::string& text) {
     size_t end = text.size();
+    while (end > 0 && is_space(text[end - 1])) --end;
+    text.resize(end);
 
-    // Find first non-whitespace
-    while (start < end && std::isspace(static_cast<unsigned char>(text[start]))) {
-        ++start;
+    size_t start = skip_spaces(text, 0);
+    text.erase(0, start);
+}
+
+void punctuate_in_place(std::string& text) {
+    // Trim trailing whitespace first
+    while (!text.empty() && is_space(text.back())) {
+        text.pop_back();
     }
 
-    // Find last non-whitespace
-    while (end > start && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
-        --end;
+    if (text.empty()) return;
+
+    // Check if already ends with punctuation
+    char last = text.back();
+    if (last == '.' || last == '!' || last == '?' || last == ':' || last == ';') {
+        return;
     }
 
-    if (start >= end) return "";
+    // Add period if text doesn't end with punctuation
+    text += '.';
+}
 
-    return text.substr(start, end - start);
+// Per-thread buffers for the filler stage; they keep their capacity, so after
+// the first few dictations processing doesn't allocate
+struct Workspace {
+    std::string text;
+    std::string scratch;
+    std::string prev;
+};
+
+Workspace& workspace() {
+    thread_local Workspace ws;
+    return ws;
 }
 
-std::string TextProcessor::ensure_punctuation(const std::string& text) const {
-    if (text.empty()) return text;
+enum Stage : unsigned {
+    STAGE_FILLERS = 1u << 0,
+    STAGE_SPACING = 1u << 1,
+    STAGE_CAPITALIZE = 1u << 2,
+    STAGE_TRIM = 1u << 3,
+    STAGE_PUNCTUATE = 1u << 4,
+    STAGE_COUNT = 5
+};
+
+// One instantiation per combination of enabled stages, so disabled stages are
+// compiled out. Order matters: remove fillers first, then fix spacing, then
+// capitalize, then punctuation. Spacing and sentence capitalization share one pass.
+template <unsigned Stages>
+void run_stages(std::string_view text, std::string& out) {
+    std::string_view source = text;
+
+    if constexpr ((Stages & STAGE_FILLERS) != 0) {
+        Workspace& ws = workspace();
+        ws.text.assign(text.data(), text.size());
+        remove_fillers_in_place(ws.text, ws.scratch, ws.prev);
+        source = ws.text;
+    }
 
-    std::string result = text;
+    out.clear();
+    if constexpr ((Stages & STAGE_SPACING) != 0) {
+        if constexpr ((Stages & STAGE_CAPITALIZE) != 0) {
+            append_spaced(source, out, SentenceCase{});
+        } else {
+            append_spaced(source, out, keep_case);
+        }
+    } else {
+        out.append(source.data(), source.size());
+        if constexpr ((Stages & STAGE_CAPITALIZE) != 0) {
+            capitalize_sentences(out);
+        }
+    }
 
-    // Trim trailing whitespace first
-    while (!result.empty() && std::isspace(static_cast<unsigned char>(result.back()))) {
-        result.pop_back();
+    if constexpr ((Stages & STAGE_CAPITALIZE) != 0) {
+        fix_standalone_i(out);
     }
+    if constexpr ((Stages & STAGE_TRIM) != 0) {
+        trim_in_place(out);
+    }
+    if constexpr ((Stages & STAGE_PUNCTUATE) != 0) {
+        punctuate_in_place(out);
+    }
+}
 
-    if (result.empty()) return result;
+using Pipeline = void (*)(std::string_view, std::string&);
 
-    // Check if already ends with punctuation
-    char last = result.back();
-    if (last == '.' || last == '!' || last == '?' || last == ':' || last == ';') {
-        return result;
+template <size_t... Masks>
+constexpr std::array<Pipeline, sizeof...(Masks)> make_pipelines(std::index_sequence<Masks...>) {
+    return {{&run_stages<static_cast<unsigned>(Masks)>...}};
+}
+
+constexpr auto PIPELINES = make_pipelines(std::make_index_sequence<1u << STAGE_COUNT>{});
+
+unsigned stage_mask(const TextProcessorConfig& config) {
+    return (config.remove_fillers ? STAGE_FILLERS : 0u) |
+           (config.fix_spacing ? STAGE_SPACING : 0u) |
+           (config.auto_capitalize ? STAGE_CAPITALIZE : 0u) |
+           (config.trim_whitespace ? STAGE_TRIM : 0u) |
+           (config.ensure_punctuation ? STAGE_PUNCTUATE : 0u);
+}
+
+} // namespace
+
+std::string TextProcessor::process(const std::string& text) const {
+    std::string result;
+    process(text, result);
+    return result;
+}
+
+void TextProcessor::process(std::string_view text, std::string& out) const {
+    if (text.empty()) {
+        out.clear();
+        return;
     }
+    PIPELINES[stage_mask(config_)](text, out);
+}
 
-    // Add period if text doesn't end with punctuation
-    result += '.';
+std::string TextProcessor::remove_filler_words(const std::string& text) const {
+    std::string result = text;
+    std::string scratch;
+    std::string prev;
+    scratch.reserve(text.size());
+    remove_fillers_in_place(result, scratch, prev);
     return result;
 }
 
+std::string TextProcessor::fix_capitalization(const std::string& text) const {
+    std::string result = text;
+    capitalize_sentences(result);
+    fix_standalone_i(result);
+    return result;
+}
+
+std::string TextProcessor::fix_spacing(const std::string& text) const {
+    std::string result;
+    result.reserve(text.size());
+    append_spaced(text, result, keep_case);
+    return result;
+}
+
+std::string TextProcessor::trim(const std::string& text) const {
+    std::string result = text;
+    trim_in_place(result);
+    return result;
+}
+
+std::string TextProcessor::ensure_punctuation(const std::string& text) const {
+    std::string result = text;
+    punctuate_in_place(result);
+    return result;
+}
+
+namespace {
+
+struct WordSpan {
+    size_t begin;
+    size_t end;
+    std::string key;  // Lowercase letters and digits only
+};
+
+std::vector<WordSpan> split_words(const std::string& text) {
+    std::vector<WordSpan> words;
+    size_t i = 0;
+    while (i < text.size()) {
+        i = skip_spaces(text, i);
+        if (i >= text.size()) break;
+        WordSpan word{i, i, {}};
+        while (i < text.size() && !is_space(text[i])) {
+            if (std::isalnum(static_cast<unsigned char>(text[i]))) word.key += lower(text[i]);
+            ++i;
+        }
+        word.end = i;
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+} // namespace
+
+std::string TextProcessor::drop_overlap(const std::string& committed, const std::string& next,
+                                        size_t max_words) {
+    std::vector<WordSpan> tail = split_words(committed);
+    std::vector<WordSpan> head = split_words(next);
+    if (tail.size() > max_words) tail.erase(tail.begin(), tail.end() - static_cast<std::ptrdiff_t>(max_words));
+
+    // Longest run of words ending `committed` that also starts `next`
+    size_t overlap = 0;
+    for (size_t n = std::min(tail.size(), head.size()); n > 0; --n) {
+        bool same = true;
+        for (size_t k = 0; k < n && same; ++k) {
+            const std::string& a = tail[tail.size() - n + k].key;
+            same = !a.empty() && a == head[k].key;
+        }
+        if (same && (n > 1 || head[0].key.size() > 4)) {
+            overlap = n;
+            break;
+        }
+    }
+    if (overlap == 0) return next;
+    if (overlap == head.size()) return std::string();
+
+    // Keep the leading whitespace so the result still joins onto `committed`
+    return next.substr(0, head[0].begin) + next.substr(head[overlap].begin);
+}
+
 } // namespace whispr
@@ -0,0 +1,43 @@
+#include "text_typer.hpp"
+#include <algorithm>
+
+namespace whispr {
+
+TextTyper::TextTyper(TypeFn type, EraseFn erase)
+    : type_(std::move(type))
+    , erase_(std::move(erase)) {}
+
+size_t TextTyper::count_chars(const std::string& text, size_t from) {
+    size_t count = 0;
+    for (size_t i = from; i < text.size(); ++i) {
+        // Continuation bytes are 10xxxxxx
+        if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) ++count;
+    }
+    return count;
+}
+
+bool TextTyper::update(const std::string& text) {
+    started_ = true;
+
+    auto mismatch = std::mismatch(typed_.begin(), typed_.end(), text.begin(), text.end());
+    size_t common = static_cast<size_t>(mismatch.first - typed_.begin());
+    // Don't keep half of a multi-byte character
+    while (common > 0 && common < typed_.size() &&
+           (static_cast<unsigned char>(typed_[common]) & 0xC0) == 0x80) {
+        --common;
+    }
+
+    if (common < typed_.size()) {
+        if (!erase_(count_chars(typed_, common))) return false;
+        typed_.resize(common);
+    }
+
+    if (common < text.size()) {
+        std::string rest = text.substr(common);
+        if (!type_(rest)) return false;
+        typed_ += rest;
+    }
+    return true;
+}
+
+} // namespace whispr
@@ -0,0 +1,164 @@
+#include "thread_tuner.hpp"
+#include "transcriber.hpp"
+#include "cpu_topology.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace whispr {
+
+namespace {
+
+constexpr int SAMPLE_RATE = 16000;
+constexpr int CLIP_MS = 2000;
+constexpr int RUNS_PER_COUNT = 2;  // Best of, to ride out a stray background task
+
+// Voiced-sounding signal: a 140 Hz harmonic stack with syllable-rate amplitude
+// modulation, so the encoder and a few decoder steps both run as for speech
+std::vector<float> synthetic_clip() {
+    const float pi = 3.14159265f;
+    std::vector<float> clip(static_cast<size_t>(SAMPLE_RATE) * CLIP_MS / 1000);
+    for (size_t i = 0; i < clip.size(); ++i) {
+        float t = static_cast<float>(i) / SAMPLE_RATE;
+        float voice = 0.0f;
+        for (int h = 1; h <= 8; ++h) {
+            voice += std::sin(2.0f * pi * 140.0f * h * t) / static_cast<float>(h);
+        }
+        float envelope = 0.5f - 0.5f * std::cos(2.0f * pi * 4.0f * t);
+        clip[i] = 0.1f * envelope * voice;
+    }
+    return clip;
+}
+
+} // namespace
+
+ThreadTuner::ThreadTuner(std::string cache_path)
+    : cache_path_(std::move(cache_path))
+    , cpus_(available_cpu_count()) {
+    load();
+}
+
+std::string ThreadTuner::default_cache_path() {
+    const char* home = std::getenv("HOME");
+    if (!home) return "";
+    return std::string(home) + "/.whispr/threads.txt";
+}
+
+std::string ThreadTuner::key(const std::string& model_path, const std::string& profile_name) {
+    // By file name, so moving the model directory keeps the results
+    return std::filesystem::path(model_path).filename().string() + " " + profile_name;
+}
+
+int ThreadTuner::lookup(const std::string& model_path, const std::string& profile_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = best_.find(key(model_path, profile_name));
+    return it != best_.end() ? it->second : 0;
+}
+
+std::vector<int> ThreadTuner::candidates(int performance_cores, int all_cores) {
+    performance_cores = std::max(performance_cores, 1);
+    all_cores = std::max(all_cores, performance_cores);
+
+    // Half the P-cores is one per physical core with SMT; past the P-cores,
+    // slow cores can hold the fast ones back at each barrier
+    std::vector<int> counts = {
+        performance_cores / 2,
+        performance_cores * 3 / 4,
+        performance_cores,
+        all_cores,
+        4,  // The long-standing default, as a reference point
+    };
+    counts.erase(std::remove_if(counts.begin(), counts.end(),
+                                [&](int n) { return n < 1 || n > all_cores; }),
+                 counts.end());
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    return counts;
+}
+
+int ThreadTuner::tune(Transcriber& transcriber, const TranscriptionProfile& profile,
+                      const std::atomic<bool>* cancel) {
+    std::shared_ptr<WhisperModel> model = transcriber.model();
+    if (!model) return 0;
+
+    const std::vector<float> clip = synthetic_clip();
+    DecodeOptions options;
+    options.process_text = false;
+    options.log_result = false;
+    options.cancel = cancel;
+
+    int best_threads = 0;
+    int64_t best_us = 0;
+    std::cout << "Tuning threads for " << key(model->path(), profile.name) << ":";
+    for (int n : candidates(performance_core_count(), available_cpu_count())) {
+        options.n_threads = n;
+        int64_t fastest_us = 0;
+        for (int run = 0; run < RUNS_PER_COUNT; ++run) {
+            const uint64_t decodes_before = transcriber.decodes_started();
+            auto start = std::chrono::steady_clock::now();
+            TranscriptionResult result = transcriber.transcribe_with_profile(clip, profile, options);
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            // A quality switch mid-way would compare different models, and a
+            // dictation decoding alongside would skew the timing: nothing is
+            // stored, the next tuning run measures again
+            if (!result.success || transcriber.model() != model ||
+                transcriber.decodes_started() != decodes_before + 1) {
+                std::cout << " stopped" << std::endl;
+                return 0;
+            }
+            if (run == 0 || elapsed < fastest_us) fastest_us = elapsed;
+        }
+        std::cout << " " << n << "=" << (fastest_us / 1000) << "ms" << std::flush;
+        if (best_threads == 0 || fastest_us < best_us) {
+            best_threads = n;
+            best_us = fastest_us;
+        }
+    }
+    std::cout << " -> " << best_threads << " threads" << std::endl;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    best_[key(model->path(), profile.name)] = best_threads;
+    save_locked();
+    return best_threads;
+}
+
+void ThreadTuner::load() {
+    if (cache_path_.empty()) return;
+
+    std::ifstream file(cache_path_);
+    if (!file.is_open()) return;
+
+    // "cpus<TAB>N" first, then one "model profile<TAB>threads" per line
+    std::string line;
+    if (!std::getline(file, line) || line != "cpus\t" + std::to_string(cpus_)) {
+        return;  // Different machine or CPU set: measure again
+    }
+    while (std::getline(file, line)) {
+        size_t tab = line.rfind('\t');
+        if (tab == std::string::npos || tab == 0) continue;
+        int threads = std::atoi(line.c_str() + tab + 1);
+        if (threads > 0) best_[line.substr(0, tab)] = threads;
+    }
+}
+
+void ThreadTuner::save_locked() const {
+    if (cache_path_.empty()) return;
+
+    std::ofstream file(cache_path_, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to save thread tuning: " << cache_path_ << std::endl;
+        return;
+    }
+    file << "cpus\t" << cpus_ << '\n';
+    for (const auto& entry : best_) {
+        file << entry.first << '\t' << entry.second << '\n';
+    }
+}
+
+} // namespace whispr
@@ -0,0 +1,304 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace whispr {
+
+namespace {
+
+constexpr size_t STAGE_COUNT = static_cast<size_t>(TraceStage::Count);
+constexpr size_t RING_EVENTS = 4096;  // Per thread; older events are overwritten
+
+// Log-scale buckets over microseconds: values below 8 are exact, then 8
+// sub-buckets per power of two
+constexpr int SUB_BITS = 3;
+constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+constexpr size_t BUCKETS = SUB_BUCKETS * 40;
+
+size_t bucket_index(uint64_t us) {
+    if (us < SUB_BUCKETS) return static_cast<size_t>(us);
+    int exponent = 63 - __builtin_clzll(us);
+    size_t index = static_cast<size_t>(SUB_BUCKETS * (exponent - SUB_BITS + 1)) +
+                   static_cast<size_t>((us >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1));
+    return std::min(index, BUCKETS - 1);
+}
+
+// Middle of the range a bucket covers, in microseconds
+double bucket_value(size_t index) {
+    if (index < SUB_BUCKETS) return static_cast<double>(index);
+    int exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BITS - 1;
+    uint64_t sub = index % SUB_BUCKETS;
+    uint64_t width = 1ULL << (exponent - SUB_BITS);
+    uint64_t low = (1ULL << exponent) + sub * width;
+    return static_cast<double>(low) + static_cast<double>(width) / 2.0;
+}
+
+struct Histogram {
+    std::atomic<uint64_t> buckets[BUCKETS] = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> max_us{0};
+};
+
+// One event slot. The sequence number is odd while the owner thread writes,
+// so a concurrent dump can skip a slot it caught half-written.
+struct Slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<int64_t> begin_ns{0};
+    std::atomic<int64_t> end_ns{0};
+    std::atomic<uint64_t> job{0};
+    std::atomic<uint8_t> stage{0};
+};
+
+struct ThreadBuffer {
+    uint32_t tid = 0;         // Kept when the buffer passes to a new thread: one viewer lane
+    std::string name;         // Guarded by the registry mutex
+    uint64_t job = 0;         // Owner thread only
+    std::atomic<uint64_t> head{0};
+    Slot slots[RING_EVENTS];
+};
+
+struct Registry {
+    std::atomic<bool> enabled{false};
+    Trace::Clock::time_point start;
+    Histogram histograms[STAGE_COUNT];
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;  // Kept after their thread exits
+    std::vector<ThreadBuffer*> free;                     // ... and handed to the next new thread
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Returns the thread's buffer on exit, so threads started per decode (the
+// speculative accurate pass) reuse a few rings instead of each leaving one
+// behind; the old events stay readable until the next owner overwrites them
+struct BufferLease {
+    ThreadBuffer* buffer = nullptr;
+
+    ~BufferLease() {
+        if (!buffer) return;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer->job = 0;
+        reg.free.push_back(buffer);
+    }
+};
+
+ThreadBuffer& thread_buffer() {
+    thread_local BufferLease lease;
+    if (!lease.buffer) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (!reg.free.empty()) {
+            lease.buffer = reg.free.back();
+            reg.free.pop_back();
+            lease.buffer->name.clear();
+        } else {
+            reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+            lease.buffer = reg.buffers.back().get();
+            lease.buffer->tid = static_cast<uint32_t>(reg.buffers.size());
+        }
+    }
+    return *lease.buffer;
+}
+
+int64_t to_ns(Trace::Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out << c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+const char* trace_stage_name(TraceStage stage) {
+    switch (stage) {
+        case TraceStage::HotkeyDispatch: return "hotkey_dispatch";
+        case TraceStage::CaptureStop: return "capture_stop";
+        case TraceStage::QueueWait: return "queue_wait";
+        case TraceStage::Preprocess: return "preprocess";
+        case TraceStage::Vad: return "vad";
+        case TraceStage::Mel: return "mel";
+        case TraceStage::Encode: return "encode";
+        case TraceStage::Decode: return "decode";
+        case TraceStage::Inference: return "inference";
+        case TraceStage::TextProcess: return "text_process";
+        case TraceStage::ClipboardSet: return "clipboard_set";
+        case TraceStage::Paste: return "paste";
+        case TraceStage::Type: return "type";
+        case TraceStage::KeyToText: return "key_to_text";
+        case TraceStage::ModelWake: return "model_wake";
+        default: return "unknown";
+    }
+}
+
+void Trace::enable() {
+    Registry& reg = registry();
+    if (reg.enabled.load()) return;
+    reg.start = Clock::now();
+    reg.enabled.store(true);
+}
+
+bool Trace::enabled() {
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void Trace::record(TraceStage stage, Clock::time_point begin, Clock::time_point end) {
+    if (!enabled() || stage >= TraceStage::Count) return;
+    if (end < begin) end = begin;
+
+    Registry& reg = registry();
+    const uint64_t us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+    Histogram& histogram = reg.histograms[static_cast<size_t>(stage)];
+    histogram.buckets[bucket_index(us)].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    uint64_t seen = histogram.max_us.load(std::memory_order_relaxed);
+    while (us > seen && !histogram.max_us.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {
+    }
+
+    ThreadBuffer& buffer = thread_buffer();
+    const uint64_t index = buffer.head.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[index % RING_EVENTS];
+    slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.begin_ns.store(to_ns(begin), std::memory_order_relaxed);
+    slot.end_ns.store(to_ns(end), std::memory_order_relaxed);
+    slot.job.store(buffer.job, std::memory_order_relaxed);
+    slot.stage.store(static_cast<uint8_t>(stage), std::memory_order_relaxed);
+    slot.seq.store(2 * index + 2, std::memory_order_release);
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void Trace::set_job(uint64_t job) {
+    if (!enabled()) return;
+    thread_buffer().job = job;
+}
+
+void Trace::name_thread(const char* name) {
+    if (!enabled()) return;
+    ThreadBuffer& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+size_t Trace::thread_buffers() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.buffers.size();
+}
+
+Trace::Summary Trace::summary(TraceStage stage) {
+    Summary result = {0, 0.0, 0.0, 0.0, 0.0};
+    if (stage >= TraceStage::Count) return result;
+
+    const Histogram& histogram = registry().histograms[static_cast<size_t>(stage)];
+    uint64_t counts[BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    result.count = total;
+    result.max_ms = static_cast<double>(histogram.max_us.load(std::memory_order_relaxed)) / 1000.0;
+    if (total == 0) return result;
+
+    // Smallest bucket holding at least fraction of all events
+    auto percentile = [&](double fraction) {
+        uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5);
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(bucket_value(i) / 1000.0, result.max_ms);
+        }
+        return result.max_ms;
+    };
+    result.p50_ms = percentile(0.50);
+    result.p95_ms = percentile(0.95);
+    result.p99_ms = percentile(0.99);
+    return result;
+}
+
+void Trace::print_report(std::ostream& out) {
+    out << "\nLatency by stage (ms):\n"
+        << std::left << std::setw(17) << "stage" << std::right
+        << std::setw(8) << "count" << std::setw(10) << "p50" << std::setw(10) << "p95"
+        << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    out << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        Summary s = summary(static_cast<TraceStage>(i));
+        if (s.count == 0) continue;
+        out << std::left << std::setw(17) << trace_stage_name(static_cast<TraceStage>(i)) << std::right
+            << std::setw(8) << s.count << std::setw(10) << s.p50_ms << std::setw(10) << s.p95_ms
+            << std::setw(10) << s.p99_ms << std::setw(10) << s.max_ms << "\n";
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6) << std::flush;
+}
+
+bool Trace::write_chrome_trace(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    Registry& reg = registry();
+    const int64_t start_ns = to_ns(reg.start);
+    bool first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << std::fixed << std::setprecision(3);  // Microseconds with nanosecond digits
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        if (!buffer->name.empty()) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":";
+            write_json_string(out, buffer->name);
+            out << "}}";
+        }
+
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const uint64_t oldest = head > RING_EVENTS ? head - RING_EVENTS : 0;
+        for (uint64_t index = oldest; index < head; ++index) {
+            const Slot& slot = buffer->slots[index % RING_EVENTS];
+            const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            const int64_t begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+            const int64_t end_ns = slot.end_ns.load(std::memory_order_relaxed);
+            const uint64_t job = slot.job.load(std::memory_order_relaxed);
+            const auto stage = static_cast<TraceStage>(slot.stage.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq != 2 * index + 2 || slot.seq.load(std::memory_order_relaxed) != seq) {
+                continue;  // Overwritten while we read it
+            }
+
+            separator();
+            out << "{\"name\":\"" << trace_stage_name(stage) << "\",\"cat\":\"voxtype\",\"ph\":\"X\""
+                << ",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << (begin_ns - start_ns) / 1000.0
+                << ",\"dur\":" << (end_ns - begin_ns) / 1000.0;
+            if (job != 0) out << ",\"args\":{\"job\":" << job << "}";
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+
+} // namespace whispr
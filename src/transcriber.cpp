@@ -1,7 +1,13 @@
 #include "transcriber.hpp"
 #include "whisper.h"
+#include "cpu_topology.hpp"
+#include "running_confidence.hpp"
+#include "trace.hpp"
 #include <iostream>
 #include <chrono>
+#include <thread>
+#include <algorithm>
+#include <type_traits>
 
 namespace whispr {
 
@@ -11,47 +17,192 @@ Transcriber::~Transcriber() {
     shutdown();
 }
 
-bool Transcriber::initialize(const std::string& model_path, int n_threads) {
-    if (ctx_) return true;
+bool Transcriber::initialize(const std::string& model_path, int n_threads, size_t max_states) {
+    if (is_initialized()) return true;
 
-    n_threads_ = n_threads;
+    // Initialize whisper context with GPU acceleration (Metal on macOS)
+    auto model = WhisperModel::load(model_path, max_states, true);
+    if (!model) return false;
 
-    // Initialize whisper context with GPU acceleration
-    struct whisper_context_params cparams = whisper_context_default_params();
-#ifdef PLATFORM_MACOS
-    cparams.use_gpu = true;   // Enable Metal acceleration on macOS
-#else
-    cparams.use_gpu = false;
-#endif
+    return initialize(std::move(model), n_threads);
+}
 
-    ctx_ = whisper_init_from_file_with_params(model_path.c_str(), cparams);
-    if (!ctx_) {
-        std::cerr << "Failed to load whisper model: " << model_path << std::endl;
-        return false;
-    }
+bool Transcriber::initialize(std::shared_ptr<WhisperModel> model, int n_threads) {
+    if (!model) return false;
 
-    std::cout << "Loaded whisper model: " << model_path << std::endl;
+    std::lock_guard<std::mutex> lock(model_mutex_);
+    n_threads_ = n_threads;
+    model_ = std::move(model);
     return true;
 }
 
 void Transcriber::shutdown() {
-    if (ctx_) {
-        whisper_free(ctx_);
-        ctx_ = nullptr;
+    // In-flight decodes hold their own reference and release the model when done
+    {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+        model_.reset();
+        model_expected_ = false;
+    }
+    model_cv_.notify_all();
+}
+
+bool Transcriber::is_initialized() const {
+    std::lock_guard<std::mutex> lock(model_mutex_);
+    return model_ != nullptr;
+}
+
+void Transcriber::set_model(std::shared_ptr<WhisperModel> model, const TranscriptionProfile& profile) {
+    {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+        model_ = std::move(model);
+        profile_ = profile;
+        model_expected_ = false;
+    }
+    model_cv_.notify_all();
+}
+
+void Transcriber::release_model() {
+    std::lock_guard<std::mutex> lock(model_mutex_);
+    model_.reset();
+}
+
+void Transcriber::expect_model(bool expected) {
+    {
+        std::lock_guard<std::mutex> lock(model_mutex_);
+        model_expected_ = expected;
     }
+    model_cv_.notify_all();
+}
+
+std::shared_ptr<WhisperModel> Transcriber::model() const {
+    std::lock_guard<std::mutex> lock(model_mutex_);
+    return model_;
+}
+
+void Transcriber::set_profile(const TranscriptionProfile& profile) {
+    std::lock_guard<std::mutex> lock(model_mutex_);
+    profile_ = profile;
+}
+
+TranscriptionProfile Transcriber::get_profile() const {
+    std::lock_guard<std::mutex> lock(model_mutex_);
+    return profile_;
+}
+
+static_assert(std::is_same<whisper_token, int32_t>::value, "PromptTokens must hold whisper tokens");
+
+namespace {
+
+// Running confidence is only trusted to end a decode after this many tokens
+constexpr int EARLY_EXIT_MIN_TOKENS = 16;
+// How far below the adaptive threshold it must be by then
+constexpr float EARLY_EXIT_MARGIN = 0.1f;
+
+// Shared with whisper's callbacks: cancellation, running confidence and, when
+// tracing, the moments the encoder and the first decoder step begin (0 until seen)
+struct DecodeHooks {
+    const std::atomic<bool>* cancel = nullptr;
+    bool tracing = false;
+    std::atomic<int64_t> encode_begin{0};
+    std::atomic<int64_t> decode_begin{0};  // Beam decoders may report it from several threads
+
+    RunningConfidence confidence;
+    bool track_pending = false;     // One decoder, so the sequence in the logits callback is the result's
+    float stop_below = 0.0f;
+    std::atomic<bool> stopped{false};  // Running confidence fell below stop_below
+    std::atomic<bool> cut_short{false};  // ... and whisper gave up work because of it
+
+    // After the last segment there is nothing left to stop, so a decode only
+    // counts as stopped early once whisper has asked and been refused
+    bool aborted() {
+        if (cancel && cancel->load()) return true;
+        if (!stopped.load(std::memory_order_relaxed)) return false;
+        cut_short.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    void check_confidence() {
+        if (stop_below > 0.0f && confidence.below(stop_below, EARLY_EXIT_MIN_TOKENS)) {
+            stopped.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+int64_t now_ticks() {
+    return Trace::Clock::now().time_since_epoch().count();
 }
 
-TranscriptionResult Transcriber::transcribe(const std::vector<float>& audio) {
-    return transcribe_with_profile(audio, profile_);
+Trace::Clock::time_point from_ticks(int64_t ticks) {
+    return Trace::Clock::time_point(Trace::Clock::duration(ticks));
 }
 
-TranscriptionResult Transcriber::transcribe_with_profile(const std::vector<float>& audio,
-                                                          const TranscriptionProfile& profile) {
+void mark_once(std::atomic<int64_t>& mark) {
+    int64_t unset = 0;
+    if (mark.load(std::memory_order_relaxed) == 0) {
+        mark.compare_exchange_strong(unset, now_ticks(), std::memory_order_relaxed);
+    }
+}
+
+// Tokens never outnumber bytes, so this buffer always suffices
+std::vector<whisper_token> tokenize(whisper_context* ctx, const std::string& text) {
+    std::vector<whisper_token> tokens(text.size() + 1);
+    int n = whisper_tokenize(ctx, text.c_str(), tokens.data(), static_cast<int>(tokens.size()));
+    tokens.resize(static_cast<size_t>(std::max(n, 0)));
+    return tokens;
+}
+
+} // namespace
+
+void Transcriber::set_initial_prompt(const std::string& prompt) {
+    std::lock_guard<std::mutex> lock(prompt_mutex_);
+    initial_prompt_ = prompt;
+    prompt_tokens_.reset();
+    prompt_model_.reset();
+}
+
+std::shared_ptr<const Transcriber::PromptTokens> Transcriber::prompt_tokens(
+        const std::shared_ptr<WhisperModel>& model) const {
+    std::lock_guard<std::mutex> lock(prompt_mutex_);
+    if (initial_prompt_.empty()) return nullptr;
+    if (prompt_tokens_ && prompt_model_.lock() == model) return prompt_tokens_;
+
+    // Models can differ in vocabulary, so tokens are only reused with the same one
+    prompt_tokens_ = std::make_shared<const PromptTokens>(tokenize(model->context(), initial_prompt_));
+    prompt_model_ = model;
+    return prompt_tokens_;
+}
+
+int Transcriber::count_tokens(const std::string& text) const {
+    std::shared_ptr<WhisperModel> model = this->model();
+    if (!model) return -1;
+    return static_cast<int>(tokenize(model->context(), text).size());
+}
+
+int Transcriber::max_prompt_tokens() const {
+    std::shared_ptr<WhisperModel> model = this->model();
+    if (!model) return 0;
+    return whisper_n_text_ctx(model->context()) / 2;
+}
+
+TranscriptionResult Transcriber::transcribe(Span<const float> audio) {
+    return transcribe_with_profile(audio, get_profile());
+}
+
+TranscriptionResult Transcriber::transcribe_with_profile(Span<const float> audio,
+                                                          const TranscriptionProfile& profile,
+                                                          const DecodeOptions& options) {
     TranscriptionResult result;
     result.success = false;
     result.confidence = 0.0f;
 
-    if (!ctx_) {
+    // Keep the model alive for this decode even if it is switched meanwhile;
+    // after an idle unload, wait for the reload the hotkey started
+    std::shared_ptr<WhisperModel> model;
+    {
+        std::unique_lock<std::mutex> lock(model_mutex_);
+        model_cv_.wait(lock, [this]() { return model_ || !model_expected_; });
+        model = model_;
+    }
+    if (!model) {
         result.error = "Transcriber not initialized";
         return result;
     }
@@ -60,9 +211,35 @@ TranscriptionResult Transcriber::transcribe_with_profile(const std::vector<float
         result.error = "No audio data";
         return result;
     }
+    decodes_started_.fetch_add(1, std::memory_order_relaxed);
 
     auto start_time = std::chrono::high_resolution_clock::now();
 
+    std::shared_ptr<const PromptTokens> prompt = prompt_tokens(model);
+    PromptTokens with_context;
+    if (!options.context.empty()) {
+        // Whisper only keeps the newest half context of prompt tokens anyway
+        if (prompt) with_context = *prompt;
+        std::vector<whisper_token> context = tokenize(model->context(), " " + options.context);
+        with_context.insert(with_context.end(), context.begin(), context.end());
+        const size_t limit = static_cast<size_t>(whisper_n_text_ctx(model->context()) / 2);
+        if (with_context.size() > limit) {
+            with_context.erase(with_context.begin(), with_context.end() - static_cast<std::ptrdiff_t>(limit));
+        }
+    }
+    const PromptTokens* prompt_used = with_context.empty() ? prompt.get() : &with_context;
+    const bool has_prompt = prompt_used && !prompt_used->empty();
+
+    if (auto_threads_) {
+        // ggml's workers are spawned by this thread and inherit its placement
+        thread_local bool pinned = false;
+        if (!pinned) {
+            pinned = true;
+            pin_to_performance_cores();
+        }
+    }
+    const int n_threads = options.n_threads > 0 ? options.n_threads : thread_budget(*model, profile);
+
     // Configure whisper parameters based on profile
     whisper_full_params wparams = whisper_full_default_params(
         profile.beam_size > 1 ? WHISPER_SAMPLING_BEAM_SEARCH : WHISPER_SAMPLING_GREEDY
@@ -75,12 +252,16 @@ TranscriptionResult Transcriber::transcribe_with_profile(const std::vector<float
     wparams.translate        = translate_;
     // Use single segment for short audio (<10s) to prevent duplication, multi for longer
     bool is_short = audio.size() < static_cast<size_t>(16000 * 10);  // 10 seconds at 16kHz
-    wparams.single_segment   = is_short;
-    wparams.no_context       = initial_prompt_.empty();  // Use context if prompt provided
+    wparams.single_segment   = is_short && !options.multi_segment;
+    wparams.no_context       = !has_prompt;  // Use context if prompt provided
     wparams.language         = language_.c_str();
-    wparams.n_threads        = n_threads_;
+    wparams.n_threads        = n_threads;
     wparams.suppress_blank   = true;   // Suppress blank outputs
 
+    // Short clips don't need the encoder to process 30s of padding
+    const int64_t audio_ms = static_cast<int64_t>(audio.size()) * 1000 / 16000;
+    wparams.audio_ctx        = select_audio_ctx(profile, audio_ms);
+
     // Apply profile settings
     wparams.greedy.best_of        = profile.best_of;
     wparams.beam_search.beam_size = profile.beam_size;
@@ -92,11 +273,12 @@ TranscriptionResult Transcriber::transcribe_with_profile(const std::vector<float
     // Optimized parameters based on OpenAI recommendations
     wparams.temperature_inc       = 0.2f;   // Fallback temperature increment for retries
     wparams.max_initial_ts        = 1.0f;   // Limit first timestamp to 1 second
-    wparams.token_timestamps      = true;   // Enable word-level timestamps for debugging
+    wparams.token_timestamps      = profile.token_timestamps;
 
-    // Initial prompt for context
-    if (!initial_prompt_.empty()) {
-        wparams.initial_prompt = initial_prompt_.c_str();
+    // Initial prompt for context, already tokenized (whisper would redo it per call)
+    if (has_prompt) {
+        wparams.prompt_tokens   = prompt_used->data();
+        wparams.prompt_n_tokens = static_cast<int>(prompt_used->size());
     }
 
     // Progress callback
@@ -110,22 +292,139 @@ TranscriptionResult Transcriber::transcribe_with_profile(const std::vector<float
         wparams.progress_callback_user_data = &progress_cb_;
     }
 
+    // Confidence is accumulated as each segment is finished, while its token
+    // data is fresh, instead of in a pass over the whole result afterwards
+    DecodeHooks hooks;
+    hooks.cancel = options.cancel;
+    hooks.tracing = Trace::enabled();
+    hooks.stop_below = options.stop_below;
+    // Beam search and best-of sampling run several decoders (on several
+    // threads), so only a greedy decode has one sequence to follow mid-segment
+    hooks.track_pending = options.stop_below > 0.0f &&
+                          profile.beam_size <= 1 && profile.best_of <= 1;
+    wparams.new_segment_callback = [](struct whisper_context*, struct whisper_state* state, int n_new, void* user_data) {
+        auto* hooks = static_cast<DecodeHooks*>(user_data);
+        const int n_segments = whisper_full_n_segments_from_state(state);
+        for (int seg = std::max(0, n_segments - n_new); seg < n_segments; ++seg) {
+            const int n_tokens = whisper_full_n_tokens_from_state(state, seg);
+            for (int tok = 0; tok < n_tokens; ++tok) {
+                whisper_token_data token_data = whisper_full_get_token_data_from_state(state, seg, tok);
+                hooks->confidence.commit(token_data.id, token_data.p);
+            }
+        }
+        hooks->confidence.end_segments();
+        hooks->check_confidence();
+    };
+    wparams.new_segment_callback_user_data = &hooks;
+
+    // Cancellation and early exit: checked before the encoder starts and between graph nodes
+    if (options.cancel || options.stop_below > 0.0f || hooks.tracing) {
+        wparams.encoder_begin_callback = [](struct whisper_context*, struct whisper_state*, void* user_data) {
+            auto* hooks = static_cast<DecodeHooks*>(user_data);
+            if (hooks->tracing) mark_once(hooks->encode_begin);
+            return !hooks->aborted();
+        };
+        wparams.encoder_begin_callback_user_data = &hooks;
+    }
+    if (options.cancel || options.stop_below > 0.0f) {
+        wparams.abort_callback = [](void* user_data) {
+            return static_cast<DecodeHooks*>(user_data)->aborted();
+        };
+        wparams.abort_callback_user_data = &hooks;
+    }
+    // Called before sampling each decoder step with the tokens decoded so far;
+    // the first call ends the encoder
+    if (hooks.tracing || hooks.track_pending) {
+        wparams.logits_filter_callback = [](struct whisper_context*, struct whisper_state*,
+                                            const whisper_token_data* tokens, int n_tokens, float*, void* user_data) {
+            auto* hooks = static_cast<DecodeHooks*>(user_data);
+            if (hooks->tracing) mark_once(hooks->decode_begin);
+            if (!hooks->track_pending) return;
+
+            float sum = 0.0f;
+            int counted = 0;
+            for (int i = 0; i < n_tokens; ++i) {
+                if (tokens[i].id >= 0 && tokens[i].p > 0.0f) {
+                    sum += tokens[i].p;
+                    ++counted;
+                }
+            }
+            hooks->confidence.set_pending(sum, counted);
+            hooks->check_confidence();
+        };
+        wparams.logits_filter_callback_user_data = &hooks;
+    }
+
+    // Results live in the state, so it stays leased until they are read
+    StatePool::Lease lease = model->states().acquire();
+    if (!lease) {
+        result.error = "No whisper state available";
+        return result;
+    }
+    whisper_state* state = lease.get();
+
+    // May have waited for the state; don't start work nobody wants anymore
+    if (options.cancel && options.cancel->load()) {
+        result.error = "Cancelled";
+        return result;
+    }
+
     // Run inference
-    int ret = whisper_full(ctx_, wparams, audio.data(), static_cast<int>(audio.size()));
+    const auto inference_begin = Trace::Clock::now();
+    int ret = whisper_full_with_state(model->context(), state, wparams, audio.data(), static_cast<int>(audio.size()));
+    if (hooks.tracing) {
+        // Stage split of the first 30s window; later windows count as decode
+        const auto inference_end = Trace::Clock::now();
+        const int64_t encode_begin = hooks.encode_begin.load();
+        const int64_t decode_begin = hooks.decode_begin.load();
+        Trace::record(TraceStage::Inference, inference_begin, inference_end);
+        if (encode_begin != 0) {
+            Trace::record(TraceStage::Mel, inference_begin, from_ticks(encode_begin));
+            if (decode_begin != 0) {
+                Trace::record(TraceStage::Encode, from_ticks(encode_begin), from_ticks(decode_begin));
+                Trace::record(TraceStage::Decode, from_ticks(decode_begin), inference_end);
+            }
+        }
+    }
+    if (options.cancel && options.cancel->load()) {
+        result.error = "Cancelled";
+        return result;
+    }
+    if (hooks.cut_short.load()) {
+        result.error = "Low confidence";
+        result.stopped_early = true;
+        result.confidence = hooks.confidence.value();
+        result.duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start_time).count();
+        if (options.log_result) {
+            std::cout << "Transcription [" << profile.name << "] stopped after "
+                      << hooks.confidence.tokens() << " tokens (conf: "
+                      << static_cast<int>(result.confidence * 100) << "%)" << std::endl;
+        }
+        return result;
+    }
     if (ret != 0) {
         result.error = "Whisper inference failed";
         return result;
     }
 
-    // Get result
-    const int n_segments = whisper_full_n_segments(ctx_);
+    // Get result (whisper timestamps are in 10ms units)
+    const int n_segments = whisper_full_n_segments_from_state(state);
     std::string text;
+    result.segments.reserve(n_segments);
     for (int i = 0; i < n_segments; ++i) {
-        const char* segment_text = whisper_full_get_segment_text(ctx_, i);
+        const char* segment_text = whisper_full_get_segment_text_from_state(state, i);
         if (segment_text) {
             text += segment_text;
+            result.segments.push_back({
+                whisper_full_get_segment_t0_from_state(state, i) * 10,
+                whisper_full_get_segment_t1_from_state(state, i) * 10,
+                segment_text
+            });
         }
     }
+    result.confidence = hooks.confidence.committed();
+    lease.release();
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -141,28 +440,84 @@ TranscriptionResult Transcriber::transcribe_with_profile(const std::vector<float
     result.raw_text = text;
 
     // Post-process text (remove fillers, fix formatting)
-    if (process_text_ && !text.empty()) {
-        text = text_processor_.process(text);
+    if (options.process_text) {
+        TraceSpan span(TraceStage::TextProcess);
+        text = post_process(text);
     }
 
     result.text = text;
     result.duration_ms = duration.count();
-    result.confidence = calculate_confidence();
     result.success = true;
 
-    std::cout << "Transcription [" << profile.name << "] took " << result.duration_ms << "ms (conf: "
+    if (!options.log_result) return result;
+
+    std::cout << "Transcription [" << profile.name;
+    if (wparams.audio_ctx > 0) {
+        std::cout << ", ctx " << wparams.audio_ctx;
+    }
+    std::cout << "] took " << result.duration_ms << "ms (conf: "
               << static_cast<int>(result.confidence * 100) << "%): \"" << result.text << "\"" << std::endl;
-    if (process_text_ && result.raw_text != result.text) {
+    if (options.process_text && process_text_ && result.raw_text != result.text) {
         std::cout << "  (raw: \"" << result.raw_text << "\")" << std::endl;
     }
 
     return result;
 }
 
-TranscriptionResult Transcriber::transcribe_adaptive(const std::vector<float>& audio,
+TranscriptionResult Transcriber::warm_up(const TranscriptionProfile& profile) {
+    const std::vector<float> silence(16000, 0.0f);
+    DecodeOptions options;
+    options.process_text = false;
+    options.log_result = false;
+    return transcribe_with_profile(silence, profile, options);
+}
+
+int Transcriber::thread_budget(const WhisperModel& model, const TranscriptionProfile& profile) const {
+    const int tuned = auto_threads_ && tuner_ ? tuner_->lookup(model.path(), profile.name) : 0;
+    return tuned > 0 ? tuned : n_threads_;
+}
+
+std::string Transcriber::post_process(const std::string& raw_text) const {
+    if (!process_text_ || raw_text.empty()) return raw_text;
+    return text_processor_.process(raw_text);
+}
+
+std::string Transcriber::post_process_partial(const std::string& raw_text) const {
+    if (!process_text_ || raw_text.empty()) return raw_text;
+
+    TextProcessorConfig config = text_processor_.get_config();
+    config.ensure_punctuation = false;
+    return TextProcessor(config).process(raw_text);
+}
+
+TranscriptionResult Transcriber::transcribe_adaptive(Span<const float> audio,
                                                       float confidence_threshold) {
-    // First pass: try with current (fast) profile
-    auto result = transcribe_with_profile(audio, PROFILE_FAST);
+    if (speculative_) {
+        return transcribe_adaptive_speculative(audio, confidence_threshold);
+    }
+    return transcribe_adaptive_sequential(audio, confidence_threshold);
+}
+
+TranscriptionResult Transcriber::transcribe_adaptive_sequential(Span<const float> audio,
+                                                                 float confidence_threshold) {
+    // First pass: try with current (fast) profile, given up as soon as its
+    // running confidence shows the retry will be needed anyway
+    DecodeOptions fast_options;
+    fast_options.stop_below = confidence_threshold - EARLY_EXIT_MARGIN;
+    auto result = transcribe_with_profile(audio, PROFILE_FAST, fast_options);
+
+    if (result.stopped_early) {
+        std::cout << "Low confidence (" << static_cast<int>(result.confidence * 100)
+                  << "%) while decoding, switching to Optimized profile..." << std::endl;
+
+        auto retry_result = transcribe_with_profile(audio, PROFILE_OPTIMIZED);
+        if (!retry_result.success) {
+            // Better the fast pass's text than none
+            retry_result = transcribe_with_profile(audio, PROFILE_FAST);
+        }
+        retry_result.duration_ms += result.duration_ms;
+        return retry_result;
+    }
 
     // If confidence is low and we're not already using the best profile, retry
     if (result.success && result.confidence < confidence_threshold && !result.text.empty()) {
@@ -181,28 +536,60 @@ TranscriptionResult Transcriber::transcribe_adaptive(const std::vector<float>& a
     return result;
 }
 
-float Transcriber::calculate_confidence() const {
-    if (!ctx_) return 0.0f;
+TranscriptionResult Transcriber::transcribe_adaptive_speculative(Span<const float> audio,
+                                                                  float confidence_threshold) {
+    auto start_time = std::chrono::high_resolution_clock::now();
 
-    const int n_segments = whisper_full_n_segments(ctx_);
-    if (n_segments == 0) return 0.0f;
+    // Each pass gets half of what it would have alone, so the two never
+    // oversubscribe the cores; tuned counts are per profile for one decode
+    std::shared_ptr<WhisperModel> model = this->model();
+    auto half_budget = [&](const TranscriptionProfile& profile) {
+        return std::max(1, (model ? thread_budget(*model, profile) : n_threads_) / 2);
+    };
+
+    std::atomic<bool> cancel_accurate{false};
+    DecodeOptions accurate_options;
+    accurate_options.n_threads = half_budget(PROFILE_OPTIMIZED);
+    accurate_options.cancel = &cancel_accurate;
+
+    // Speculatively start the accurate pass on its own state
+    TranscriptionResult accurate;
+    std::thread accurate_thread([&]() {
+        accurate = transcribe_with_profile(audio, PROFILE_OPTIMIZED, accurate_options);
+    });
+
+    // A fast pass that is clearly going to lose stops early and stops
+    // competing with the accurate one for cores and memory bandwidth
+    DecodeOptions fast_options;
+    fast_options.n_threads = half_budget(PROFILE_FAST);
+    fast_options.stop_below = confidence_threshold - EARLY_EXIT_MARGIN;
+    auto fast = transcribe_with_profile(audio, PROFILE_FAST, fast_options);
+
+    const bool fast_good = fast.success && (fast.confidence >= confidence_threshold || fast.text.empty());
+    if (fast_good) {
+        cancel_accurate.store(true);
+    } else if (fast.success || fast.stopped_early) {
+        std::cout << "Low confidence (" << static_cast<int>(fast.confidence * 100)
+                  << "%), waiting for speculative Optimized pass..." << std::endl;
+    }
 
-    float total_prob = 0.0f;
-    int total_tokens = 0;
+    // The accurate pass reads the caller's audio, so always wait for it to stop
+    accurate_thread.join();
 
-    for (int seg = 0; seg < n_segments; ++seg) {
-        const int n_tokens = whisper_full_n_tokens(ctx_, seg);
-        for (int tok = 0; tok < n_tokens; ++tok) {
-            whisper_token_data token_data = whisper_full_get_token_data(ctx_, seg, tok);
-            // Skip special tokens (negative IDs or very low probability)
-            if (token_data.id >= 0 && token_data.p > 0.0f) {
-                total_prob += token_data.p;
-                total_tokens++;
-            }
-        }
+    if (fast.stopped_early && !accurate.success) {
+        // Better the fast pass's text than none
+        fast = transcribe_with_profile(audio, PROFILE_FAST);
     }
 
-    return total_tokens > 0 ? total_prob / static_cast<float>(total_tokens) : 0.0f;
+    auto end_time = std::chrono::high_resolution_clock::now();
+    int64_t wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    TranscriptionResult result = fast;
+    if (!fast_good && accurate.success && (!fast.success || accurate.confidence > fast.confidence)) {
+        result = std::move(accurate);
+    }
+    result.duration_ms = wall_ms;  // Both passes overlapped; report wall time
+    return result;
 }
 
 } // namespace whispr
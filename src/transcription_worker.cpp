@@ -0,0 +1,113 @@
+#include "transcription_worker.hpp"
+#include <iostream>
+
+namespace whispr {
+
+TranscriptionWorker::TranscriptionWorker(std::unique_ptr<Transcriber> transcriber, size_t max_pending,
+                                         size_t n_workers)
+    : transcriber_(std::move(transcriber))
+    , max_pending_(max_pending > 0 ? max_pending : 1)
+    , n_workers_(n_workers > 0 ? n_workers : 1) {
+}
+
+TranscriptionWorker::~TranscriptionWorker() {
+    stop();
+}
+
+bool TranscriptionWorker::start() {
+    if (running_.load()) return true;
+    if (!transcriber_ || !transcriber_->is_initialized()) return false;
+
+    running_.store(true);
+    for (size_t i = 0; i < n_workers_; ++i) {
+        worker_threads_.emplace_back([this]() {
+            run_loop();
+        });
+    }
+
+    return true;
+}
+
+void TranscriptionWorker::stop() {
+    if (!running_.load()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_.store(false);
+        if (!queue_.empty()) {
+            std::cerr << "Discarding " << queue_.size() << " queued transcription(s)" << std::endl;
+            pending_.fetch_sub(queue_.size());
+            queue_.clear();
+        }
+    }
+    queue_cv_.notify_all();
+
+    for (auto& thread : worker_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    worker_threads_.clear();
+}
+
+bool TranscriptionWorker::submit(Task task, Completion on_complete) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_.load() || pending_.load() >= max_pending_) {
+            return false;
+        }
+        queue_.push_back({next_job_id_++, std::move(task), std::move(on_complete)});
+        pending_.fetch_add(1);
+    }
+    queue_cv_.notify_one();
+    return true;
+}
+
+void TranscriptionWorker::run_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this]() { return !running_.load() || !queue_.empty(); });
+            if (!running_.load()) break;
+
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        TranscriptionResult result = job.task(*transcriber_);
+
+        {
+            std::lock_guard<std::mutex> lock(finished_mutex_);
+            finished_.emplace(job.id, Finished{std::move(result), std::move(job.on_complete)});
+        }
+        deliver_ready();
+    }
+}
+
+void TranscriptionWorker::deliver_ready() {
+    // Whoever holds deliver_mutex_ drains everything that is ready, so a job
+    // finishing early just parks its result until its predecessors are done
+    std::lock_guard<std::mutex> deliver_lock(deliver_mutex_);
+    while (true) {
+        Finished done;
+        {
+            std::lock_guard<std::mutex> lock(finished_mutex_);
+            auto it = finished_.find(next_to_deliver_);
+            if (it == finished_.end()) return;
+            done = std::move(it->second);
+            finished_.erase(it);
+            ++next_to_deliver_;
+        }
+
+        // Count the job as done before its callback so the callback sees
+        // an accurate pending() for state updates
+        pending_.fetch_sub(1);
+
+        if (done.on_complete) {
+            done.on_complete(done.result);
+        }
+    }
+}
+
+} // namespace whispr
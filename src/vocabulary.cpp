@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <cstdlib>
+#include <cctype>
 
 namespace whispr {
 
@@ -84,67 +85,194 @@ VocabularyConfig VocabularyLoader::load_from_file(const std::string& path) {
     return vocab;
 }
 
-std::string VocabularyLoader::truncate_to_tokens(const std::string& text, int max_tokens) {
-    // Rough estimate: 4 characters per token on average
-    int max_chars = max_tokens * 4;
-    if (static_cast<int>(text.length()) <= max_chars) {
-        return text;
-    }
+int VocabularyLoader::estimate_tokens(const std::string& text) {
+    return static_cast<int>((text.length() + 3) / 4);
+}
 
-    // Find last complete word before limit
-    std::string truncated = text.substr(0, max_chars);
-    size_t last_space = truncated.find_last_of(" ,.");
-    if (last_space != std::string::npos && last_space > 0) {
-        truncated = truncated.substr(0, last_space);
-    }
+namespace {
+
+enum Section { PROPER_NOUNS, TECHNICAL_TERMS, COMMON_PHRASES, SECTION_COUNT };
 
-    return truncated;
+const std::vector<std::string>& section_terms(const VocabularyConfig& vocab, int section) {
+    switch (section) {
+        case PROPER_NOUNS: return vocab.proper_nouns;
+        case TECHNICAL_TERMS: return vocab.technical_terms;
+        default: return vocab.common_phrases;
+    }
 }
 
-std::string VocabularyLoader::build_initial_prompt(const VocabularyConfig& vocab,
-                                                    const std::string& base_prompt) {
+// Render the prompt with the chosen terms (indices into each section, in order)
+std::string render_prompt(const VocabularyConfig& vocab, const std::string& base_prompt,
+                          const std::vector<size_t> (&chosen)[SECTION_COUNT]) {
     std::ostringstream prompt;
 
     // Start with base prompt if provided
     if (!base_prompt.empty()) {
         prompt << base_prompt;
-        if (base_prompt.back() != ' ' && base_prompt.back() != '.') {
+        if (base_prompt.back() != ' ') {
             prompt << " ";
         }
     }
 
     // Add proper nouns
-    if (!vocab.proper_nouns.empty()) {
+    if (!chosen[PROPER_NOUNS].empty()) {
         prompt << "Names and proper nouns: ";
-        for (size_t i = 0; i < vocab.proper_nouns.size(); ++i) {
+        for (size_t i = 0; i < chosen[PROPER_NOUNS].size(); ++i) {
             if (i > 0) prompt << ", ";
-            prompt << vocab.proper_nouns[i];
+            prompt << vocab.proper_nouns[chosen[PROPER_NOUNS][i]];
         }
         prompt << ". ";
     }
 
     // Add technical terms
-    if (!vocab.technical_terms.empty()) {
+    if (!chosen[TECHNICAL_TERMS].empty()) {
         prompt << "Technical terms: ";
-        for (size_t i = 0; i < vocab.technical_terms.size(); ++i) {
+        for (size_t i = 0; i < chosen[TECHNICAL_TERMS].size(); ++i) {
             if (i > 0) prompt << ", ";
-            prompt << vocab.technical_terms[i];
+            prompt << vocab.technical_terms[chosen[TECHNICAL_TERMS][i]];
         }
         prompt << ". ";
     }
 
     // Add common phrases (these can be particularly helpful)
-    if (!vocab.common_phrases.empty()) {
+    if (!chosen[COMMON_PHRASES].empty()) {
         prompt << "Common phrases: ";
-        for (size_t i = 0; i < vocab.common_phrases.size(); ++i) {
+        for (size_t i = 0; i < chosen[COMMON_PHRASES].size(); ++i) {
             if (i > 0) prompt << "; ";
-            prompt << "\"" << vocab.common_phrases[i] << "\"";
+            prompt << "\"" << vocab.common_phrases[chosen[COMMON_PHRASES][i]] << "\"";
         }
         prompt << ". ";
     }
 
-    // Truncate to stay within token limit (leave some room for safety)
-    return truncate_to_tokens(prompt.str(), 200);
+    return prompt.str();
+}
+
+std::string to_lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+bool is_word_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+} // namespace
+
+std::string VocabularyLoader::build_initial_prompt(const VocabularyConfig& vocab,
+                                                    const std::string& base_prompt) {
+    // Leave some room for safety, the estimate can be off either way
+    return build_initial_prompt(vocab, base_prompt, {}, estimate_tokens, 200);
+}
+
+std::string VocabularyLoader::build_initial_prompt(const VocabularyConfig& vocab,
+                                                    const std::string& base_prompt,
+                                                    const TermUsage& usage,
+                                                    const TokenCounter& count_tokens,
+                                                    int max_tokens) {
+    struct Candidate {
+        int section;
+        size_t index;
+        uint32_t uses;
+    };
+
+    std::vector<Candidate> candidates;
+    for (int section = 0; section < SECTION_COUNT; ++section) {
+        const auto& terms = section_terms(vocab, section);
+        for (size_t i = 0; i < terms.size(); ++i) {
+            auto it = usage.find(terms[i]);
+            candidates.push_back({section, i, it != usage.end() ? it->second : 0u});
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) { return a.uses > b.uses; });
+
+    // Whisper keeps the end of an over-long prompt, which would cut the base
+    // prompt first; add terms only while the real token count fits. A term
+    // that doesn't fit may leave room for a shorter, less used one.
+    std::vector<size_t> chosen[SECTION_COUNT];
+    std::string prompt = render_prompt(vocab, base_prompt, chosen);
+    for (const Candidate& candidate : candidates) {
+        chosen[candidate.section].push_back(candidate.index);
+        std::string attempt = render_prompt(vocab, base_prompt, chosen);
+        if (count_tokens(attempt) <= max_tokens) {
+            prompt = std::move(attempt);
+        } else {
+            chosen[candidate.section].pop_back();
+        }
+    }
+
+    return prompt;
+}
+
+void VocabularyLoader::count_usage(const VocabularyConfig& vocab, const std::string& text, TermUsage& usage) {
+    const std::string haystack = to_lower(text);
+
+    for (int section = 0; section < SECTION_COUNT; ++section) {
+        for (const auto& term : section_terms(vocab, section)) {
+            const std::string needle = to_lower(term);
+            if (needle.empty()) continue;
+
+            for (size_t pos = haystack.find(needle); pos != std::string::npos;
+                 pos = haystack.find(needle, pos + 1)) {
+                size_t end = pos + needle.size();
+                bool starts_word = pos == 0 || !is_word_char(haystack[pos - 1]);
+                bool ends_word = end == haystack.size() || !is_word_char(haystack[end]);
+                if (starts_word && ends_word) {
+                    ++usage[term];
+                }
+            }
+        }
+    }
+}
+
+std::string VocabularyLoader::get_default_usage_path() {
+    const char* home = std::getenv("HOME");
+    if (!home) return "";
+    return std::string(home) + "/.whispr/vocabulary_usage.txt";
+}
+
+TermUsage VocabularyLoader::load_usage(const std::string& path) {
+    TermUsage usage;
+    if (path.empty()) return usage;
+
+    std::ifstream file(path);
+    if (!file.is_open()) return usage;
+
+    // One "count<TAB>term" per line
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos || tab == 0 || tab + 1 >= line.size()) continue;
+        unsigned long count = std::strtoul(line.c_str(), nullptr, 10);
+        usage[line.substr(tab + 1)] = static_cast<uint32_t>(count);
+    }
+    return usage;
+}
+
+bool VocabularyLoader::save_usage(const std::string& path, const TermUsage& usage) {
+    if (path.empty()) return false;
+
+    // Write aside and rename so a crash never leaves a truncated file
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write vocabulary usage: " << tmp_path << std::endl;
+            return false;
+        }
+        for (const auto& entry : usage) {
+            file << entry.second << '\t' << entry.first << '\n';
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::cerr << "Failed to write vocabulary usage: " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
 }
 
 bool VocabularyLoader::create_default_vocabulary_file() {
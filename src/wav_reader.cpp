@@ -0,0 +1,240 @@
+#include "wav_reader.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace whispr {
+
+namespace {
+
+constexpr size_t FRAMES_PER_BLOCK = 4096;
+constexpr uint32_t OPEN_ENDED_SIZE = 0xFFFFFFFFu;  // Written by encoders that stream to a pipe
+constexpr int FORMAT_PCM = 1;
+constexpr int FORMAT_FLOAT = 3;
+constexpr int FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Read and discard, which also works on pipes where fseek doesn't
+bool skip(FILE* file, uint64_t bytes) {
+    uint8_t buffer[4096];
+    while (bytes > 0) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(bytes, sizeof(buffer)));
+        if (std::fread(buffer, 1, n, file) != n) return false;
+        bytes -= n;
+    }
+    return true;
+}
+
+float decode_sample(const uint8_t* p, int format, int bits) {
+    if (format == FORMAT_FLOAT) {
+        if (bits == 64) {
+            uint64_t v = static_cast<uint64_t>(le32(p)) | (static_cast<uint64_t>(le32(p + 4)) << 32);
+            double d;
+            std::memcpy(&d, &v, sizeof(d));
+            return static_cast<float>(d);
+        }
+        uint32_t v = le32(p);
+        float f;
+        std::memcpy(&f, &v, sizeof(f));
+        return f;
+    }
+    switch (bits) {
+        case 8: return (static_cast<int>(p[0]) - 128) / 128.0f;  // 8-bit WAV is unsigned
+        case 16: return static_cast<int16_t>(le16(p)) / 32768.0f;
+        case 24: {
+            int32_t v = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
+            if (v & 0x800000) v -= 0x1000000;
+            return v / 8388608.0f;
+        }
+        default: return static_cast<int32_t>(le32(p)) / 2147483648.0f;
+    }
+}
+
+} // namespace
+
+WavReader::~WavReader() {
+    close();
+}
+
+bool WavReader::fail(const std::string& message) {
+    error_ = message;
+    close();
+    return false;
+}
+
+bool WavReader::open(const std::string& path, int target_rate) {
+    close();
+    error_.clear();
+
+    if (path == "-") return open(stdin, target_rate);
+
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) return fail("cannot open " + path);
+    owns_file_ = true;
+    streamed_ = false;
+    return read_header(target_rate);
+}
+
+bool WavReader::open(FILE* stream, int target_rate) {
+    close();
+    error_.clear();
+
+    file_ = stream;
+    if (!file_) return fail("no input stream");
+    owns_file_ = false;
+    streamed_ = true;
+    return read_header(target_rate);
+}
+
+bool WavReader::read_header(int target_rate) {
+    uint8_t header[12];
+    if (std::fread(header, 1, sizeof(header), file_) != sizeof(header) ||
+        std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+        return fail("not a RIFF/WAVE file");
+    }
+
+    bool have_format = false;
+    for (;;) {
+        uint8_t chunk[8];
+        if (std::fread(chunk, 1, sizeof(chunk), file_) != sizeof(chunk)) {
+            return fail("no data chunk");
+        }
+        const uint32_t size = le32(chunk + 4);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[40] = {};
+            const size_t n = std::min<size_t>(size, sizeof(fmt));
+            if (size < 16 || std::fread(fmt, 1, n, file_) != n ||
+                !skip(file_, size - n + (size & 1))) {
+                return fail("bad fmt chunk");
+            }
+            format_ = le16(fmt);
+            channels_ = le16(fmt + 2);
+            source_rate_ = static_cast<int>(le32(fmt + 4));
+            bits_ = le16(fmt + 14);
+            if (format_ == FORMAT_EXTENSIBLE && size >= 26) {
+                format_ = le16(fmt + 24);  // First two bytes of the subformat GUID
+            }
+            have_format = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            data_open_ended_ = streamed_ || size == OPEN_ENDED_SIZE;
+            data_left_ = size;
+            data_bytes_ = size;
+            break;
+        } else if (!skip(file_, static_cast<uint64_t>(size) + (size & 1))) {
+            return fail("truncated file");
+        }
+    }
+
+    if (!have_format) return fail("data chunk before fmt chunk");
+    const bool pcm_ok = format_ == FORMAT_PCM && (bits_ == 8 || bits_ == 16 || bits_ == 24 || bits_ == 32);
+    const bool float_ok = format_ == FORMAT_FLOAT && (bits_ == 32 || bits_ == 64);
+    if (!pcm_ok && !float_ok) {
+        return fail("unsupported sample format " + std::to_string(format_) + "/" + std::to_string(bits_) + " bit");
+    }
+    if (channels_ < 1 || source_rate_ < 1000 || target_rate < 1000) {
+        return fail("bad channel count or sample rate");
+    }
+
+    target_rate_ = target_rate;
+    step_ = static_cast<double>(source_rate_) / target_rate_;
+    pos_ = 0.0;
+    eof_ = false;
+    in_.clear();
+    in_.reserve(FRAMES_PER_BLOCK + 1);
+    raw_.resize(FRAMES_PER_BLOCK * channels_ * (bits_ / 8));
+    return true;
+}
+
+void WavReader::close() {
+    if (file_ && owns_file_) std::fclose(file_);
+    file_ = nullptr;
+    in_.clear();
+    eof_ = true;
+}
+
+size_t WavReader::total_samples() const {
+    if (data_open_ended_ || channels_ < 1 || bits_ < 8) return 0;
+    const uint64_t frames = data_bytes_ / (static_cast<uint64_t>(channels_) * (bits_ / 8));
+    return static_cast<size_t>(frames * target_rate_ / source_rate_);
+}
+
+bool WavReader::refill() {
+    // Keep the sample under pos_ (and anything after it) for interpolation
+    const size_t keep_from = std::min(static_cast<size_t>(pos_), in_.size());
+    in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(keep_from));
+    pos_ -= static_cast<double>(keep_from);
+
+    const size_t sample_bytes = static_cast<size_t>(bits_ / 8);
+    const size_t frame_bytes = sample_bytes * channels_;
+    size_t want = raw_.size();
+    if (!data_open_ended_) want = static_cast<size_t>(std::min<uint64_t>(want, data_left_));
+
+    const size_t got = want > 0 ? std::fread(raw_.data(), 1, want, file_) : 0;
+    data_left_ -= std::min<uint64_t>(data_left_, got);
+    const size_t frames = got / frame_bytes;
+    if (frames == 0) {
+        eof_ = true;
+        return false;
+    }
+
+    const float scale = 1.0f / static_cast<float>(channels_);
+    for (size_t f = 0; f < frames; ++f) {
+        const uint8_t* p = raw_.data() + f * frame_bytes;
+        float sum = 0.0f;
+        for (int c = 0; c < channels_; ++c) {
+            sum += decode_sample(p + c * sample_bytes, format_, bits_);
+        }
+        in_.push_back(sum * scale);
+    }
+    return true;
+}
+
+size_t WavReader::read(float* out, size_t max) {
+    if (!file_) return 0;
+
+    // Linear interpolation. There is no anti-aliasing filter: for 44.1/48 kHz
+    // speech down to 16 kHz what folds back is little and mostly noise.
+    size_t produced = 0;
+    while (produced < max) {
+        const size_t i = static_cast<size_t>(pos_);
+        if (i + 1 >= in_.size()) {
+            if (!eof_ && refill()) continue;
+            if (i >= in_.size()) break;
+            out[produced++] = in_[i];  // Last source sample: nothing to blend with
+            pos_ += step_;
+            continue;
+        }
+        const float frac = static_cast<float>(pos_ - static_cast<double>(i));
+        out[produced++] = in_[i] + (in_[i + 1] - in_[i]) * frac;
+        pos_ += step_;
+    }
+    return produced;
+}
+
+bool WavReader::read_all(const std::string& path, std::vector<float>& out,
+                         int target_rate, std::string* error) {
+    WavReader reader;
+    out.clear();
+    if (!reader.open(path, target_rate)) {
+        if (error) *error = reader.error();
+        return false;
+    }
+    out.reserve(reader.total_samples());
+
+    float block[4096];
+    size_t n;
+    while ((n = reader.read(block, 4096)) > 0) {
+        out.insert(out.end(), block, block + n);
+    }
+    return true;
+}
+
+} // namespace whispr
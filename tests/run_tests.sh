@@ -21,6 +21,7 @@ g++ -std=c++17 -O2 \
     -o test_audio_processor \
     test_audio_processor.cpp \
     "$PROJECT_DIR/src/audio_processor.cpp" \
+    "$PROJECT_DIR/src/streaming_vad.cpp" \
     -lm 2>&1 || {
         echo "Failed to build audio processor tests"
         exit 1
@@ -38,6 +39,145 @@ g++ -std=c++17 -O2 \
         exit 1
     }
 
+# Build ring buffer test
+echo "Building ring buffer tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_ring_buffer \
+    test_ring_buffer.cpp \
+    -lpthread 2>&1 || {
+        echo "Failed to build ring buffer tests"
+        exit 1
+    }
+
+# Build text typer test
+echo "Building text typer tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_text_typer \
+    test_text_typer.cpp \
+    "$PROJECT_DIR/src/text_typer.cpp" \
+    2>&1 || {
+        echo "Failed to build text typer tests"
+        exit 1
+    }
+
+# Build key tap test
+echo "Building key tap tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_key_tap \
+    test_key_tap.cpp 2>&1 || {
+        echo "Failed to build key tap tests"
+        exit 1
+    }
+
+# Build vocabulary test
+echo "Building vocabulary tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_vocabulary \
+    test_vocabulary.cpp \
+    "$PROJECT_DIR/src/vocabulary.cpp" \
+    2>&1 || {
+        echo "Failed to build vocabulary tests"
+        exit 1
+    }
+
+# Build trace test
+echo "Building trace tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_trace \
+    test_trace.cpp \
+    "$PROJECT_DIR/src/trace.cpp" \
+    -lpthread 2>&1 || {
+        echo "Failed to build trace tests"
+        exit 1
+    }
+
+# Build WAV reader test
+echo "Building WAV reader tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_wav_reader \
+    test_wav_reader.cpp \
+    "$PROJECT_DIR/src/wav_reader.cpp" \
+    2>&1 || {
+        echo "Failed to build WAV reader tests"
+        exit 1
+    }
+
+# Build speech chunker test
+echo "Building speech chunker tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_speech_chunker \
+    test_speech_chunker.cpp \
+    "$PROJECT_DIR/src/speech_chunker.cpp" \
+    2>&1 || {
+        echo "Failed to build speech chunker tests"
+        exit 1
+    }
+
+# Build model precision test
+echo "Building model precision tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_model_precision \
+    test_model_precision.cpp \
+    2>&1 || {
+        echo "Failed to build model precision tests"
+        exit 1
+    }
+
+# Build IPC server test
+echo "Building IPC server tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_ipc_server \
+    test_ipc_server.cpp \
+    "$PROJECT_DIR/src/ipc_server.cpp" \
+    -lpthread 2>&1 || {
+        echo "Failed to build IPC server tests"
+        exit 1
+    }
+
+# Build history store test
+echo "Building history store tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_history_store \
+    test_history_store.cpp \
+    "$PROJECT_DIR/src/history_store.cpp" \
+    -lpthread 2>&1 || {
+        echo "Failed to build history store tests"
+        exit 1
+    }
+
+# Build running confidence test
+echo "Building running confidence tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_running_confidence \
+    test_running_confidence.cpp 2>&1 || {
+        echo "Failed to build running confidence tests"
+        exit 1
+    }
+
+# Build continuous dictation test
+echo "Building continuous dictation tests..."
+g++ -std=c++17 -O2 \
+    -I"$PROJECT_DIR/include" \
+    -o test_continuous_dictation \
+    test_continuous_dictation.cpp \
+    "$PROJECT_DIR/src/continuous_dictation.cpp" \
+    "$PROJECT_DIR/src/speech_chunker.cpp" \
+    -lpthread 2>&1 || {
+        echo "Failed to build continuous dictation tests"
+        exit 1
+    }
+
 echo ""
 
 # Run tests
@@ -54,6 +194,90 @@ echo "Running text processor tests..."
     exit 1
 }
 
+echo ""
+echo "Running ring buffer tests..."
+./test_ring_buffer || {
+    echo "Ring buffer tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running text typer tests..."
+./test_text_typer || {
+    echo "Text typer tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running key tap tests..."
+./test_key_tap || {
+    echo "Key tap tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running vocabulary tests..."
+./test_vocabulary || {
+    echo "Vocabulary tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running trace tests..."
+./test_trace || {
+    echo "Trace tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running WAV reader tests..."
+./test_wav_reader || {
+    echo "WAV reader tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running speech chunker tests..."
+./test_speech_chunker || {
+    echo "Speech chunker tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running model precision tests..."
+./test_model_precision || {
+    echo "Model precision tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running IPC server tests..."
+./test_ipc_server || {
+    echo "IPC server tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running history store tests..."
+./test_history_store || {
+    echo "History store tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running running confidence tests..."
+./test_running_confidence || {
+    echo "Running confidence tests FAILED"
+    exit 1
+}
+
+echo ""
+echo "Running continuous dictation tests..."
+./test_continuous_dictation || {
+    echo "Continuous dictation tests FAILED"
+    exit 1
+}
+
 echo ""
 echo "==================================================="
 echo "     All Automated Tests Passed!"
@@ -62,4 +286,4 @@ echo ""
 echo "To run manual accuracy tests, use: ./manual_test.sh"
 
 # Clean up
-rm -f test_audio_processor test_text_processor
+rm -f test_audio_processor test_text_processor test_ring_buffer test_text_typer test_key_tap test_vocabulary test_trace test_wav_reader test_speech_chunker test_model_precision test_ipc_server test_history_store test_running_confidence test_continuous_dictation
@@ -1,10 +1,12 @@
 // Automated tests for AudioProcessor
-// Compile: g++ -std=c++17 -I../include -o test_audio test_audio_processor.cpp ../src/audio_processor.cpp -lm
+// Compile: g++ -std=c++17 -I../include -o test_audio test_audio_processor.cpp ../src/audio_processor.cpp ../src/streaming_vad.cpp -lm
 
 #include "audio_processor.hpp"
+#include "streaming_vad.hpp"
 #include <iostream>
 #include <cmath>
 #include <cassert>
+#include <algorithm>
 
 using namespace whispr;
 
@@ -176,6 +178,119 @@ void test_enhanced_vad() {
     std::cout << "  PASS: Enhanced VAD extracting speech" << std::endl;
 }
 
+// Test VAD ranges and in-place compaction match extract_speech
+void test_speech_ranges_compact() {
+    std::cout << "Testing speech ranges and in-place compaction..." << std::endl;
+
+    auto silence1 = generate_silence(4000);
+    auto speech1 = generate_sine(8000, 440.0f, 0.3f);
+    auto silence2 = generate_silence(8000);
+    auto speech2 = generate_sine(8000, 880.0f, 0.4f);
+
+    std::vector<float> audio;
+    audio.insert(audio.end(), silence1.begin(), silence1.end());
+    audio.insert(audio.end(), speech1.begin(), speech1.end());
+    audio.insert(audio.end(), silence2.begin(), silence2.end());
+    audio.insert(audio.end(), speech2.begin(), speech2.end());
+
+    auto ranges = AudioProcessor::detect_speech(audio, 0.015f, 100, 50, 16000);
+    assert(ranges.size() == 2 && "Should find two separate speech segments");
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        assert(ranges[i].start >= ranges[i - 1].end && "Ranges must be disjoint and sorted");
+    }
+
+    auto expected = AudioProcessor::extract_speech(audio, 0.015f, 100, 50, 16000);
+
+    const float* original_data = audio.data();
+    size_t n = AudioProcessor::compact(audio, ranges);
+    audio.resize(n);
+
+    assert(audio.data() == original_data && "Compaction must not reallocate");
+    assert(audio == expected && "Compaction should match extract_speech output");
+
+    std::cout << "  PASS: Speech compacted in place" << std::endl;
+}
+
+// Test online VAD during capture matches offline detection
+void test_streaming_vad() {
+    std::cout << "Testing online VAD during capture..." << std::endl;
+
+    auto silence1 = generate_silence(4000);
+    auto speech1 = generate_sine(8000, 440.0f, 0.3f);
+    auto silence2 = generate_silence(8000);
+    auto speech2 = generate_sine(8000, 880.0f, 0.4f);
+    auto silence3 = generate_silence(4000);
+
+    std::vector<float> audio;
+    audio.insert(audio.end(), silence1.begin(), silence1.end());
+    audio.insert(audio.end(), speech1.begin(), speech1.end());
+    audio.insert(audio.end(), silence2.begin(), silence2.end());
+    audio.insert(audio.end(), speech2.begin(), speech2.end());
+    audio.insert(audio.end(), silence3.begin(), silence3.end());
+
+    VadConfig config;
+    config.threshold = 0.015f;
+    StreamingVad vad(config, audio.size());
+
+    // Feed in odd-sized capture blocks; state must carry across block edges
+    bool saw_speech = false;
+    for (size_t i = 0; i < audio.size(); i += 333) {
+        size_t n = std::min<size_t>(333, audio.size() - i);
+        vad.feed(Span<const float>(audio.data() + i, n));
+        saw_speech = saw_speech || vad.in_speech();
+    }
+    assert(saw_speech && "Speech should be detected while feeding");
+    assert(!vad.in_speech() && vad.trailing_silence_ms() >= 200 && "Trailing silence should be tracked");
+
+    auto online = vad.segments();
+    auto offline = AudioProcessor::detect_speech(audio, 0.015f, 100, 50, 16000);
+    assert(online.size() == 2 && "Should find both segments online");
+    assert(online.size() == offline.size() && "Online and offline VAD should agree");
+    for (size_t i = 0; i < online.size(); ++i) {
+        assert(online[i].start == offline[i].start && online[i].end == offline[i].end);
+    }
+
+    // Quieter capture with a later 25x gain is judged at the final level
+    std::vector<float> quiet = audio;
+    for (auto& s : quiet) s *= 0.04f;  // Speech below threshold until the 25x gain undoes this
+    StreamingVad quiet_vad(config, quiet.size());
+    quiet_vad.feed(quiet);
+    assert(quiet_vad.segments().empty() && "Unboosted quiet audio has no speech");
+    StreamingVad boosted_vad(config, quiet.size());
+    boosted_vad.feed(quiet);
+    assert(boosted_vad.segments(25.0f).size() == 2 && "Gain should rescale the threshold");
+
+    std::cout << "  PASS: Online VAD matches offline detection" << std::endl;
+}
+
+// Test capture-time block processing matches one process() call
+void test_streamed_processing() {
+    std::cout << "Testing capture-time block processing..." << std::endl;
+
+    auto audio = generate_sine(16000, 300.0f, 0.05f);
+    auto noise = generate_noise(8000, 0.002f);
+    audio.insert(audio.end(), noise.begin(), noise.end());
+
+    // Reference: whole buffer in one call
+    std::vector<float> reference = audio;
+    AudioProcessor whole(16000.0f);
+    whole.process(reference);
+
+    // Streaming stage in capture-sized blocks, gain stages after release
+    std::vector<float> streamed = audio;
+    AudioProcessor blocks(16000.0f);
+    for (size_t i = 0; i < streamed.size(); i += 512) {
+        size_t n = std::min<size_t>(512, streamed.size() - i);
+        blocks.process_block(Span<float>(streamed.data() + i, n));
+    }
+    assert(blocks.stats().count == streamed.size() && "Stats should cover every block");
+    blocks.finish(streamed);
+
+    assert(streamed == reference && "Block processing should match a single process() call");
+
+    std::cout << "  PASS: Block processing matches full processing" << std::endl;
+}
+
 // Test full processing chain
 void test_full_chain() {
     std::cout << "Testing full processing chain..." << std::endl;
@@ -213,6 +328,9 @@ int main() {
     test_agc();
     test_silence_trimming();
     test_enhanced_vad();
+    test_speech_ranges_compact();
+    test_streaming_vad();
+    test_streamed_processing();
     test_full_chain();
 
     std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
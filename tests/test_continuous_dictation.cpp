@@ -0,0 +1,152 @@
+// Automated tests for ContinuousDictation (hands-free utterance endpointing)
+// Compile: g++ -std=c++17 -I../include -o test_continuous_dictation test_continuous_dictation.cpp ../src/continuous_dictation.cpp ../src/speech_chunker.cpp -lpthread
+
+#include "continuous_dictation.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace whispr;
+
+namespace {
+
+const int SAMPLE_RATE = 16000;
+
+std::vector<float> tone(int ms, float amplitude = 0.1f) {
+    std::vector<float> samples(static_cast<size_t>(ms) * SAMPLE_RATE / 1000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = amplitude * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / SAMPLE_RATE);
+    }
+    return samples;
+}
+
+std::vector<float> silence(int ms) {
+    return std::vector<float>(static_cast<size_t>(ms) * SAMPLE_RATE / 1000, 0.0f);
+}
+
+// Fed in audio-callback sized blocks, like the capture thread does
+void feed(ContinuousDictation& dictation, const std::vector<float>& samples) {
+    const size_t block = 512;
+    for (size_t i = 0; i < samples.size(); i += block) {
+        const size_t n = std::min(block, samples.size() - i);
+        dictation.feed(Span<const float>(samples.data() + i, n));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+struct Collector {
+    std::mutex mutex;
+    std::vector<AudioChunk> utterances;
+
+    size_t count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return utterances.size();
+    }
+
+    bool wait_for(size_t n) {
+        for (int i = 0; i < 200; ++i) {
+            if (count() >= n) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+};
+
+ContinuousConfig test_config() {
+    ContinuousConfig config;
+    config.sample_rate = SAMPLE_RATE;
+    config.end_silence_ms = 500;
+    config.min_speech_ms = 200;
+    return config;
+}
+
+} // namespace
+
+void test_endpoints() {
+    std::cout << "Testing utterances cut at pauses while listening..." << std::endl;
+
+    Collector collector;
+    ContinuousDictation dictation(test_config(), [&](AudioChunk&& utterance) {
+        std::lock_guard<std::mutex> lock(collector.mutex);
+        collector.utterances.push_back(std::move(utterance));
+    });
+    dictation.begin();
+
+    feed(dictation, silence(300));
+    feed(dictation, tone(1000));
+    feed(dictation, silence(600));
+    // Handed on once the pause is long enough, before anything else is said
+    assert(collector.wait_for(1));
+
+    feed(dictation, tone(400));
+    // A pause shorter than end_silence_ms doesn't end the utterance
+    feed(dictation, silence(200));
+    feed(dictation, tone(400));
+    feed(dictation, silence(600));
+    assert(collector.wait_for(2));
+
+    dictation.end();
+    assert(collector.count() == 2);
+    assert(dictation.utterances() == 2);
+
+    const AudioChunk& first = collector.utterances[0];
+    const AudioChunk& second = collector.utterances[1];
+    assert(first.has_speech && second.has_speech);
+    assert(first.start_sample == 0);
+    assert(second.start_sample == first.start_sample + static_cast<int64_t>(first.samples.size()));
+    // First: leading silence, the tone, half the pause
+    assert(first.samples.size() >= static_cast<size_t>(SAMPLE_RATE * 1.3));
+    assert(first.samples.size() <= static_cast<size_t>(SAMPLE_RATE * 1.6));
+    // Second holds both halves around the short pause
+    assert(second.samples.size() >= static_cast<size_t>(SAMPLE_RATE * 1.0));
+
+    for (AudioChunk& utterance : collector.utterances) dictation.recycle(std::move(utterance.samples));
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_noise_and_end() {
+    std::cout << "Testing noise bursts and speech cut off by end()..." << std::endl;
+
+    Collector collector;
+    ContinuousDictation dictation(test_config(), [&](AudioChunk&& utterance) {
+        std::lock_guard<std::mutex> lock(collector.mutex);
+        collector.utterances.push_back(std::move(utterance));
+    });
+    dictation.begin();
+
+    // A click is not an utterance
+    feed(dictation, tone(50, 0.5f));
+    feed(dictation, silence(800));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    assert(collector.count() == 0);
+
+    // Still talking when listening stops: handed on by end()
+    feed(dictation, tone(600));
+    dictation.end();
+    assert(collector.count() == 1);
+    assert(!dictation.is_active());
+
+    // Listening again starts over at sample 0
+    dictation.begin();
+    feed(dictation, tone(600));
+    dictation.end();
+    assert(collector.count() == 2);
+    assert(collector.utterances[1].start_sample == 0);
+    assert(dictation.dropped_samples() == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Continuous Dictation Test Suite ===" << std::endl << std::endl;
+
+    test_endpoints();
+    test_noise_and_end();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
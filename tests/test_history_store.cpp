@@ -0,0 +1,175 @@
+// Automated tests for the dictation history log
+// Compile: g++ -std=c++17 -I../include -o test_history_store test_history_store.cpp ../src/history_store.cpp
+
+#include "history_store.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace whispr;
+
+namespace {
+
+std::string log_path() {
+    return "/tmp/voxtype-history-test-" + std::to_string(getpid()) + ".log";
+}
+
+HistoryEntry make_entry(const std::string& text, const std::string& raw, float confidence) {
+    HistoryEntry entry;
+    entry.text = text;
+    entry.raw_text = raw;
+    entry.confidence = confidence;
+    entry.timings.audio_ms = 2000;
+    entry.timings.decode_ms = 150;
+    entry.timings.key_to_text_ms = 180;
+    return entry;
+}
+
+} // namespace
+
+void test_words_and_preview() {
+    std::cout << "Testing word splitting and previews..." << std::endl;
+
+    auto words = HistoryStore::words("Don't push to GitHub, OK?");
+    assert(words.size() == 5);
+    assert(words[0] == "dont" && words[3] == "github" && words[4] == "ok");
+
+    assert(HistoryStore::preview("short", 40) == "short");
+    assert(HistoryStore::preview("line one\nline two", 40) == "line one line two");
+    assert(HistoryStore::preview("abcdefghij", 8) == "abcde...");
+    // Cut on character boundaries
+    assert(HistoryStore::preview("caf\xc3\xa9 caf\xc3\xa9 caf\xc3\xa9", 7) == "caf\xc3\xa9...");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_append_and_reopen() {
+    std::cout << "Testing append and reopen..." << std::endl;
+    std::remove(log_path().c_str());
+
+    {
+        HistoryStore store;
+        assert(store.open(log_path()));
+        HistoryEntry first = make_entry("Meeting notes for Monday.", "meeting notes for monday", 0.9f);
+        assert(store.append(first) && first.id == 1 && first.time_ms > 0);
+        // Enough to outgrow the initial mapping
+        for (int i = 0; i < 2000; ++i) {
+            HistoryEntry filler = make_entry("Filler entry number " + std::to_string(i) + ".", "", 0.5f);
+            assert(store.append(filler));
+        }
+        HistoryEntry last = make_entry("Push the fix to GitHub.", "push the fix to github", 0.8f);
+        assert(store.append(last) && last.id == 2002);
+
+        // One writer at a time
+        HistoryStore second;
+        assert(!second.open(log_path()));
+        assert(!second.error().empty());
+    }
+
+    HistoryStore store;
+    assert(store.open(log_path(), true));
+    assert(store.size() == 2002);
+    HistoryEntry entry;
+    assert(store.get(1, entry));
+    assert(entry.text == "Meeting notes for Monday.");
+    assert(entry.raw_text == "meeting notes for monday");
+    assert(entry.confidence == 0.9f);
+    assert(entry.timings.audio_ms == 2000 && entry.timings.decode_ms == 150 && entry.timings.key_to_text_ms == 180);
+    assert(!store.get(0, entry) && !store.get(2003, entry));
+
+    HistoryEntry rejected = make_entry("x", "x", 1.0f);
+    assert(!store.append(rejected));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_search() {
+    std::cout << "Testing search..." << std::endl;
+
+    HistoryStore store;
+    assert(store.open(log_path(), true));
+
+    auto ids = store.search("github", 10);
+    assert(ids.size() == 1 && ids[0] == 2002);
+    // Prefix on the last word, case-insensitive, all words required
+    assert(store.search("MEET", 10).size() == 1);
+    assert(store.search("notes mon", 10).size() == 1);
+    assert(store.search("notes mon ", 10).empty());
+    assert(store.search("notes github", 10).empty());
+    // Newest first, limited
+    ids = store.search("filler", 3);
+    assert(ids.size() == 3 && ids[0] == 2001 && ids[1] == 2000 && ids[2] == 1999);
+    assert(store.search("  ", 10).empty());
+
+    HistorySnapshot snapshot = store.snapshot(5, 12);
+    assert(snapshot.items.size() == 5 && snapshot.matches == 2002);
+    assert(snapshot.items[0].id == 2002 && snapshot.items[0].preview == "Push the ...");
+
+    snapshot = store.snapshot(5, 40, "entry number 19");
+    assert(snapshot.matches == 111);  // 19, 190-199, 1900-1999
+    assert(snapshot.items.size() == 5 && snapshot.items[0].preview == "Filler entry number 1999.");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_torn_tail() {
+    std::cout << "Testing recovery from a torn append..." << std::endl;
+
+    // Corrupt inside the last record, as a crash mid-append would leave it
+    struct stat st;
+    assert(stat(log_path().c_str(), &st) == 0);
+    {
+        HistoryStore store;
+        assert(store.open(log_path(), true));
+        assert(store.size() == 2002);
+    }
+    {
+        HistoryStore writer;
+        assert(writer.open(log_path()));
+        HistoryEntry extra = make_entry("Temporary entry.", "", 0.7f);
+        assert(writer.append(extra) && extra.id == 2003);
+    }
+    int fd = ::open(log_path().c_str(), O_RDWR);
+    assert(fd >= 0);
+    // The last record ends with "Temporary entry." padded to 8 bytes;
+    // find it from the header's used count and flip a byte in it
+    uint64_t used = 0;
+    assert(pread(fd, &used, sizeof(used), 16) == sizeof(used));
+    char byte = 0;
+    assert(pread(fd, &byte, 1, static_cast<off_t>(used - 10)) == 1);
+    byte ^= 0x5a;
+    assert(pwrite(fd, &byte, 1, static_cast<off_t>(used - 10)) == 1);
+    ::close(fd);
+
+    HistoryStore store;
+    assert(store.open(log_path()));
+    assert(store.size() == 2002);
+    HistoryEntry next = make_entry("After recovery.", "", 0.6f);
+    assert(store.append(next) && next.id == 2003);
+    store.close();
+
+    assert(store.open(log_path(), true));
+    HistoryEntry entry;
+    assert(store.size() == 2003 && store.get(2003, entry) && entry.text == "After recovery.");
+    assert(store.search("temporary", 10).empty());
+    store.close();
+
+    std::remove(log_path().c_str());
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== History Store Test Suite ===" << std::endl << std::endl;
+
+    test_words_and_preview();
+    test_append_and_reopen();
+    test_search();
+    test_torn_tail();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Automated tests for the daemon socket API
+// Compile: g++ -std=c++17 -I../include -o test_ipc_server test_ipc_server.cpp ../src/ipc_server.cpp -lpthread
+
+#include "ipc_server.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace whispr;
+
+namespace {
+
+std::string socket_path() {
+    return "/tmp/voxtype-test-" + std::to_string(getpid()) + ".sock";
+}
+
+// Replies like the daemon: from another thread, one partial, then the result
+IpcServer::Handlers echo_handlers() {
+    IpcServer::Handlers handlers;
+    handlers.transcribe = [](std::shared_ptr<SharedAudio> audio, bool partials, IpcServer::Reply reply) {
+        std::thread([audio, partials, reply]() {
+            Span<float> samples = audio->samples();
+            float sum = 0.0f;
+            for (float s : samples) sum += s;
+            // Mapped copy-on-write, so writing is allowed
+            samples[0] = 0.0f;
+
+            if (partials) reply(IpcServer::partial_json("so far"), false);
+            TranscriptionResult result;
+            result.success = true;
+            result.text = std::to_string(samples.size()) + " samples";
+            result.raw_text = std::to_string(static_cast<int>(sum));
+            result.confidence = 0.5f;
+            result.duration_ms = 1;
+            result.segments.push_back({0, 100, "x"});
+            reply(IpcServer::result_json(result), true);
+        }).detach();
+    };
+    handlers.status = []() { return std::string("\"state\":\"idle\""); };
+    return handlers;
+}
+
+int raw_connect(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    assert(fd >= 0);
+    assert(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    return fd;
+}
+
+std::string raw_read_line(int fd) {
+    std::string line;
+    char ch;
+    while (::recv(fd, &ch, 1, 0) == 1 && ch != '\n') line += ch;
+    return line;
+}
+
+// Request line with `fd` attached as SCM_RIGHTS
+bool send_with_fd(int socket, const std::string& line, int fd) {
+    iovec iov{const_cast<char*>(line.data()), line.size()};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* c = CMSG_FIRSTHDR(&message);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(c), &fd, sizeof(int));
+    return ::sendmsg(socket, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(line.size());
+}
+
+} // namespace
+
+void test_json() {
+    std::cout << "Testing reply encoding..." << std::endl;
+
+    assert(IpcServer::quote("a \"b\"\\\n") == "\"a \\\"b\\\"\\\\\\n\"");
+    assert(IpcServer::quote(std::string("\x01", 1)) == "\"\\u0001\"");
+    assert(IpcServer::partial_json("hi") == "{\"type\":\"partial\",\"text\":\"hi\"}");
+    assert(IpcServer::error_json("bad") == "{\"type\":\"error\",\"error\":\"bad\"}");
+
+    TranscriptionResult failed;
+    failed.success = false;
+    failed.error = "no model";
+    assert(IpcServer::result_json(failed) == IpcServer::error_json("no model"));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_status_and_shared_memory() {
+    std::cout << "Testing status and shared-memory transcription..." << std::endl;
+
+    IpcServer server(echo_handlers());
+    assert(server.start(socket_path()));
+
+    IpcClient client;
+    assert(client.connect(socket_path()));
+
+    std::string line;
+    assert(client.status(line));
+    assert(line == "{\"type\":\"status\",\"state\":\"idle\"}");
+
+    std::vector<float> samples(16000, 0.25f);
+    std::vector<std::string> lines;
+    assert(client.transcribe(samples, true, [&](const std::string& l) { lines.push_back(l); }));
+    assert(lines.size() == 2);
+    assert(lines[0] == IpcServer::partial_json("so far"));
+    assert(lines[1].find("\"text\":\"16000 samples\"") != std::string::npos);
+    assert(lines[1].find("\"raw_text\":\"4000\"") != std::string::npos);
+    assert(lines[1].find("\"segments\":[{\"start_ms\":0,\"end_ms\":100,\"text\":\"x\"}]") != std::string::npos);
+    assert(samples[0] == 0.25f);
+
+    // Same connection, next request, no partials
+    lines.clear();
+    assert(client.transcribe(Span<const float>(samples.data(), 800), false,
+                             [&](const std::string& l) { lines.push_back(l); }));
+    assert(lines.size() == 1);
+    assert(lines[0].find("\"text\":\"800 samples\"") != std::string::npos);
+    assert(server.requests() == 2);
+
+    server.stop();
+    assert(access(socket_path().c_str(), F_OK) != 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_inline_and_errors() {
+    std::cout << "Testing inline audio and bad requests..." << std::endl;
+
+    IpcServer server(echo_handlers());
+    assert(server.start(socket_path()));
+    int fd = raw_connect(socket_path());
+
+    const std::string bad = "HELLO\n";
+    assert(::send(fd, bad.data(), bad.size(), 0) == static_cast<ssize_t>(bad.size()));
+    assert(raw_read_line(fd).find("\"type\":\"error\"") != std::string::npos);
+
+    // Descriptor missing
+    const std::string no_fd = "TRANSCRIBE 10\n";
+    assert(::send(fd, no_fd.data(), no_fd.size(), 0) == static_cast<ssize_t>(no_fd.size()));
+    assert(raw_read_line(fd).find("\"type\":\"error\"") != std::string::npos);
+
+    const std::string zero = "TRANSCRIBE 0 inline\n";
+    assert(::send(fd, zero.data(), zero.size(), 0) == static_cast<ssize_t>(zero.size()));
+    assert(raw_read_line(fd).find("\"type\":\"error\"") != std::string::npos);
+
+    std::vector<float> samples(100, 1.0f);
+    const std::string request = "TRANSCRIBE 100 inline\n";
+    assert(::send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+    const size_t bytes = samples.size() * sizeof(float);
+    assert(::send(fd, samples.data(), bytes, 0) == static_cast<ssize_t>(bytes));
+    std::string line = raw_read_line(fd);
+    assert(line.find("\"type\":\"result\"") == 1);
+    assert(line.find("\"raw_text\":\"100\"") != std::string::npos);
+
+    ::close(fd);
+    server.stop();
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_unsealed_memory() {
+    std::cout << "Testing unsealed shared memory is refused..." << std::endl;
+
+#ifdef F_ADD_SEALS
+    IpcServer server(echo_handlers());
+    assert(server.start(socket_path()));
+    int fd = raw_connect(socket_path());
+
+    // A client could shrink this under the daemon's mapping
+    int memory = memfd_create("voxtype-test", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    assert(memory >= 0 && ftruncate(memory, 400) == 0);
+    assert(send_with_fd(fd, "TRANSCRIBE 100\n", memory));
+    std::string line = raw_read_line(fd);
+    assert(line.find("\"type\":\"error\"") == 1);
+    assert(line.find("sealed") != std::string::npos);
+
+    // Sealed, the same memory is accepted
+    assert(fcntl(memory, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) == 0);
+    assert(send_with_fd(fd, "TRANSCRIBE 100\n", memory));
+    assert(raw_read_line(fd).find("\"text\":\"100 samples\"") != std::string::npos);
+
+    // Descriptors nobody claims are capped: the client is dropped
+    for (int i = 0; i < 16 && send_with_fd(fd, " ", memory); ++i) {}
+    ::close(memory);
+    char ch;
+    assert(::recv(fd, &ch, 1, 0) == 0);
+
+    ::close(fd);
+    server.stop();
+#endif
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_socket_ownership() {
+    std::cout << "Testing stale and live sockets..." << std::endl;
+
+    // A stale socket file (nobody listening) is replaced
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socket_path().c_str(), sizeof(address.sun_path) - 1);
+        assert(::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        ::close(fd);
+    }
+    IpcServer first(echo_handlers());
+    assert(first.start(socket_path()));
+
+    // A live one is not taken over
+    IpcServer second(echo_handlers());
+    assert(!second.start(socket_path()));
+
+    IpcClient client;
+    std::string line;
+    assert(client.connect(socket_path()) && client.status(line));
+
+    first.stop();
+    IpcClient gone;
+    assert(!gone.connect(socket_path()));
+    assert(!gone.error().empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== IPC Server Test Suite ===" << std::endl << std::endl;
+
+    test_json();
+    test_status_and_shared_memory();
+    test_inline_and_errors();
+    test_unsealed_memory();
+    test_socket_ownership();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
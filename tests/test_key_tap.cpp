@@ -0,0 +1,86 @@
+// Automated tests for tap_events (typing while the hotkey modifier is held)
+// Compile: g++ -std=c++17 -I../include -o test_key_tap test_key_tap.cpp
+
+#include "key_tap.hpp"
+#include <iostream>
+#include <cassert>
+#include <set>
+#include <vector>
+
+using namespace whispr;
+
+namespace {
+
+const unsigned KEY_A = 38;
+const unsigned SHIFT = 50;
+const unsigned RIGHT_ALT = 108;
+const unsigned CONTROL = 37;
+
+// Replays events on a key state that starts with `held` down and checks that
+// the tapped key only ever goes down with no held modifier still pressed
+void check_clean_tap(const std::vector<KeyEvent>& events, unsigned code, bool shift,
+                     const std::vector<unsigned>& held) {
+    std::set<unsigned> down(held.begin(), held.end());
+    bool tapped = false;
+    for (const KeyEvent& event : events) {
+        if (event.code == code && event.press) {
+            tapped = true;
+            for (unsigned key : held) {
+                if (key != SHIFT) assert(down.count(key) == 0);
+            }
+            assert(down.count(SHIFT) == (shift ? 1u : 0u));
+        }
+        if (event.press) {
+            down.insert(event.code);
+        } else {
+            down.erase(event.code);
+        }
+    }
+    assert(tapped);
+    // Held keys are down again, nothing else is
+    assert(down == std::set<unsigned>(held.begin(), held.end()));
+}
+
+} // namespace
+
+void test_plain_tap() {
+    std::cout << "Testing taps with nothing held..." << std::endl;
+
+    std::vector<KeyEvent> events = tap_events(KEY_A, false, SHIFT, {});
+    assert(events.size() == 2);
+    assert((events[0] == KeyEvent{KEY_A, true}));
+    assert((events[1] == KeyEvent{KEY_A, false}));
+
+    events = tap_events(KEY_A, true, SHIFT, {});
+    assert(events.size() == 4);
+    check_clean_tap(events, KEY_A, true, {});
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_held_hotkey() {
+    std::cout << "Testing taps while the hotkey modifier is held..." << std::endl;
+
+    // Right Alt (the default hotkey) must not turn letters into shortcuts or AltGr symbols
+    check_clean_tap(tap_events(KEY_A, false, SHIFT, {RIGHT_ALT}), KEY_A, false, {RIGHT_ALT});
+    check_clean_tap(tap_events(KEY_A, true, SHIFT, {RIGHT_ALT}), KEY_A, true, {RIGHT_ALT});
+    check_clean_tap(tap_events(KEY_A, false, SHIFT, {RIGHT_ALT, CONTROL}), KEY_A, false, {RIGHT_ALT, CONTROL});
+
+    // Held Shift: released for a lowercase letter, kept for an uppercase one
+    check_clean_tap(tap_events(KEY_A, false, SHIFT, {SHIFT}), KEY_A, false, {SHIFT});
+    std::vector<KeyEvent> events = tap_events(KEY_A, true, SHIFT, {SHIFT});
+    assert(events.size() == 2);
+    check_clean_tap(events, KEY_A, true, {SHIFT});
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Key Tap Test Suite ===" << std::endl << std::endl;
+
+    test_plain_tap();
+    test_held_hotkey();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
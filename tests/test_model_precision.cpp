@@ -0,0 +1,71 @@
+// Automated tests for model precision selection and naming
+// Compile: g++ -std=c++17 -I../include -o test_model_precision test_model_precision.cpp
+
+#include "config.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace whispr;
+
+void test_filenames() {
+    std::cout << "Testing quantized model filenames..." << std::endl;
+
+    assert(get_model_filename(ModelQuality::Balanced, ModelPrecision::F16) == "ggml-base.en.bin");
+    assert(get_model_filename(ModelQuality::Balanced, ModelPrecision::Auto) == "ggml-base.en.bin");
+    assert(get_model_filename(ModelQuality::Fast, ModelPrecision::Q8) == "ggml-tiny.en-q8_0.bin");
+    assert(get_model_filename(ModelQuality::Accurate, ModelPrecision::Q5) == "ggml-small.en-q5_1.bin");
+    // Medium is published as q5_0
+    assert(get_model_filename(ModelQuality::Best, ModelPrecision::Q5) == "ggml-medium.en-q5_0.bin");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_parse() {
+    std::cout << "Testing precision names..." << std::endl;
+
+    ModelPrecision precision = ModelPrecision::F16;
+    assert(parse_model_precision("q8", precision) && precision == ModelPrecision::Q8);
+    assert(parse_model_precision("q5_1", precision) && precision == ModelPrecision::Q5);
+    assert(parse_model_precision("auto", precision) && precision == ModelPrecision::Auto);
+    assert(!parse_model_precision("q4", precision) && precision == ModelPrecision::Auto);
+    assert(parse_model_precision(precision_name(ModelPrecision::Q8), precision) && precision == ModelPrecision::Q8);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_selection() {
+    std::cout << "Testing automatic precision selection..." << std::endl;
+
+    // GPU: full precision
+    assert(select_model_precision(ModelQuality::Best, true, true, 64000) == ModelPrecision::F16);
+    // CPU with SIMD: q8 for small models, q5 for medium
+    assert(select_model_precision(ModelQuality::Balanced, false, true, 16000) == ModelPrecision::Q8);
+    assert(select_model_precision(ModelQuality::Best, false, true, 16000) == ModelPrecision::Q5);
+    // No SIMD and plenty of memory: f16
+    assert(select_model_precision(ModelQuality::Accurate, false, false, 16000) == ModelPrecision::F16);
+    // Short on memory: q5 regardless of the CPU
+    assert(select_model_precision(ModelQuality::Best, false, false, 2000) == ModelPrecision::Q5);
+    assert(select_model_precision(ModelQuality::Accurate, false, true, 900) == ModelPrecision::Q5);
+    // Unknown memory doesn't count as short
+    assert(select_model_precision(ModelQuality::Fast, false, true, 0) == ModelPrecision::Q8);
+
+    // Quantized files are smaller
+    for (int q = 0; q < 4; ++q) {
+        ModelQuality quality = static_cast<ModelQuality>(q);
+        assert(model_size_mb(quality, ModelPrecision::Q5) < model_size_mb(quality, ModelPrecision::Q8));
+        assert(model_size_mb(quality, ModelPrecision::Q8) < model_size_mb(quality, ModelPrecision::F16));
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Model Precision Test Suite ===" << std::endl << std::endl;
+
+    test_filenames();
+    test_parse();
+    test_selection();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Automated tests for RunningConfidence
+// Compile: g++ -std=c++17 -I../include -o test_running_confidence test_running_confidence.cpp
+
+#include "running_confidence.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+using namespace whispr;
+
+namespace {
+
+bool near(float a, float b) {
+    return std::fabs(a - b) < 1e-5f;
+}
+
+} // namespace
+
+void test_committed_mean() {
+    std::cout << "Testing committed segments..." << std::endl;
+
+    RunningConfidence confidence;
+    assert(confidence.tokens() == 0);
+    assert(confidence.value() == 0.0f);
+    assert(confidence.committed() == 0.0f);
+
+    confidence.commit(10, 0.9f);
+    confidence.commit(11, 0.5f);
+    // Special tokens don't count
+    confidence.commit(-1, 0.8f);
+    confidence.commit(12, 0.0f);
+    confidence.end_segments();
+
+    assert(confidence.tokens() == 2);
+    assert(near(confidence.committed(), 0.7f));
+    assert(near(confidence.value(), 0.7f));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_pending_sequence() {
+    std::cout << "Testing the sequence being decoded..." << std::endl;
+
+    RunningConfidence confidence;
+    confidence.commit(1, 1.0f);
+    confidence.end_segments();
+
+    // Reported whole on every step, so each update replaces the last
+    confidence.set_pending(0.4f, 1);
+    confidence.set_pending(0.8f, 2);
+    assert(confidence.tokens() == 3);
+    assert(near(confidence.value(), 0.6f));
+    // Not part of the result until its segment is finished
+    assert(near(confidence.committed(), 1.0f));
+
+    // A temperature fallback restarts the sequence
+    confidence.set_pending(0.9f, 1);
+    assert(confidence.tokens() == 2);
+    assert(near(confidence.value(), 0.95f));
+
+    // Its finished segment is committed and the sequence cleared
+    confidence.commit(2, 0.9f);
+    confidence.end_segments();
+    assert(confidence.tokens() == 2);
+    assert(near(confidence.value(), 0.95f));
+    assert(near(confidence.committed(), 0.95f));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_below() {
+    std::cout << "Testing early-exit decision..." << std::endl;
+
+    RunningConfidence confidence;
+    confidence.set_pending(0.3f * 4, 4);
+    // Too few tokens to tell
+    assert(!confidence.below(0.6f, 16));
+    assert(confidence.below(0.6f, 4));
+
+    confidence.set_pending(0.3f * 20, 20);
+    assert(confidence.below(0.6f, 16));
+    assert(!confidence.below(0.25f, 16));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Running Confidence Test Suite ===" << std::endl << std::endl;
+
+    test_committed_mean();
+    test_pending_sequence();
+    test_below();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
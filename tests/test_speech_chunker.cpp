@@ -0,0 +1,152 @@
+// Automated tests for SpeechChunker
+// Compile: g++ -std=c++17 -I../include -o test_speech_chunker test_speech_chunker.cpp ../src/speech_chunker.cpp
+
+#include "speech_chunker.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+using namespace whispr;
+
+static const int RATE = 16000;
+
+// Alternating speech-like tone and silence, `pattern` in ms: tone, gap, tone, ...
+static std::vector<float> make_stream(const std::vector<int>& pattern) {
+    std::vector<float> out;
+    bool tone = true;
+    for (int ms : pattern) {
+        const size_t n = static_cast<size_t>(ms) * RATE / 1000;
+        for (size_t i = 0; i < n; ++i) {
+            out.push_back(tone ? 0.3f * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(out.size()) / RATE) : 0.0f);
+        }
+        tone = !tone;
+    }
+    return out;
+}
+
+static std::vector<AudioChunk> run(const ChunkerConfig& config, const std::vector<float>& stream, size_t block) {
+    std::vector<AudioChunk> chunks;
+    SpeechChunker chunker(config, [&](AudioChunk&& chunk) { chunks.push_back(std::move(chunk)); });
+    for (size_t i = 0; i < stream.size(); i += block) {
+        const size_t n = std::min(block, stream.size() - i);
+        chunker.feed(Span<const float>(stream.data() + i, n));
+    }
+    chunker.finish();
+    return chunks;
+}
+
+static void check_contiguous(const std::vector<AudioChunk>& chunks, const std::vector<float>& stream) {
+    int64_t next = 0;
+    for (const AudioChunk& chunk : chunks) {
+        assert(chunk.start_sample == next);
+        for (size_t i = 0; i < chunk.samples.size(); ++i) {
+            assert(chunk.samples[i] == stream[static_cast<size_t>(next) + i]);
+        }
+        next += static_cast<int64_t>(chunk.samples.size());
+    }
+    assert(next == static_cast<int64_t>(stream.size()));
+}
+
+void test_short_stream() {
+    std::cout << "Testing stream shorter than one chunk..." << std::endl;
+
+    std::vector<float> stream = make_stream({3000, 500, 2000});
+    std::vector<AudioChunk> chunks = run(ChunkerConfig{}, stream, 512);
+    assert(chunks.size() == 1);
+    assert(chunks[0].has_speech);
+    check_contiguous(chunks, stream);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_cuts_in_pause() {
+    std::cout << "Testing cut in the first pause after the target..." << std::endl;
+
+    ChunkerConfig config;
+    config.target_ms = 5000;
+    config.max_ms = 9000;
+    // The 200ms gap is too short; the 600ms one after 5s is where it cuts
+    std::vector<float> stream = make_stream({4000, 200, 1500, 600, 3000});
+    std::vector<AudioChunk> chunks = run(config, stream, 777);
+    assert(chunks.size() == 2);
+    check_contiguous(chunks, stream);
+
+    // In [5700ms, 6300ms], close to the middle once the 300ms pause is seen
+    const double cut_ms = chunks[1].start_sample * 1000.0 / RATE;
+    assert(cut_ms > 5700.0 && cut_ms < 6300.0);
+    assert(chunks[0].has_speech && chunks[1].has_speech);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_forced_cut() {
+    std::cout << "Testing forced cut at the quietest point..." << std::endl;
+
+    ChunkerConfig config;
+    config.target_ms = 5000;
+    config.max_ms = 8000;
+    // No pause long enough anywhere; the gaps are 100ms
+    std::vector<float> stream = make_stream({3000, 100, 3500, 100, 4000});
+    std::vector<AudioChunk> chunks = run(config, stream, 4096);
+    assert(chunks.size() >= 2);
+    check_contiguous(chunks, stream);
+    for (const AudioChunk& chunk : chunks) {
+        assert(chunk.samples.size() <= static_cast<size_t>(config.max_ms) * RATE / 1000);
+    }
+
+    // The one gap in the second half of the first 8s is at 6600-6700ms
+    const double cut_ms = chunks[1].start_sample * 1000.0 / RATE;
+    assert(cut_ms >= 6600.0 && cut_ms <= 6710.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_silence_and_recycle() {
+    std::cout << "Testing silent chunks and buffer reuse..." << std::endl;
+
+    ChunkerConfig config;
+    config.target_ms = 2000;
+    config.max_ms = 3000;
+    std::vector<float> stream = make_stream({0, 10000});  // All silence
+
+    std::vector<int64_t> starts;
+    const float* first_buffer = nullptr;
+    bool reused = false;
+    SpeechChunker* self = nullptr;
+    SpeechChunker chunker(config, [&](AudioChunk&& chunk) {
+        assert(!chunk.has_speech);
+        starts.push_back(chunk.start_sample);
+        if (!first_buffer) {
+            first_buffer = chunk.samples.data();
+        } else if (chunk.samples.data() == first_buffer) {
+            reused = true;
+        }
+        self->recycle(std::move(chunk.samples));
+    });
+    self = &chunker;
+    chunker.feed(Span<const float>(stream.data(), stream.size()));
+    chunker.finish();
+
+    assert(starts.size() >= 4);
+    assert(reused);
+
+    // finish() starts over at sample 0
+    chunker.feed(Span<const float>(stream.data(), 1600));
+    chunker.finish();
+    assert(starts.back() == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== SpeechChunker Test Suite ===" << std::endl << std::endl;
+
+    test_short_stream();
+    test_cuts_in_pause();
+    test_forced_cut();
+    test_silence_and_recycle();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
@@ -145,6 +145,65 @@ void test_edge_cases() {
     std::cout << "  PASS" << std::endl;
 }
 
+void test_stage_pipeline() {
+    std::cout << "Testing stage pipeline..." << std::endl;
+
+    const std::string input = "um so  i was like ,thinking the the idea , you know";
+
+    // Every config combination must match running the individual stages in order
+    for (unsigned mask = 0; mask < 32; ++mask) {
+        TextProcessorConfig config;
+        config.remove_fillers = (mask & 1) != 0;
+        config.fix_spacing = (mask & 2) != 0;
+        config.auto_capitalize = (mask & 4) != 0;
+        config.trim_whitespace = (mask & 8) != 0;
+        config.ensure_punctuation = (mask & 16) != 0;
+        TextProcessor proc(config);
+
+        std::string expected = input;
+        if (config.remove_fillers) expected = proc.remove_filler_words(expected);
+        if (config.fix_spacing) expected = proc.fix_spacing(expected);
+        if (config.auto_capitalize) expected = proc.fix_capitalization(expected);
+        if (config.trim_whitespace) expected = proc.trim(expected);
+        if (config.ensure_punctuation) expected = proc.ensure_punctuation(expected);
+
+        assert(proc.process(input) == expected && "Pipeline should match chained stages");
+    }
+
+    // Reused output buffer is overwritten, not appended to
+    TextProcessor proc;
+    std::string out = "stale contents";
+    proc.process(std::string_view("hello there"), out);
+    assert(out == "Hello there.");
+    proc.process(std::string_view("um ok"), out);
+    assert(out == "Ok.");
+    proc.process(std::string_view(""), out);
+    assert(out.empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_drop_overlap() {
+    std::cout << "Testing overlap removal between chunks..." << std::endl;
+
+    // Words repeated from the end of the previous chunk are dropped
+    assert(TextProcessor::drop_overlap(" We went to the store", " to the store and bought milk") ==
+           " and bought milk");
+    // Case and punctuation don't matter
+    assert(TextProcessor::drop_overlap("Then we left, quickly.", " Quickly. After that") == " After that");
+    // Nothing repeated
+    assert(TextProcessor::drop_overlap("hello there", " general kenobi") == " general kenobi");
+    // A short single word may be a real repetition
+    assert(TextProcessor::drop_overlap("I said that", " that is fine") == " that is fine");
+    // Everything already committed
+    assert(TextProcessor::drop_overlap("one two three", " two three").empty());
+    // Only the last max_words words are considered
+    assert(TextProcessor::drop_overlap("a b c d", " a b c d e", 2) == " a b c d e");
+    assert(TextProcessor::drop_overlap("", " fresh start") == " fresh start");
+
+    std::cout << "  PASS" << std::endl;
+}
+
 int main() {
     std::cout << "\n=== Text Processor Test Suite ===" << std::endl << std::endl;
 
@@ -156,6 +215,8 @@ int main() {
     test_whitespace_cleanup();
     test_complex_sentences();
     test_edge_cases();
+    test_stage_pipeline();
+    test_drop_overlap();
 
     std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
     return 0;
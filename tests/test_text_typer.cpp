@@ -0,0 +1,97 @@
+// Automated tests for TextTyper
+// Compile: g++ -std=c++17 -I../include -o test_typer test_text_typer.cpp ../src/text_typer.cpp
+
+#include "text_typer.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+
+using namespace whispr;
+
+// Stand-in for the focused window: applies typed text and backspaces
+struct FakeScreen {
+    std::string text;
+    size_t erased = 0;
+    size_t typed = 0;
+    bool fail_typing = false;
+
+    TextTyper make_typer() {
+        return TextTyper(
+            [this](const std::string& s) {
+                if (fail_typing) return false;
+                text += s;
+                typed += TextTyper::count_chars(s);
+                return true;
+            },
+            [this](size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    // Remove one UTF-8 code point
+                    while (!text.empty() && (static_cast<unsigned char>(text.back()) & 0xC0) == 0x80) text.pop_back();
+                    if (!text.empty()) text.pop_back();
+                }
+                erased += count;
+                return true;
+            });
+    }
+};
+
+void test_incremental_growth() {
+    std::cout << "Testing incremental typing..." << std::endl;
+
+    FakeScreen screen;
+    TextTyper typer = screen.make_typer();
+
+    assert(typer.update("Hello there"));
+    assert(typer.update("Hello there how are"));
+    assert(typer.update("Hello there, how are you?"));
+
+    assert(screen.text == "Hello there, how are you?");
+    // Growing text only types the new part; the comma forced one correction
+    assert(screen.erased == 8);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_correction_and_utf8() {
+    std::cout << "Testing corrections across multi-byte characters..." << std::endl;
+
+    FakeScreen screen;
+    TextTyper typer = screen.make_typer();
+
+    assert(typer.update("caf\xC3\xA9 au lait"));
+    // Differs inside the second byte of a character: whole character is retyped
+    assert(typer.update("caf\xC3\xA8"));
+    assert(screen.text == "caf\xC3\xA8");
+    assert(screen.erased == 9);
+    assert(TextTyper::count_chars("caf\xC3\xA9") == 4);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_failed_typing() {
+    std::cout << "Testing failed typing..." << std::endl;
+
+    FakeScreen screen;
+    TextTyper typer = screen.make_typer();
+
+    assert(typer.update("One two"));
+    screen.fail_typing = true;
+    assert(!typer.update("One three"));
+
+    // Typed text is the common prefix, so the caller can paste the rest
+    assert(typer.typed() == "One t");
+    assert(screen.text == typer.typed());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Text Typer Test Suite ===" << std::endl << std::endl;
+
+    test_incremental_growth();
+    test_correction_and_utf8();
+    test_failed_typing();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Automated tests for Trace
+// Compile: g++ -std=c++17 -I../include -o test_trace test_trace.cpp ../src/trace.cpp -lpthread
+
+#include "trace.hpp"
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace whispr;
+
+static Trace::Clock::time_point at_us(int64_t us) {
+    return Trace::Clock::time_point(std::chrono::microseconds(us));
+}
+
+void test_disabled_by_default() {
+    std::cout << "Testing disabled tracing..." << std::endl;
+
+    Trace::record(TraceStage::Decode, at_us(0), at_us(1000));
+    assert(Trace::summary(TraceStage::Decode).count == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_percentiles() {
+    std::cout << "Testing percentiles..." << std::endl;
+
+    Trace::enable();
+    // 1..100 ms: p50 = 50, p95 = 95, p99 = 99
+    for (int ms = 1; ms <= 100; ++ms) {
+        Trace::record(TraceStage::Encode, at_us(0), at_us(ms * 1000));
+    }
+
+    Trace::Summary s = Trace::summary(TraceStage::Encode);
+    assert(s.count == 100);
+    assert(std::fabs(s.p50_ms - 50.0) / 50.0 < 0.07);
+    assert(std::fabs(s.p95_ms - 95.0) / 95.0 < 0.07);
+    assert(std::fabs(s.p99_ms - 99.0) / 99.0 < 0.07);
+    assert(std::fabs(s.max_ms - 100.0) < 1e-9);
+    assert(s.p99_ms <= s.max_ms);
+
+    // Sub-8us durations are exact
+    Trace::record(TraceStage::Vad, at_us(10), at_us(13));
+    assert(std::fabs(Trace::summary(TraceStage::Vad).p50_ms - 0.003) < 1e-9);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_threads() {
+    std::cout << "Testing concurrent recording..." << std::endl;
+
+    const int per_thread = 10000;  // More than one ring holds, so old events are overwritten
+    std::vector<std::thread> threads;
+    std::atomic<int> running{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &running]() {
+            Trace::name_thread(t == 0 ? "first" : "other");
+            Trace::set_job(static_cast<uint64_t>(t + 1));
+            for (int i = 0; i < per_thread; ++i) {
+                Trace::record(TraceStage::Paste, at_us(i), at_us(i + 5));
+            }
+            // All alive at once, so none takes over another's ring
+            running.fetch_add(1);
+            while (running.load() < 4) std::this_thread::yield();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    assert(Trace::summary(TraceStage::Paste).count == 4u * per_thread);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_chrome_trace() {
+    std::cout << "Testing Chrome trace output..." << std::endl;
+
+    const std::string path = "test_trace.json";
+    assert(Trace::write_chrome_trace(path));
+
+    std::ifstream file(path);
+    std::stringstream json;
+    json << file.rdbuf();
+    std::string text = json.str();
+    std::remove(path.c_str());
+
+    assert(text.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    assert(text.find("\"name\":\"encode\"") != std::string::npos);
+    assert(text.find("\"name\":\"paste\"") != std::string::npos);
+    assert(text.find("\"args\":{\"name\":\"first\"}") != std::string::npos);
+    assert(text.find("\"args\":{\"job\":4}") != std::string::npos);
+    assert(text.substr(text.size() - 4) == "\n]}\n");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_buffer_reuse() {
+    std::cout << "Testing rings of exited threads are reused..." << std::endl;
+
+    // Like the accurate pass: a new thread per decode, one after another
+    const size_t before = Trace::thread_buffers();
+    for (int t = 0; t < 20; ++t) {
+        std::thread([]() { Trace::record(TraceStage::Decode, at_us(0), at_us(10)); }).join();
+    }
+    assert(Trace::thread_buffers() == before);
+    assert(Trace::summary(TraceStage::Decode).count == 20);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Trace Test Suite ===" << std::endl << std::endl;
+
+    test_disabled_by_default();
+    test_percentiles();
+    test_threads();
+    test_chrome_trace();
+    test_buffer_reuse();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
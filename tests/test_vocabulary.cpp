@@ -0,0 +1,106 @@
+// Automated tests for vocabulary prompt building
+// Compile: g++ -std=c++17 -I../include -o test_vocabulary test_vocabulary.cpp ../src/vocabulary.cpp
+
+#include "vocabulary.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+using namespace whispr;
+
+// Stand-in tokenizer: one token per word
+static int count_words(const std::string& text) {
+    int words = 0;
+    bool in_word = false;
+    for (char c : text) {
+        bool space = c == ' ';
+        if (!space && !in_word) ++words;
+        in_word = !space;
+    }
+    return words;
+}
+
+static VocabularyConfig sample_vocab() {
+    VocabularyConfig vocab;
+    vocab.proper_nouns = {"Anthropic", "Ralph Wiggum"};
+    vocab.technical_terms = {"GitHub", "TypeScript"};
+    vocab.common_phrases = {"That makes sense"};
+    return vocab;
+}
+
+void test_everything_fits() {
+    std::cout << "Testing prompt with room for every term..." << std::endl;
+
+    std::string prompt = VocabularyLoader::build_initial_prompt(sample_vocab(), "Base.", {}, count_words, 100);
+    assert(prompt == "Base. Names and proper nouns: Anthropic, Ralph Wiggum. "
+                     "Technical terms: GitHub, TypeScript. Common phrases: \"That makes sense\". ");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_budget_is_exact() {
+    std::cout << "Testing token budget..." << std::endl;
+
+    for (int budget = 1; budget <= 30; ++budget) {
+        std::string prompt = VocabularyLoader::build_initial_prompt(sample_vocab(), "Base.", {}, count_words, budget);
+        // The base prompt is always kept; terms never push past the budget
+        assert(prompt.compare(0, 5, "Base.") == 0);
+        assert(count_words(prompt) <= budget || prompt == "Base.");
+    }
+
+    // "Base. Names and proper nouns: Anthropic." is 6 words; the long name
+    // doesn't fit after it, but the one-word technical term does
+    VocabularyConfig vocab;
+    vocab.proper_nouns = {"Anthropic", "Ralph Wiggum of Springfield"};
+    vocab.technical_terms = {"GitHub"};
+    std::string prompt = VocabularyLoader::build_initial_prompt(vocab, "Base.", {}, count_words, 9);
+    assert(prompt == "Base. Names and proper nouns: Anthropic. Technical terms: GitHub. ");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_usage_priority() {
+    std::cout << "Testing usage-frequency priority..." << std::endl;
+
+    TermUsage usage;
+    VocabularyLoader::count_usage(sample_vocab(), "typescript and TypeScript, not TypeScripts", usage);
+    VocabularyLoader::count_usage(sample_vocab(), "Ask ralph wiggum", usage);
+    assert(usage["TypeScript"] == 2);
+    assert(usage["Ralph Wiggum"] == 1);
+    assert(usage.count("GitHub") == 0);
+
+    // Most used term first, then the next
+    std::string prompt = VocabularyLoader::build_initial_prompt(sample_vocab(), "", usage, count_words, 9);
+    assert(prompt == "Names and proper nouns: Ralph Wiggum. Technical terms: TypeScript. ");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_usage_round_trip() {
+    std::cout << "Testing usage persistence..." << std::endl;
+
+    std::string path = "test_vocabulary_usage.txt";
+    TermUsage usage = {{"GitHub", 3}, {"That makes sense", 7}};
+    assert(VocabularyLoader::save_usage(path, usage));
+
+    TermUsage loaded = VocabularyLoader::load_usage(path);
+    assert(loaded == usage);
+    std::remove(path.c_str());
+
+    assert(VocabularyLoader::load_usage(path).empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== Vocabulary Test Suite ===" << std::endl << std::endl;
+
+    test_everything_fits();
+    test_budget_is_exact();
+    test_usage_priority();
+    test_usage_round_trip();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}
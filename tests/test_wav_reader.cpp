@@ -0,0 +1,224 @@
+// Automated tests for WavReader
+// Compile: g++ -std=c++17 -I../include -o test_wav_reader test_wav_reader.cpp ../src/wav_reader.cpp
+
+#include "wav_reader.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace whispr;
+
+static const char* PATH = "test_wav_reader.wav";
+
+static void put16(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(v & 0xFF);
+    out.push_back((v >> 8) & 0xFF);
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t v) {
+    put16(out, v & 0xFFFF);
+    put16(out, v >> 16);
+}
+
+static void put_tag(std::vector<uint8_t>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+// RIFF file around already encoded sample bytes
+static void write_wav(const std::vector<uint8_t>& samples, int format, int channels, int rate, int bits,
+                      bool extra_chunk = false, bool open_ended = false) {
+    std::vector<uint8_t> out;
+    put_tag(out, "RIFF");
+    put32(out, 0);  // Readers don't need the RIFF size
+    put_tag(out, "WAVE");
+
+    put_tag(out, "fmt ");
+    if (format == 0xFFFE) {
+        put32(out, 40);
+    } else {
+        put32(out, 16);
+    }
+    put16(out, format);
+    put16(out, channels);
+    put32(out, rate);
+    put32(out, rate * channels * bits / 8);
+    put16(out, channels * bits / 8);
+    put16(out, bits);
+    if (format == 0xFFFE) {
+        put16(out, 22);
+        put16(out, bits);
+        put32(out, 0);
+        put16(out, 1);  // Subformat: PCM
+        for (int i = 0; i < 14; ++i) out.push_back(0);
+    }
+
+    if (extra_chunk) {
+        put_tag(out, "LIST");
+        put32(out, 5);  // Odd size: followed by a pad byte
+        for (int i = 0; i < 6; ++i) out.push_back('x');
+    }
+
+    put_tag(out, "data");
+    put32(out, open_ended ? 0xFFFFFFFFu : static_cast<uint32_t>(samples.size()));
+    out.insert(out.end(), samples.begin(), samples.end());
+
+    FILE* f = std::fopen(PATH, "wb");
+    assert(f);
+    std::fwrite(out.data(), 1, out.size(), f);
+    std::fclose(f);
+}
+
+static std::vector<uint8_t> pcm16(const std::vector<float>& samples) {
+    std::vector<uint8_t> out;
+    for (float s : samples) {
+        put16(out, static_cast<uint16_t>(static_cast<int16_t>(std::lround(s * 32767.0f))));
+    }
+    return out;
+}
+
+static std::vector<float> sine(int rate, float hz, size_t count) {
+    std::vector<float> out(count);
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = 0.5f * std::sin(2.0f * 3.14159265f * hz * static_cast<float>(i) / rate);
+    }
+    return out;
+}
+
+void test_pcm16_mono() {
+    std::cout << "Testing 16-bit mono at 16 kHz..." << std::endl;
+
+    std::vector<float> source = sine(16000, 440.0f, 16000);
+    write_wav(pcm16(source), 1, 1, 16000, 16, true);
+
+    std::vector<float> decoded;
+    std::string error;
+    assert(WavReader::read_all(PATH, decoded, 16000, &error));
+    assert(decoded.size() == source.size());
+    for (size_t i = 0; i < source.size(); ++i) {
+        assert(std::fabs(decoded[i] - source[i]) < 1.0f / 16000.0f);
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_small_reads() {
+    std::cout << "Testing reads in small blocks..." << std::endl;
+
+    std::vector<float> source = sine(16000, 300.0f, 10007);
+    write_wav(pcm16(source), 1, 1, 16000, 16);
+
+    std::vector<float> whole;
+    assert(WavReader::read_all(PATH, whole));
+
+    WavReader reader;
+    assert(reader.open(PATH));
+    assert(reader.total_samples() == source.size());
+    std::vector<float> pieces;
+    float block[7];
+    size_t n;
+    while ((n = reader.read(block, 7)) > 0) {
+        pieces.insert(pieces.end(), block, block + n);
+    }
+    assert(pieces == whole);
+    assert(reader.read(block, 7) == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_stereo_resample() {
+    std::cout << "Testing 24-bit stereo at 48 kHz..." << std::endl;
+
+    // Left and right differ; the mix is their average
+    const size_t frames = 48000;
+    std::vector<float> left = sine(48000, 200.0f, frames);
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < frames; ++i) {
+        for (float s : {left[i], 0.0f}) {
+            int32_t v = static_cast<int32_t>(std::lround(s * 8388607.0f));
+            bytes.push_back(v & 0xFF);
+            bytes.push_back((v >> 8) & 0xFF);
+            bytes.push_back((v >> 16) & 0xFF);
+        }
+    }
+    write_wav(bytes, 0xFFFE, 2, 48000, 24);
+
+    WavReader reader;
+    assert(reader.open(PATH, 16000));
+    assert(reader.source_rate() == 48000);
+    assert(reader.channels() == 2);
+    assert(reader.total_samples() == 16000);
+
+    std::vector<float> decoded;
+    assert(WavReader::read_all(PATH, decoded, 16000));
+    assert(decoded.size() == 16000);
+    std::vector<float> expected = sine(16000, 200.0f, 16000);
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        assert(std::fabs(decoded[i] - 0.5f * expected[i]) < 1e-3f);
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_float_open_ended() {
+    std::cout << "Testing float samples with an open-ended data chunk..." << std::endl;
+
+    std::vector<float> source = {0.0f, 0.25f, -0.5f, 1.0f, -1.0f};
+    std::vector<uint8_t> bytes;
+    for (float s : source) {
+        uint32_t v;
+        std::memcpy(&v, &s, sizeof(v));
+        put32(bytes, v);
+    }
+    write_wav(bytes, 3, 1, 16000, 32, false, true);
+
+    WavReader reader;
+    assert(reader.open(PATH));
+    assert(reader.total_samples() == 0);  // Unknown
+
+    std::vector<float> decoded;
+    assert(WavReader::read_all(PATH, decoded));
+    assert(decoded == source);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_rejects() {
+    std::cout << "Testing invalid files..." << std::endl;
+
+    std::vector<float> out;
+    std::string error;
+    assert(!WavReader::read_all("does_not_exist.wav", out, 16000, &error));
+    assert(!error.empty());
+
+    FILE* f = std::fopen(PATH, "wb");
+    std::fputs("this is not a wav file", f);
+    std::fclose(f);
+    assert(!WavReader::read_all(PATH, out, 16000, &error));
+    assert(error == "not a RIFF/WAVE file");
+
+    // A-law is not supported
+    write_wav(std::vector<uint8_t>(100, 0), 6, 1, 8000, 8);
+    assert(!WavReader::read_all(PATH, out, 16000, &error));
+    assert(error.find("unsupported") == 0);
+
+    std::remove(PATH);
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "\n=== WavReader Test Suite ===" << std::endl << std::endl;
+
+    test_pcm16_mono();
+    test_small_reads();
+    test_stereo_resample();
+    test_float_open_ended();
+    test_rejects();
+
+    std::cout << "\n=== All Tests Passed! ===" << std::endl << std::endl;
+    return 0;
+}